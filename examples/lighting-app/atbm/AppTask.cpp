@@ -19,6 +19,9 @@
 #include "AppTask.h"
 
 #include <app-common/zap-generated/attributes/Accessors.h>
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+#include <platform/internal/BLEManager.h>
+#endif
 
 #include "atbm_general.h"
 
@@ -134,6 +137,10 @@ void AppTask::DispatchEvent(AppEvent * aEvent)
 
 void AppTask::LightingActionEventHandler(AppEvent * aEvent)
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+    // A press while CHIPoBLE is advertising boosts discovery; otherwise this is a no-op.
+    chip::DeviceLayer::Internal::BLEMgrImpl().TriggerAdvertisingBurst();
+#endif
     AppLED.Toggle();
     chip::DeviceLayer::PlatformMgr().LockChipStack();
     sAppTask.UpdateClusterState();
@@ -124,6 +124,12 @@ extern "C" void app_matter_main()
     }
 
 #if CONFIG_ENABLE_ATBM_FACTORY_DATA_PROVIDER
+    error = sFactoryDataProvider.Init();
+    if (error != CHIP_NO_ERROR)
+    {
+        // Fall back to the factory data in EasyFlash rather than a partition we cannot trust.
+        ChipLogError(DeviceLayer, "Factory partition invalid: %s", ErrorStr(error));
+    }
     SetCommissionableDataProvider(&sFactoryDataProvider);
 #if CONFIG_ENABLE_ATBM_DEVICE_INSTANCE_INFO_PROVIDER
     SetDeviceInstanceInfoProvider(&sFactoryDataProvider);
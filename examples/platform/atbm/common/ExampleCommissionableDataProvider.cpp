@@ -21,11 +21,15 @@
 #include <string.h>
 
 #include <crypto/CHIPCryptoPAL.h>
+#include <lib/support/Base64.h>
+#include <lib/support/BufferWriter.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/Span.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <platform/atbm/ATBMConfig.h>
 
 using namespace chip::Crypto;
+using chip::DeviceLayer::Internal::ATBMConfig;
 
 namespace {
 
@@ -36,6 +40,94 @@ CHIP_ERROR GeneratePaseSalt(std::vector<uint8_t> & spake2pSaltVector)
     return DRBG_get_bytes(spake2pSaltVector.data(), spake2pSaltVector.size());
 }
 
+// The salt and verifier are cached in the same base64 form as factory provisioned ones (see
+// ATBMFactoryDataProvider). The tag binds them to the passcode and iteration count they were
+// derived from; it reveals no more about the passcode than the verifier itself.
+using VerifierCacheTag = uint8_t[kSHA256_Hash_Length];
+
+CHIP_ERROR ComputeVerifierCacheTag(uint32_t passcode, uint32_t iterationCount, const std::vector<uint8_t> & salt,
+                                   const std::vector<uint8_t> & serializedVerifier, VerifierCacheTag & tag)
+{
+    Hash_SHA256_stream sha;
+    uint8_t params[2 * sizeof(uint32_t)];
+    chip::Encoding::LittleEndian::BufferWriter writer(params, sizeof(params));
+    chip::MutableByteSpan tagSpan(tag);
+
+    writer.Put32(passcode).Put32(iterationCount);
+    ReturnErrorOnFailure(sha.Begin());
+    ReturnErrorOnFailure(sha.AddData(chip::ByteSpan(params, writer.Needed())));
+    ReturnErrorOnFailure(sha.AddData(chip::ByteSpan(salt.data(), salt.size())));
+    ReturnErrorOnFailure(sha.AddData(chip::ByteSpan(serializedVerifier.data(), serializedVerifier.size())));
+    return sha.Finish(tagSpan);
+}
+
+CHIP_ERROR ReadBase64ConfigValue(const ATBMConfig::Key & key, std::vector<uint8_t> & value)
+{
+    char base64[BASE64_ENCODED_LEN(kSpake2p_VerifierSerialized_Length) + 1];
+    size_t base64Len = 0;
+
+    ReturnErrorOnFailure(ATBMConfig::ReadConfigValueBin(key, reinterpret_cast<uint8_t *>(base64), sizeof(base64), base64Len));
+    value.resize(BASE64_MAX_DECODED_LEN(base64Len));
+    uint32_t len = chip::Base64Decode32(base64, static_cast<uint32_t>(base64Len), value.data());
+    VerifyOrReturnError(len != UINT32_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+    value.resize(len);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteBase64ConfigValue(const ATBMConfig::Key & key, const std::vector<uint8_t> & value)
+{
+    char base64[BASE64_ENCODED_LEN(kSpake2p_VerifierSerialized_Length) + 1];
+
+    VerifyOrReturnError(value.size() <= kSpake2p_VerifierSerialized_Length, CHIP_ERROR_BUFFER_TOO_SMALL);
+    uint32_t base64Len = chip::Base64Encode32(value.data(), static_cast<uint32_t>(value.size()), base64);
+    return ATBMConfig::WriteConfigValueStr(key, base64, base64Len);
+}
+
+// Loads a cached salt and verifier for this passcode and iteration count; when a salt was
+// given, the cached one must match it.
+CHIP_ERROR LoadCachedVerifier(uint32_t passcode, uint32_t iterationCount, const chip::Optional<std::vector<uint8_t>> & salt,
+                              std::vector<uint8_t> & cachedSalt, std::vector<uint8_t> & cachedVerifier)
+{
+    VerifierCacheTag storedTag;
+    VerifierCacheTag tag;
+    size_t storedTagLen = 0;
+
+    ReturnErrorOnFailure(
+        ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_Spake2pVerifierTag, storedTag, sizeof(storedTag), storedTagLen));
+    VerifyOrReturnError(storedTagLen == sizeof(storedTag), CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    ReturnErrorOnFailure(ReadBase64ConfigValue(ATBMConfig::kConfigKey_Spake2pSalt, cachedSalt));
+    ReturnErrorOnFailure(ReadBase64ConfigValue(ATBMConfig::kConfigKey_Spake2pVerifier, cachedVerifier));
+
+    VerifyOrReturnError(!salt.HasValue() || salt.Value() == cachedSalt, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    VerifyOrReturnError(cachedSalt.size() >= kSpake2p_Min_PBKDF_Salt_Length && cachedSalt.size() <= kSpake2p_Max_PBKDF_Salt_Length,
+                        CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    VerifyOrReturnError(cachedVerifier.size() == kSpake2p_VerifierSerialized_Length, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+    ReturnErrorOnFailure(ComputeVerifierCacheTag(passcode, iterationCount, cachedSalt, cachedVerifier, tag));
+    VerifyOrReturnError(memcmp(tag, storedTag, sizeof(tag)) == 0, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StoreCachedVerifier(uint32_t passcode, uint32_t iterationCount, const std::vector<uint8_t> & salt,
+                               const std::vector<uint8_t> & serializedVerifier)
+{
+    VerifierCacheTag tag;
+
+    // Without a tag, an existing salt or verifier was provisioned in the factory: leave it alone.
+    if (!ATBMConfig::ConfigValueExists(ATBMConfig::kConfigKey_Spake2pVerifierTag) &&
+        (ATBMConfig::ConfigValueExists(ATBMConfig::kConfigKey_Spake2pSalt) ||
+         ATBMConfig::ConfigValueExists(ATBMConfig::kConfigKey_Spake2pVerifier)))
+    {
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+
+    // The tag goes first, so that an interrupted update fails verification on the next boot.
+    ReturnErrorOnFailure(ComputeVerifierCacheTag(passcode, iterationCount, salt, serializedVerifier, tag));
+    ReturnErrorOnFailure(ATBMConfig::WriteConfigValueBin(ATBMConfig::kConfigKey_Spake2pVerifierTag, tag, sizeof(tag)));
+    ReturnErrorOnFailure(WriteBase64ConfigValue(ATBMConfig::kConfigKey_Spake2pSalt, salt));
+    return WriteBase64ConfigValue(ATBMConfig::kConfigKey_Spake2pVerifier, serializedVerifier);
+}
+
 } // namespace
 
 CHIP_ERROR ExampleCommissionableDataProvider::Init(chip::Optional<std::vector<uint8_t>> serializedSpake2pVerifier,
@@ -94,6 +186,28 @@ CHIP_ERROR ExampleCommissionableDataProvider::Init(chip::Optional<std::vector<ui
         ChipLogError(Support, "PASE salt length invalid: %u", static_cast<unsigned>(spake2pSaltLength));
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
+
+    bool havePasscode       = setupPasscode.HasValue();
+    bool haveCachedVerifier = false;
+    std::vector<uint8_t> serializedPasscodeVerifier(kSpake2p_VerifierSerialized_Length);
+    if (havePasscode && !havePaseVerifier)
+    {
+        std::vector<uint8_t> cachedSalt;
+        err = LoadCachedVerifier(setupPasscode.Value(), spake2pIterationCount, spake2pSalt, cachedSalt,
+                                 serializedPasscodeVerifier);
+        if (err == CHIP_NO_ERROR)
+        {
+            ChipLogProgress(Support, "Using cached PASE verifier");
+            spake2pSalt.SetValue(std::move(cachedSalt));
+            havePaseSalt       = true;
+            haveCachedVerifier = true;
+        }
+        else
+        {
+            serializedPasscodeVerifier.resize(kSpake2p_VerifierSerialized_Length);
+        }
+    }
+
     if (!havePaseSalt)
     {
         ChipLogProgress(Support, "ExampleCommissionableDataProvider didn't get a PASE salt, generating one.");
@@ -107,11 +221,9 @@ CHIP_ERROR ExampleCommissionableDataProvider::Init(chip::Optional<std::vector<ui
         spake2pSalt.SetValue(std::move(spake2pSaltVector));
     }
 
-    bool havePasscode = setupPasscode.HasValue();
     Spake2pVerifier passcodeVerifier;
-    std::vector<uint8_t> serializedPasscodeVerifier(kSpake2p_VerifierSerialized_Length);
     chip::MutableByteSpan saltSpan{ spake2pSalt.Value().data(), spake2pSalt.Value().size() };
-    if (havePasscode)
+    if (havePasscode && !haveCachedVerifier)
     {
         err = passcodeVerifier.Generate(spake2pIterationCount, saltSpan, setupPasscode.Value());
         if (err != CHIP_NO_ERROR)
@@ -127,6 +239,15 @@ CHIP_ERROR ExampleCommissionableDataProvider::Init(chip::Optional<std::vector<ui
             ChipLogError(Support, "Failed to serialize PASE verifier from passcode: %" CHIP_ERROR_FORMAT, err.Format());
             return err;
         }
+
+        if (!havePaseVerifier)
+        {
+            err = StoreCachedVerifier(setupPasscode.Value(), spake2pIterationCount, spake2pSalt.Value(), serializedPasscodeVerifier);
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(Support, "PASE verifier not cached: %" CHIP_ERROR_FORMAT, err.Format());
+            }
+        }
     }
 
     // Make sure we actually have a verifier
@@ -0,0 +1,705 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ATBMShellCommands.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lib/shell/Engine.h>
+#include <lib/shell/streamer.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/internal/BLEManager.h>
+
+#include <lwip/opt.h>
+
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
+#include <platform/atbm/DiagnosticDataProviderImpl.h>
+#include <platform/atbm/WiFiReconnectPolicy.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+#include <platform/atbm/HeapTracker.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+#include <platform/atbm/LockProfiler.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+#include <platform/atbm/PowerGovernor.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+#include <platform/atbm/TaskProfiler.h>
+#endif
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+#include <platform/atbm/LogFilter.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+#include <platform/atbm/FlashTrace.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK
+#include <platform/atbm/P256Benchmark.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK
+#include <platform/atbm/SessionCryptoBenchmark.h>
+#endif
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+#include <platform/atbm/mbedtls/atbm_crypto_accel.h>
+#endif
+#if ATBM_LWIP_MEM_POOL
+#include <platform/atbm/pkt_pool/atbm_pkt_pool.h>
+#endif
+
+using namespace chip::DeviceLayer;
+
+namespace chip {
+namespace Shell {
+
+namespace {
+
+Engine sATBMSubCommands;
+
+CHIP_ERROR PrintCommandHelp(shell_command_t * command, void * arg)
+{
+    streamer_printf(streamer_get(), "  %-15s %s\r\n", command->cmd_name, command->cmd_help);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ATBMHelpHandler(int argc, char ** argv)
+{
+    sATBMSubCommands.ForEachCommand(PrintCommandHelp, nullptr);
+    return CHIP_NO_ERROR;
+}
+
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+CHIP_ERROR BLEStatsHandler(int argc, char ** argv)
+{
+    Internal::BLEManagerImpl::BLEPathStats stats;
+    Internal::BLEManagerImpl::AdvertisingMetrics advMetrics;
+    Internal::BLEManagerImpl::AdvertisingPhase advPhase;
+
+    if (argc > 0 && strcmp(argv[0], "reset") == 0)
+    {
+        PlatformMgr().LockChipStack();
+        Internal::BLEMgrImpl().ResetBLEPathStats();
+        PlatformMgr().UnlockChipStack();
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    PlatformMgr().LockChipStack();
+    Internal::BLEMgrImpl().GetBLEPathStats(stats);
+    PlatformMgr().UnlockChipStack();
+    streamer_printf(streamer_get(), "TX: %" PRIu32 " bytes, %" PRIu32 " fragments, %" PRIu32 " allocs\r\n", stats.TxBytes,
+                    stats.TxFragments, stats.TxAllocs);
+    streamer_printf(streamer_get(), "RX: %" PRIu32 " bytes, %" PRIu32 " fragments, %" PRIu32 " allocs\r\n", stats.RxBytes,
+                    stats.RxFragments, stats.RxAllocs);
+    streamer_printf(streamer_get(), "Indication latency: last %" PRIu32 " us, max %" PRIu32 " us, avg %" PRIu32 " us (%" PRIu32
+                    " confirms)\r\n",
+                    stats.IndicationLatencyLastUs, stats.IndicationLatencyMaxUs,
+                    stats.IndicationConfirms ? static_cast<uint32_t>(stats.IndicationLatencyTotalUs / stats.IndicationConfirms) : 0,
+                    stats.IndicationConfirms);
+    streamer_printf(streamer_get(), "CHIP task: %" PRIu32 " events, max %" PRIu32 " us, total %" PRIu32 " us\r\n",
+                    stats.ChipEvents, stats.ChipEventTimeMaxUs, static_cast<uint32_t>(stats.ChipEventTimeTotalUs));
+
+    PlatformMgr().LockChipStack();
+    Internal::BLEMgrImpl().GetAdvertisingMetrics(advMetrics);
+    advPhase = Internal::BLEMgrImpl().GetAdvertisingPhase();
+    PlatformMgr().UnlockChipStack();
+    streamer_printf(streamer_get(),
+                    "Advertising: phase %u, fast %" PRIu32 " ms, medium %" PRIu32 " ms, slow %" PRIu32 " ms, burst %" PRIu32
+                    " ms\r\n",
+                    static_cast<unsigned>(advPhase), advMetrics.PhaseTimeMs[0], advMetrics.PhaseTimeMs[1],
+                    advMetrics.PhaseTimeMs[2], advMetrics.PhaseTimeMs[3]);
+    streamer_printf(streamer_get(), "Advertising radio on: %" PRIu32 " ms, %" PRIu32 " restarts, %" PRIu32 " data updates\r\n",
+                    static_cast<uint32_t>(advMetrics.RadioOnTimeUs / 1000), advMetrics.ParamUpdates, advMetrics.DataOnlyUpdates);
+    streamer_printf(streamer_get(), "Discovery: %" PRIu32 " connects, last after %" PRIu32 " ms\r\n", advMetrics.DiscoveryCount,
+                    advMetrics.LastDiscoveryLatencyMs);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
+// Retries at a fixed interval whatever the disconnect reason, to compare against the default
+// backoff policy on a given AP.
+class FixedIntervalReconnectPolicy : public WiFiReconnectPolicy
+{
+public:
+    void SetInterval(System::Clock::Timeout interval) { mInterval = interval; }
+
+    System::Clock::Timeout GetNextRetryDelay(uint16_t reasonCode, bool connectionLost, RetryClass & retryClass) override
+    {
+        retryClass = RetryClass::kFast;
+        return mInterval;
+    }
+    void Reset() override {}
+
+private:
+    System::Clock::Timeout mInterval;
+};
+
+FixedIntervalReconnectPolicy sFixedReconnectPolicy;
+
+CHIP_ERROR WiFiReconnectHandler(int argc, char ** argv)
+{
+    WiFiReconnectCounters counters;
+
+    // The policy and the counters belong to the CHIP thread.
+    if (argc == 1 && strcmp(argv[0], "reset") == 0)
+    {
+        PlatformMgr().LockChipStack();
+        CHIP_ERROR err = DiagnosticDataProviderImpl::GetDefaultInstance().ResetWiFiNetworkDiagnosticsCounts();
+        PlatformMgr().UnlockChipStack();
+        return err;
+    }
+    if (argc == 1 && strcmp(argv[0], "backoff") == 0)
+    {
+        PlatformMgr().LockChipStack();
+        ConnectivityMgrImpl().SetWiFiReconnectPolicy(nullptr);
+        PlatformMgr().UnlockChipStack();
+        return CHIP_NO_ERROR;
+    }
+    if (argc == 2 && strcmp(argv[0], "fixed") == 0)
+    {
+        uint32_t intervalMs = static_cast<uint32_t>(strtoul(argv[1], nullptr, 0));
+        VerifyOrReturnError(intervalMs > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+        PlatformMgr().LockChipStack();
+        sFixedReconnectPolicy.SetInterval(System::Clock::Milliseconds32(intervalMs));
+        ConnectivityMgrImpl().SetWiFiReconnectPolicy(&sFixedReconnectPolicy);
+        PlatformMgr().UnlockChipStack();
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    PlatformMgr().LockChipStack();
+    CHIP_ERROR err = DiagnosticDataProviderImpl::GetDefaultInstance().GetWiFiReconnectCounters(counters);
+    PlatformMgr().UnlockChipStack();
+    ReturnErrorOnFailure(err);
+
+    streamer_printf(streamer_get(), "Connect: %" PRIu32 " attempts, %" PRIu32 " failures\r\n", counters.ConnectAttempts,
+                    counters.ConnectFailures);
+    streamer_printf(streamer_get(), "Retries: %" PRIu32 " fast, %" PRIu32 " backoff, %" PRIu32 " auth failure\r\n",
+                    counters.FastRetries, counters.BackoffRetries, counters.AuthFailureRetries);
+    streamer_printf(streamer_get(), "Last retry delay: %" PRIu32 " ms\r\n", counters.LastRetryDelayMs);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_WIFI
+
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+void PrintLockStats(Internal::LockProfiler::LockId lock)
+{
+    using Internal::LockProfiler;
+
+    LockProfiler::LockStats stats;
+    LockProfiler::GetLockStats(lock, stats);
+
+    streamer_printf(streamer_get(), "%s: %" PRIu32 " acquires, %" PRIu32 " contended, max wait %" PRIu32
+                    " us, max hold %" PRIu32 " us (%s)\r\n",
+                    LockProfiler::GetLockName(lock), stats.Acquires, stats.Contended, stats.MaxWaitUs, stats.MaxHoldUs,
+                    LockProfiler::GetTaskName(stats.MaxHoldTask));
+    streamer_printf(streamer_get(), "  wait <10us %" PRIu32 ", <100us %" PRIu32 ", <1ms %" PRIu32 ", <10ms %" PRIu32
+                    ", <100ms %" PRIu32 ", >=100ms %" PRIu32 "\r\n",
+                    stats.WaitHistogram[0], stats.WaitHistogram[1], stats.WaitHistogram[2], stats.WaitHistogram[3],
+                    stats.WaitHistogram[4], stats.WaitHistogram[5]);
+
+    for (uint8_t i = 0; i < LockProfiler::kMaxTasks; i++)
+    {
+        const LockProfiler::TaskStats & task = stats.Tasks[i];
+        if (task.Acquires == 0)
+        {
+            continue;
+        }
+        streamer_printf(streamer_get(), "  %-16s %8" PRIu32 " acquires, %6" PRIu32 " contended, avg wait %" PRIu32
+                        " us, max wait %" PRIu32 " us\r\n",
+                        LockProfiler::GetTaskName(i), task.Acquires, task.Contended, task.TotalWaitUs / task.Acquires,
+                        task.MaxWaitUs);
+    }
+}
+
+// Prints the trace ring as CSV, one record per line, for the host analyzer.
+void PrintLockTrace()
+{
+    using Internal::LockProfiler;
+
+    static LockProfiler::TraceRecord sRecords[LockProfiler::kTraceDepth];
+    uint32_t dropped = 0;
+    size_t count     = LockProfiler::GetTrace(sRecords, ArraySize(sRecords), &dropped);
+
+    streamer_printf(streamer_get(), "# lock trace, %u records, %" PRIu32 " dropped\r\n", static_cast<unsigned>(count), dropped);
+    streamer_printf(streamer_get(), "timestamp_us,lock,event,task\r\n");
+    for (size_t i = 0; i < count; i++)
+    {
+        const LockProfiler::TraceRecord & record = sRecords[i];
+        streamer_printf(streamer_get(), "%" PRIu32 ",%s,%s,%s\r\n", record.TimestampUs,
+                        LockProfiler::GetLockName(static_cast<LockProfiler::LockId>(record.Lock)),
+                        LockProfiler::GetTraceEventName(record.Event), LockProfiler::GetTaskName(record.Task));
+    }
+}
+
+CHIP_ERROR LockStatsHandler(int argc, char ** argv)
+{
+    if (argc > 0 && strcmp(argv[0], "reset") == 0)
+    {
+        Internal::LockProfiler::Reset();
+        return CHIP_NO_ERROR;
+    }
+    if (argc > 0 && strcmp(argv[0], "trace") == 0)
+    {
+        PrintLockTrace();
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    PrintLockStats(Internal::LockProfiler::kLock_LwIPCore);
+    PrintLockStats(Internal::LockProfiler::kLock_ChipStack);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+// Indexed by chip::Logging::LogCategory.
+const char * const sLogLevelNames[] = { "none", "error", "progress", "detail", "automation" };
+
+const char * LogLevelName(uint8_t mask)
+{
+    uint8_t level = Internal::LogFilter::MaskToLevel(mask);
+    return (level < ArraySize(sLogLevelNames)) ? sLogLevelNames[level] : "all";
+}
+
+void PrintLogModule(const char * module, uint8_t mask, void * context)
+{
+    streamer_printf(streamer_get(), "  %-4s %s\r\n", module, LogLevelName(mask));
+}
+
+CHIP_ERROR LogFilterHandler(int argc, char ** argv)
+{
+    using Internal::LogFilter;
+
+    if (argc == 0)
+    {
+        streamer_printf(streamer_get(), "  *    %s\r\n", LogLevelName(LogFilter::GetDefaultMask()));
+        LogFilter::ForEachModule(PrintLogModule, nullptr);
+        return CHIP_NO_ERROR;
+    }
+    if (argc == 1 && strcmp(argv[0], "reset") == 0)
+    {
+        return LogFilter::Reset();
+    }
+    VerifyOrReturnError(argc == 2, CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (uint8_t level = 0; level < ArraySize(sLogLevelNames); level++)
+    {
+        if (strcmp(argv[1], sLogLevelNames[level]) == 0)
+        {
+            return LogFilter::SetLevel(strcmp(argv[0], "*") == 0 ? nullptr : argv[0], level);
+        }
+    }
+    return CHIP_ERROR_INVALID_ARGUMENT;
+}
+#endif // CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+// Prints the persisted trace as "TRACE <hex>" lines for scripts/tools/atbm/decode_flash_trace.py.
+CHIP_ERROR DumpFlashTrace()
+{
+    uint8_t chunk[64];
+    size_t used = Internal::FlashTrace::GetFlashUsedSize();
+
+    for (size_t offset = 0; offset < used; offset += sizeof(chunk))
+    {
+        size_t len = (used - offset < sizeof(chunk)) ? used - offset : sizeof(chunk);
+
+        ReturnErrorOnFailure(Internal::FlashTrace::ReadFlash(offset, chunk, len));
+        streamer_printf(streamer_get(), "TRACE ");
+        for (size_t i = 0; i < len; i++)
+        {
+            streamer_printf(streamer_get(), "%02X", chunk[i]);
+        }
+        streamer_printf(streamer_get(), "\r\n");
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FlashTraceHandler(int argc, char ** argv)
+{
+    using Internal::FlashTrace;
+
+    if (argc == 1 && strcmp(argv[0], "flush") == 0)
+    {
+        FlashTrace::Checkpoint(FlashTrace::kReason_Shell);
+        return CHIP_NO_ERROR;
+    }
+    if (argc == 1 && strcmp(argv[0], "dump") == 0)
+    {
+        return DumpFlashTrace();
+    }
+    if (argc == 1 && strcmp(argv[0], "clean") == 0)
+    {
+        return FlashTrace::Clean();
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    streamer_printf(streamer_get(), "Flash:   %u / %u bytes\r\n", static_cast<unsigned>(FlashTrace::GetFlashUsedSize()),
+                    static_cast<unsigned>(FlashTrace::GetFlashTotalSize()));
+    streamer_printf(streamer_get(), "Pending: %u records\r\n", static_cast<unsigned>(FlashTrace::GetPendingCount()));
+    streamer_printf(streamer_get(), "Lost:    %" PRIu32 " records\r\n", FlashTrace::GetLostCount());
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+
+#if CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK
+CHIP_ERROR P256BenchmarkHandler(int argc, char ** argv)
+{
+    using Internal::P256Benchmark;
+
+    P256Benchmark::Result results[P256Benchmark::kOp_Max];
+    uint32_t iterations = 10;
+
+    VerifyOrReturnError(argc <= 1, CHIP_ERROR_INVALID_ARGUMENT);
+    if (argc == 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[0], nullptr, 0));
+    }
+
+    // Blocks the shell task for the whole run.
+    ReturnErrorOnFailure(P256Benchmark::Run(iterations, results));
+
+    streamer_printf(streamer_get(), "%s\r\n", P256Benchmark::GetBackendDescription());
+    for (uint8_t op = 0; op < P256Benchmark::kOp_Max; op++)
+    {
+        const P256Benchmark::Result & result = results[op];
+        uint32_t avgUs                       = static_cast<uint32_t>(result.TotalUs / result.Iterations);
+
+        streamer_printf(streamer_get(), "  %-8s avg %8" PRIu32 " us, %4" PRIu32 " ops/s\r\n",
+                        P256Benchmark::GetOpName(static_cast<P256Benchmark::Op>(op)), avgUs, avgUs ? 1000000 / avgUs : 0);
+    }
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK
+
+#if CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK
+CHIP_ERROR SessionCryptoBenchmarkHandler(int argc, char ** argv)
+{
+    using Internal::SessionCryptoBenchmark;
+
+    static SessionCryptoBenchmark::Results sResults;
+    uint32_t iterations = 10;
+
+    VerifyOrReturnError(argc <= 1, CHIP_ERROR_INVALID_ARGUMENT);
+    if (argc == 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[0], nullptr, 0));
+    }
+
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+    const atbm_crypto_accel_t * accel = atbm_crypto_accel_get();
+    streamer_printf(streamer_get(), "Accelerator: %s\r\n", (accel != nullptr) ? accel->name : "none");
+    atbm_crypto_accel_reset_stats();
+#endif
+
+    // Blocks the shell task for the whole run.
+    ReturnErrorOnFailure(SessionCryptoBenchmark::Run(iterations, sResults));
+
+    streamer_printf(streamer_get(), "  %-8s", "us/msg");
+    for (uint8_t size = 0; size < SessionCryptoBenchmark::kNumPayloadSizes; size++)
+    {
+        streamer_printf(streamer_get(), " %6uB", static_cast<unsigned>(SessionCryptoBenchmark::GetPayloadSize(size)));
+    }
+    streamer_printf(streamer_get(), "\r\n");
+    for (uint8_t op = 0; op < SessionCryptoBenchmark::kOp_Max; op++)
+    {
+        streamer_printf(streamer_get(), "  %-8s", SessionCryptoBenchmark::GetOpName(static_cast<SessionCryptoBenchmark::Op>(op)));
+        for (uint8_t size = 0; size < SessionCryptoBenchmark::kNumPayloadSizes; size++)
+        {
+            const SessionCryptoBenchmark::Result & result = sResults[op][size];
+            streamer_printf(streamer_get(), " %7" PRIu32, static_cast<uint32_t>(result.TotalUs / result.Iterations));
+        }
+        streamer_printf(streamer_get(), "\r\n");
+    }
+
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+    atbm_crypto_accel_stats_t stats;
+    atbm_crypto_accel_get_stats(&stats);
+    streamer_printf(streamer_get(), "AES blocks: %" PRIu32 " hw, %" PRIu32 " sw; SHA-256 blocks: %" PRIu32 " hw, %" PRIu32 " sw\r\n",
+                    stats.aes_blocks_hw, stats.aes_blocks_sw, stats.sha256_blocks_hw, stats.sha256_blocks_sw);
+#endif
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK
+
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+CHIP_ERROR HeapStatsHandler(int argc, char ** argv)
+{
+    using Internal::HeapTracker;
+
+    HeapTracker::HeapInfo info;
+
+    if (argc > 0 && strcmp(argv[0], "reset") == 0)
+    {
+        HeapTracker::ResetWatermarks();
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    HeapTracker::GetHeapInfo(info);
+    streamer_printf(streamer_get(), "Heap: %" PRIu32 " total, %" PRIu32 " free, %" PRIu32 " high watermark\r\n", info.TotalBytes,
+                    info.FreeBytes, info.HighWatermark);
+    streamer_printf(streamer_get(), "Largest free block: %" PRIu32 ", fragmentation %u.%u%%\r\n", info.LargestFreeBlock,
+                    info.FragmentationPermille / 10, info.FragmentationPermille % 10);
+
+    streamer_printf(streamer_get(), "  %-8s %8s %8s %8s %8s %6s\r\n", "tag", "current", "peak", "allocs", "frees", "fails");
+    for (uint8_t tag = 0; tag < HeapTracker::kTag_Max; tag++)
+    {
+        HeapTracker::TagStats stats;
+        HeapTracker::GetTagStats(static_cast<HeapTracker::Tag>(tag), stats);
+        streamer_printf(streamer_get(), "  %-8s %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %6" PRIu32 "\r\n",
+                        HeapTracker::GetTagName(static_cast<HeapTracker::Tag>(tag)), stats.CurrentBytes, stats.PeakBytes,
+                        stats.Allocs, stats.Frees, stats.Failures);
+    }
+    if (info.LwipStats)
+    {
+        streamer_printf(streamer_get(), "  %-8s %8" PRIu32 " %8" PRIu32 "\r\n", "lwip", info.LwipBytes, info.LwipPeakBytes);
+    }
+
+    // lwIP (unless built with MEM_STATS), the SDK and task stacks allocate outside the tracker.
+    uint32_t used      = info.TotalBytes - info.FreeBytes;
+    uint32_t accounted = info.TrackedBytes + info.LwipBytes;
+    streamer_printf(streamer_get(), "  %-8s %8" PRIu32 "\r\n", "other", (used > accounted) ? used - accounted : 0);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+
+#if ATBM_LWIP_MEM_POOL
+CHIP_ERROR PacketPoolStatsHandler(int argc, char ** argv)
+{
+    static const char * const sPoolNames[ATBM_PKT_POOL_CLASSES] = { "small", "medium", "large" };
+    uint32_t heapAllocs;
+    uint32_t heapFailures;
+
+    if (argc > 0 && strcmp(argv[0], "reset") == 0)
+    {
+        atbm_pkt_pool_reset_stats();
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    streamer_printf(streamer_get(), "  %-7s %6s %6s %6s %6s %8s %6s\r\n", "pool", "size", "blocks", "used", "peak", "allocs",
+                    "misses");
+    for (unsigned int pool = 0; pool < ATBM_PKT_POOL_CLASSES; pool++)
+    {
+        atbm_pkt_pool_stats_t stats;
+        atbm_pkt_pool_get_stats(pool, &stats);
+        streamer_printf(streamer_get(), "  %-7s %6" PRIu32 " %6u %6u %6u %8" PRIu32 " %6" PRIu32 "\r\n", sPoolNames[pool],
+                        stats.block_size, stats.blocks, stats.used, stats.peak, stats.allocs, stats.misses);
+    }
+    atbm_pkt_pool_get_heap_stats(&heapAllocs, &heapFailures);
+    streamer_printf(streamer_get(), "Heap fallback: %" PRIu32 " allocs, %" PRIu32 " failures\r\n", heapAllocs, heapFailures);
+    return CHIP_NO_ERROR;
+}
+#endif // ATBM_LWIP_MEM_POOL
+
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+CHIP_ERROR PowerStatsHandler(int argc, char ** argv)
+{
+    using Internal::PowerGovernor;
+
+    PowerGovernor::SleepPlan plan;
+    PowerGovernor::Stats stats;
+
+    if (argc > 0 && strcmp(argv[0], "reset") == 0)
+    {
+        PowerGovernor::Reset();
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    PowerGovernor::GetSleepPlan(plan);
+    if (plan.SleepMs == PowerGovernor::kNoDeadline)
+    {
+        streamer_printf(streamer_get(), "Next deadline: none\r\n");
+    }
+    else
+    {
+        streamer_printf(streamer_get(), "Next deadline: %" PRIu32 " ms (%s)\r\n", plan.SleepMs,
+                        PowerGovernor::GetSourceName(plan.LimitedBy));
+    }
+    for (uint8_t source = 0; source < PowerGovernor::kSource_Max; source++)
+    {
+        if (plan.SourceMs[source] != PowerGovernor::kNoDeadline)
+        {
+            streamer_printf(streamer_get(), "  %-8s %10" PRIu32 " ms\r\n",
+                            PowerGovernor::GetSourceName(static_cast<PowerGovernor::Source>(source)), plan.SourceMs[source]);
+        }
+    }
+
+    PowerGovernor::GetStats(stats);
+    streamer_printf(streamer_get(), "Wake-ups:\r\n");
+    for (uint8_t reason = 0; reason < PowerGovernor::kWake_Max; reason++)
+    {
+        streamer_printf(streamer_get(), "  %-8s %10" PRIu32 "\r\n",
+                        PowerGovernor::GetWakeReasonName(static_cast<PowerGovernor::WakeReason>(reason)), stats.Wakes[reason]);
+    }
+    streamer_printf(streamer_get(), "  after <10ms %" PRIu32 ", <100ms %" PRIu32 ", <1s %" PRIu32 ", <10s %" PRIu32
+                    ", >=10s %" PRIu32 "\r\n",
+                    stats.SleepHistogram[0], stats.SleepHistogram[1], stats.SleepHistogram[2], stats.SleepHistogram[3],
+                    stats.SleepHistogram[4]);
+    streamer_printf(streamer_get(), "Deferrable timers: %" PRIu32 ", %" PRIu32 " on a scheduled wake-up\r\n", stats.DeferredTimers,
+                    stats.CoalescedTimers);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+void PrintTaskSnapshot(const Internal::TaskProfiler::Snapshot & snapshot)
+{
+    using Internal::TaskProfiler;
+
+    streamer_printf(streamer_get(), "Snapshot at %" PRIu32 " ms over %" PRIu32 " ms of run time%s\r\n", snapshot.TimestampMs,
+                    snapshot.RunTimeUs / 1000, snapshot.Truncated ? " (truncated)" : "");
+    streamer_printf(streamer_get(), "  %-16s %4s %-9s %6s %10s\r\n", "task", "prio", "state", "cpu%", "stack free");
+    for (uint8_t i = 0; i < snapshot.TaskCount; i++)
+    {
+        const TaskProfiler::TaskSample & task = snapshot.Tasks[i];
+        if (task.CpuPermille == TaskProfiler::kNoCpu)
+        {
+            streamer_printf(streamer_get(), "  %-16s %4u %-9s %6s %10" PRIu32 "\r\n", task.Name, task.Priority,
+                            TaskProfiler::GetStateName(task.State), "-", task.StackFreeMinBytes);
+        }
+        else
+        {
+            streamer_printf(streamer_get(), "  %-16s %4u %-9s %4u.%u %10" PRIu32 "\r\n", task.Name, task.Priority,
+                            TaskProfiler::GetStateName(task.State), task.CpuPermille / 10, task.CpuPermille % 10,
+                            task.StackFreeMinBytes);
+        }
+    }
+}
+
+// Prints the snapshot ring as CSV, oldest first, one task per line.
+void PrintTaskHistory()
+{
+    using Internal::TaskProfiler;
+
+    static TaskProfiler::Snapshot sSnapshot;
+    size_t count = TaskProfiler::GetSnapshotCount();
+
+    streamer_printf(streamer_get(), "# task snapshots, %u\r\n", static_cast<unsigned>(count));
+    streamer_printf(streamer_get(), "timestamp_ms,task,number,priority,state,cpu_permille,stack_free_min\r\n");
+    for (size_t age = count; age > 0; age--)
+    {
+        VerifyOrReturn(TaskProfiler::GetSnapshot(age - 1, sSnapshot));
+        for (uint8_t i = 0; i < sSnapshot.TaskCount; i++)
+        {
+            const TaskProfiler::TaskSample & task = sSnapshot.Tasks[i];
+            streamer_printf(streamer_get(), "%" PRIu32 ",%s,%" PRIu32 ",%u,%s,%d,%" PRIu32 "\r\n", sSnapshot.TimestampMs, task.Name,
+                            task.Number, task.Priority, TaskProfiler::GetStateName(task.State),
+                            (task.CpuPermille == TaskProfiler::kNoCpu) ? -1 : task.CpuPermille, task.StackFreeMinBytes);
+        }
+    }
+}
+
+CHIP_ERROR TaskStatsHandler(int argc, char ** argv)
+{
+    using Internal::TaskProfiler;
+
+    // The profiler state belongs to the CHIP thread.
+    if (argc > 0 && strcmp(argv[0], "sample") == 0)
+    {
+        return DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) { TaskProfiler::Sample(); });
+    }
+    if (argc > 0 && strcmp(argv[0], "reset") == 0)
+    {
+        return DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) { TaskProfiler::Reset(); });
+    }
+    if (argc > 0 && strcmp(argv[0], "csv") == 0)
+    {
+        PrintTaskHistory();
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(argc == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    static TaskProfiler::Snapshot sSnapshot;
+    if (!TaskProfiler::GetSnapshot(0, sSnapshot))
+    {
+        streamer_printf(streamer_get(), "No task snapshot yet\r\n");
+        return CHIP_NO_ERROR;
+    }
+    PrintTaskSnapshot(sSnapshot);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+
+CHIP_ERROR ATBMHandler(int argc, char ** argv)
+{
+    if (argc == 0)
+    {
+        return ATBMHelpHandler(argc, argv);
+    }
+    return sATBMSubCommands.ExecCommand(argc, argv);
+}
+
+} // namespace
+
+void RegisterATBMCommands()
+{
+    static const shell_command_t sATBMSubCommandList[] = {
+        { &ATBMHelpHandler, "help", "Usage: atbm <subcommand>" },
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+        { &BLEStatsHandler, "ble", "CHIPoBLE data path and advertising statistics. Usage: atbm ble [reset]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
+        { &WiFiReconnectHandler, "wifi",
+          "WiFi station reconnect counters and policy. Usage: atbm wifi [reset | backoff | fixed <ms>]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+        { &HeapStatsHandler, "heap", "Heap usage per subsystem, watermark and fragmentation. Usage: atbm heap [reset]" },
+#endif
+#if ATBM_LWIP_MEM_POOL
+        { &PacketPoolStatsHandler, "pools", "lwIP / packet buffer pool usage. Usage: atbm pools [reset]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+        { &PowerStatsHandler, "power", "CHIP event loop wake-ups and next deadline. Usage: atbm power [reset]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+        { &TaskStatsHandler, "tasks", "Per-task CPU share and stack headroom. Usage: atbm tasks [sample|csv|reset]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+        { &LockStatsHandler, "locks", "LwIP core / CHIP stack lock contention. Usage: atbm locks [reset|trace]" },
+#endif
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+        { &LogFilterHandler, "log",
+          "Runtime log levels. Usage: atbm log [reset | <module|*> <none|error|progress|detail|automation>]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+        { &FlashTraceHandler, "trace", "Persistent event trace. Usage: atbm trace [flush|dump|clean]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK
+        { &P256BenchmarkHandler, "p256", "P-256 keygen/import/sign/verify/ECDH timing. Usage: atbm p256 [iterations]" },
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK
+        { &SessionCryptoBenchmarkHandler, "crypto", "Per-message AES-CCM/SHA-256 timing. Usage: atbm crypto [iterations]" },
+#endif
+    };
+
+    static const shell_command_t sATBMCommand = { &ATBMHandler, "atbm", "ATBM platform diagnostics" };
+
+    sATBMSubCommands.RegisterCommands(sATBMSubCommandList, ArraySize(sATBMSubCommandList));
+    Engine::Root().RegisterCommands(&sATBMCommand, 1);
+}
+
+} // namespace Shell
+} // namespace chip
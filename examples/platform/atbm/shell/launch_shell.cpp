@@ -16,6 +16,7 @@
  */
 
 #include "launch_shell.h"
+#include "ATBMShellCommands.h"
 
 #include "FreeRTOS.h"
 #include "task.h"
@@ -27,6 +28,7 @@ namespace chip {
 void LaunchShell()
 {
     chip::Shell::Engine::Root().Init();
+    chip::Shell::RegisterATBMCommands();
 }
 
 } // namespace chip
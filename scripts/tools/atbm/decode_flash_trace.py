@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Project CHIP Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Decodes the persistent event trace of an ATBM device (chip_enable_flash_trace = true).
+
+The trace is read from one of:
+
+    console   "TRACE <hex>" lines printed by the "atbm trace dump" shell command (default)
+    stream    the same bytes as a binary file (--format stream)
+    image     a raw readout of the EasyFlash log area, i.e. the user data2 section,
+              including the 12 byte sector headers (--format image)
+
+Each record is 20 bytes, little endian (see src/platform/atbm/FlashTrace.h):
+
+    u8 magic (0xA5), u8 check (XOR of the other bytes), u16 event, u32 timestamp_ms, u32 args[3]
+
+The oldest flash sector is recycled when the area is full, so the data may start in
+the middle of a record; the decoder resynchronizes on the magic and check bytes.
+
+Usage:
+
+    decode_flash_trace.py console.log
+    decode_flash_trace.py --format image --csv user_data2.bin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+RECORD = struct.Struct('<BBHI3I')
+RECORD_MAGIC = 0xA5
+
+SECTOR_SIZE = 4096
+SECTOR_HEADER = struct.Struct('<3I')
+SECTOR_MAGIC = 0xEF30EF30
+SECTOR_USING = 0xFEFEFEFE
+SECTOR_FULL = 0xFCFCFCFC
+
+CHECKPOINT_REASONS = ['periodic', 'reboot', 'abort', 'fault', 'watchdog', 'shell']
+RETRY_CLASSES = ['fast', 'backoff', 'auth-failure']
+
+# event id -> (name, argument names); keep in sync with FlashTrace::EventId.
+EVENTS = {
+    0x0001: ('Boot', ['sw_version']),
+    0x0002: ('Checkpoint', ['reason']),
+    0x0003: ('Lost', ['records']),
+    0x0100: ('WiFiConnected', []),
+    0x0101: ('WiFiDisconnected', ['reason']),
+    0x0102: ('WiFiReconnect', ['reason', 'delay_ms', 'class']),
+    0x0103: ('IPv4Up', []),
+    0x0104: ('IPv4Lost', []),
+    0x0200: ('BLEConnected', ['con']),
+    0x0201: ('BLEDisconnected', ['con', 'hci_reason']),
+    0x0202: ('BLEIndicationFailed', ['con', 'status']),
+}
+
+APP_EVENT_BASE = 0x8000
+
+_TRACE_LINE = re.compile(r'TRACE ([0-9A-Fa-f]+)\s*$')
+
+
+def read_console(data):
+    stream = bytearray()
+    for line in data.decode('utf-8', errors='replace').splitlines():
+        match = _TRACE_LINE.search(line)
+        if match:
+            stream += bytes.fromhex(match.group(1))
+    return bytes(stream)
+
+
+def read_image(data):
+    """Strips the sector headers and orders the sectors oldest first."""
+    sectors = []
+    for offset in range(0, len(data) - SECTOR_SIZE + 1, SECTOR_SIZE):
+        magic, using, full = SECTOR_HEADER.unpack_from(data, offset)
+        if magic != SECTOR_MAGIC or using != SECTOR_USING:
+            sectors.append(None)
+            continue
+        payload = data[offset + SECTOR_HEADER.size:offset + SECTOR_SIZE]
+        if full != SECTOR_FULL:
+            # Partially written: the written part ends before the erased (0xFF) words.
+            end = len(payload)
+            while end >= 4 and payload[end - 4:end] == b'\xff\xff\xff\xff':
+                end -= 4
+            payload = payload[:end]
+        sectors.append((full == SECTOR_FULL, payload))
+
+    # The sector being written is the newest; the one after it is the oldest.
+    current = next((i for i, s in enumerate(sectors) if s is not None and not s[0]), len(sectors) - 1)
+    order = list(range(current + 1, len(sectors))) + list(range(0, current + 1))
+    return b''.join(sectors[i][1] for i in order if sectors[i] is not None)
+
+
+def parse_records(stream):
+    offset = 0
+    while offset + RECORD.size <= len(stream):
+        chunk = stream[offset:offset + RECORD.size]
+        check = 0
+        for byte in chunk:
+            check ^= byte
+        if chunk[0] == RECORD_MAGIC and check == 0:
+            _, _, event, timestamp, arg0, arg1, arg2 = RECORD.unpack(chunk)
+            yield event, timestamp, (arg0, arg1, arg2)
+            offset += RECORD.size
+        else:
+            offset += 4
+
+
+def describe(event, args):
+    if event >= APP_EVENT_BASE:
+        return 'App+0x{:04x}'.format(event - APP_EVENT_BASE), list(args)
+
+    name, arg_names = EVENTS.get(event, ('0x{:04x}'.format(event), ['arg0', 'arg1', 'arg2']))
+    values = []
+    for arg_name, value in zip(arg_names, args):
+        if name == 'Checkpoint' and arg_name == 'reason' and value < len(CHECKPOINT_REASONS):
+            value = CHECKPOINT_REASONS[value]
+        elif name == 'WiFiReconnect' and arg_name == 'class' and value < len(RETRY_CLASSES):
+            value = RETRY_CLASSES[value]
+        values.append('{}={}'.format(arg_name, value))
+    return name, values
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', type=argparse.FileType('rb'), nargs='?', default=sys.stdin.buffer,
+                        help='trace source (default: stdin)')
+    parser.add_argument('--format', choices=['console', 'stream', 'image'], default='console')
+    parser.add_argument('--csv', action='store_true', help='print boot,timestamp_ms,event,args as CSV')
+    args = parser.parse_args()
+
+    data = args.input.read()
+    if args.format == 'console':
+        stream = read_console(data)
+    elif args.format == 'image':
+        stream = read_image(data)
+    else:
+        stream = data
+
+    # Records before the first Boot record belong to a boot whose start was recycled.
+    boot = 0
+    if args.csv:
+        print('boot,timestamp_ms,event,args')
+    for event, timestamp, event_args in parse_records(stream):
+        if event == 0x0001:
+            boot += 1
+        name, values = describe(event, event_args)
+        if args.csv:
+            print('{},{},{},"{}"'.format(boot, timestamp, name, ' '.join(str(v) for v in values)))
+        else:
+            print('[boot {:3}] {:10.3f}s  {:<20} {}'.format(boot, timestamp / 1000.0, name, ' '.join(str(v) for v in values)))
+
+
+if __name__ == '__main__':
+    main()
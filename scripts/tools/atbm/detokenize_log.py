@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Project CHIP Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Detokenizes the console log of an ATBM device built with tokenized logging.
+
+Tokenized records (chip_pw_tokenizer_logging = true) appear on the console as
+
+    [DL] $<base64>      written by the deferred logger (CHIP_DEVICE_CONFIG_LOG_DEFERRED)
+    [DL] <HEX>          written directly by the CHIP logging core
+
+All other lines are passed through unchanged.
+
+The token database is created from the linked firmware image:
+
+    python3 -m pw_tokenizer.database create --database tokens.csv firmware.elf
+
+Usage:
+
+    detokenize_log.py tokens.csv < console.log
+    detokenize_log.py tokens.csv -i console.log -o decoded.log
+"""
+
+import argparse
+import base64
+import binascii
+import os
+import re
+import sys
+
+_CHIP_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..', '..'))
+_PW_TOKENIZER_PY = os.path.join(_CHIP_ROOT, 'third_party', 'pigweed', 'repo', 'pw_tokenizer', 'py')
+if os.path.isdir(_PW_TOKENIZER_PY):
+    sys.path.insert(0, _PW_TOKENIZER_PY)
+
+try:
+    from pw_tokenizer import detokenize
+except ImportError:
+    sys.exit('pw_tokenizer not found: activate the Pigweed environment or "pip install pw_tokenizer"')
+
+_RECORD = re.compile(r'^(?P<prefix>\s*\[(?P<module>[^\]]+)\] )(?:\$(?P<b64>[A-Za-z0-9+/=]+)|(?P<hex>(?:[0-9A-F]{2}){4,}))\s*$')
+
+
+def decode_record(match):
+    try:
+        if match.group('b64'):
+            return base64.b64decode(match.group('b64'), validate=True)
+        return binascii.unhexlify(match.group('hex'))
+    except (binascii.Error, ValueError):
+        return None
+
+
+def detokenize_line(detokenizer, line):
+    match = _RECORD.match(line)
+    if not match:
+        return line
+
+    record = decode_record(match)
+    if record is None:
+        return line
+
+    result = detokenizer.detokenize(record)
+    if not result.ok():
+        return line
+    return '{}{}\n'.format(match.group('prefix'), result)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('database', nargs='+', help='token database(s): CSV, binary or ELF')
+    parser.add_argument('-i', '--input', type=argparse.FileType('r', errors='replace'), default=sys.stdin,
+                        help='console log (default: stdin)')
+    parser.add_argument('-o', '--output', type=argparse.FileType('w'), default=sys.stdout,
+                        help='decoded log (default: stdout)')
+    args = parser.parse_args()
+
+    detokenizer = detokenize.Detokenizer(*args.database)
+    for line in args.input:
+        args.output.write(detokenize_line(detokenizer, line))
+        args.output.flush()
+
+
+if __name__ == '__main__':
+    main()
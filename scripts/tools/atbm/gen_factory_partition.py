@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Project CHIP Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates the factory data partition of an ATBM device (chip_use_factory_partition = true).
+
+The image is written to CHIP_DEVICE_CONFIG_FACTORY_PARTITION_ADDR, by default the user
+key section at flash offset 0x101000, and is read in place by the firmware (see
+src/platform/atbm/FactoryPartition.h):
+
+    u32 magic "AFDP", u16 version, u16 count, u32 payload_len, u32 crc32(payload)
+    count x { u16 tag, u16 len, value, padding to 4 bytes }
+
+Everything is stored decoded: certificates and keys as DER/raw bytes, the SPAKE2+ salt
+and verifier as the bytes behind their Base64 form, integers as u32 little endian.
+
+Usage:
+
+    gen_factory_partition.py -o factory.bin --discriminator 3840 \\
+        --spake2p-iterations 1000 --spake2p-salt <base64> --spake2p-verifier <base64> \\
+        --dac-cert dac.der --dac-key dac_key.der --pai-cert pai.der --cd cd.der \\
+        --vendor-id 0xFFF1 --vendor-name ACME --product-id 0x8001 --product-name Light \\
+        --serial-num SN0001 --mfg-date 2024-06-01 --hw-ver 1 --hw-ver-str 1.0
+    gen_factory_partition.py --dump factory.bin
+"""
+
+import argparse
+import base64
+import datetime
+import struct
+import sys
+import zlib
+
+MAGIC = 0x50444641
+VERSION = 1
+HEADER = struct.Struct('<IHHII')
+ENTRY = struct.Struct('<HH')
+
+DEFAULT_SIZE = 0x1000
+
+SPAKE2P_MIN_SALT_LEN = 16
+SPAKE2P_MAX_SALT_LEN = 32
+SPAKE2P_VERIFIER_LEN = 97
+DAC_PRIVATE_KEY_LEN = 32
+DAC_PUBLIC_KEY_LEN = 65
+
+# Keep in sync with FactoryPartition::Tag.
+TAGS = {
+    'discriminator': 1,
+    'spake2p_iterations': 2,
+    'spake2p_salt': 3,
+    'spake2p_verifier': 4,
+    'dac_cert': 5,
+    'dac_private_key': 6,
+    'dac_public_key': 7,
+    'pai_cert': 8,
+    'cd': 9,
+    'vendor_name': 10,
+    'vendor_id': 11,
+    'product_name': 12,
+    'product_id': 13,
+    'product_url': 14,
+    'product_label': 15,
+    'hw_ver_str': 16,
+    'hw_ver': 17,
+    'rd_id_uid': 18,
+    'serial_num': 19,
+    'mfg_date': 20,
+    'part_number': 21,
+    'product_finish': 22,
+    'product_color': 23,
+}
+
+INTEGER_TAGS = {'discriminator', 'spake2p_iterations', 'vendor_id', 'product_id', 'hw_ver', 'product_finish',
+                'product_color'}
+STRING_TAGS = {'vendor_name', 'product_name', 'product_url', 'product_label', 'hw_ver_str', 'serial_num',
+               'mfg_date', 'part_number'}
+
+
+def read_file(path):
+    with open(path, 'rb') as f:
+        return f.read()
+
+
+def load_dac_key(path):
+    """Returns (private, public) raw keys from a raw 32 byte key, or a DER/PEM key."""
+    data = read_file(path)
+    if len(data) == DAC_PRIVATE_KEY_LEN:
+        return data, None
+
+    try:
+        from cryptography.hazmat.primitives import serialization
+    except ImportError:
+        sys.exit('{}: not a raw P-256 key; install "cryptography" to read DER/PEM keys'.format(path))
+
+    if data.startswith(b'-----'):
+        key = serialization.load_pem_private_key(data, password=None)
+    else:
+        key = serialization.load_der_private_key(data, password=None)
+    private = key.private_numbers().private_value.to_bytes(DAC_PRIVATE_KEY_LEN, 'big')
+    public = key.public_key().public_bytes(serialization.Encoding.X962, serialization.PublicFormat.UncompressedPoint)
+    return private, public
+
+
+def collect_values(args):
+    values = {}
+
+    for name in INTEGER_TAGS:
+        value = getattr(args, name)
+        if value is not None:
+            values[name] = struct.pack('<I', value)
+    for name in STRING_TAGS:
+        value = getattr(args, name)
+        if value is not None:
+            values[name] = value.encode('utf-8')
+
+    if args.discriminator is not None and args.discriminator > 0xFFF:
+        sys.exit('discriminator must fit in 12 bits')
+    if args.mfg_date is not None:
+        datetime.date.fromisoformat(args.mfg_date)
+
+    if args.spake2p_salt is not None:
+        values['spake2p_salt'] = base64.b64decode(args.spake2p_salt, validate=True)
+        if not SPAKE2P_MIN_SALT_LEN <= len(values['spake2p_salt']) <= SPAKE2P_MAX_SALT_LEN:
+            sys.exit('SPAKE2+ salt must be {} to {} bytes'.format(SPAKE2P_MIN_SALT_LEN, SPAKE2P_MAX_SALT_LEN))
+    if args.spake2p_verifier is not None:
+        values['spake2p_verifier'] = base64.b64decode(args.spake2p_verifier, validate=True)
+        if len(values['spake2p_verifier']) != SPAKE2P_VERIFIER_LEN:
+            sys.exit('SPAKE2+ verifier must be {} bytes'.format(SPAKE2P_VERIFIER_LEN))
+
+    for name in ('dac_cert', 'pai_cert', 'cd'):
+        path = getattr(args, name)
+        if path is not None:
+            values[name] = read_file(path)
+
+    if args.dac_key is not None:
+        private, public = load_dac_key(args.dac_key)
+        if args.dac_pubkey is not None:
+            public = read_file(args.dac_pubkey)
+        if public is None or len(public) != DAC_PUBLIC_KEY_LEN:
+            sys.exit('a raw DAC key needs --dac-pubkey with the 65 byte uncompressed public key')
+        values['dac_private_key'] = private
+        values['dac_public_key'] = public
+
+    if args.rd_id_uid is not None:
+        values['rd_id_uid'] = bytes.fromhex(args.rd_id_uid)
+        if len(values['rd_id_uid']) < 16:
+            sys.exit('rotating device id unique id must be at least 16 bytes')
+
+    return values
+
+
+def build(values, size):
+    payload = bytearray()
+    for name in sorted(values, key=lambda n: TAGS[n]):
+        value = values[name]
+        payload += ENTRY.pack(TAGS[name], len(value))
+        payload += value
+        payload += b'\x00' * (-len(value) % 4)
+
+    image = HEADER.pack(MAGIC, VERSION, len(values), len(payload), zlib.crc32(payload)) + payload
+    if len(image) > size:
+        sys.exit('partition needs {} bytes, only {} available'.format(len(image), size))
+    # Pad with the erased flash value so the image can be written over the whole section.
+    return image + b'\xff' * (size - len(image))
+
+
+def dump(image):
+    magic, version, count, payload_len, crc = HEADER.unpack_from(image)
+    if magic != MAGIC:
+        sys.exit('no factory partition (magic 0x{:08x})'.format(magic))
+    payload = image[HEADER.size:HEADER.size + payload_len]
+    status = 'ok' if zlib.crc32(payload) == crc else 'MISMATCH'
+    print('version {}, {} entries, {} bytes, crc32 0x{:08x} {}'.format(version, count, payload_len, crc, status))
+
+    names = {tag: name for name, tag in TAGS.items()}
+    offset = 0
+    for _ in range(count):
+        tag, length = ENTRY.unpack_from(payload, offset)
+        offset += ENTRY.size
+        value = payload[offset:offset + length]
+        offset += length + (-length % 4)
+        name = names.get(tag, 'tag{}'.format(tag))
+        if name in INTEGER_TAGS:
+            text = '{0} (0x{0:x})'.format(struct.unpack('<I', value)[0])
+        elif name in STRING_TAGS:
+            text = value.decode('utf-8', errors='replace')
+        elif name == 'dac_private_key':
+            text = '<{} bytes>'.format(length)
+        else:
+            text = value.hex() if length <= 32 else '<{} bytes> {}...'.format(length, value[:16].hex())
+        print('  {:<20} {}'.format(name, text))
+
+
+def any_int(text):
+    return int(text, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-o', '--output', help='partition image to write')
+    parser.add_argument('--dump', metavar='IMAGE', help='print the content of an existing partition image')
+    parser.add_argument('--size', type=any_int, default=DEFAULT_SIZE,
+                        help='partition size, CHIP_DEVICE_CONFIG_FACTORY_PARTITION_SIZE (default: 0x1000)')
+
+    commissioning = parser.add_argument_group('commissioning')
+    commissioning.add_argument('--discriminator', type=any_int)
+    commissioning.add_argument('--spake2p-iterations', dest='spake2p_iterations', type=any_int)
+    commissioning.add_argument('--spake2p-salt', dest='spake2p_salt', metavar='BASE64')
+    commissioning.add_argument('--spake2p-verifier', dest='spake2p_verifier', metavar='BASE64')
+
+    attestation = parser.add_argument_group('device attestation')
+    attestation.add_argument('--dac-cert', dest='dac_cert', metavar='DER')
+    attestation.add_argument('--dac-key', dest='dac_key', metavar='FILE', help='raw 32 byte, DER or PEM P-256 key')
+    attestation.add_argument('--dac-pubkey', dest='dac_pubkey', metavar='FILE',
+                             help='raw 65 byte public key, required with a raw private key')
+    attestation.add_argument('--pai-cert', dest='pai_cert', metavar='DER')
+    attestation.add_argument('--cd', metavar='DER', help='certification declaration')
+
+    instance = parser.add_argument_group('device instance')
+    instance.add_argument('--vendor-id', dest='vendor_id', type=any_int)
+    instance.add_argument('--vendor-name', dest='vendor_name')
+    instance.add_argument('--product-id', dest='product_id', type=any_int)
+    instance.add_argument('--product-name', dest='product_name')
+    instance.add_argument('--product-url', dest='product_url')
+    instance.add_argument('--product-label', dest='product_label')
+    instance.add_argument('--part-number', dest='part_number')
+    instance.add_argument('--hw-ver', dest='hw_ver', type=any_int)
+    instance.add_argument('--hw-ver-str', dest='hw_ver_str')
+    instance.add_argument('--serial-num', dest='serial_num')
+    instance.add_argument('--mfg-date', dest='mfg_date', metavar='YYYY-MM-DD')
+    instance.add_argument('--rd-id-uid', dest='rd_id_uid', metavar='HEX', help='rotating device id unique id')
+    instance.add_argument('--product-finish', dest='product_finish', type=any_int)
+    instance.add_argument('--product-color', dest='product_color', type=any_int)
+
+    args = parser.parse_args()
+
+    if args.dump:
+        dump(read_file(args.dump))
+        return
+    if not args.output:
+        parser.error('--output is required')
+
+    image = build(collect_values(args), args.size)
+    with open(args.output, 'wb') as f:
+        f.write(image)
+
+
+if __name__ == '__main__':
+    main()
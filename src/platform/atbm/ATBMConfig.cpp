@@ -33,6 +33,7 @@
 #include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <platform/atbm/ATBMUtils.h>
+#include <platform/atbm/HeapTracker.h>
 
 #include <easyflash.h>
 
@@ -100,6 +101,8 @@ const ATBMConfig::Key ATBMConfig::kConfigKey_UserCredentials             = { "us
 const ATBMConfig::Key ATBMConfig::kConfigKey_WeekDaySchedules            = { "week-day-sched" };
 const ATBMConfig::Key ATBMConfig::kConfigKey_YearDaySchedules            = { "year-day-sched" };
 const ATBMConfig::Key ATBMConfig::kConfigKey_HolidaySchedules            = { "holiday-sched" };
+const ATBMConfig::Key ATBMConfig::kConfigKey_Spake2pVerifierTag          = { "spake2p-tag" };
+const ATBMConfig::Key ATBMConfig::kConfigKey_RealTime                    = { "real-time" };
 
 // Keys stored in the Chip-counters namespace
 const ATBMConfig::Key ATBMConfig::kCounterKey_RebootCount           = { "reboot-count" };
@@ -168,7 +171,7 @@ CHIP_ERROR ATBMConfig::ReadConfigValueStr(Key key, char * buf, size_t bufSize, s
     char *tmpVal = NULL;
     size_t ret;
     
-    tmpVal = (char *)malloc(bufSize);
+    tmpVal = (char *)HeapTracker::Alloc(HeapTracker::kTag_Config, bufSize);
     if (tmpVal == NULL)
     {
     	ChipLogError(DeviceLayer, "ReadConfigValueStr malloc fail");
@@ -185,9 +188,9 @@ CHIP_ERROR ATBMConfig::ReadConfigValueStr(Key key, char * buf, size_t bufSize, s
 
     outLen = ret;
     Platform::CopyString(buf, outLen, tmpVal);
-    free(tmpVal);
 
 exit:
+    HeapTracker::Free(tmpVal);
     return err;
 }
 
@@ -198,7 +201,7 @@ CHIP_ERROR ATBMConfig::ReadConfigValueBin(Key key, uint8_t * buf, size_t bufSize
     size_t ret;
     size_t savedLen = 0;
     
-    tmpVal = (char *)malloc(bufSize);
+    tmpVal = (char *)HeapTracker::Alloc(HeapTracker::kTag_Config, bufSize);
     if (tmpVal == NULL)
     {
     	ChipLogError(DeviceLayer, "ReadConfigValueBin malloc fail");
@@ -215,9 +218,9 @@ CHIP_ERROR ATBMConfig::ReadConfigValueBin(Key key, uint8_t * buf, size_t bufSize
 
     outLen = ret;
     memcpy(buf, tmpVal, outLen);
-    free(tmpVal);
 
 exit:
+    HeapTracker::Free(tmpVal);
     return err;
 }
 
@@ -103,6 +103,8 @@ public:
     static const Key kConfigKey_WeekDaySchedules;
     static const Key kConfigKey_YearDaySchedules;
     static const Key kConfigKey_HolidaySchedules;
+    static const Key kConfigKey_Spake2pVerifierTag;
+    static const Key kConfigKey_RealTime;
 
     // CHIP Counter keys
     static const Key kCounterKey_RebootCount;
@@ -18,6 +18,28 @@
 #include <lib/support/Base64.h>
 #include <platform/atbm/ATBMConfig.h>
 #include <platform/atbm/ATBMFactoryDataProvider.h>
+#include <platform/atbm/AttestationCache.h>
+
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+#include <platform/atbm/FactoryPartition.h>
+
+// Returns the result of a factory partition lookup unless the value is not in the partition,
+// in which case the caller falls back to the EasyFlash keys.
+#define ReturnIfInFactoryPartition(expr)                                                                                           \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        CHIP_ERROR __err = (expr);                                                                                                 \
+        if (__err != CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND)                                                                           \
+        {                                                                                                                          \
+            return __err;                                                                                                          \
+        }                                                                                                                          \
+    } while (false)
+#else
+#define ReturnIfInFactoryPartition(expr)                                                                                           \
+    do                                                                                                                             \
+    {                                                                                                                              \
+    } while (false)
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
 
 namespace chip {
 namespace DeviceLayer {
@@ -37,12 +59,63 @@ CHIP_ERROR LoadKeypairFromRaw(ByteSpan privateKey, ByteSpan publicKey, Crypto::P
     memcpy(serializedKeypair.Bytes() + publicKey.size(), privateKey.data(), privateKey.size());
     return keypair.Deserialize(serializedKeypair);
 }
+
+CHIP_ERROR LoadDACKeypair(Crypto::P256Keypair & keypair)
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    ByteSpan privKey;
+    ByteSpan pubKey;
+    if (FactoryPartition::Get(FactoryPartition::kTag_DACPrivateKey, privKey) == CHIP_NO_ERROR &&
+        FactoryPartition::Get(FactoryPartition::kTag_DACPublicKey, pubKey) == CHIP_NO_ERROR)
+    {
+        return LoadKeypairFromRaw(privKey, pubKey, keypair);
+    }
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+
+    uint8_t privKeyBuf[kDACPrivateKeySize];
+    uint8_t pubKeyBuf[kDACPublicKeySize];
+    size_t privKeyLen = sizeof(privKeyBuf);
+    size_t pubKeyLen  = sizeof(pubKeyBuf);
+
+    // The private key is read last so that every path after it clears it.
+    ReturnErrorOnFailure(ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_DACPublicKey, pubKeyBuf, pubKeyLen, pubKeyLen));
+    ReturnErrorOnFailure(
+        ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_DACPrivateKey, privKeyBuf, privKeyLen, privKeyLen));
+
+    CHIP_ERROR err = LoadKeypairFromRaw(ByteSpan(privKeyBuf, privKeyLen), ByteSpan(pubKeyBuf, pubKeyLen), keypair);
+    Crypto::ClearSecretData(privKeyBuf, sizeof(privKeyBuf));
+    return err;
+}
 } // namespace
 
+CHIP_ERROR ATBMFactoryDataProvider::Init()
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    CHIP_ERROR err = FactoryPartition::Init();
+    if (err == CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND)
+    {
+        ChipLogProgress(DeviceLayer, "No factory partition, using factory data from EasyFlash");
+        return CHIP_NO_ERROR;
+    }
+    return err;
+#else
+    return CHIP_NO_ERROR;
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+}
+
 CHIP_ERROR ATBMFactoryDataProvider::GetSetupDiscriminator(uint16_t & setupDiscriminator)
 {
+    CHIP_ERROR err = CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND;
     uint32_t setupDiscriminator32;
-    ReturnErrorOnFailure(ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_SetupDiscriminator, setupDiscriminator32));
+
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    err = FactoryPartition::Get(FactoryPartition::kTag_Discriminator, setupDiscriminator32);
+#endif
+    if (err == CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND)
+    {
+        err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_SetupDiscriminator, setupDiscriminator32);
+    }
+    ReturnErrorOnFailure(err);
     VerifyOrReturnLogError(setupDiscriminator32 <= kMaxDiscriminatorValue, CHIP_ERROR_INVALID_ARGUMENT);
     setupDiscriminator = static_cast<uint16_t>(setupDiscriminator32);
     return CHIP_NO_ERROR;
@@ -50,11 +123,14 @@ CHIP_ERROR ATBMFactoryDataProvider::GetSetupDiscriminator(uint16_t & setupDiscri
 
 CHIP_ERROR ATBMFactoryDataProvider::GetSpake2pIterationCount(uint32_t & iterationCount)
 {
+    ReturnIfInFactoryPartition(FactoryPartition::Get(FactoryPartition::kTag_Spake2pIterationCount, iterationCount));
     return ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_Spake2pIterationCount, iterationCount);
 }
 
 CHIP_ERROR ATBMFactoryDataProvider::GetSpake2pSalt(MutableByteSpan & saltBuf)
 {
+    ReturnIfInFactoryPartition(FactoryPartition::CopyTo(FactoryPartition::kTag_Spake2pSalt, saltBuf));
+
     static constexpr size_t kSpake2pSalt_MaxBase64Len = BASE64_ENCODED_LEN(chip::Crypto::kSpake2p_Max_PBKDF_Salt_Length) + 1;
 
     CHIP_ERROR err                          = CHIP_NO_ERROR;
@@ -75,6 +151,15 @@ CHIP_ERROR ATBMFactoryDataProvider::GetSpake2pSalt(MutableByteSpan & saltBuf)
 
 CHIP_ERROR ATBMFactoryDataProvider::GetSpake2pVerifier(MutableByteSpan & verifierBuf, size_t & verifierLen)
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    ByteSpan verifier;
+    if (FactoryPartition::Get(FactoryPartition::kTag_Spake2pVerifier, verifier) == CHIP_NO_ERROR)
+    {
+        verifierLen = verifier.size();
+        return CopySpanToMutableSpan(verifier, verifierBuf);
+    }
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+
     static constexpr size_t kSpake2pSerializedVerifier_MaxBase64Len =
         BASE64_ENCODED_LEN(chip::Crypto::kSpake2p_VerifierSerialized_Length) + 1;
 
@@ -97,6 +182,8 @@ CHIP_ERROR ATBMFactoryDataProvider::GetSpake2pVerifier(MutableByteSpan & verifie
 
 CHIP_ERROR ATBMFactoryDataProvider::GetCertificationDeclaration(MutableByteSpan & outBuffer)
 {
+    ReturnIfInFactoryPartition(FactoryPartition::CopyTo(FactoryPartition::kTag_CertDeclaration, outBuffer));
+
     size_t certSize;
     ReturnErrorOnFailure(
         ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_CertDeclaration, outBuffer.data(), outBuffer.size(), certSize));
@@ -113,6 +200,8 @@ CHIP_ERROR ATBMFactoryDataProvider::GetFirmwareInformation(MutableByteSpan & out
 
 CHIP_ERROR ATBMFactoryDataProvider::GetDeviceAttestationCert(MutableByteSpan & outBuffer)
 {
+    ReturnIfInFactoryPartition(FactoryPartition::CopyTo(FactoryPartition::kTag_DACCert, outBuffer));
+
     size_t certSize;
     ReturnErrorOnFailure(
         ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_DACCert, outBuffer.data(), outBuffer.size(), certSize));
@@ -122,6 +211,8 @@ CHIP_ERROR ATBMFactoryDataProvider::GetDeviceAttestationCert(MutableByteSpan & o
 
 CHIP_ERROR ATBMFactoryDataProvider::GetProductAttestationIntermediateCert(MutableByteSpan & outBuffer)
 {
+    ReturnIfInFactoryPartition(FactoryPartition::CopyTo(FactoryPartition::kTag_PAICert, outBuffer));
+
     size_t certSize;
     ReturnErrorOnFailure(
         ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_PAICert, outBuffer.data(), outBuffer.size(), certSize));
@@ -132,23 +223,12 @@ CHIP_ERROR ATBMFactoryDataProvider::GetProductAttestationIntermediateCert(Mutabl
 CHIP_ERROR ATBMFactoryDataProvider::SignWithDeviceAttestationKey(const ByteSpan & messageToSign, MutableByteSpan & outSignBuffer)
 {
     Crypto::P256ECDSASignature signature;
-    Crypto::P256Keypair keypair;
 
     VerifyOrReturnError(!outSignBuffer.empty(), CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(!messageToSign.empty(), CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(outSignBuffer.size() >= signature.Capacity(), CHIP_ERROR_BUFFER_TOO_SMALL);
 
-    uint8_t privKeyBuf[kDACPrivateKeySize];
-    uint8_t pubKeyBuf[kDACPublicKeySize];
-    size_t privKeyLen = sizeof(privKeyBuf);
-    size_t pubKeyLen  = sizeof(pubKeyBuf);
-
-    ReturnErrorOnFailure(
-        ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_DACPrivateKey, privKeyBuf, privKeyLen, privKeyLen));
-    ReturnErrorOnFailure(ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_DACPublicKey, pubKeyBuf, pubKeyLen, pubKeyLen));
-
-    ReturnErrorOnFailure(LoadKeypairFromRaw(ByteSpan(privKeyBuf, privKeyLen), ByteSpan(pubKeyBuf, pubKeyLen), keypair));
-    ReturnErrorOnFailure(keypair.ECDSA_sign_msg(messageToSign.data(), messageToSign.size(), signature));
+    ReturnErrorOnFailure(AttestationCache::Sign(LoadDACKeypair, messageToSign, signature));
 
     return CopySpanToMutableSpan(ByteSpan{ signature.ConstBytes(), signature.Length() }, outSignBuffer);
 }
@@ -157,15 +237,22 @@ CHIP_ERROR ATBMFactoryDataProvider::SignWithDeviceAttestationKey(const ByteSpan
 CHIP_ERROR ATBMFactoryDataProvider::GetVendorName(char * buf, size_t bufSize)
 {
     size_t vendorNameLen = 0; // without counting null-terminator
+    ReturnIfInFactoryPartition(FactoryPartition::GetString(FactoryPartition::kTag_VendorName, buf, bufSize, vendorNameLen));
     return ATBMConfig::ReadConfigValueStr(ATBMConfig::kConfigKey_VendorName, buf, bufSize, vendorNameLen);
 }
 
 CHIP_ERROR ATBMFactoryDataProvider::GetVendorId(uint16_t & vendorId)
 {
-    ChipError err   = CHIP_NO_ERROR;
+    ChipError err   = CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND;
     uint32_t valInt = 0;
 
-    err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_VendorId, valInt);
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    err = FactoryPartition::Get(FactoryPartition::kTag_VendorId, valInt);
+#endif
+    if (err == CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND)
+    {
+        err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_VendorId, valInt);
+    }
     ReturnErrorOnFailure(err);
     vendorId = static_cast<uint16_t>(valInt);
     return err;
@@ -174,15 +261,22 @@ CHIP_ERROR ATBMFactoryDataProvider::GetVendorId(uint16_t & vendorId)
 CHIP_ERROR ATBMFactoryDataProvider::GetProductName(char * buf, size_t bufSize)
 {
     size_t productNameLen = 0; // without counting null-terminator
+    ReturnIfInFactoryPartition(FactoryPartition::GetString(FactoryPartition::kTag_ProductName, buf, bufSize, productNameLen));
     return ATBMConfig::ReadConfigValueStr(ATBMConfig::kConfigKey_ProductName, buf, bufSize, productNameLen);
 }
 
 CHIP_ERROR ATBMFactoryDataProvider::GetProductId(uint16_t & productId)
 {
-    ChipError err   = CHIP_NO_ERROR;
+    ChipError err   = CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND;
     uint32_t valInt = 0;
 
-    err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_ProductId, valInt);
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    err = FactoryPartition::Get(FactoryPartition::kTag_ProductId, valInt);
+#endif
+    if (err == CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND)
+    {
+        err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_ProductId, valInt);
+    }
     ReturnErrorOnFailure(err);
     productId = static_cast<uint16_t>(valInt);
     return err;
@@ -190,6 +284,9 @@ CHIP_ERROR ATBMFactoryDataProvider::GetProductId(uint16_t & productId)
 
 CHIP_ERROR ATBMFactoryDataProvider::GetProductURL(char * buf, size_t bufSize)
 {
+    size_t len = 0;
+    ReturnIfInFactoryPartition(FactoryPartition::GetString(FactoryPartition::kTag_ProductURL, buf, bufSize, len));
+
     CHIP_ERROR err = ATBMConfig::ReadConfigValueStr(ATBMConfig::kConfigKey_ProductURL, buf, bufSize, bufSize);
     if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
     {
@@ -200,6 +297,9 @@ CHIP_ERROR ATBMFactoryDataProvider::GetProductURL(char * buf, size_t bufSize)
 
 CHIP_ERROR ATBMFactoryDataProvider::GetProductLabel(char * buf, size_t bufSize)
 {
+    size_t len = 0;
+    ReturnIfInFactoryPartition(FactoryPartition::GetString(FactoryPartition::kTag_ProductLabel, buf, bufSize, len));
+
     CHIP_ERROR err = ATBMConfig::ReadConfigValueStr(ATBMConfig::kConfigKey_ProductLabel, buf, bufSize, bufSize);
     if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
     {
@@ -211,6 +311,8 @@ CHIP_ERROR ATBMFactoryDataProvider::GetProductLabel(char * buf, size_t bufSize)
 CHIP_ERROR ATBMFactoryDataProvider::GetHardwareVersionString(char * buf, size_t bufSize)
 {
     size_t hardwareVersionStringLen = 0; // without counting null-terminator
+    ReturnIfInFactoryPartition(
+        FactoryPartition::GetString(FactoryPartition::kTag_HardwareVersionString, buf, bufSize, hardwareVersionStringLen));
     return ATBMConfig::ReadConfigValueStr(ATBMConfig::kConfigKey_HardwareVersionString, buf, bufSize, hardwareVersionStringLen);
 }
 
@@ -221,6 +323,8 @@ CHIP_ERROR ATBMFactoryDataProvider::GetRotatingDeviceIdUniqueId(MutableByteSpan
     static_assert(ConfigurationManager::kRotatingDeviceIDUniqueIDLength >= ConfigurationManager::kMinRotatingDeviceIDUniqueIDLength,
                   "Length of unique ID for rotating device ID is smaller than minimum.");
 
+    ReturnIfInFactoryPartition(FactoryPartition::CopyTo(FactoryPartition::kTag_RotatingDevIdUniqueId, uniqueIdSpan));
+
     size_t uniqueIdLen = 0;
     err = ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_RotatingDevIdUniqueId, uniqueIdSpan.data(), uniqueIdSpan.size(),
                                           uniqueIdLen);
@@ -232,20 +336,43 @@ CHIP_ERROR ATBMFactoryDataProvider::GetRotatingDeviceIdUniqueId(MutableByteSpan
 
 CHIP_ERROR ATBMFactoryDataProvider::GetSerialNumber(char * buf, size_t bufSize)
 {
+    size_t serialNumberLen = 0;
+    ReturnIfInFactoryPartition(FactoryPartition::GetString(FactoryPartition::kTag_SerialNumber, buf, bufSize, serialNumberLen));
+
 	return GenericDeviceInstanceInfoProvider<ATBMConfig>::GetSerialNumber(buf, bufSize);
 }
 
 CHIP_ERROR ATBMFactoryDataProvider::GetManufacturingDate(uint16_t & year, uint8_t & month, uint8_t & day)
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    ByteSpan date;
+    if (FactoryPartition::Get(FactoryPartition::kTag_ManufacturingDate, date) == CHIP_NO_ERROR)
+    {
+        // The generator checks the date; only the "YYYY-MM-DD" shape is verified here.
+        const uint8_t * d = date.data();
+        VerifyOrReturnError(date.size() == 10 && d[4] == '-' && d[7] == '-', CHIP_ERROR_INVALID_ARGUMENT);
+        year  = static_cast<uint16_t>((d[0] - '0') * 1000 + (d[1] - '0') * 100 + (d[2] - '0') * 10 + (d[3] - '0'));
+        month = static_cast<uint8_t>((d[5] - '0') * 10 + (d[6] - '0'));
+        day   = static_cast<uint8_t>((d[8] - '0') * 10 + (d[9] - '0'));
+        return CHIP_NO_ERROR;
+    }
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+
 	return GenericDeviceInstanceInfoProvider<ATBMConfig>::GetManufacturingDate(year, month, day);
 }
 
 CHIP_ERROR ATBMFactoryDataProvider::GetProductFinish(app::Clusters::BasicInformation::ProductFinishEnum * finish)
 {
-    CHIP_ERROR err         = CHIP_NO_ERROR;
+    CHIP_ERROR err         = CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND;
     uint32_t productFinish = 0;
 
-    err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_ProductFinish, productFinish);
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    err = FactoryPartition::Get(FactoryPartition::kTag_ProductFinish, productFinish);
+#endif
+    if (err == CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND)
+    {
+        err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_ProductFinish, productFinish);
+    }
     VerifyOrReturnError(err == CHIP_NO_ERROR, CHIP_ERROR_NOT_IMPLEMENTED);
 
     *finish = static_cast<app::Clusters::BasicInformation::ProductFinishEnum>(productFinish);
@@ -255,10 +382,16 @@ CHIP_ERROR ATBMFactoryDataProvider::GetProductFinish(app::Clusters::BasicInforma
 
 CHIP_ERROR ATBMFactoryDataProvider::GetProductPrimaryColor(app::Clusters::BasicInformation::ColorEnum * primaryColor)
 {
-    CHIP_ERROR err = CHIP_NO_ERROR;
+    CHIP_ERROR err = CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND;
     uint32_t color = 0;
 
-    err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_ProductColor, color);
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    err = FactoryPartition::Get(FactoryPartition::kTag_ProductColor, color);
+#endif
+    if (err == CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND)
+    {
+        err = ATBMConfig::ReadConfigValue(ATBMConfig::kConfigKey_ProductColor, color);
+    }
     VerifyOrReturnError(err == CHIP_NO_ERROR, CHIP_ERROR_NOT_IMPLEMENTED);
 
     *primaryColor = static_cast<app::Clusters::BasicInformation::ColorEnum>(color);
@@ -268,11 +401,23 @@ CHIP_ERROR ATBMFactoryDataProvider::GetProductPrimaryColor(app::Clusters::BasicI
 
 CHIP_ERROR ATBMFactoryDataProvider::GetHardwareVersion(uint16_t & hardwareVersion)
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+    uint32_t hardwareVersion32;
+    if (FactoryPartition::Get(FactoryPartition::kTag_HardwareVersion, hardwareVersion32) == CHIP_NO_ERROR)
+    {
+        hardwareVersion = static_cast<uint16_t>(hardwareVersion32);
+        return CHIP_NO_ERROR;
+    }
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+
 	return GenericDeviceInstanceInfoProvider<ATBMConfig>::GetHardwareVersion(hardwareVersion);
 }
 
 CHIP_ERROR ATBMFactoryDataProvider::GetPartNumber(char * buf, size_t bufSize)
 {
+    size_t len = 0;
+    ReturnIfInFactoryPartition(FactoryPartition::GetString(FactoryPartition::kTag_PartNumber, buf, bufSize, len));
+
     CHIP_ERROR err = ATBMConfig::ReadConfigValueStr(ATBMConfig::kConfigKey_PartNumber, buf, bufSize, bufSize);
     if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
     {
@@ -44,6 +44,12 @@ public:
 #endif // CHIP_DEVICE_CONFIG_ENABLE_DEVICE_INSTANCE_INFO_PROVIDER
     {}
 
+    /**
+     * Indexes the factory data partition when it is enabled.  Values missing from the
+     * partition, or all of them when there is none, are read from EasyFlash.
+     */
+    CHIP_ERROR Init();
+
     // ===== Members functions that implement the CommissionableDataProvider
     CHIP_ERROR GetSetupDiscriminator(uint16_t & setupDiscriminator) override;
     CHIP_ERROR SetSetupDiscriminator(uint16_t setupDiscriminator) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
@@ -19,6 +19,7 @@
 #include <crypto/CHIPCryptoPAL.h>
 #include <platform/atbm/ATBMConfig.h>
 #include <platform/atbm/ATBMSecureCertDACProvider.h>
+#include <platform/atbm/AttestationCache.h>
 
 #if CONFIG_USE_ATBM_ECDSA_PERIPHERAL
 #include <platform/atbm/ATBMCHIPCryptoPAL.h>
@@ -46,25 +47,8 @@ CHIP_ERROR LoadKeypairFromRaw(ByteSpan privateKey, ByteSpan publicKey, Crypto::P
     memcpy(serializedKeypair.Bytes() + publicKey.size(), privateKey.data(), privateKey.size());
     return keypair.Deserialize(serializedKeypair);
 }
-} // namespace
-
-CHIP_ERROR ATBMSecureCertDACProvider ::GetCertificationDeclaration(MutableByteSpan & outBuffer)
-{
-    size_t certSize;
-    ReturnErrorOnFailure(
-        ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_CertDeclaration, outBuffer.data(), outBuffer.size(), certSize));
-    outBuffer.reduce_size(certSize);
-    return CHIP_NO_ERROR;
-}
 
-CHIP_ERROR ATBMSecureCertDACProvider ::GetFirmwareInformation(MutableByteSpan & out_firmware_info_buffer)
-{
-    // We do not provide any FirmwareInformation.
-    out_firmware_info_buffer.reduce_size(0);
-    return CHIP_NO_ERROR;
-}
-
-CHIP_ERROR ATBMSecureCertDACProvider ::GetDeviceAttestationCert(MutableByteSpan & outBuffer)
+CHIP_ERROR LoadDeviceCert(MutableByteSpan & outBuffer)
 {
     char * dac_cert  = NULL;
     uint32_t dac_len = 0;
@@ -75,7 +59,7 @@ CHIP_ERROR ATBMSecureCertDACProvider ::GetDeviceAttestationCert(MutableByteSpan
         VerifyOrReturnError(dac_len <= kMaxDERCertLength, CHIP_ERROR_UNSUPPORTED_CERT_FORMAT,
                             atbm_secure_cert_free_device_cert(dac_cert));
         VerifyOrReturnError(dac_len <= outBuffer.size(), CHIP_ERROR_BUFFER_TOO_SMALL, atbm_secure_cert_free_device_cert(dac_cert));
-        memcpy(outBuffer.data(), dac_cert, outBuffer.size());
+        memcpy(outBuffer.data(), dac_cert, dac_len);
         outBuffer.reduce_size(dac_len);
         atbm_secure_cert_free_device_cert(dac_cert);
         return CHIP_NO_ERROR;
@@ -85,7 +69,7 @@ CHIP_ERROR ATBMSecureCertDACProvider ::GetDeviceAttestationCert(MutableByteSpan
     return CHIP_ERROR_INCORRECT_STATE;
 }
 
-CHIP_ERROR ATBMSecureCertDACProvider ::GetProductAttestationIntermediateCert(MutableByteSpan & outBuffer)
+CHIP_ERROR LoadCACert(MutableByteSpan & outBuffer)
 {
     char * pai_cert  = NULL;
     uint32_t pai_len = 0;
@@ -95,7 +79,7 @@ CHIP_ERROR ATBMSecureCertDACProvider ::GetProductAttestationIntermediateCert(Mut
         VerifyOrReturnError(pai_len <= kMaxDERCertLength, CHIP_ERROR_UNSUPPORTED_CERT_FORMAT,
                             atbm_secure_cert_free_ca_cert(pai_cert));
         VerifyOrReturnError(pai_len <= outBuffer.size(), CHIP_ERROR_BUFFER_TOO_SMALL, atbm_secure_cert_free_ca_cert(pai_cert));
-        memcpy(outBuffer.data(), pai_cert, outBuffer.size());
+        memcpy(outBuffer.data(), pai_cert, pai_len);
         outBuffer.reduce_size(pai_len);
         atbm_secure_cert_free_ca_cert(pai_cert);
         return CHIP_NO_ERROR;
@@ -105,6 +89,51 @@ CHIP_ERROR ATBMSecureCertDACProvider ::GetProductAttestationIntermediateCert(Mut
     return CHIP_ERROR_INCORRECT_STATE;
 }
 
+#if !CONFIG_USE_ATBM_ECDSA_PERIPHERAL
+CHIP_ERROR LoadSecureCertKeypair(Crypto::P256Keypair & keypair)
+{
+    char * sc_keypair       = NULL;
+    uint32_t sc_keypair_len = 0;
+
+    int err = atbm_secure_cert_get_priv_key(&sc_keypair, &sc_keypair_len);
+    VerifyOrReturnError(err == 0 && sc_keypair != NULL && sc_keypair_len != 0, CHIP_ERROR_INCORRECT_STATE,
+                        ChipLogError(DeviceLayer, "atbm_secure_cert_get_priv_key failed err:%d", err));
+
+    CHIP_ERROR chipError =
+        LoadKeypairFromRaw(ByteSpan(reinterpret_cast<const uint8_t *>(sc_keypair + kPrivKeyOffset), kDACPrivateKeySize),
+                           ByteSpan(reinterpret_cast<const uint8_t *>(sc_keypair + kPubKeyOffset), kDACPublicKeySize), keypair);
+    atbm_secure_cert_free_priv_key(sc_keypair);
+    return chipError;
+}
+#endif // !CONFIG_USE_ATBM_ECDSA_PERIPHERAL
+} // namespace
+
+CHIP_ERROR ATBMSecureCertDACProvider ::GetCertificationDeclaration(MutableByteSpan & outBuffer)
+{
+    size_t certSize;
+    ReturnErrorOnFailure(
+        ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_CertDeclaration, outBuffer.data(), outBuffer.size(), certSize));
+    outBuffer.reduce_size(certSize);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ATBMSecureCertDACProvider ::GetFirmwareInformation(MutableByteSpan & out_firmware_info_buffer)
+{
+    // We do not provide any FirmwareInformation.
+    out_firmware_info_buffer.reduce_size(0);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ATBMSecureCertDACProvider ::GetDeviceAttestationCert(MutableByteSpan & outBuffer)
+{
+    return AttestationCache::GetCert(AttestationCache::kCert_DAC, LoadDeviceCert, outBuffer);
+}
+
+CHIP_ERROR ATBMSecureCertDACProvider ::GetProductAttestationIntermediateCert(MutableByteSpan & outBuffer)
+{
+    return AttestationCache::GetCert(AttestationCache::kCert_PAI, LoadCACert, outBuffer);
+}
+
 CHIP_ERROR ATBMSecureCertDACProvider ::SignWithDeviceAttestationKey(const ByteSpan & messageToSign,
                                                                      MutableByteSpan & outSignBuffer)
 {
@@ -153,23 +182,7 @@ CHIP_ERROR ATBMSecureCertDACProvider ::SignWithDeviceAttestationKey(const ByteSp
     else // This flow is for devices which do not support ECDSA peripheral
     {
 #if !CONFIG_USE_ATBM_ECDSA_PERIPHERAL
-        Crypto::P256Keypair keypair;
-        char * sc_keypair       = NULL;
-        uint32_t sc_keypair_len = 0;
-
-        err = atbm_secure_cert_get_priv_key(&sc_keypair, &sc_keypair_len);
-        VerifyOrReturnError(err == 0 && sc_keypair != NULL && sc_keypair_len != 0, CHIP_ERROR_INCORRECT_STATE,
-                            ChipLogError(DeviceLayer, "atbm_secure_cert_get_priv_key failed err:%d", err));
-
-        chipError =
-            LoadKeypairFromRaw(ByteSpan(reinterpret_cast<const uint8_t *>(sc_keypair + kPrivKeyOffset), kDACPrivateKeySize),
-                               ByteSpan(reinterpret_cast<const uint8_t *>(sc_keypair + kPubKeyOffset), kDACPublicKeySize), keypair);
-        VerifyOrReturnError(chipError == CHIP_NO_ERROR, chipError, atbm_secure_cert_free_priv_key(sc_keypair));
-
-        chipError = keypair.ECDSA_sign_msg(messageToSign.data(), messageToSign.size(), signature);
-        VerifyOrReturnError(chipError == CHIP_NO_ERROR, chipError, atbm_secure_cert_free_priv_key(sc_keypair));
-
-        atbm_secure_cert_free_priv_key(sc_keypair);
+        ReturnErrorOnFailure(AttestationCache::Sign(LoadSecureCertKeypair, messageToSign, signature));
 #else
         return CHIP_ERROR_INCORRECT_STATE;
 #endif // !CONFIG_USE_ESP32_ECDSA_PERIPHERAL
@@ -0,0 +1,123 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/AttestationCache.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+
+#include <string.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+#if CHIP_DEVICE_CONFIG_ENABLE_ATTESTATION_CACHE
+
+namespace {
+
+Crypto::P256Keypair * sKeypair;
+uint8_t * sCerts[AttestationCache::kCert_Max];
+size_t sCertLengths[AttestationCache::kCert_Max];
+
+} // namespace
+
+CHIP_ERROR AttestationCache::Sign(KeypairLoader loader, const ByteSpan & message, Crypto::P256ECDSASignature & signature)
+{
+    if (sKeypair == nullptr)
+    {
+        Crypto::P256Keypair * keypair = Platform::New<Crypto::P256Keypair>();
+        VerifyOrReturnError(keypair != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        CHIP_ERROR err = loader(*keypair);
+        if (err != CHIP_NO_ERROR)
+        {
+            Platform::Delete(keypair);
+            return err;
+        }
+        sKeypair = keypair;
+    }
+    return sKeypair->ECDSA_sign_msg(message.data(), message.size(), signature);
+}
+
+CHIP_ERROR AttestationCache::GetCert(CertId id, CertLoader loader, MutableByteSpan & outBuffer)
+{
+    VerifyOrReturnError(id < kCert_Max, CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (sCerts[id] != nullptr)
+    {
+        return CopySpanToMutableSpan(ByteSpan(sCerts[id], sCertLengths[id]), outBuffer);
+    }
+
+    ReturnErrorOnFailure(loader(outBuffer));
+
+    // Not caching only costs the next caller a reload.
+    uint8_t * cert = static_cast<uint8_t *>(Platform::MemoryAlloc(outBuffer.size()));
+    if (cert != nullptr)
+    {
+        memcpy(cert, outBuffer.data(), outBuffer.size());
+        sCerts[id]       = cert;
+        sCertLengths[id] = outBuffer.size();
+    }
+    return CHIP_NO_ERROR;
+}
+
+void AttestationCache::Clear()
+{
+    if (sKeypair != nullptr)
+    {
+        // Frees the mbedTLS key, which zeroizes the private scalar.
+        sKeypair->Clear();
+        Platform::Delete(sKeypair);
+        sKeypair = nullptr;
+    }
+    for (size_t i = 0; i < kCert_Max; i++)
+    {
+        if (sCerts[i] != nullptr)
+        {
+            Crypto::ClearSecretData(sCerts[i], sCertLengths[i]);
+            Platform::MemoryFree(sCerts[i]);
+            sCerts[i]       = nullptr;
+            sCertLengths[i] = 0;
+        }
+    }
+}
+
+#else
+
+CHIP_ERROR AttestationCache::Sign(KeypairLoader loader, const ByteSpan & message, Crypto::P256ECDSASignature & signature)
+{
+    Crypto::P256Keypair keypair;
+    ReturnErrorOnFailure(loader(keypair));
+    return keypair.ECDSA_sign_msg(message.data(), message.size(), signature);
+}
+
+CHIP_ERROR AttestationCache::GetCert(CertId id, CertLoader loader, MutableByteSpan & outBuffer)
+{
+    return loader(outBuffer);
+}
+
+void AttestationCache::Clear() {}
+
+#endif // CHIP_DEVICE_CONFIG_ENABLE_ATTESTATION_CACHE
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
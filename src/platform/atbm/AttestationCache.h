@@ -0,0 +1,66 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          RAM cache of the device attestation keypair and certificates for the ATBM
+ *          attestation credentials providers (CHIP_DEVICE_CONFIG_ENABLE_ATTESTATION_CACHE).
+ */
+
+#pragma once
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Keeps the DAC keypair, and optionally the DAC and PAI certificates, in RAM once a
+ * provider has loaded them, so that attestation during commissioning imports the key
+ * only once.  Everything is allocated on first use from the CHIP heap.
+ *
+ * Clear() zeroizes and frees the cache; ConfigurationManagerImpl calls it on factory
+ * reset.  The cache must only be used from the CHIP thread.
+ */
+class AttestationCache
+{
+public:
+    enum CertId : uint8_t
+    {
+        kCert_DAC = 0,
+        kCert_PAI,
+        kCert_Max,
+    };
+
+    using KeypairLoader = CHIP_ERROR (*)(Crypto::P256Keypair & keypair);
+    using CertLoader    = CHIP_ERROR (*)(MutableByteSpan & outBuffer);
+
+    /** Signs with the cached DAC keypair, importing it with loader on first use. */
+    static CHIP_ERROR Sign(KeypairLoader loader, const ByteSpan & message, Crypto::P256ECDSASignature & signature);
+
+    /** Copies a cached certificate into outBuffer, fetching it with loader on first use. */
+    static CHIP_ERROR GetCert(CertId id, CertLoader loader, MutableByteSpan & outBuffer);
+
+    static void Clear();
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
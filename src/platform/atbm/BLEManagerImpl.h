@@ -50,6 +50,7 @@ struct ble_gatt_char_context
 };
 
 #define MAX_SCAN_RSP_DATA_LEN 31
+#define MAX_ADV_DATA_LEN 31
 
 namespace chip {
 namespace DeviceLayer {
@@ -64,11 +65,78 @@ class BLEManagerImpl final : public BLEManager,
                              private Ble::BleApplicationDelegate
 {
 public:
+    /**
+     * Phases of the adaptive advertising scheduler.  Advertising starts in the fast phase,
+     * steps down to medium and then slow while no central connects, and can be boosted
+     * to a short burst phase on user request (e.g. button press).
+     */
+    enum class AdvertisingPhase : uint8_t
+    {
+        kFast = 0,
+        kMedium,
+        kSlow,
+        kBurst,
+    };
+
+    static constexpr uint8_t kNumAdvertisingPhases = 4;
+
+    /**
+     * WiFi activities that open a coexistence window, during which the fast and burst
+     * phases are capped to the medium interval.
+     */
+    enum class WiFiCoexReason : uint8_t
+    {
+        kScan        = 0x01,
+        kAssociation = 0x02,
+    };
+
+    struct AdvertisingMetrics
+    {
+        uint32_t PhaseTimeMs[kNumAdvertisingPhases]; /**< Time spent advertising in each phase. */
+        uint64_t RadioOnTimeUs;                      /**< Estimated advertising airtime. */
+        uint32_t LastDiscoveryLatencyMs;             /**< Advertising start to first central connection. */
+        uint32_t DiscoveryCount;                     /**< Connections received while advertising. */
+        uint32_t ParamUpdates;                       /**< Advertiser restarts caused by an interval change. */
+        uint32_t DataOnlyUpdates;                    /**< Payload updates applied without restarting the advertiser. */
+    };
+
+    /**
+     * CHIPoBLE data path counters, used to quantify BTP throughput, indication latency,
+     * per-message allocations and the time the CHIP task spends on BLE events.
+     *
+     * Only updated on the CHIP task; read or reset them there or with the CHIP stack lock held.
+     */
+    struct BLEPathStats
+    {
+        uint32_t TxBytes;
+        uint32_t TxFragments;
+        uint32_t TxAllocs; /**< mbufs allocated for outgoing indications. */
+        uint32_t RxBytes;
+        uint32_t RxFragments;
+        uint32_t RxAllocs; /**< Packet buffers allocated for incoming writes. */
+        uint32_t IndicationConfirms;
+        uint32_t IndicationLatencyLastUs;
+        uint32_t IndicationLatencyMaxUs;
+        uint64_t IndicationLatencyTotalUs;
+        uint32_t ChipEvents;
+        uint32_t ChipEventTimeMaxUs;
+        uint64_t ChipEventTimeTotalUs;
+    };
+
     uint8_t scanResponseBuffer[MAX_SCAN_RSP_DATA_LEN];
     BLEManagerImpl() {}
     CHIP_ERROR ConfigureScanResponseData(ByteSpan data);
     void ClearScanResponseData(void);
 
+    /** Boosts advertising to the burst phase; may be called from any task. */
+    CHIP_ERROR TriggerAdvertisingBurst(void);
+    void SetWiFiCoexActive(WiFiCoexReason reason, bool active);
+    /** Call on the CHIP task or with the CHIP stack lock held. */
+    void GetAdvertisingMetrics(AdvertisingMetrics & metrics);
+    AdvertisingPhase GetAdvertisingPhase(void) const { return mAdvPhase; }
+    void GetBLEPathStats(BLEPathStats & stats) const { stats = mPathStats; }
+    void ResetBLEPathStats(void) { memset(&mPathStats, 0, sizeof(mPathStats)); }
+
 private:
     chip::Optional<chip::ByteSpan> mScanResponse;
 
@@ -131,7 +199,6 @@ private:
         kAdvertising              = 0x0040, /**< The system is currently CHIPoBLE advertising. */
         kControlOpInProgress      = 0x0080, /**< An async control operation has been issued to the ESP BLE layer. */
         kAdvertisingEnabled       = 0x0100, /**< The application has enabled CHIPoBLE advertising. */
-        kFastAdvertisingEnabled   = 0x0200, /**< The application has enabled fast advertising. */
         kUseCustomDeviceName      = 0x0400, /**< The application has configured a custom BLE device name. */
         kAdvertisingRefreshNeeded = 0x0800, /**< The advertising configuration/state in ESP BLE layer needs to be updated. */
     };
@@ -139,37 +206,43 @@ private:
     enum
     {
         kMaxConnections      = BLE_LAYER_NUM_BLE_ENDPOINTS,
-        kMaxDeviceNameLength = 16
+        kMaxDeviceNameLength = 16,
+        kIndicationCredits   = 1, /**< ATT allows a single outstanding indication per connection. */
     };
 
-    uint16_t mSubscribedConIds[kMaxConnections];
-
+    /**
+     * Per-connection CHIPoBLE state.  Only touched from the CHIP task; GAP events from the
+     * NimBLE host task are forwarded with PlatformMgr().ScheduleWork().
+     */
     struct CHIPoBLEConState
     {
-        System::PacketBufferHandle PendingIndBuf;
+        uint64_t IndicationSentAtUs;
         uint16_t ConId;
         uint16_t MTU : 10;
         uint16_t Allocated : 1;
         uint16_t Subscribed : 1;
         uint16_t Unused : 4;
+        uint8_t TxCredits;
 
         void Set(uint16_t conId)
         {
-            PendingIndBuf = nullptr;
-            ConId         = conId;
-            MTU           = 0;
-            Allocated     = 1;
-            Subscribed    = 0;
-            Unused        = 0;
+            IndicationSentAtUs = 0;
+            ConId              = conId;
+            MTU                = 0;
+            Allocated          = 1;
+            Subscribed         = 0;
+            Unused             = 0;
+            TxCredits          = kIndicationCredits;
         }
         void Reset()
         {
-            PendingIndBuf = nullptr;
-            ConId         = BLE_CONNECTION_UNINITIALIZED;
-            MTU           = 0;
-            Allocated     = 0;
-            Subscribed    = 0;
-            Unused        = 0;
+            IndicationSentAtUs = 0;
+            ConId              = BLE_CONNECTION_UNINITIALIZED;
+            MTU                = 0;
+            Allocated          = 0;
+            Subscribed         = 0;
+            Unused             = 0;
+            TxCredits          = kIndicationCredits;
         }
     };
 
@@ -191,13 +264,48 @@ private:
     CHIP_ERROR InitATBMBleLayer(void);
     CHIP_ERROR ConfigureAdvertisingData(void);
     CHIP_ERROR StartAdvertising(void);
+    bool IsAdvertiserActive(void);
+    CHIP_ERROR StopAdvertiser(void);
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+    static constexpr uint8_t kLegacyAdvInstance = 0;
+    static constexpr uint8_t kExtAdvInstance    = 1;
+    static constexpr uint8_t kAllExtAdvSets     = (1 << kLegacyAdvInstance) | (1 << kExtAdvInstance);
+
+    uint8_t GetExtAdvertisingSets(void);
+    CHIP_ERROR BuildExtAdvertisingData(uint8_t * buf, size_t bufSize, size_t & len);
+    CHIP_ERROR SetExtAdvertisingData(void);
+    CHIP_ERROR StartExtAdvertising(const ble_gap_adv_params & advParams);
+#endif
+#if CHIP_ENABLE_ADDITIONAL_DATA_ADVERTISING
+    CHIP_ERROR GenerateAdditionalDataPayload(System::PacketBufferHandle & bufferHandle);
+#endif
 
     static constexpr System::Clock::Timeout kFastAdvertiseTimeout =
         System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_BLE_ADVERTISING_INTERVAL_CHANGE_TIME);
+    static constexpr System::Clock::Timeout kMediumAdvertiseTimeout =
+        System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_TIME);
+    static constexpr System::Clock::Timeout kBurstAdvertiseTimeout =
+        System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_TIME);
     System::Clock::Timestamp mAdvertiseStartTime;
-
-    static void HandleFastAdvertisementTimer(System::Layer * systemLayer, void * context);
-    void HandleFastAdvertisementTimer();
+    System::Clock::Timestamp mAdvPhaseStartTime;
+    AdvertisingPhase mAdvPhase;
+    AdvertisingMetrics mAdvMetrics;
+    uint16_t mActiveAdvItvlMin;
+    uint16_t mActiveAdvItvlMax;
+    uint8_t mActiveAdvConnMode;
+    uint8_t mAdvData[MAX_ADV_DATA_LEN];
+    uint8_t mExtAdvSets; // Bit per enabled advertising instance; also cleared on the NimBLE host task.
+    BLEPathStats mPathStats;
+    uint8_t mWiFiCoexMask;
+    bool mDiscoveryPending;
+
+    void EnterAdvertisingPhase(AdvertisingPhase phase);
+    void ArmAdvertisingPhaseTimer(void);
+    void AccountAdvertisingTime(void);
+    void GetAdvertisingIntervals(bool connectable, uint16_t & itvlMin, uint16_t & itvlMax);
+    static void HandleAdvertisingPhaseTimer(System::Layer * systemLayer, void * context);
+    void HandleAdvertisingPhaseTimer();
+    static void HandleAdvertisingBurst(intptr_t arg);
     void HandleRXCharRead(struct ble_gatt_char_context * param);
     void HandleRXCharWrite(struct ble_gatt_char_context * param);
     void HandleTXCharWrite(struct ble_gatt_char_context * param);
@@ -208,9 +316,12 @@ private:
     CHIP_ERROR HandleGAPConnect(struct ble_gap_event * gapEvent);
     CHIP_ERROR HandleGAPPeripheralConnect(struct ble_gap_event * gapEvent);
     CHIP_ERROR HandleGAPDisconnect(struct ble_gap_event * gapEvent);
-    CHIP_ERROR SetSubscribed(uint16_t conId);
-    bool UnsetSubscribed(uint16_t conId);
-    bool IsSubscribed(uint16_t conId);
+    CHIPoBLEConState * GetConnectionState(uint16_t conId, bool allocate = false);
+    void ReleaseConnectionState(uint16_t conId);
+    CHIP_ERROR SendIndicationNow(CHIPoBLEConState & conState, const System::PacketBufferHandle & data);
+    void OnIndicationConfirmed(uint16_t conId);
+    static void HandleGAPConnectWork(intptr_t arg);
+    static void HandleGAPDisconnectWork(intptr_t arg);
     CHIP_ERROR HandleGAPCentralConnect(struct ble_gap_event * gapEvent);
     void HandleGAPConnectionFailed(struct ble_gap_event * gapEvent, CHIP_ERROR error);
 
@@ -31,5 +31,10 @@
 #define BLE_CONNECTION_UNINITIALIZED (0xFFFF)
 #define BLE_MAX_RECEIVE_WINDOW_SIZE 5
 
+// Allow a second central (e.g. a diagnostics app) alongside the commissioner.
+#ifndef BLE_LAYER_NUM_BLE_ENDPOINTS
+#define BLE_LAYER_NUM_BLE_ENDPOINTS 2
+#endif // BLE_LAYER_NUM_BLE_ENDPOINTS
+
 #define BLE_CONFIG_ERROR_MIN 6000000
 #define BLE_CONFIG_ERROR_MAX 6000999
@@ -54,3 +54,476 @@
 #define CHIP_DEVICE_CONFIG_ENABLE_COMMISSIONABLE_DEVICE_NAME 1
 #define CHIP_DEVICE_CONFIG_DEVICE_NAME "Test atbm"
 
+
+// ========== BLE Advertising Scheduler Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MIN / _MAX
+ *
+ * Advertising interval (in 0.625ms units) used once the fast advertising window
+ * (CHIP_DEVICE_CONFIG_BLE_ADVERTISING_INTERVAL_CHANGE_TIME) has expired, and while
+ * the WiFi station is busy with a scan or an association attempt.
+ */
+#ifndef CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MIN
+#define CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MIN 160 // 100ms
+#endif // CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MIN
+
+#ifndef CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MAX
+#define CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MAX 240 // 150ms
+#endif // CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MAX
+
+/**
+ * CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_TIME
+ *
+ * Time in milliseconds spent in the medium advertising phase before falling back
+ * to the slow advertising interval.
+ */
+#ifndef CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_TIME
+#define CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_TIME 120000
+#endif // CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_TIME
+
+/**
+ * CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MIN / _MAX / _TIME
+ *
+ * Interval (in 0.625ms units) and duration (in milliseconds) of the short advertising
+ * burst requested through BLEManagerImpl::TriggerAdvertisingBurst(), e.g. on a button press.
+ */
+#ifndef CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MIN
+#define CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MIN 32 // 20ms
+#endif // CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MIN
+
+#ifndef CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MAX
+#define CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MAX 48 // 30ms
+#endif // CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MAX
+
+#ifndef CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_TIME
+#define CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_TIME 10000
+#endif // CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_TIME
+
+/**
+ * CHIP_DEVICE_CONFIG_BLE_ADV_EVENT_AIRTIME_US
+ *
+ * Estimated radio-on time of one legacy advertising event (3 channels, ADV_IND plus
+ * the RX window for scan/connect requests), used for the radio-on time metric.
+ */
+#ifndef CHIP_DEVICE_CONFIG_BLE_ADV_EVENT_AIRTIME_US
+#define CHIP_DEVICE_CONFIG_BLE_ADV_EVENT_AIRTIME_US 1200
+#endif // CHIP_DEVICE_CONFIG_BLE_ADV_EVENT_AIRTIME_US
+
+/**
+ * CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+ *
+ * Advertise CHIPoBLE with an LE extended advertising set (full commissioning data,
+ * device name and rotating ID in one non-scannable PDU chain) alongside a legacy
+ * fallback set for older phones.  Requires the NimBLE host/controller libraries to
+ * be built with BLE_EXT_ADV and at least two advertising instances; enabled through
+ * the chip_enable_ble_ext_adv GN argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+#define CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING 0
+#endif // CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+
+/**
+ * CHIP_DEVICE_CONFIG_BLE_EXT_ADV_PRIMARY_PHY / _SECONDARY_PHY
+ *
+ * PHYs (BLE_HCI_LE_PHY_*) of the extended advertising set.  The primary PHY carries
+ * the ADV_EXT_IND on the advertising channels (1M or coded); the secondary PHY carries
+ * the AUX_ADV_IND holding the payload (1M, 2M or coded).
+ */
+#ifndef CHIP_DEVICE_CONFIG_BLE_EXT_ADV_PRIMARY_PHY
+#define CHIP_DEVICE_CONFIG_BLE_EXT_ADV_PRIMARY_PHY 1 // BLE_HCI_LE_PHY_1M
+#endif // CHIP_DEVICE_CONFIG_BLE_EXT_ADV_PRIMARY_PHY
+
+#ifndef CHIP_DEVICE_CONFIG_BLE_EXT_ADV_SECONDARY_PHY
+#define CHIP_DEVICE_CONFIG_BLE_EXT_ADV_SECONDARY_PHY 2 // BLE_HCI_LE_PHY_2M
+#endif // CHIP_DEVICE_CONFIG_BLE_EXT_ADV_SECONDARY_PHY
+
+// ========== WiFi Station Reconnect Policy Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_MAX_INTERVAL
+ *
+ * Upper bound (in milliseconds) of the exponential reconnect backoff.  The backoff
+ * starts at CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_INTERVAL and doubles after
+ * every failed attempt.
+ */
+#ifndef CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_MAX_INTERVAL
+#define CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_MAX_INTERVAL 300000
+#endif // CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_MAX_INTERVAL
+
+/**
+ * CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_AUTH_FAIL_INTERVAL
+ *
+ * Initial reconnect delay (in milliseconds) after the AP rejected the credentials.
+ * Retrying sooner cannot succeed until the AP configuration changes.
+ */
+#ifndef CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_AUTH_FAIL_INTERVAL
+#define CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_AUTH_FAIL_INTERVAL 60000
+#endif // CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_AUTH_FAIL_INTERVAL
+
+/**
+ * CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_FAST_RETRIES
+ *
+ * Number of retries made at the base interval, without backoff, after a transient
+ * disconnect (e.g. AP restart, inactivity or lost beacons).
+ */
+#ifndef CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_FAST_RETRIES
+#define CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_FAST_RETRIES 3
+#endif // CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_FAST_RETRIES
+
+// ========== WiFi Network Selection and Roaming Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_WIFI_MAX_NETWORKS
+ *
+ * Number of WiFi networks the Network Commissioning driver can store.  The list order
+ * is the connection priority.
+ */
+#ifndef CHIP_DEVICE_CONFIG_WIFI_MAX_NETWORKS
+#define CHIP_DEVICE_CONFIG_WIFI_MAX_NETWORKS 4
+#endif // CHIP_DEVICE_CONFIG_WIFI_MAX_NETWORKS
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+ *
+ * Periodically check the station RSSI and move to a stronger AP of a saved network
+ * when the current link gets weak.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+#define CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING 1
+#endif // CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+
+/**
+ * CHIP_DEVICE_CONFIG_WIFI_ROAM_CHECK_INTERVAL
+ *
+ * Time in milliseconds between two RSSI checks while connected.
+ */
+#ifndef CHIP_DEVICE_CONFIG_WIFI_ROAM_CHECK_INTERVAL
+#define CHIP_DEVICE_CONFIG_WIFI_ROAM_CHECK_INTERVAL 30000
+#endif // CHIP_DEVICE_CONFIG_WIFI_ROAM_CHECK_INTERVAL
+
+/**
+ * CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_THRESHOLD / _HYSTERESIS
+ *
+ * A roaming scan starts when the RSSI (dBm) drops below the threshold, and the station
+ * only moves to an AP that is at least the hysteresis (dB) stronger than the current one.
+ */
+#ifndef CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_THRESHOLD
+#define CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_THRESHOLD (-75)
+#endif // CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_THRESHOLD
+
+#ifndef CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_HYSTERESIS
+#define CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_HYSTERESIS 8
+#endif // CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_HYSTERESIS
+
+// ========== Internet Connectivity Tracking Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+ *
+ * Confirm Internet reachability by opening a TCP connection to
+ * CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST:CHIP_DEVICE_CONFIG_INTERNET_PROBE_PORT once the
+ * station has an address, instead of inferring it from the presence of an address,
+ * gateway and DNS server only.
+ */
+#ifndef CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+#define CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED 0
+#endif // CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+
+#ifndef CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST
+#define CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST "connectivitycheck.gstatic.com"
+#endif // CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST
+
+#ifndef CHIP_DEVICE_CONFIG_INTERNET_PROBE_PORT
+#define CHIP_DEVICE_CONFIG_INTERNET_PROBE_PORT 80
+#endif // CHIP_DEVICE_CONFIG_INTERNET_PROBE_PORT
+
+/**
+ * CHIP_DEVICE_CONFIG_INTERNET_PROBE_TIMEOUT
+ *
+ * Time in milliseconds after which a probe that got no answer counts as unreachable.
+ */
+#ifndef CHIP_DEVICE_CONFIG_INTERNET_PROBE_TIMEOUT
+#define CHIP_DEVICE_CONFIG_INTERNET_PROBE_TIMEOUT 10000
+#endif // CHIP_DEVICE_CONFIG_INTERNET_PROBE_TIMEOUT
+
+/**
+ * CHIP_DEVICE_CONFIG_INTERNET_PROBE_INTERVAL
+ *
+ * Time in milliseconds a probe result is cached before the next probe.
+ */
+#ifndef CHIP_DEVICE_CONFIG_INTERNET_PROBE_INTERVAL
+#define CHIP_DEVICE_CONFIG_INTERNET_PROBE_INTERVAL 300000
+#endif // CHIP_DEVICE_CONFIG_INTERNET_PROBE_INTERVAL
+
+// ========== Real Time Clock Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_SNTP
+ *
+ * Set the real time clock from CHIP_DEVICE_CONFIG_SNTP_SERVER once the station has
+ * Internet connectivity, and periodically afterwards to estimate the oscillator drift.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_SNTP
+#define CHIP_DEVICE_CONFIG_ENABLE_SNTP 1
+#endif // CHIP_DEVICE_CONFIG_ENABLE_SNTP
+
+#ifndef CHIP_DEVICE_CONFIG_SNTP_SERVER
+#define CHIP_DEVICE_CONFIG_SNTP_SERVER "pool.ntp.org"
+#endif // CHIP_DEVICE_CONFIG_SNTP_SERVER
+
+/**
+ * CHIP_DEVICE_CONFIG_SNTP_STARTUP_DELAY
+ *
+ * Time in milliseconds between gaining connectivity and the first request.
+ */
+#ifndef CHIP_DEVICE_CONFIG_SNTP_STARTUP_DELAY
+#define CHIP_DEVICE_CONFIG_SNTP_STARTUP_DELAY 5000
+#endif // CHIP_DEVICE_CONFIG_SNTP_STARTUP_DELAY
+
+/**
+ * CHIP_DEVICE_CONFIG_SNTP_RESYNC_INTERVAL
+ *
+ * Time in milliseconds between two successful updates.
+ */
+#ifndef CHIP_DEVICE_CONFIG_SNTP_RESYNC_INTERVAL
+#define CHIP_DEVICE_CONFIG_SNTP_RESYNC_INTERVAL 86400000
+#endif // CHIP_DEVICE_CONFIG_SNTP_RESYNC_INTERVAL
+
+/**
+ * CHIP_DEVICE_CONFIG_REAL_TIME_RESTORE
+ *
+ * Restore the real time saved before the last reboot at startup, as a lower bound of
+ * the current time until the next network update.  The drift estimate is always restored.
+ *
+ * Off by default: the restored time misses the time spent powered off, yet the stack
+ * would take it as the current time (e.g. for certificate validity).  The stack already
+ * keeps its own lower bound, the Last Known Good Time, for that purpose.
+ */
+#ifndef CHIP_DEVICE_CONFIG_REAL_TIME_RESTORE
+#define CHIP_DEVICE_CONFIG_REAL_TIME_RESTORE 0
+#endif // CHIP_DEVICE_CONFIG_REAL_TIME_RESTORE
+
+// ========== Logging Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_LOG_DEFERRED
+ *
+ * Queue log records in a RAM ring drained to the console by a low priority task,
+ * instead of writing them to the UART on the logging thread.  Records that do not fit
+ * in the ring are dropped and counted.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LOG_DEFERRED
+#define CHIP_DEVICE_CONFIG_LOG_DEFERRED 1
+#endif // CHIP_DEVICE_CONFIG_LOG_DEFERRED
+
+/**
+ * CHIP_DEVICE_CONFIG_LOG_RING_SIZE
+ *
+ * Size in bytes of the deferred log ring.  Each record takes a 4 byte header plus the
+ * module name and the formatted message (or the tokenized record).
+ */
+#ifndef CHIP_DEVICE_CONFIG_LOG_RING_SIZE
+#define CHIP_DEVICE_CONFIG_LOG_RING_SIZE 4096
+#endif // CHIP_DEVICE_CONFIG_LOG_RING_SIZE
+
+#ifndef CHIP_DEVICE_CONFIG_LOG_TASK_NAME
+#define CHIP_DEVICE_CONFIG_LOG_TASK_NAME "LOG"
+#endif // CHIP_DEVICE_CONFIG_LOG_TASK_NAME
+
+#ifndef CHIP_DEVICE_CONFIG_LOG_TASK_STACK_SIZE
+#define CHIP_DEVICE_CONFIG_LOG_TASK_STACK_SIZE 1024
+#endif // CHIP_DEVICE_CONFIG_LOG_TASK_STACK_SIZE
+
+#ifndef CHIP_DEVICE_CONFIG_LOG_TASK_PRIORITY
+#define CHIP_DEVICE_CONFIG_LOG_TASK_PRIORITY 1
+#endif // CHIP_DEVICE_CONFIG_LOG_TASK_PRIORITY
+
+/**
+ * CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+ *
+ * Check each message against a per-module category mask before it is formatted.  The
+ * masks are set with the "atbm log" shell command and kept in the KVS.  This only
+ * narrows what the compile-time CHIP_DETAIL_LOGGING/CHIP_PROGRESS_LOGGING flags build in.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+#define CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER 1
+#endif // CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+
+// ========== Heap Tracking Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+ *
+ * Account the heap allocations of the platform layer and of Platform::MemoryAlloc() per
+ * subsystem, and track the heap high watermark reported by Software Diagnostics.  Costs
+ * a few bytes of header per block.  Reported by the `atbm heap` shell command.  Set
+ * through the chip_enable_heap_tracking GN argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+#define CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING 0
+#endif // CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+
+// ========== Power Governor Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+ *
+ * Move the platform housekeeping timers (SNTP resync, internet probe, task profiler) onto
+ * already scheduled wake-ups or a common boundary, and count the CHIP event loop wake-ups
+ * by reason.  Reported by the `atbm power` shell command.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+#define CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR 1
+#endif // CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+
+/**
+ * CHIP_DEVICE_CONFIG_POWER_GOVERNOR_TIMER_SLACK
+ *
+ * Default lateness in milliseconds allowed to a housekeeping timer so that it can share a
+ * wake-up; 0 starts them on time.
+ */
+#ifndef CHIP_DEVICE_CONFIG_POWER_GOVERNOR_TIMER_SLACK
+#define CHIP_DEVICE_CONFIG_POWER_GOVERNOR_TIMER_SLACK 1000
+#endif // CHIP_DEVICE_CONFIG_POWER_GOVERNOR_TIMER_SLACK
+
+// ========== Task Profiler Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+ *
+ * Snapshot the CPU share, priority, state and minimum free stack of every task each
+ * CHIP_DEVICE_CONFIG_TASK_PROFILER_INTERVAL milliseconds, keeping the last
+ * CHIP_DEVICE_CONFIG_TASK_PROFILER_HISTORY snapshots.  Reported by the `atbm tasks` shell
+ * command and the thread metrics of the software diagnostics cluster.  Set through the
+ * chip_enable_task_profiler GN argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+#define CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER 0
+#endif // CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+
+#ifndef CHIP_DEVICE_CONFIG_TASK_PROFILER_INTERVAL
+#define CHIP_DEVICE_CONFIG_TASK_PROFILER_INTERVAL 10000
+#endif // CHIP_DEVICE_CONFIG_TASK_PROFILER_INTERVAL
+
+#ifndef CHIP_DEVICE_CONFIG_TASK_PROFILER_HISTORY
+#define CHIP_DEVICE_CONFIG_TASK_PROFILER_HISTORY 4
+#endif // CHIP_DEVICE_CONFIG_TASK_PROFILER_HISTORY
+
+/**
+ * CHIP_DEVICE_CONFIG_TASK_PROFILER_MAX_TASKS
+ *
+ * Tasks kept per snapshot, lowest task numbers first.
+ */
+#ifndef CHIP_DEVICE_CONFIG_TASK_PROFILER_MAX_TASKS
+#define CHIP_DEVICE_CONFIG_TASK_PROFILER_MAX_TASKS 16
+#endif // CHIP_DEVICE_CONFIG_TASK_PROFILER_MAX_TASKS
+
+// ========== Lock Profiling Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+ *
+ * Record per-task acquire counts, wait time histograms and the longest hold of the LwIP
+ * core lock and the CHIP stack lock, plus a short acquire/release trace.  Reported by
+ * the `atbm locks` shell command.  Set through the chip_enable_lock_profiling GN argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+#define CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING 0
+#endif // CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+
+// ========== Flash Trace Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+ *
+ * Record platform events (Wi-Fi and BLE connection changes, reconnect attempts, ...) in a
+ * RAM ring and persist them to the EasyFlash log area for post-mortem analysis.  Set
+ * through the chip_enable_flash_trace GN argument; the SDK must be built with
+ * CONFIG_EF_USING_LOG so that ef_log_*() is available.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+#define CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE 0
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+
+/**
+ * CHIP_DEVICE_CONFIG_FLASH_TRACE_RING_RECORDS
+ *
+ * Number of 20 byte trace records held in RAM between checkpoints.
+ */
+#ifndef CHIP_DEVICE_CONFIG_FLASH_TRACE_RING_RECORDS
+#define CHIP_DEVICE_CONFIG_FLASH_TRACE_RING_RECORDS 128
+#endif // CHIP_DEVICE_CONFIG_FLASH_TRACE_RING_RECORDS
+
+/**
+ * CHIP_DEVICE_CONFIG_FLASH_TRACE_CHECKPOINT_INTERVAL
+ *
+ * Interval in milliseconds between periodic checkpoints of the trace ring to flash.
+ * Nothing is written when no record was added since the previous checkpoint.
+ */
+#ifndef CHIP_DEVICE_CONFIG_FLASH_TRACE_CHECKPOINT_INTERVAL
+#define CHIP_DEVICE_CONFIG_FLASH_TRACE_CHECKPOINT_INTERVAL (10 * 60 * 1000)
+#endif // CHIP_DEVICE_CONFIG_FLASH_TRACE_CHECKPOINT_INTERVAL
+
+// ========== Factory Data Partition Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+ *
+ * Serve ATBMFactoryDataProvider from a read-only, CRC protected partition generated by
+ * scripts/tools/atbm/gen_factory_partition.py, falling back to the EasyFlash keys for
+ * anything the partition does not hold.  Set through the chip_use_factory_partition GN
+ * argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+#define CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION 0
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION
+
+/**
+ * CHIP_DEVICE_CONFIG_FACTORY_PARTITION_ADDR
+ *
+ * Memory mapped flash address of the factory data partition; by default the user key
+ * section of app_flash_param.h.
+ */
+#ifndef CHIP_DEVICE_CONFIG_FACTORY_PARTITION_ADDR
+#define CHIP_DEVICE_CONFIG_FACTORY_PARTITION_ADDR FLASH_USR_KEY_SECTION_ADDR
+#endif // CHIP_DEVICE_CONFIG_FACTORY_PARTITION_ADDR
+
+#ifndef CHIP_DEVICE_CONFIG_FACTORY_PARTITION_SIZE
+#define CHIP_DEVICE_CONFIG_FACTORY_PARTITION_SIZE FLASH_USR_KEY_SECTION_LEN
+#endif // CHIP_DEVICE_CONFIG_FACTORY_PARTITION_SIZE
+
+// ========== Device Attestation Configuration =========
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_ATTESTATION_CACHE
+ *
+ * Keep the DAC keypair (and the secure cert partition's DAC and PAI certificates) in RAM
+ * after first use instead of importing them for every attestation request.  The cache is
+ * zeroized on factory reset.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_ATTESTATION_CACHE
+#define CHIP_DEVICE_CONFIG_ENABLE_ATTESTATION_CACHE 1
+#endif // CHIP_DEVICE_CONFIG_ENABLE_ATTESTATION_CACHE
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK
+ *
+ * Build P256Benchmark and the "atbm p256" shell command, which time P-256 key
+ * generation, import, ECDSA sign/verify and ECDH through the crypto PAL.  Set through the
+ * chip_enable_p256_benchmark GN argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK
+#define CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK 0
+#endif // CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK
+
+/**
+ * CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK
+ *
+ * Build SessionCryptoBenchmark and the "atbm crypto" shell command, which time AES-CCM
+ * and SHA-256 over Interaction Model sized payloads.  Set through the
+ * chip_enable_session_crypto_benchmark GN argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK
+#define CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK 0
+#endif // CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK
@@ -0,0 +1,68 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Platform::Memory* for ATBM platforms (chip_config_memory_management = "platform"),
+ *          accounted under the "chip" tag of the HeapTracker.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <lib/support/CHIPMem.h>
+#include <platform/atbm/HeapTracker.h>
+
+using chip::DeviceLayer::Internal::HeapTracker;
+
+namespace chip {
+namespace Platform {
+
+CHIP_ERROR MemoryAllocatorInit(void * buf, size_t bufSize)
+{
+    return CHIP_NO_ERROR;
+}
+
+void MemoryAllocatorShutdown() {}
+
+void * MemoryAlloc(size_t size)
+{
+    return HeapTracker::Alloc(HeapTracker::kTag_Chip, size);
+}
+
+void * MemoryCalloc(size_t num, size_t size)
+{
+    return HeapTracker::Calloc(HeapTracker::kTag_Chip, num, size);
+}
+
+void * MemoryRealloc(void * p, size_t size)
+{
+    return HeapTracker::Realloc(HeapTracker::kTag_Chip, p, size);
+}
+
+void MemoryFree(void * p)
+{
+    HeapTracker::Free(p);
+}
+
+bool MemoryInternalCheckPointer(const void * p, size_t min_size)
+{
+    return (p != nullptr);
+}
+
+} // namespace Platform
+} // namespace chip
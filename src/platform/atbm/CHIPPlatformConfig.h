@@ -32,3 +32,13 @@
 #define CHIP_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_ID 1
 #define CHIP_CONFIG_PERSISTED_STORAGE_MAX_KEY_LENGTH 2
 
+
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+// Persist the trace ring before chipDie() aborts; see FlashTrace.h.
+#ifdef __cplusplus
+extern "C" void atbm_flash_trace_abort(void);
+#else
+void atbm_flash_trace_abort(void);
+#endif
+#define CHIP_CONFIG_ABORT() atbm_flash_trace_abort()
+#endif // CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
@@ -29,6 +29,13 @@
 #include <lib/support/CodeUtils.h>
 #include <platform/ConfigurationManager.h>
 #include <platform/atbm/ATBMConfig.h>
+#include <platform/atbm/AttestationCache.h>
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+#include <platform/atbm/DeferredLog.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+#include <platform/atbm/FlashTrace.h>
+#endif
 #include <platform/internal/GenericConfigurationManagerImpl.ipp>
 #include "atbm_general.h"
 
@@ -260,7 +267,14 @@ void ConfigurationManagerImpl::DoFactoryReset(intptr_t arg)
 
     ChipLogProgress(DeviceLayer, "Performing factory reset");
     ef_env_set_default();
+    AttestationCache::Clear();
     ChipLogProgress(DeviceLayer, "System restarting");
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+    DeferredLog::Flush();
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+    FlashTrace::Checkpoint(FlashTrace::kReason_Reboot);
+#endif
     hal_sys_reboot();
 }
 
@@ -49,6 +49,14 @@
 
 #include <lib/support/BitFlags.h>
 
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
+#include <platform/atbm/InternetConnectivityTracker.h>
+#include <platform/atbm/WiFiReconnectPolicy.h>
+#if CHIP_DEVICE_CONFIG_ENABLE_SNTP
+#include <platform/atbm/SntpClient.h>
+#endif
+#endif
+
 namespace chip {
 
 namespace Inet {
@@ -89,6 +97,17 @@ class ConnectivityManagerImpl final : public ConnectivityManager,
     // the implementation methods provided by this class.
     friend class ConnectivityManager;
 
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
+public:
+    /**
+     * Replaces the WiFi station reconnect policy.  Passing nullptr restores the default
+     * jittered exponential backoff.  The policy must outlive the connectivity manager.
+     */
+    void SetWiFiReconnectPolicy(WiFiReconnectPolicy * policy);
+    const WiFiReconnectCounters & GetWiFiReconnectCounters() const { return mWiFiReconnectCounters; }
+    void ResetWiFiReconnectCounters() { mWiFiReconnectCounters = {}; }
+#endif // CHIP_DEVICE_CONFIG_ENABLE_WIFI
+
 private:
     CHIP_ERROR _Init(void);
     void _OnPlatformEvent(const ChipDeviceEvent * event);
@@ -116,6 +135,14 @@ private:
     WiFiStationMode mWiFiStationMode;
     WiFiStationState mWiFiStationState;
     System::Clock::Timeout mWiFiStationReconnectInterval;
+    System::Clock::Timeout mWiFiStationReconnectDelay;
+    ExponentialBackoffReconnectPolicy mDefaultWiFiReconnectPolicy;
+    WiFiReconnectPolicy * mWiFiReconnectPolicy;
+    WiFiReconnectCounters mWiFiReconnectCounters;
+    Internal::InternetConnectivityTracker mInternetTracker;
+#if CHIP_DEVICE_CONFIG_ENABLE_SNTP
+    Internal::SntpClient mSntpClient;
+#endif
     BitFlags<Flags> mFlags;
 
     CHIP_ERROR InitWiFi(void);
@@ -125,6 +152,7 @@ private:
     void OnStationConnected(void);
     void OnStationDisconnected(void);
     void ChangeWiFiStationState(WiFiStationState newState);
+    void ScheduleStationReconnect(System::Clock::Timestamp now, bool connectionLost);
     static void DriveStationState(::chip::System::Layer * aLayer, void * aAppState);
 
 #if CHIP_DEVICE_CONFIG_ENABLE_WIFI_AP
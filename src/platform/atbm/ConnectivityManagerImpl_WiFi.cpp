@@ -28,15 +28,14 @@
 #include <platform/DeviceInstanceInfoProvider.h>
 #include <platform/DiagnosticDataProvider.h>
 #include <platform/atbm/ATBMUtils.h>
+#include <platform/atbm/FlashTrace.h>
 #include <platform/atbm/NetworkCommissioningDriver.h>
 #include <platform/atbm/route_hook/atbm_route_hook.h>
 
 #include <platform/internal/BLEManager.h>
 
 #include "lwip/lwipopts.h"
-#include <lwip/dns.h>
 #include <lwip/ip_addr.h>
-#include <lwip/nd6.h>
 #include <lwip/netif.h>
 
 #if CHIP_DEVICE_CONFIG_ENABLE_WIFI
@@ -141,6 +140,9 @@ CHIP_ERROR ConnectivityManagerImpl::InitWiFi()
     mWiFiStationMode  = kWiFiStationMode_Disabled;
     mWiFiStationState = kWiFiStationState_NotConnected;
     mWiFiStationReconnectInterval = System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_INTERVAL);
+    mWiFiStationReconnectDelay    = mWiFiStationReconnectInterval;
+    mWiFiReconnectPolicy          = &mDefaultWiFiReconnectPolicy;
+    mWiFiReconnectCounters        = {};
 
 #if CHIP_DEVICE_CONFIG_ENABLE_WIFI_AP
     mLastAPDemandTime  = System::Clock::kZero;
@@ -154,6 +156,14 @@ CHIP_ERROR ConnectivityManagerImpl::InitWiFi()
     // Ensure that ATBM station mode is enabled.
     ReturnErrorOnFailure(Internal::ATBMUtils::EnableStationMode());
 
+    // Seeds the reconnect jitter from the station MAC address.
+    mDefaultWiFiReconnectPolicy.Init(mWiFiStationReconnectInterval);
+
+    mInternetTracker.Init([]() { sInstance.UpdateInternetConnectivityState(); });
+#if CHIP_DEVICE_CONFIG_ENABLE_SNTP
+    mSntpClient.Init();
+#endif
+
     // If there is no persistent station provision...
     if (!IsWiFiStationProvisioned())
     {
@@ -199,6 +209,9 @@ void ConnectivityManagerImpl::OnWiFiPlatformEvent(const ChipDeviceEvent * event)
         {
         case WIFI_EVENT_SCAN_DONE:
             ChipLogProgress(DeviceLayer, "WIFI_EVENT_SCAN_DONE");
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+            Internal::BLEMgrImpl().SetWiFiCoexActive(Internal::BLEManagerImpl::WiFiCoexReason::kScan, false);
+#endif
             NetworkCommissioning::ATBMWiFiDriver::GetInstance().OnScanWiFiNetworkDone();
             break;
         case WIFI_EVENT_STA_START:
@@ -207,6 +220,7 @@ void ConnectivityManagerImpl::OnWiFiPlatformEvent(const ChipDeviceEvent * event)
             break;
         case WIFI_EVENT_STA_CONNECTED:
             ChipLogProgress(DeviceLayer, "WIFI_EVENT_STA_CONNECTED");
+            ATBM_FLASH_TRACE(kEvent_WiFiConnected);
             if (mWiFiStationState == kWiFiStationState_Connecting)
             {
                 ChangeWiFiStationState(kWiFiStationState_Connecting_Succeeded);
@@ -216,6 +230,7 @@ void ConnectivityManagerImpl::OnWiFiPlatformEvent(const ChipDeviceEvent * event)
         case WIFI_EVENT_STA_DISCONNECTED:
             ChipLogProgress(DeviceLayer, "WIFI_EVENT_STA_DISCONNECTED");
             NetworkCommissioning::ATBMWiFiDriver::GetInstance().SetLastDisconnectReason(event);
+            ATBM_FLASH_TRACE(kEvent_WiFiDisconnected, NetworkCommissioning::ATBMWiFiDriver::GetInstance().GetLastDisconnectReason());
             if (mWiFiStationState == kWiFiStationState_Connecting)
             {
                 ChangeWiFiStationState(kWiFiStationState_Connecting_Failed);
@@ -306,6 +321,7 @@ void ConnectivityManagerImpl::DriveStationState()
             ChangeWiFiStationState(kWiFiStationState_Connected);
             ChipLogProgress(DeviceLayer, "WiFi station interface connected");
             mLastStationConnectFailTime = System::Clock::kZero;
+            mWiFiReconnectPolicy->Reset();
             OnStationConnected();
         }
 
@@ -336,12 +352,31 @@ void ConnectivityManagerImpl::DriveStationState()
             if (prevState != kWiFiStationState_Connecting_Failed)
             {
                 ChipLogProgress(DeviceLayer, "WiFi station interface disconnected");
-                mLastStationConnectFailTime = System::Clock::kZero;
                 OnStationDisconnected();
+                if (NetworkCommissioning::ATBMWiFiDriver::GetInstance().IsRoamPending())
+                {
+                    // Deliberate disconnect to roam: join the new AP straight away.
+                    mLastStationConnectFailTime = System::Clock::kZero;
+                }
+                else if (prevState == kWiFiStationState_Connected)
+                {
+                    ScheduleStationReconnect(now, true);
+                }
+                else
+                {
+                    mLastStationConnectFailTime = System::Clock::kZero;
+                }
+            }
+            else if (NetworkCommissioning::ATBMWiFiDriver::GetInstance().OnStationConnectFailed())
+            {
+                // A failed fast reconnect is retried straight away with a full scan.
+                mWiFiReconnectCounters.ConnectFailures++;
+                mLastStationConnectFailTime = System::Clock::kZero;
             }
             else
             {
-                mLastStationConnectFailTime = now;
+                mWiFiReconnectCounters.ConnectFailures++;
+                ScheduleStationReconnect(now, false);
             }
         }
 
@@ -353,17 +388,18 @@ void ConnectivityManagerImpl::DriveStationState()
             // Initiate a connection to the AP if we haven't done so before, or if enough
             // time has passed since the last attempt.
             if (mLastStationConnectFailTime == System::Clock::kZero ||
-                now >= mLastStationConnectFailTime + mWiFiStationReconnectInterval)
+                now >= mLastStationConnectFailTime + mWiFiStationReconnectDelay)
             {
                 ChipLogProgress(DeviceLayer, "Attempting to connect WiFi station interface");
-                atbm_wifi_connect_ap_autoMgmt();
+                mWiFiReconnectCounters.ConnectAttempts++;
+                NetworkCommissioning::ATBMWiFiDriver::GetInstance().StartStationConnect();
                 ChangeWiFiStationState(kWiFiStationState_Connecting);
             }
 
             // Otherwise arrange another connection attempt at a suitable point in the future.
             else
             {
-                System::Clock::Timeout timeToNextConnect = (mLastStationConnectFailTime + mWiFiStationReconnectInterval) - now;
+                System::Clock::Timeout timeToNextConnect = (mLastStationConnectFailTime + mWiFiStationReconnectDelay) - now;
 
                 ChipLogProgress(DeviceLayer, "Next WiFi station reconnect in %" PRIu32 " ms",
                                 System::Clock::Milliseconds32(timeToNextConnect).count());
@@ -378,6 +414,46 @@ void ConnectivityManagerImpl::DriveStationState()
     // of the WiFi station.
 }
 
+void ConnectivityManagerImpl::ScheduleStationReconnect(System::Clock::Timestamp now, bool connectionLost)
+{
+    uint16_t reason = NetworkCommissioning::ATBMWiFiDriver::GetInstance().GetLastDisconnectReason();
+    WiFiReconnectPolicy::RetryClass retryClass;
+
+    mWiFiStationReconnectDelay  = mWiFiReconnectPolicy->GetNextRetryDelay(reason, connectionLost, retryClass);
+    mLastStationConnectFailTime = now;
+
+    switch (retryClass)
+    {
+    case WiFiReconnectPolicy::RetryClass::kFast:
+        mWiFiReconnectCounters.FastRetries++;
+        break;
+    case WiFiReconnectPolicy::RetryClass::kBackoff:
+        mWiFiReconnectCounters.BackoffRetries++;
+        break;
+    case WiFiReconnectPolicy::RetryClass::kAuthFailure:
+        mWiFiReconnectCounters.AuthFailureRetries++;
+        break;
+    }
+    mWiFiReconnectCounters.LastRetryDelayMs = System::Clock::Milliseconds32(mWiFiStationReconnectDelay).count();
+
+    ChipLogProgress(DeviceLayer, "WiFi reconnect (reason %u) scheduled in %" PRIu32 " ms", reason,
+                    mWiFiReconnectCounters.LastRetryDelayMs);
+    ATBM_FLASH_TRACE(kEvent_WiFiReconnect, reason, mWiFiReconnectCounters.LastRetryDelayMs, static_cast<uint32_t>(retryClass));
+}
+
+void ConnectivityManagerImpl::SetWiFiReconnectPolicy(WiFiReconnectPolicy * policy)
+{
+    mWiFiReconnectPolicy = (policy != nullptr) ? policy : &mDefaultWiFiReconnectPolicy;
+    mWiFiReconnectPolicy->Reset();
+}
+
+CHIP_ERROR ConnectivityManagerImpl::_SetWiFiStationReconnectInterval(System::Clock::Timeout val)
+{
+    mWiFiStationReconnectInterval = val;
+    mDefaultWiFiReconnectPolicy.SetBaseInterval(val);
+    return CHIP_NO_ERROR;
+}
+
 void ConnectivityManagerImpl::OnStationConnected()
 {
     // Assign an IPv6 link local address to the station interface.
@@ -398,7 +474,7 @@ void ConnectivityManagerImpl::OnStationConnected()
             chip::to_underlying(chip::app::Clusters::WiFiNetworkDiagnostics::ConnectionStatusEnum::kConnected));
     }
 
-    UpdateInternetConnectivityState();
+    mInternetTracker.OnNetifChanged();
 }
 
 void ConnectivityManagerImpl::OnStationDisconnected()
@@ -426,7 +502,7 @@ void ConnectivityManagerImpl::OnStationDisconnected()
             chip::to_underlying(chip::app::Clusters::WiFiNetworkDiagnostics::ConnectionStatusEnum::kNotConnected));
     }
 
-    UpdateInternetConnectivityState();
+    mInternetTracker.OnNetifChanged();
 }
 
 void ConnectivityManagerImpl::ChangeWiFiStationState(WiFiStationState newState)
@@ -436,6 +512,11 @@ void ConnectivityManagerImpl::ChangeWiFiStationState(WiFiStationState newState)
         ChipLogProgress(DeviceLayer, "WiFi station state change: %s -> %s", WiFiStationStateToStr(mWiFiStationState),
                         WiFiStationStateToStr(newState));
         mWiFiStationState = newState;
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+        // Keep BLE advertising off the fast interval while the station is associating.
+        Internal::BLEMgrImpl().SetWiFiCoexActive(Internal::BLEManagerImpl::WiFiCoexReason::kAssociation,
+                                                 newState == kWiFiStationState_Connecting);
+#endif
         NetworkCommissioning::ATBMWiFiDriver::GetInstance().OnNetworkStatusChange();
     }
 }
@@ -602,45 +683,15 @@ void ConnectivityManagerImpl::UpdateInternetConnectivityState(void)
     const bool hadIPv6Conn = mFlags.Has(ConnectivityFlags::kHaveIPv6InternetConnectivity);
     IPAddress addr;
 
-    // If the WiFi station is currently in the connected state...
+    // If the WiFi station is currently in the connected state, take the netif state
+    // maintained by the connectivity tracker.
     if (mWiFiStationState == kWiFiStationState_Connected)
     {
-        // Get the LwIP netif for the WiFi station interface.
-        struct netif * netif = Internal::ATBMUtils::GetStationNetif();
-
-        // If the WiFi station interface is up...
-        if (netif != NULL && netif_is_up(netif) && netif_is_link_up(netif))
+        haveIPv4Conn = mInternetTracker.HasIPv4Connectivity();
+        haveIPv6Conn = mInternetTracker.HasIPv6Connectivity();
+        if (haveIPv4Conn)
         {
-            // Check if a DNS server is currently configured.  If so...
-            ip_addr_t dnsServerAddr = *dns_getserver(0);
-            if (!ip_addr_isany_val(dnsServerAddr))
-            {
-                // If the station interface has been assigned an IPv4 address, and has
-                // an IPv4 gateway, then presume that the device has IPv4 Internet
-                // connectivity.
-                if (!ip4_addr_isany_val(*netif_ip4_addr(netif)) && !ip4_addr_isany_val(*netif_ip4_gw(netif)))
-                {
-                    haveIPv4Conn = true;
-                    IPAddress::FromString(inet_ntoa(netif->ip_addr.u_addr.ip4.addr), addr);
-                }
-
-                // Search among the IPv6 addresses assigned to the interface for a Global Unicast
-                // address (2000::/3) that is in the valid state.  If such an address is found...
-                for (uint8_t i = 0; i < LWIP_IPV6_NUM_ADDRESSES; i++)
-                {
-                    if (ip6_addr_isglobal(netif_ip6_addr(netif, i)) && ip6_addr_isvalid(netif_ip6_addr_state(netif, i)))
-                    {
-                        // Determine if there is a default IPv6 router that is currently reachable
-                        // via the station interface.  If so, presume for now that the device has
-                        // IPv6 connectivity.
-                        struct netif * found_if = nd6_find_route(IP6_ADDR_ANY6);
-                        if (found_if && netif->num == found_if->num)
-                        {
-                            haveIPv6Conn = true;
-                        }
-                    }
-                }
-            }
+            addr = mInternetTracker.GetIPv4Address();
         }
     }
 
@@ -669,12 +720,17 @@ void ConnectivityManagerImpl::UpdateInternetConnectivityState(void)
         {
             ChipLogProgress(DeviceLayer, "%s Internet connectivity %s", "IPv6", (haveIPv6Conn) ? "ESTABLISHED" : "LOST");
         }
+
+#if CHIP_DEVICE_CONFIG_ENABLE_SNTP
+        mSntpClient.OnConnectivityChanged(haveIPv4Conn || haveIPv6Conn);
+#endif
     }
 }
 
 void ConnectivityManagerImpl::OnStationIPv4AddressAvailable(void)
 {
-    UpdateInternetConnectivityState();
+    ATBM_FLASH_TRACE(kEvent_IPv4Up);
+    mInternetTracker.OnNetifChanged();
 
     ChipDeviceEvent event;
     event.Type                           = DeviceEventType::kInterfaceIpAddressChanged;
@@ -685,8 +741,9 @@ void ConnectivityManagerImpl::OnStationIPv4AddressAvailable(void)
 void ConnectivityManagerImpl::OnStationIPv4AddressLost(void)
 {
     ChipLogProgress(DeviceLayer, "IPv4 address lost on WiFi station interface");
+    ATBM_FLASH_TRACE(kEvent_IPv4Lost);
 
-    UpdateInternetConnectivityState();
+    mInternetTracker.OnNetifChanged();
 
     ChipDeviceEvent event;
     event.Type                           = DeviceEventType::kInterfaceIpAddressChanged;
@@ -696,7 +753,7 @@ void ConnectivityManagerImpl::OnStationIPv4AddressLost(void)
 
 void ConnectivityManagerImpl::OnStationIPv6AddressAvailable(void)
 {
-    UpdateInternetConnectivityState();
+    mInternetTracker.OnNetifChanged();
 
     ChipDeviceEvent event;
     event.Type                           = DeviceEventType::kInterfaceIpAddressChanged;
@@ -0,0 +1,249 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/DeferredLog.h>
+
+#include <lib/support/Base64.h>
+#include <lib/support/CodeUtils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "atbm_general.h"
+
+extern "C" void Console_SetPolling(int polling);
+extern "C" void Console_Putc(unsigned char data);
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr size_t kMaxModuleLen  = 15;
+constexpr size_t kMaxPayloadLen = CHIP_CONFIG_LOG_MESSAGE_MAX_SIZE;
+// Base64 output chunk: 48 payload bytes -> 64 characters.
+constexpr size_t kBase64Chunk = 48;
+// Upper bound on how long Flush() waits for the drain task to finish its record.
+constexpr uint32_t kFlushTimeoutMs = 100;
+
+struct RecordHeader
+{
+    uint16_t PayloadLen;
+    uint8_t Type;
+    uint8_t ModuleLen;
+};
+
+uint8_t sRing[CHIP_DEVICE_CONFIG_LOG_RING_SIZE];
+size_t sHead; // Next byte written.
+size_t sTail; // Next byte read.
+size_t sUsed;
+uint32_t sDropped;
+uint32_t sDroppedReported;
+
+TaskHandle_t sDrainTask;
+SemaphoreHandle_t sDataAvailable;
+SemaphoreHandle_t sDrainLock;
+
+// Only touched with sDrainLock held.
+struct
+{
+    RecordHeader Header;
+    char Module[kMaxModuleLen + 1];
+    uint8_t Payload[kMaxPayloadLen];
+} sOutRecord;
+
+void RingWrite(const void * data, size_t len)
+{
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+    size_t first          = sizeof(sRing) - sHead;
+
+    if (len < first)
+    {
+        first = len;
+    }
+    memcpy(&sRing[sHead], bytes, first);
+    memcpy(&sRing[0], bytes + first, len - first);
+    sHead = (sHead + len) % sizeof(sRing);
+    sUsed += len;
+}
+
+void RingRead(void * data, size_t len)
+{
+    uint8_t * bytes = static_cast<uint8_t *>(data);
+    size_t first    = sizeof(sRing) - sTail;
+
+    if (len < first)
+    {
+        first = len;
+    }
+    memcpy(bytes, &sRing[sTail], first);
+    memcpy(bytes + first, &sRing[0], len - first);
+    sTail = (sTail + len) % sizeof(sRing);
+    sUsed -= len;
+}
+
+void ConsoleWrite(const char * data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        Console_Putc(static_cast<unsigned char>(data[i]));
+    }
+}
+
+void EmitRecord(const char * module, size_t moduleLen, uint8_t type, const uint8_t * payload, size_t len)
+{
+    Console_SetPolling(1);
+    ConsoleWrite("\n[", 2);
+    ConsoleWrite(module, moduleLen);
+    ConsoleWrite("] ", 2);
+    if (type == DeferredLog::kRecord_Tokenized)
+    {
+        char encoded[BASE64_ENCODED_LEN(kBase64Chunk)];
+
+        ConsoleWrite("$", 1);
+        for (size_t offset = 0; offset < len; offset += kBase64Chunk)
+        {
+            size_t chunk = (len - offset < kBase64Chunk) ? len - offset : kBase64Chunk;
+            ConsoleWrite(encoded, Base64Encode(payload + offset, static_cast<uint16_t>(chunk), encoded));
+        }
+    }
+    else
+    {
+        ConsoleWrite(reinterpret_cast<const char *>(payload), len);
+    }
+    ConsoleWrite("\r\n", 2);
+    Console_SetPolling(0);
+}
+
+// Pops and prints one record. Must be called with sDrainLock held.
+bool DrainOne()
+{
+    uint32_t dropped;
+
+    taskENTER_CRITICAL();
+    if (sUsed == 0)
+    {
+        taskEXIT_CRITICAL();
+        return false;
+    }
+    RingRead(&sOutRecord.Header, sizeof(sOutRecord.Header));
+    RingRead(sOutRecord.Module, sOutRecord.Header.ModuleLen);
+    RingRead(sOutRecord.Payload, sOutRecord.Header.PayloadLen);
+    dropped = sDropped - sDroppedReported;
+    sDroppedReported += dropped;
+    taskEXIT_CRITICAL();
+
+    if (dropped > 0)
+    {
+        char notice[48];
+        int len = snprintf(notice, sizeof(notice), "%lu log records dropped", static_cast<unsigned long>(dropped));
+        EmitRecord("DL", 2, DeferredLog::kRecord_Text, reinterpret_cast<const uint8_t *>(notice), static_cast<size_t>(len));
+    }
+    EmitRecord(sOutRecord.Module, sOutRecord.Header.ModuleLen, sOutRecord.Header.Type, sOutRecord.Payload,
+               sOutRecord.Header.PayloadLen);
+    return true;
+}
+
+void DrainTaskMain(void * arg)
+{
+    for (;;)
+    {
+        xSemaphoreTake(sDataAvailable, portMAX_DELAY);
+
+        xSemaphoreTake(sDrainLock, portMAX_DELAY);
+        while (DrainOne())
+        {
+        }
+        xSemaphoreGive(sDrainLock);
+    }
+}
+
+} // namespace
+
+CHIP_ERROR DeferredLog::Start()
+{
+    VerifyOrReturnError(sDrainTask == nullptr, CHIP_NO_ERROR);
+
+    sDataAvailable = xSemaphoreCreateBinary();
+    sDrainLock     = xSemaphoreCreateMutex();
+    VerifyOrReturnError(sDataAvailable != nullptr && sDrainLock != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    VerifyOrReturnError(xTaskCreate(DrainTaskMain, CHIP_DEVICE_CONFIG_LOG_TASK_NAME,
+                                    CHIP_DEVICE_CONFIG_LOG_TASK_STACK_SIZE / sizeof(StackType_t), nullptr,
+                                    CHIP_DEVICE_CONFIG_LOG_TASK_PRIORITY, &sDrainTask) == pdPASS,
+                        CHIP_ERROR_NO_MEMORY);
+    return CHIP_NO_ERROR;
+}
+
+void DeferredLog::Log(const char * module, RecordType type, const void * payload, size_t len)
+{
+    RecordHeader header;
+    size_t moduleLen = strnlen(module, kMaxModuleLen);
+
+    if (len > kMaxPayloadLen)
+    {
+        len = kMaxPayloadLen;
+    }
+
+    if (sDrainTask == nullptr || hal_in_irq())
+    {
+        EmitRecord(module, moduleLen, type, static_cast<const uint8_t *>(payload), len);
+        return;
+    }
+
+    header.PayloadLen = static_cast<uint16_t>(len);
+    header.Type       = type;
+    header.ModuleLen  = static_cast<uint8_t>(moduleLen);
+
+    taskENTER_CRITICAL();
+    if (sizeof(sRing) - sUsed < sizeof(header) + moduleLen + len)
+    {
+        sDropped++;
+        taskEXIT_CRITICAL();
+        return;
+    }
+    RingWrite(&header, sizeof(header));
+    RingWrite(module, moduleLen);
+    RingWrite(payload, len);
+    taskEXIT_CRITICAL();
+
+    xSemaphoreGive(sDataAvailable);
+}
+
+void DeferredLog::Flush()
+{
+    VerifyOrReturn(sDrainTask != nullptr);
+
+    VerifyOrReturn(xSemaphoreTake(sDrainLock, pdMS_TO_TICKS(kFlushTimeoutMs)) == pdTRUE);
+    while (DrainOne())
+    {
+    }
+    xSemaphoreGive(sDrainLock);
+}
+
+uint32_t DeferredLog::GetDroppedCount()
+{
+    return sDropped;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,69 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Ring-buffered console logging for ATBM platforms
+ *          (CHIP_DEVICE_CONFIG_LOG_DEFERRED).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Decouples log producers from the UART.
+ *
+ * Log() copies the record into a RAM ring and returns; a low priority task drains the
+ * ring to the console. When the ring is full the record is dropped and counted, and the
+ * drain task reports the number of dropped records with the next record it prints.
+ *
+ * Tokenized records (CHIP_PW_TOKENIZER_LOGGING) are kept in binary form and printed as
+ * pw_tokenizer prefixed Base64 ("$...") for detokenization on the host.
+ *
+ * Before Start(), and from interrupt context, records are written to the console
+ * synchronously.
+ */
+class DeferredLog
+{
+public:
+    enum RecordType : uint8_t
+    {
+        kRecord_Text = 0,
+        kRecord_Tokenized,
+    };
+
+    static CHIP_ERROR Start();
+
+    static void Log(const char * module, RecordType type, const void * payload, size_t len);
+
+    /** Drains the ring on the calling task, e.g. before a reboot. */
+    static void Flush();
+
+    static uint32_t GetDroppedCount();
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -28,9 +28,15 @@
 #include <platform/DiagnosticDataProvider.h>
 #include <platform/atbm/DiagnosticDataProviderImpl.h>
 #include <platform/atbm/ATBMUtils.h>
+#include <platform/atbm/HeapTracker.h>
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+#include <platform/atbm/TaskProfiler.h>
+#endif
 
 #include "atbm_general.h"
 
+#include <new>
+
 using namespace ::chip;
 using namespace ::chip::TLV;
 using namespace ::chip::DeviceLayer;
@@ -87,9 +93,63 @@ CHIP_ERROR DiagnosticDataProviderImpl::GetCurrentHeapUsed(uint64_t & currentHeap
 
 CHIP_ERROR DiagnosticDataProviderImpl::GetCurrentHeapHighWatermark(uint64_t & currentHeapHighWatermark)
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+    currentHeapHighWatermark = HeapTracker::GetHighWatermark();
+    return CHIP_NO_ERROR;
+#else
     return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
+#endif
 }
 
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+CHIP_ERROR DiagnosticDataProviderImpl::ResetWatermarks()
+{
+    HeapTracker::ResetWatermarks();
+    return CHIP_NO_ERROR;
+}
+#endif
+
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+CHIP_ERROR DiagnosticDataProviderImpl::GetThreadMetrics(ThreadMetrics ** threadMetricsOut)
+{
+    // Only read on the CHIP thread.
+    static TaskProfiler::TaskSample sTasks[TaskProfiler::kMaxTasks];
+    ThreadMetrics * head = nullptr;
+
+    size_t count = TaskProfiler::ReadTasks(sTasks, ArraySize(sTasks));
+    for (size_t i = count; i > 0; i--)
+    {
+        const TaskProfiler::TaskSample & task = sTasks[i - 1];
+        ThreadMetrics * thread                = Platform::New<ThreadMetrics>();
+        if (thread == nullptr)
+        {
+            ReleaseThreadMetrics(head);
+            return CHIP_ERROR_NO_MEMORY;
+        }
+
+        Platform::CopyString(thread->NameBuf, task.Name);
+        thread->name.Emplace(CharSpan::fromCharString(thread->NameBuf));
+        thread->id = task.Number;
+        thread->stackFreeMinimum.Emplace(task.StackFreeMinBytes);
+        thread->Next = head;
+        head         = thread;
+    }
+
+    *threadMetricsOut = head;
+    return CHIP_NO_ERROR;
+}
+
+void DiagnosticDataProviderImpl::ReleaseThreadMetrics(ThreadMetrics * threadMetrics)
+{
+    while (threadMetrics)
+    {
+        ThreadMetrics * del = threadMetrics;
+        threadMetrics       = threadMetrics->Next;
+        Platform::Delete(del);
+    }
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+
 CHIP_ERROR DiagnosticDataProviderImpl::GetRebootCount(uint16_t & rebootCount)
 {
     uint32_t count = 0;
@@ -131,7 +191,10 @@ CHIP_ERROR DiagnosticDataProviderImpl::GetBootReason(BootReasonType & bootReason
 
 CHIP_ERROR DiagnosticDataProviderImpl::GetNetworkInterfaces(NetworkInterface ** netifpp)
 {
-    NetworkInterface * ifp = new NetworkInterface();
+    void * mem = HeapTracker::Alloc(HeapTracker::kTag_NetIf, sizeof(NetworkInterface));
+    VerifyOrReturnError(mem != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    NetworkInterface * ifp = new (mem) NetworkInterface();
     struct netif * netif     = atbm_wifi_get_sta_netif();
     if (netif == NULL)
     {
@@ -173,7 +236,8 @@ void DiagnosticDataProviderImpl::ReleaseNetworkInterfaces(NetworkInterface * net
     {
         NetworkInterface * del = netifp;
         netifp                 = netifp->Next;
-        delete del;
+        del->~NetworkInterface();
+        HeapTracker::Free(del);
     }
 }
 
@@ -255,6 +319,13 @@ CHIP_ERROR DiagnosticDataProviderImpl::GetWiFiOverrunCount(uint64_t & overrunCou
 
 CHIP_ERROR DiagnosticDataProviderImpl::ResetWiFiNetworkDiagnosticsCounts()
 {
+    ConnectivityMgrImpl().ResetWiFiReconnectCounters();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DiagnosticDataProviderImpl::GetWiFiReconnectCounters(WiFiReconnectCounters & counters)
+{
+    counters = ConnectivityMgrImpl().GetWiFiReconnectCounters();
     return CHIP_NO_ERROR;
 }
 #endif // CHIP_DEVICE_CONFIG_ENABLE_WIFI
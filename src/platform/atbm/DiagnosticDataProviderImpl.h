@@ -25,6 +25,9 @@
 #include <memory>
 
 #include <platform/DiagnosticDataProvider.h>
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
+#include <platform/atbm/WiFiReconnectPolicy.h>
+#endif
 
 namespace chip {
 namespace DeviceLayer {
@@ -42,6 +45,15 @@ public:
     CHIP_ERROR GetCurrentHeapFree(uint64_t & currentHeapFree) override;
     CHIP_ERROR GetCurrentHeapUsed(uint64_t & currentHeapUsed) override;
     CHIP_ERROR GetCurrentHeapHighWatermark(uint64_t & currentHeapHighWatermark) override;
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+    bool SupportsWatermarks() override { return true; }
+    CHIP_ERROR ResetWatermarks() override;
+#endif
+
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+    CHIP_ERROR GetThreadMetrics(ThreadMetrics ** threadMetricsOut) override;
+    void ReleaseThreadMetrics(ThreadMetrics * threadMetrics) override;
+#endif
 
     CHIP_ERROR GetRebootCount(uint16_t & rebootCount) override;
     CHIP_ERROR GetUpTime(uint64_t & upTime) override;
@@ -65,6 +77,10 @@ public:
     CHIP_ERROR GetWiFiCurrentMaxRate(uint64_t & currentMaxRate) override;
     CHIP_ERROR GetWiFiOverrunCount(uint64_t & overrunCount) override;
     CHIP_ERROR ResetWiFiNetworkDiagnosticsCounts() override;
+
+    // ===== Platform-specific diagnostics.
+
+    CHIP_ERROR GetWiFiReconnectCounters(WiFiReconnectCounters & counters);
 #endif // CHIP_DEVICE_CONFIG_ENABLE_WIFI
 };
 
@@ -22,6 +22,7 @@
 #include <platform/CHIPDeviceLayer.h>
 
 #include <ATBMConfig.h>
+#include <platform/atbm/HeapTracker.h>
 #include <lwip/ip4_addr.h>
 #include <lwip/ip6_addr.h>
 #include <lwip/netifapi.h>
@@ -189,7 +190,12 @@ int mdns_responder_ops(struct netif * netif)
         }
     }
 
-    items        = static_cast<mdns_txt_item_t *>(chip::Platform::MemoryCalloc(glservice->mTextEntrySize, sizeof(mdns_txt_item_t)));
+    items = static_cast<mdns_txt_item_t *>(
+        HeapTracker::Calloc(HeapTracker::kTag_Dnssd, glservice->mTextEntrySize, sizeof(mdns_txt_item_t)));
+    if (items == nullptr && glservice->mTextEntrySize > 0)
+    {
+        return -1;
+    }
     mdns.txt_cnt = glservice->mTextEntrySize;
     for (size_t i = 0; i < glservice->mTextEntrySize; i++)
     {
@@ -201,11 +207,12 @@ int mdns_responder_ops(struct netif * netif)
 
     if (MDNS_TXT_MAX_LEN < packet_len)
     {
+        HeapTracker::Free(items);
         return -1;
     }
 
     dnssd_txt_resolve(packet, items, glservice->mTextEntrySize);
-    chip::Platform::MemoryFree(items);
+    HeapTracker::Free(items);
 
     iot_printf("name = %s nType = %s protocol = %d port = %d \r\n", glservice->mName, glservice->mType, protocol, glservice->mPort);
     slot = mdns_resp_add_service(netif, glservice->mName, glservice->mType, static_cast<uint8_t>(glservice->mProtocol),
@@ -0,0 +1,149 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/FactoryPartition.h>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
+#include <easyflash.h>
+
+#include "app_flash_param.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+struct Header
+{
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t Count;
+    uint32_t PayloadLen;
+    uint32_t Crc32; // ef_calc_crc32() of the payload.
+};
+
+static_assert(sizeof(Header) == 16, "FactoryPartition header layout is generated on the host");
+
+constexpr size_t kEntryHeaderLen = 4;
+
+// Indexed by tag; a null value marks an absent tag.
+const uint8_t * sValues[FactoryPartition::kTag_Max];
+uint16_t sLengths[FactoryPartition::kTag_Max];
+bool sPresent;
+
+} // namespace
+
+CHIP_ERROR FactoryPartition::Init()
+{
+    return Init(ByteSpan(reinterpret_cast<const uint8_t *>(CHIP_DEVICE_CONFIG_FACTORY_PARTITION_ADDR),
+                         CHIP_DEVICE_CONFIG_FACTORY_PARTITION_SIZE));
+}
+
+CHIP_ERROR FactoryPartition::Init(ByteSpan image)
+{
+    Header header;
+
+    sPresent = false;
+    memset(sValues, 0, sizeof(sValues));
+    memset(sLengths, 0, sizeof(sLengths));
+
+    VerifyOrReturnError(image.size() >= sizeof(header), CHIP_ERROR_INVALID_ARGUMENT);
+    memcpy(&header, image.data(), sizeof(header));
+
+    // An erased sector reads as all ones: no partition was written.
+    VerifyOrReturnError(header.Magic == kMagic, CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND);
+    VerifyOrReturnError(header.Version == kVersion, CHIP_ERROR_VERSION_MISMATCH);
+    VerifyOrReturnError(header.PayloadLen <= image.size() - sizeof(header), CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+
+    const uint8_t * payload = image.data() + sizeof(header);
+    VerifyOrReturnError(ef_calc_crc32(0, payload, header.PayloadLen) == header.Crc32, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
+    size_t offset = 0;
+    for (uint16_t i = 0; i < header.Count; i++)
+    {
+        VerifyOrReturnError(offset + kEntryHeaderLen <= header.PayloadLen, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+        uint16_t tag = Encoding::LittleEndian::Get16(payload + offset);
+        uint16_t len = Encoding::LittleEndian::Get16(payload + offset + 2);
+        offset += kEntryHeaderLen;
+        VerifyOrReturnError(header.PayloadLen - offset >= len, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+
+        // Unknown tags come from a newer generator; skip them.
+        if (tag > 0 && tag < kTag_Max)
+        {
+            sValues[tag]  = payload + offset;
+            sLengths[tag] = len;
+        }
+        offset += (len + 3u) & ~3u;
+    }
+
+    sPresent = true;
+    ChipLogProgress(DeviceLayer, "Factory partition: %u entries, %u bytes", header.Count,
+                    static_cast<unsigned>(header.PayloadLen));
+    return CHIP_NO_ERROR;
+}
+
+bool FactoryPartition::IsPresent()
+{
+    return sPresent;
+}
+
+CHIP_ERROR FactoryPartition::Get(Tag tag, ByteSpan & value)
+{
+    VerifyOrReturnError(tag < kTag_Max && sValues[tag] != nullptr, CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND);
+    value = ByteSpan(sValues[tag], sLengths[tag]);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FactoryPartition::Get(Tag tag, uint32_t & value)
+{
+    ByteSpan span;
+    ReturnErrorOnFailure(Get(tag, span));
+    VerifyOrReturnError(span.size() == sizeof(uint32_t), CHIP_ERROR_INVALID_INTEGER_VALUE);
+    value = Encoding::LittleEndian::Get32(span.data());
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FactoryPartition::GetString(Tag tag, char * buf, size_t bufSize, size_t & outLen)
+{
+    ByteSpan span;
+    ReturnErrorOnFailure(Get(tag, span));
+    VerifyOrReturnError(span.size() < bufSize, CHIP_ERROR_BUFFER_TOO_SMALL);
+    memcpy(buf, span.data(), span.size());
+    buf[span.size()] = '\0';
+    outLen           = span.size();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FactoryPartition::CopyTo(Tag tag, MutableByteSpan & buf)
+{
+    ByteSpan span;
+    ReturnErrorOnFailure(Get(tag, span));
+    return CopySpanToMutableSpan(span, buf);
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,103 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Read-only factory data partition for ATBM platforms
+ *          (CHIP_DEVICE_CONFIG_ENABLE_FACTORY_PARTITION).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Index over the factory data partition written at manufacturing time by
+ * scripts/tools/atbm/gen_factory_partition.py.
+ *
+ * The partition is a 16 byte header (magic, version, entry count, payload length and the
+ * CRC-32 of the payload) followed by TLV entries: a 16 bit tag, a 16 bit length and the
+ * value, padded to 4 bytes.  Values are stored decoded (no Base64), integers little endian.
+ * Flash is memory mapped, so Init() checks the CRC once and records where each value
+ * lives; Get() then returns a span pointing into flash without copying.
+ */
+class FactoryPartition
+{
+public:
+    // Keep in sync with scripts/tools/atbm/gen_factory_partition.py.
+    enum Tag : uint16_t
+    {
+        kTag_Discriminator = 1,    // u32
+        kTag_Spake2pIterationCount, // u32
+        kTag_Spake2pSalt,
+        kTag_Spake2pVerifier,
+        kTag_DACCert,
+        kTag_DACPrivateKey,
+        kTag_DACPublicKey,
+        kTag_PAICert,
+        kTag_CertDeclaration,
+        kTag_VendorName,
+        kTag_VendorId, // u32
+        kTag_ProductName,
+        kTag_ProductId, // u32
+        kTag_ProductURL,
+        kTag_ProductLabel,
+        kTag_HardwareVersionString,
+        kTag_HardwareVersion, // u32
+        kTag_RotatingDevIdUniqueId,
+        kTag_SerialNumber,
+        kTag_ManufacturingDate, // "YYYY-MM-DD"
+        kTag_PartNumber,
+        kTag_ProductFinish, // u32
+        kTag_ProductColor,  // u32
+        kTag_Max,
+    };
+
+    static constexpr uint32_t kMagic   = 0x50444641; // "AFDP"
+    static constexpr uint16_t kVersion = 1;
+
+    /** Validates and indexes the partition at CHIP_DEVICE_CONFIG_FACTORY_PARTITION_ADDR. */
+    static CHIP_ERROR Init();
+
+    /** Validates and indexes a partition image at an arbitrary address, which must stay valid. */
+    static CHIP_ERROR Init(ByteSpan image);
+
+    /** True once Init() found a valid partition. */
+    static bool IsPresent();
+
+    /** Returns CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND when the tag is absent. */
+    static CHIP_ERROR Get(Tag tag, ByteSpan & value);
+    static CHIP_ERROR Get(Tag tag, uint32_t & value);
+
+    /** Copies a string value and NUL terminates it; outLen excludes the terminator. */
+    static CHIP_ERROR GetString(Tag tag, char * buf, size_t bufSize, size_t & outLen);
+
+    /** Copies a binary value into buf and reduces buf to its size. */
+    static CHIP_ERROR CopyTo(Tag tag, MutableByteSpan & buf);
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,265 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/FlashTrace.h>
+
+#include <lib/support/CodeUtils.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <easyflash.h>
+
+#include "timers.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+static_assert(sizeof(FlashTrace::Record) == 20, "FlashTrace::Record layout is decoded on the host");
+static_assert(sizeof(FlashTrace::Record) % 4 == 0, "ef_log_write() writes whole words");
+
+constexpr size_t kRingRecords = CHIP_DEVICE_CONFIG_FLASH_TRACE_RING_RECORDS;
+// Records copied out of the ring per ef_log_write() call.
+constexpr size_t kBlockRecords               = 16;
+constexpr uint32_t kCheckpointLockTimeoutMs = 100;
+
+FlashTrace::Record sRing[kRingRecords];
+size_t sHead;    // Next record written.
+size_t sPending; // Records not yet persisted, ending at sHead.
+uint32_t sLost;  // Pending records overwritten since the last checkpoint.
+uint32_t sLostTotal;
+
+// Only touched with sCheckpointLock held.
+FlashTrace::Record sBlock[kBlockRecords + 1];
+
+SemaphoreHandle_t sCheckpointLock;
+TimerHandle_t sCheckpointTimer;
+bool sCheckpointScheduled; // A periodic checkpoint is queued on the CHIP thread.
+
+uint32_t NowMs()
+{
+    return static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+void Seal(FlashTrace::Record & record)
+{
+    const uint8_t * bytes = reinterpret_cast<const uint8_t *>(&record);
+    uint8_t check         = 0;
+
+    record.Magic = FlashTrace::kRecordMagic;
+    record.Check = 0;
+    for (size_t i = 0; i < sizeof(record); i++)
+    {
+        check ^= bytes[i];
+    }
+    record.Check = check;
+}
+
+void FillRecord(FlashTrace::Record & record, uint16_t event, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    record.Event       = event;
+    record.TimestampMs = NowMs();
+    record.Args[0]     = arg0;
+    record.Args[1]     = arg1;
+    record.Args[2]     = arg2;
+}
+
+void PeriodicCheckpointWork(intptr_t context)
+{
+    taskENTER_CRITICAL();
+    sCheckpointScheduled = false;
+    taskEXIT_CRITICAL();
+
+    FlashTrace::Checkpoint(FlashTrace::kReason_Periodic);
+}
+
+// Runs on the timer daemon, which the SDK also uses for its own timers; ef_log_write() may
+// erase a flash sector, so only post the checkpoint to the CHIP thread from here.
+void CheckpointTimerHandler(TimerHandle_t timer)
+{
+    bool schedule;
+
+    taskENTER_CRITICAL();
+    schedule             = !sCheckpointScheduled;
+    sCheckpointScheduled = true;
+    taskEXIT_CRITICAL();
+
+    if (schedule && PlatformMgr().ScheduleWork(PeriodicCheckpointWork) != CHIP_NO_ERROR)
+    {
+        taskENTER_CRITICAL();
+        sCheckpointScheduled = false;
+        taskEXIT_CRITICAL();
+    }
+}
+
+} // namespace
+
+CHIP_ERROR FlashTrace::Init()
+{
+    VerifyOrReturnError(sCheckpointLock == nullptr, CHIP_NO_ERROR);
+
+    sCheckpointLock = xSemaphoreCreateMutex();
+    VerifyOrReturnError(sCheckpointLock != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    sCheckpointTimer = xTimerCreate("TRACE", pdMS_TO_TICKS(CHIP_DEVICE_CONFIG_FLASH_TRACE_CHECKPOINT_INTERVAL), pdTRUE, nullptr,
+                                    CheckpointTimerHandler);
+    VerifyOrReturnError(sCheckpointTimer != nullptr, CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(xTimerStart(sCheckpointTimer, 0) == pdPASS, CHIP_ERROR_INTERNAL);
+
+    Trace(kEvent_Boot, CHIP_CONFIG_SOFTWARE_VERSION_NUMBER);
+    return CHIP_NO_ERROR;
+}
+
+void FlashTrace::Trace(uint16_t event, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    taskENTER_CRITICAL();
+    FillRecord(sRing[sHead], event, arg0, arg1, arg2);
+    sHead = (sHead + 1) % kRingRecords;
+    if (sPending < kRingRecords)
+    {
+        sPending++;
+    }
+    else
+    {
+        sLost++;
+        sLostTotal++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void FlashTrace::Checkpoint(CheckpointReason reason)
+{
+    bool fatal   = (reason == kReason_Abort || reason == kReason_Fault || reason == kReason_Watchdog);
+    size_t count = 0;
+    size_t remaining;
+    uint32_t lost;
+
+    VerifyOrReturn(sCheckpointLock != nullptr);
+    VerifyOrReturn(xSemaphoreTake(sCheckpointLock, fatal ? 0 : pdMS_TO_TICKS(kCheckpointLockTimeoutMs)) == pdTRUE);
+
+    // Only persist what is pending now, so that a burst of new records cannot keep us here.
+    taskENTER_CRITICAL();
+    remaining = sPending;
+    lost      = sLost;
+    sLost     = 0;
+    taskEXIT_CRITICAL();
+
+    if (remaining == 0 && lost == 0 && reason == kReason_Periodic)
+    {
+        xSemaphoreGive(sCheckpointLock);
+        return;
+    }
+    if (lost > 0)
+    {
+        FillRecord(sBlock[count++], kEvent_Lost, lost, 0, 0);
+    }
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        // Records may have been overwritten since remaining was sampled.
+        if (remaining > sPending)
+        {
+            remaining = sPending;
+        }
+        while (count < kBlockRecords && remaining > 0)
+        {
+            sBlock[count++] = sRing[(sHead + kRingRecords - sPending) % kRingRecords];
+            sPending--;
+            remaining--;
+        }
+        taskEXIT_CRITICAL();
+
+        // The checkpoint record closes the flush; sBlock has room for it.
+        if (remaining == 0)
+        {
+            FillRecord(sBlock[count++], kEvent_Checkpoint, reason, 0, 0);
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            Seal(sBlock[i]);
+        }
+        if (ef_log_write(reinterpret_cast<const uint32_t *>(sBlock), count * sizeof(Record)) != EF_NO_ERR || remaining == 0)
+        {
+            break;
+        }
+        count = 0;
+    }
+
+    xSemaphoreGive(sCheckpointLock);
+}
+
+CHIP_ERROR FlashTrace::Clean()
+{
+    VerifyOrReturnError(sCheckpointLock != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(xSemaphoreTake(sCheckpointLock, pdMS_TO_TICKS(kCheckpointLockTimeoutMs)) == pdTRUE, CHIP_ERROR_BUSY);
+    EfErrCode err = ef_log_clean();
+    xSemaphoreGive(sCheckpointLock);
+    return (err == EF_NO_ERR) ? CHIP_NO_ERROR : CHIP_ERROR_WRITE_FAILED;
+}
+
+CHIP_ERROR FlashTrace::ReadFlash(size_t offset, void * buf, size_t len)
+{
+    VerifyOrReturnError(sCheckpointLock != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(offset % 4 == 0 && len % 4 == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(xSemaphoreTake(sCheckpointLock, pdMS_TO_TICKS(kCheckpointLockTimeoutMs)) == pdTRUE, CHIP_ERROR_BUSY);
+    EfErrCode err = ef_log_read(offset, static_cast<uint32_t *>(buf), len);
+    xSemaphoreGive(sCheckpointLock);
+    return (err == EF_NO_ERR) ? CHIP_NO_ERROR : CHIP_ERROR_READ_FAILED;
+}
+
+size_t FlashTrace::GetFlashUsedSize()
+{
+    return ef_log_get_used_size();
+}
+
+size_t FlashTrace::GetFlashTotalSize()
+{
+    return ef_log_get_total_size();
+}
+
+size_t FlashTrace::GetPendingCount()
+{
+    return sPending;
+}
+
+uint32_t FlashTrace::GetLostCount()
+{
+    return sLostTotal;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
+
+extern "C" void atbm_flash_trace_checkpoint(uint32_t reason)
+{
+    chip::DeviceLayer::Internal::FlashTrace::Checkpoint(
+        static_cast<chip::DeviceLayer::Internal::FlashTrace::CheckpointReason>(reason));
+}
+
+extern "C" void atbm_flash_trace_abort(void)
+{
+    chip::DeviceLayer::Internal::FlashTrace::Checkpoint(chip::DeviceLayer::Internal::FlashTrace::kReason_Abort);
+    abort();
+}
@@ -0,0 +1,135 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Binary event trace persisted to the EasyFlash log area on ATBM platforms
+ *          (CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Post-mortem event recorder.
+ *
+ * Trace() stores a fixed size record (event id, milliseconds since boot and up to three
+ * arguments) in a RAM ring; it does not format anything and only takes a short critical
+ * section.  Checkpoint() appends the records not yet persisted to the EasyFlash log area
+ * (ef_log_write), which is itself a ring of flash sectors.  Checkpoints are taken
+ * periodically on the CHIP thread, before deliberate reboots, on chipDie()/VerifyOrDie(), and by the SDK
+ * fault and watchdog handlers through atbm_flash_trace_checkpoint().
+ *
+ * When the RAM ring overflows between checkpoints the oldest records are overwritten and
+ * counted; the count is persisted as a kEvent_Lost record.  Records are decoded on the
+ * host with scripts/tools/atbm/decode_flash_trace.py.
+ *
+ * Trace() must not be called from interrupt context.
+ */
+class FlashTrace
+{
+public:
+    // Event ids below 0x8000 are reserved for the platform; applications use the rest.
+    // Keep in sync with scripts/tools/atbm/decode_flash_trace.py.
+    enum EventId : uint16_t
+    {
+        kEvent_Boot = 0x0001, // software version
+        kEvent_Checkpoint,    // reason
+        kEvent_Lost,          // records overwritten before they were persisted
+        kEvent_WiFiConnected = 0x0100,
+        kEvent_WiFiDisconnected, // reason code
+        kEvent_WiFiReconnect,    // reason code, delay ms, retry class
+        kEvent_IPv4Up,
+        kEvent_IPv4Lost,
+        kEvent_BLEConnected = 0x0200, // connection handle
+        kEvent_BLEDisconnected,       // connection handle, HCI reason
+        kEvent_BLEIndicationFailed,   // connection handle, status
+        kEvent_AppBase = 0x8000,
+    };
+
+    enum CheckpointReason : uint32_t
+    {
+        kReason_Periodic = 0,
+        kReason_Reboot,
+        kReason_Abort,
+        kReason_Fault,
+        kReason_Watchdog,
+        kReason_Shell,
+    };
+
+    struct Record
+    {
+        uint8_t Magic;
+        uint8_t Check; // XOR of all other bytes.
+        uint16_t Event;
+        uint32_t TimestampMs;
+        uint32_t Args[3];
+    };
+
+    static constexpr uint8_t kRecordMagic = 0xA5;
+
+    static CHIP_ERROR Init();
+
+    static void Trace(uint16_t event, uint32_t arg0 = 0, uint32_t arg1 = 0, uint32_t arg2 = 0);
+
+    /**
+     * Persists the pending records.  For kReason_Abort, kReason_Fault and kReason_Watchdog
+     * the checkpoint is skipped rather than waited for if another one is in progress.
+     */
+    static void Checkpoint(CheckpointReason reason);
+
+    /** Erases the flash log area. */
+    static CHIP_ERROR Clean();
+
+    /**
+     * Reads persisted trace data, oldest first.  offset and len must be multiples of 4.
+     * The area may start in the middle of a record once the oldest sector was recycled.
+     */
+    static CHIP_ERROR ReadFlash(size_t offset, void * buf, size_t len);
+    static size_t GetFlashUsedSize();
+    static size_t GetFlashTotalSize();
+
+    static size_t GetPendingCount();
+    static uint32_t GetLostCount();
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
+
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+#define ATBM_FLASH_TRACE(event, ...)                                                                                               \
+    ::chip::DeviceLayer::Internal::FlashTrace::Trace(::chip::DeviceLayer::Internal::FlashTrace::event, ##__VA_ARGS__)
+#else
+#define ATBM_FLASH_TRACE(event, ...)                                                                                               \
+    do                                                                                                                             \
+    {                                                                                                                              \
+    } while (0)
+#endif
+
+extern "C" {
+/** Checkpoint hook for the SDK fault and watchdog handlers; reason is a FlashTrace::CheckpointReason. */
+void atbm_flash_trace_checkpoint(uint32_t reason);
+}
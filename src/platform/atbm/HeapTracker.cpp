@@ -0,0 +1,317 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/HeapTracker.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <lwip/stats.h>
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "atbm_general.h"
+#include "task.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+const char * const kTagNames[HeapTracker::kTag_Max] = { "chip", "config", "dnssd", "ota", "wifi", "netif" };
+
+// Trial allocations stop once the largest free block is known to this precision.
+constexpr uint32_t kProbeGranularity = 64;
+
+uint32_t HeapUsed()
+{
+    return sys_mem_total_size_get() - sys_mem_free_size_get();
+}
+
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+
+struct BlockHeader
+{
+    uint32_t Size;
+    uint16_t Magic;
+    uint8_t Tag;
+};
+
+// Keeps the block returned to the caller aligned as malloc() would.
+constexpr size_t kHeaderSize = (sizeof(BlockHeader) + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+constexpr uint16_t kBlockMagic = 0xA7B4;
+
+HeapTracker::TagStats sTagStats[HeapTracker::kTag_Max];
+uint32_t sHighWatermark;
+
+BlockHeader * HeaderOf(void * ptr)
+{
+    return reinterpret_cast<BlockHeader *>(static_cast<uint8_t *>(ptr) - kHeaderSize);
+}
+
+void * Track(void * block, HeapTracker::Tag tag, size_t size)
+{
+    HeapTracker::TagStats & stats = sTagStats[tag];
+
+    if (block == nullptr)
+    {
+        taskENTER_CRITICAL();
+        stats.Failures++;
+        taskEXIT_CRITICAL();
+        return nullptr;
+    }
+
+    BlockHeader * header = static_cast<BlockHeader *>(block);
+    header->Size         = static_cast<uint32_t>(size);
+    header->Magic        = kBlockMagic;
+    header->Tag          = tag;
+
+    // Sampled outside the critical section, the SDK heap takes its own lock.
+    uint32_t used = HeapUsed();
+
+    taskENTER_CRITICAL();
+    stats.Allocs++;
+    stats.CurrentBytes += header->Size;
+    if (stats.CurrentBytes > stats.PeakBytes)
+    {
+        stats.PeakBytes = stats.CurrentBytes;
+    }
+    if (used > sHighWatermark)
+    {
+        sHighWatermark = used;
+    }
+    taskEXIT_CRITICAL();
+
+    return static_cast<uint8_t *>(block) + kHeaderSize;
+}
+
+void Untrack(BlockHeader * header)
+{
+    HeapTracker::TagStats & stats = sTagStats[header->Tag];
+
+    taskENTER_CRITICAL();
+    stats.Frees++;
+    stats.CurrentBytes -= header->Size;
+    taskEXIT_CRITICAL();
+
+    header->Magic = 0;
+}
+
+bool IsTracked(BlockHeader * header)
+{
+    if (header->Magic != kBlockMagic || header->Tag >= HeapTracker::kTag_Max)
+    {
+        // A block from plain malloc() or a corrupted header; leaking it is the safe option.
+        ChipLogError(DeviceLayer, "HeapTracker: untracked block %p", reinterpret_cast<uint8_t *>(header) + kHeaderSize);
+        return false;
+    }
+    return true;
+}
+
+#endif // CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+
+uint32_t ProbeLargestFreeBlock(uint32_t freeBytes)
+{
+    uint32_t low  = 0;
+    uint32_t high = freeBytes;
+
+    // Best effort: the SDK does not document how its heap locks, so malloc() is not called
+    // with the scheduler suspended.  Other tasks can allocate or free between the trials, so
+    // the result is approximate, and an allocation of theirs can fail while a trial block is
+    // held.
+    while (high - low > kProbeGranularity)
+    {
+        uint32_t size = low + (high - low) / 2;
+        void * block  = malloc(size);
+        if (block != nullptr)
+        {
+            free(block);
+            low = size;
+        }
+        else
+        {
+            high = size;
+        }
+    }
+    return low;
+}
+
+} // namespace
+
+#if CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+
+void * HeapTracker::Alloc(Tag tag, size_t size)
+{
+    return Track(malloc(kHeaderSize + size), tag, size);
+}
+
+void * HeapTracker::Calloc(Tag tag, size_t num, size_t size)
+{
+    VerifyOrReturnValue(size == 0 || num <= (SIZE_MAX - kHeaderSize) / size, nullptr);
+    void * ptr = Alloc(tag, num * size);
+    if (ptr != nullptr)
+    {
+        memset(ptr, 0, num * size);
+    }
+    return ptr;
+}
+
+void * HeapTracker::Realloc(Tag tag, void * ptr, size_t size)
+{
+    VerifyOrReturnValue(ptr != nullptr, Alloc(tag, size));
+
+    BlockHeader * header = HeaderOf(ptr);
+    VerifyOrReturnValue(IsTracked(header), nullptr);
+
+    // The old block stays valid, and accounted, if realloc() fails.
+    tag         = static_cast<Tag>(header->Tag);
+    void * next = realloc(header, kHeaderSize + size);
+    VerifyOrReturnValue(next != nullptr, Track(nullptr, tag, size));
+
+    // realloc() copied the header, which still describes the old block.
+    Untrack(static_cast<BlockHeader *>(next));
+    return Track(next, tag, size);
+}
+
+void HeapTracker::Free(void * ptr)
+{
+    VerifyOrReturn(ptr != nullptr);
+
+    BlockHeader * header = HeaderOf(ptr);
+    VerifyOrReturn(IsTracked(header));
+    Untrack(header);
+    free(header);
+}
+
+void HeapTracker::GetTagStats(Tag tag, TagStats & stats)
+{
+    memset(&stats, 0, sizeof(stats));
+    VerifyOrReturn(tag < kTag_Max);
+
+    taskENTER_CRITICAL();
+    stats = sTagStats[tag];
+    taskEXIT_CRITICAL();
+}
+
+uint32_t HeapTracker::GetHighWatermark()
+{
+    uint32_t used = HeapUsed();
+
+    taskENTER_CRITICAL();
+    if (used > sHighWatermark)
+    {
+        sHighWatermark = used;
+    }
+    used = sHighWatermark;
+    taskEXIT_CRITICAL();
+
+    return used;
+}
+
+void HeapTracker::ResetWatermarks()
+{
+    uint32_t used = HeapUsed();
+
+    taskENTER_CRITICAL();
+    sHighWatermark = used;
+    for (TagStats & stats : sTagStats)
+    {
+        stats.PeakBytes = stats.CurrentBytes;
+    }
+    taskEXIT_CRITICAL();
+}
+
+#else // CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+
+void * HeapTracker::Alloc(Tag tag, size_t size)
+{
+    return malloc(size);
+}
+
+void * HeapTracker::Calloc(Tag tag, size_t num, size_t size)
+{
+    return calloc(num, size);
+}
+
+void * HeapTracker::Realloc(Tag tag, void * ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+void HeapTracker::Free(void * ptr)
+{
+    free(ptr);
+}
+
+void HeapTracker::GetTagStats(Tag tag, TagStats & stats)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint32_t HeapTracker::GetHighWatermark()
+{
+    return 0;
+}
+
+void HeapTracker::ResetWatermarks() {}
+
+#endif // CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING
+
+const char * HeapTracker::GetTagName(Tag tag)
+{
+    return (tag < kTag_Max) ? kTagNames[tag] : "?";
+}
+
+void HeapTracker::GetHeapInfo(HeapInfo & info)
+{
+    memset(&info, 0, sizeof(info));
+
+    info.TotalBytes       = sys_mem_total_size_get();
+    info.FreeBytes        = sys_mem_free_size_get();
+    info.HighWatermark    = GetHighWatermark();
+    info.LargestFreeBlock = ProbeLargestFreeBlock(info.FreeBytes);
+    if (info.FreeBytes > 0)
+    {
+        info.FragmentationPermille =
+            static_cast<uint16_t>(1000 - static_cast<uint64_t>(info.LargestFreeBlock) * 1000 / info.FreeBytes);
+    }
+
+    for (uint8_t tag = 0; tag < kTag_Max; tag++)
+    {
+        TagStats stats;
+        GetTagStats(static_cast<Tag>(tag), stats);
+        info.TrackedBytes += stats.CurrentBytes;
+    }
+
+#if LWIP_STATS && MEM_STATS
+    // With MEM_LIBC_MALLOC, lwIP keeps these counters only when built with MEM_STATS.
+    info.LwipStats     = true;
+    info.LwipBytes     = lwip_stats.mem.used;
+    info.LwipPeakBytes = lwip_stats.mem.max;
+#endif
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
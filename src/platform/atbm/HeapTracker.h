@@ -0,0 +1,105 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Tagged heap allocations with per-subsystem accounting on ATBM platforms
+ *          (CHIP_DEVICE_CONFIG_ENABLE_HEAP_TRACKING).
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Allocator shim for the heap allocations of this layer and, through
+ * Platform::MemoryAlloc(), of the CHIP stack.  With tracking enabled every block carries
+ * a small header holding its size and tag, so that current and peak bytes can be kept
+ * per tag; the heap high watermark is sampled on each tracked allocation.  Without
+ * tracking the functions map straight onto malloc()/free().
+ *
+ * Blocks from Alloc()/Calloc()/Realloc() must be released with Free(), never free().
+ * All functions may be called from any task.
+ */
+class HeapTracker
+{
+public:
+    enum Tag : uint8_t
+    {
+        kTag_Chip = 0, // Platform::MemoryAlloc() and friends.
+        kTag_Config,   // ATBMConfig read buffers.
+        kTag_Dnssd,    // mDNS TXT items.
+        kTag_Ota,      // OTA image blocks.
+        kTag_WiFi,     // Scan results.
+        kTag_NetIf,    // General Diagnostics network interfaces.
+        kTag_Max,
+    };
+
+    struct TagStats
+    {
+        uint32_t CurrentBytes;
+        uint32_t PeakBytes;
+        uint32_t Allocs;
+        uint32_t Frees;
+        uint32_t Failures;
+    };
+
+    struct HeapInfo
+    {
+        uint32_t TotalBytes;
+        uint32_t FreeBytes;
+        uint32_t HighWatermark;    // Largest used size seen, 0 without tracking.
+        uint32_t LargestFreeBlock; // Largest allocatable block, found by probing.
+        uint16_t FragmentationPermille;
+        uint32_t TrackedBytes; // Sum of the current bytes of all tags.
+        bool LwipStats;        // Whether lwIP reports its own usage (MEM_STATS).
+        uint32_t LwipBytes;
+        uint32_t LwipPeakBytes;
+    };
+
+    static void * Alloc(Tag tag, size_t size);
+    static void * Calloc(Tag tag, size_t num, size_t size);
+    /** Resizes a block; a null ptr allocates a block with the given tag, otherwise the tag is kept. */
+    static void * Realloc(Tag tag, void * ptr, size_t size);
+    static void Free(void * ptr);
+
+    /** Copies the counters of a tag, consistent with respect to concurrent updates. */
+    static void GetTagStats(Tag tag, TagStats & stats);
+    static const char * GetTagName(Tag tag);
+
+    /**
+     * Snapshot of the whole heap.  Finding the largest free block takes a binary search of
+     * trial allocations, so this is meant for diagnostics, not for periodic polling.  The
+     * search runs alongside the other tasks, so LargestFreeBlock is approximate.
+     */
+    static void GetHeapInfo(HeapInfo & info);
+
+    /** Largest heap usage seen since boot or the last ResetWatermarks(). */
+    static uint32_t GetHighWatermark();
+
+    /** Restarts the heap and per-tag peaks from the current usage. */
+    static void ResetWatermarks();
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
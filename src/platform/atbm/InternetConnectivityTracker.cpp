@@ -0,0 +1,393 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/atbm/ATBMUtils.h>
+#include <platform/atbm/InternetConnectivityTracker.h>
+#include <platform/atbm/PowerGovernor.h>
+#if CONFIG_ENABLE_ROUTE_HOOK
+#include <platform/atbm/route_hook/atbm_route_hook.h>
+#endif
+
+#include <lwip/dns.h>
+#include <lwip/ip_addr.h>
+#include <lwip/nd6.h>
+#include <lwip/tcpip.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+InternetConnectivityTracker * sTracker = nullptr;
+#if LWIP_NETIF_EXT_STATUS_CALLBACK
+netif_ext_callback_t sNetifExtCallback;
+bool sNetifChangePending = false;
+#endif
+#if CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+// Written by the TCP/IP thread before the result is handed over to the CHIP thread.
+ip_addr_t sProbeAddr;
+
+void * ProbeArg(uint8_t generation)
+{
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(generation));
+}
+#endif
+} // namespace
+
+void InternetConnectivityTracker::Init(ChangeHandler handler)
+{
+    sTracker       = this;
+    mChangeHandler = handler;
+
+#if LWIP_NETIF_EXT_STATUS_CALLBACK
+    LOCK_TCPIP_CORE();
+    netif_add_ext_callback(&sNetifExtCallback, HandleNetifExtStatus);
+    UNLOCK_TCPIP_CORE();
+#endif
+#if CONFIG_ENABLE_ROUTE_HOOK
+    atbm_route_hook_set_ra_callback(HandleRouterAdvertisement);
+#endif
+}
+
+void InternetConnectivityTracker::OnNetifChanged()
+{
+    struct netif * netif = ATBMUtils::GetStationNetif();
+    bool linkUp          = false;
+    bool haveIPv4        = false;
+    bool haveDnsServer   = false;
+    uint8_t ipv6Mask     = 0;
+
+    LOCK_TCPIP_CORE();
+    if (netif != NULL && netif_is_up(netif) && netif_is_link_up(netif))
+    {
+        linkUp        = true;
+        haveDnsServer = !ip_addr_isany_val(*dns_getserver(0));
+        haveIPv4      = !ip4_addr_isany_val(*netif_ip4_addr(netif)) && !ip4_addr_isany_val(*netif_ip4_gw(netif));
+        if (haveIPv4)
+        {
+            mIPv4Address = Inet::IPAddress(*netif_ip4_addr(netif));
+        }
+        for (uint8_t i = 0; i < LWIP_IPV6_NUM_ADDRESSES; i++)
+        {
+            if (ip6_addr_isglobal(netif_ip6_addr(netif, i)) && ip6_addr_isvalid(netif_ip6_addr_state(netif, i)))
+            {
+                ipv6Mask |= static_cast<uint8_t>(1u << i);
+            }
+        }
+    }
+    UNLOCK_TCPIP_CORE();
+
+    if (!linkUp)
+    {
+        // Forget everything learnt on the previous link straight away, so a stale
+        // "connected" state does not hold up failover.
+        DeviceLayer::SystemLayer().CancelTimer(HandleRouterExpired, this);
+        mHaveDefaultRouter       = false;
+        mRouterFromAdvertisement = false;
+        mProbeState              = ProbeState::kUnknown;
+#if CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+        CancelProbe();
+#endif
+    }
+
+    // Without router advertisements, check the default route once when a global address appears.
+    if (ipv6Mask != 0 && mIPv6GlobalAddressMask == 0 && !mRouterFromAdvertisement)
+    {
+        UpdateDefaultRouter(netif);
+    }
+
+    mLinkUp                = linkUp;
+    mHaveIPv4              = haveIPv4;
+    mHaveDnsServer         = haveDnsServer;
+    mIPv6GlobalAddressMask = ipv6Mask;
+
+    NotifyChange();
+}
+
+void InternetConnectivityTracker::UpdateDefaultRouter(struct netif * netif)
+{
+    LOCK_TCPIP_CORE();
+    struct netif * routeNetif = nd6_find_route(IP6_ADDR_ANY6);
+    mHaveDefaultRouter        = (routeNetif != NULL && netif != NULL && routeNetif->num == netif->num);
+    UNLOCK_TCPIP_CORE();
+}
+
+void InternetConnectivityTracker::OnRouterAdvertisement(uint16_t routerLifetimeSec)
+{
+    mRouterFromAdvertisement = true;
+    mHaveDefaultRouter       = (routerLifetimeSec != 0);
+    if (mHaveDefaultRouter)
+    {
+        DeviceLayer::SystemLayer().StartTimer(System::Clock::Seconds32(routerLifetimeSec), HandleRouterExpired, this);
+    }
+    else
+    {
+        DeviceLayer::SystemLayer().CancelTimer(HandleRouterExpired, this);
+    }
+    NotifyChange();
+}
+
+void InternetConnectivityTracker::HandleRouterExpired(System::Layer * aLayer, void * aAppState)
+{
+    auto * self = static_cast<InternetConnectivityTracker *>(aAppState);
+
+    ChipLogProgress(DeviceLayer, "Default IPv6 router lifetime expired");
+    self->mHaveDefaultRouter = false;
+    self->NotifyChange();
+}
+
+bool InternetConnectivityTracker::HasIPv4Connectivity() const
+{
+    return mLinkUp && mHaveDnsServer && mHaveIPv4 && mProbeState != ProbeState::kUnreachable;
+}
+
+bool InternetConnectivityTracker::HasIPv6Connectivity() const
+{
+    return mLinkUp && mHaveDnsServer && mIPv6GlobalAddressMask != 0 && mHaveDefaultRouter &&
+        mProbeState != ProbeState::kUnreachable;
+}
+
+void InternetConnectivityTracker::NotifyChange()
+{
+#if CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+    bool haveAddress = mLinkUp && mHaveDnsServer && (mHaveIPv4 || mIPv6GlobalAddressMask != 0);
+    if (haveAddress && mProbeState == ProbeState::kUnknown && !mProbeInProgress)
+    {
+        StartProbe();
+    }
+    else if (!haveAddress)
+    {
+        DeviceLayer::SystemLayer().CancelTimer(HandleProbeTimer, this);
+    }
+#endif
+
+    if (mChangeHandler != nullptr)
+    {
+        mChangeHandler();
+    }
+}
+
+#if LWIP_NETIF_EXT_STATUS_CALLBACK
+void InternetConnectivityTracker::HandleNetifExtStatus(struct netif * netif, netif_nsc_reason_t reason,
+                                                       const netif_ext_callback_args_t * args)
+{
+    constexpr netif_nsc_reason_t kRelevantReasons = LWIP_NSC_LINK_CHANGED | LWIP_NSC_STATUS_CHANGED |
+        LWIP_NSC_IPV4_SETTINGS_CHANGED | LWIP_NSC_IPV6_SET | LWIP_NSC_IPV6_ADDR_STATE_CHANGED;
+
+    // Runs in the TCP/IP thread: hand over to the CHIP thread, coalescing bursts of changes.
+    VerifyOrReturn(netif == ATBMUtils::GetStationNetif() && (reason & kRelevantReasons) != 0);
+    VerifyOrReturn(!sNetifChangePending);
+    sNetifChangePending = true;
+    if (PlatformMgr().ScheduleWork(HandleNetifChangedWork, 0) != CHIP_NO_ERROR)
+    {
+        sNetifChangePending = false;
+    }
+}
+
+void InternetConnectivityTracker::HandleNetifChangedWork(intptr_t arg)
+{
+    sNetifChangePending = false;
+    VerifyOrReturn(sTracker != nullptr);
+    sTracker->OnNetifChanged();
+}
+#endif // LWIP_NETIF_EXT_STATUS_CALLBACK
+
+#if CONFIG_ENABLE_ROUTE_HOOK
+void InternetConnectivityTracker::HandleRouterAdvertisement(struct netif * netif, uint16_t routerLifetimeSec)
+{
+    // Runs in the TCP/IP thread.
+    VerifyOrReturn(netif == ATBMUtils::GetStationNetif());
+    PlatformMgr().ScheduleWork(HandleRouterAdvertisementWork, static_cast<intptr_t>(routerLifetimeSec));
+}
+
+void InternetConnectivityTracker::HandleRouterAdvertisementWork(intptr_t arg)
+{
+    VerifyOrReturn(sTracker != nullptr);
+    sTracker->OnRouterAdvertisement(static_cast<uint16_t>(arg));
+}
+#endif // CONFIG_ENABLE_ROUTE_HOOK
+
+#if CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+void InternetConnectivityTracker::StartProbe()
+{
+    ip_addr_t addr;
+    err_t err;
+
+    VerifyOrReturn(!mProbeInProgress);
+    mProbeInProgress = true;
+    mProbeGeneration++;
+    DeviceLayer::SystemLayer().StartTimer(System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_INTERNET_PROBE_TIMEOUT),
+                                          HandleProbeTimeout, this);
+
+    // The lookup may be answered from the lwIP DNS cache; the connection made with its
+    // result is what proves reachability.
+    LOCK_TCPIP_CORE();
+    err = dns_gethostbyname(CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST, &addr, HandleProbeDnsFound, ProbeArg(mProbeGeneration));
+    UNLOCK_TCPIP_CORE();
+
+    if (err == ERR_OK)
+    {
+        ConnectProbe(addr);
+    }
+    else if (err != ERR_INPROGRESS)
+    {
+        OnProbeResult(false);
+    }
+}
+
+void InternetConnectivityTracker::ConnectProbe(const ip_addr_t & addr)
+{
+    err_t err = ERR_MEM;
+
+    LOCK_TCPIP_CORE();
+    mProbePcb = tcp_new_ip_type(IP_GET_TYPE(&addr));
+    if (mProbePcb != nullptr)
+    {
+        tcp_arg(mProbePcb, ProbeArg(mProbeGeneration));
+        tcp_err(mProbePcb, HandleProbeError);
+        err = tcp_connect(mProbePcb, &addr, CHIP_DEVICE_CONFIG_INTERNET_PROBE_PORT, HandleProbeConnected);
+    }
+    UNLOCK_TCPIP_CORE();
+
+    if (err != ERR_OK)
+    {
+        ChipLogError(DeviceLayer, "Internet probe: connect failed: %d", err);
+        OnProbeResult(false);
+    }
+}
+
+void InternetConnectivityTracker::OnProbeResult(bool reachable)
+{
+    // The previous result stays in effect until the new probe completes.
+    VerifyOrReturn(mProbeInProgress);
+    CancelProbe();
+
+    ProbeState state = reachable ? ProbeState::kReachable : ProbeState::kUnreachable;
+    if (state != mProbeState)
+    {
+        ChipLogProgress(DeviceLayer, "Internet probe: %s %s", CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST,
+                        reachable ? "reachable" : "unreachable");
+    }
+    mProbeState = state;
+    PowerGovernor::StartDeferrableTimer(System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_INTERNET_PROBE_INTERVAL), HandleProbeTimer,
+                                        this);
+    if (mChangeHandler != nullptr)
+    {
+        mChangeHandler();
+    }
+}
+
+void InternetConnectivityTracker::CancelProbe()
+{
+    DeviceLayer::SystemLayer().CancelTimer(HandleProbeTimeout, this);
+    // Under the lock: the TCP/IP thread clears mProbePcb when it frees the pcb.
+    LOCK_TCPIP_CORE();
+    if (mProbePcb != nullptr)
+    {
+        tcp_arg(mProbePcb, nullptr);
+        tcp_err(mProbePcb, nullptr);
+        tcp_abort(mProbePcb);
+        mProbePcb = nullptr;
+    }
+    UNLOCK_TCPIP_CORE();
+    // Results of the cancelled probe still queued for the CHIP thread are ignored.
+    mProbeGeneration++;
+    mProbeInProgress = false;
+}
+
+void InternetConnectivityTracker::HandleProbeTimer(System::Layer * aLayer, void * aAppState)
+{
+    auto * self = static_cast<InternetConnectivityTracker *>(aAppState);
+    VerifyOrReturn(self->mLinkUp);
+    self->StartProbe();
+}
+
+void InternetConnectivityTracker::HandleProbeTimeout(System::Layer * aLayer, void * aAppState)
+{
+    auto * self = static_cast<InternetConnectivityTracker *>(aAppState);
+
+    ChipLogError(DeviceLayer, "Internet probe: no answer from %s", CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST);
+    self->OnProbeResult(false);
+}
+
+void InternetConnectivityTracker::HandleProbeDnsFound(const char * name, const ip_addr_t * ipaddr, void * callbackArg)
+{
+    // Runs in the TCP/IP thread.
+    uintptr_t generation = reinterpret_cast<uintptr_t>(callbackArg);
+    if (ipaddr != nullptr)
+    {
+        sProbeAddr = *ipaddr;
+    }
+    PlatformMgr().ScheduleWork(HandleProbeDnsWork, static_cast<intptr_t>(generation | ((ipaddr != nullptr) ? 0x100 : 0)));
+}
+
+void InternetConnectivityTracker::HandleProbeDnsWork(intptr_t arg)
+{
+    VerifyOrReturn(sTracker != nullptr && sTracker->mProbeInProgress && sTracker->mProbePcb == nullptr);
+    VerifyOrReturn(static_cast<uint8_t>(arg) == sTracker->mProbeGeneration);
+
+    if ((arg & 0x100) == 0)
+    {
+        sTracker->OnProbeResult(false);
+        return;
+    }
+    sTracker->ConnectProbe(sProbeAddr);
+}
+
+err_t InternetConnectivityTracker::HandleProbeConnected(void * arg, struct tcp_pcb * pcb, err_t err)
+{
+    // Runs in the TCP/IP thread.  The completed handshake is all the probe needs, so the
+    // connection is reset straight away.
+    uintptr_t generation = reinterpret_cast<uintptr_t>(arg);
+
+    tcp_err(pcb, nullptr);
+    tcp_abort(pcb);
+    if (sTracker != nullptr && sTracker->mProbePcb == pcb)
+    {
+        sTracker->mProbePcb = nullptr;
+    }
+    PlatformMgr().ScheduleWork(HandleProbeResultWork, static_cast<intptr_t>(generation | 0x100));
+    return ERR_ABRT;
+}
+
+void InternetConnectivityTracker::HandleProbeError(void * arg, err_t err)
+{
+    // Runs in the TCP/IP thread; lwIP has already freed the pcb.
+    uintptr_t generation = reinterpret_cast<uintptr_t>(arg);
+
+    if (sTracker != nullptr)
+    {
+        sTracker->mProbePcb = nullptr;
+    }
+    PlatformMgr().ScheduleWork(HandleProbeResultWork, static_cast<intptr_t>(generation));
+}
+
+void InternetConnectivityTracker::HandleProbeResultWork(intptr_t arg)
+{
+    VerifyOrReturn(sTracker != nullptr);
+    VerifyOrReturn(static_cast<uint8_t>(arg) == sTracker->mProbeGeneration);
+    sTracker->OnProbeResult((arg & 0x100) != 0);
+}
+#endif // CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
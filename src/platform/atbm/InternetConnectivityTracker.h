@@ -0,0 +1,118 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Incremental tracking of the Internet connectivity of the WiFi station
+ *          interface on ATBM platforms.
+ */
+
+#pragma once
+
+#include <inet/IPAddress.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+#include <lwip/netif.h>
+#include <lwip/tcp.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Keeps the connectivity-relevant state of the station netif (link, IPv4 address and
+ * gateway, DNS server, valid global IPv6 addresses, default IPv6 router) up to date from
+ * change notifications, so that reading it is O(1).
+ *
+ * Notifications come from the ATBM WiFi/IP events, from lwIP netif extended status
+ * callbacks when lwIP is built with LWIP_NETIF_EXT_STATUS_CALLBACK, and from router
+ * advertisements seen by the route hook.  Optionally an active probe
+ * (CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED) confirms that the Internet is actually
+ * reachable by opening a TCP connection to CHIP_DEVICE_CONFIG_INTERNET_PROBE_HOST; unlike
+ * the name lookup, the handshake cannot be answered from a cache.  The result is kept for
+ * CHIP_DEVICE_CONFIG_INTERNET_PROBE_INTERVAL.
+ *
+ * All methods must be called from the CHIP thread.
+ */
+class InternetConnectivityTracker
+{
+public:
+    using ChangeHandler = void (*)();
+
+    void Init(ChangeHandler handler);
+
+    /** Re-reads the station netif after a link or address change. */
+    void OnNetifChanged();
+
+    /** Records the router lifetime (in seconds) of a router advertisement; 0 withdraws the router. */
+    void OnRouterAdvertisement(uint16_t routerLifetimeSec);
+
+    bool HasIPv4Connectivity() const;
+    bool HasIPv6Connectivity() const;
+    const Inet::IPAddress & GetIPv4Address() const { return mIPv4Address; }
+
+private:
+    enum class ProbeState : uint8_t
+    {
+        kUnknown,
+        kReachable,
+        kUnreachable,
+    };
+
+    void UpdateDefaultRouter(struct netif * netif);
+    void NotifyChange();
+    static void HandleRouterExpired(System::Layer * aLayer, void * aAppState);
+#if LWIP_NETIF_EXT_STATUS_CALLBACK
+    static void HandleNetifExtStatus(struct netif * netif, netif_nsc_reason_t reason, const netif_ext_callback_args_t * args);
+    static void HandleNetifChangedWork(intptr_t arg);
+#endif
+#if CONFIG_ENABLE_ROUTE_HOOK
+    static void HandleRouterAdvertisement(struct netif * netif, uint16_t routerLifetimeSec);
+    static void HandleRouterAdvertisementWork(intptr_t arg);
+#endif
+#if CHIP_DEVICE_CONFIG_INTERNET_PROBE_ENABLED
+    void StartProbe();
+    void ConnectProbe(const ip_addr_t & addr);
+    void OnProbeResult(bool reachable);
+    void CancelProbe();
+    static void HandleProbeTimer(System::Layer * aLayer, void * aAppState);
+    static void HandleProbeTimeout(System::Layer * aLayer, void * aAppState);
+    static void HandleProbeDnsFound(const char * name, const ip_addr_t * ipaddr, void * callbackArg);
+    static void HandleProbeDnsWork(intptr_t arg);
+    static err_t HandleProbeConnected(void * arg, struct tcp_pcb * pcb, err_t err);
+    static void HandleProbeError(void * arg, err_t err);
+    static void HandleProbeResultWork(intptr_t arg);
+#endif
+
+    ChangeHandler mChangeHandler = nullptr;
+    Inet::IPAddress mIPv4Address;
+    uint8_t mIPv6GlobalAddressMask = 0;
+    bool mLinkUp                   = false;
+    bool mHaveIPv4                 = false;
+    bool mHaveDnsServer            = false;
+    bool mHaveDefaultRouter        = false;
+    bool mRouterFromAdvertisement  = false;
+    ProbeState mProbeState         = ProbeState::kUnknown;
+    bool mProbeInProgress          = false;
+    uint8_t mProbeGeneration       = 0;
+    struct tcp_pcb * mProbePcb     = nullptr;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
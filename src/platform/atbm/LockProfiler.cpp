@@ -0,0 +1,234 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/LockProfiler.h>
+
+#include <string.h>
+
+#include "atbm_general.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr uint32_t kWaitBucketLimitsUs[LockProfiler::kWaitBuckets - 1] = { 10, 100, 1000, 10000, 100000 };
+
+TaskHandle_t sTaskHandles[LockProfiler::kMaxTasks];
+char sTaskNames[LockProfiler::kMaxTasks][configMAX_TASK_NAME_LEN];
+uint8_t sTaskCount;
+
+LockProfiler::LockStats sLockStats[LockProfiler::kLock_Max];
+uint32_t sHoldStartUs[LockProfiler::kLock_Max];
+uint8_t sHolder[LockProfiler::kLock_Max];
+
+LockProfiler::TraceRecord sTrace[LockProfiler::kTraceDepth];
+uint32_t sTraceCount; // Total records appended since the last reset.
+
+size_t WaitBucket(uint32_t waitUs)
+{
+    size_t bucket = 0;
+    while (bucket < ArraySize(kWaitBucketLimitsUs) && waitUs >= kWaitBucketLimitsUs[bucket])
+    {
+        bucket++;
+    }
+    return bucket;
+}
+
+} // namespace
+
+uint32_t LockProfiler::Now()
+{
+    return static_cast<uint32_t>(::hal_get_os_us_time());
+}
+
+uint8_t LockProfiler::FindOrAddCurrentTask()
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    for (uint8_t i = 0; i < sTaskCount; i++)
+    {
+        if (sTaskHandles[i] == self)
+        {
+            return i;
+        }
+    }
+    if (sTaskCount >= kMaxTasks)
+    {
+        return kNoTask;
+    }
+
+    sTaskHandles[sTaskCount] = self;
+    strncpy(sTaskNames[sTaskCount], pcTaskGetTaskName(self), configMAX_TASK_NAME_LEN - 1);
+    sTaskNames[sTaskCount][configMAX_TASK_NAME_LEN - 1] = '\0';
+    return sTaskCount++;
+}
+
+void LockProfiler::AppendTrace(uint32_t timestampUs, LockId lock, TraceEvent event, uint8_t task)
+{
+    TraceRecord & record = sTrace[sTraceCount % kTraceDepth];
+
+    record.TimestampUs = timestampUs;
+    record.Lock        = lock;
+    record.Event       = event;
+    record.Task        = task;
+    sTraceCount++;
+}
+
+void LockProfiler::OnAcquired(LockId lock, bool contended, uint32_t waitStartUs)
+{
+    uint32_t now    = Now();
+    uint32_t waitUs = contended ? now - waitStartUs : 0;
+
+    taskENTER_CRITICAL();
+
+    LockStats & stats = sLockStats[lock];
+    uint8_t task      = FindOrAddCurrentTask();
+
+    stats.Acquires++;
+    stats.WaitHistogram[WaitBucket(waitUs)]++;
+    if (contended)
+    {
+        stats.Contended++;
+        AppendTrace(waitStartUs, lock, kTrace_Wait, task);
+    }
+    if (waitUs > stats.MaxWaitUs)
+    {
+        stats.MaxWaitUs = waitUs;
+    }
+    if (task != kNoTask)
+    {
+        TaskStats & taskStats = stats.Tasks[task];
+
+        taskStats.Acquires++;
+        taskStats.TotalWaitUs += waitUs;
+        if (contended)
+        {
+            taskStats.Contended++;
+        }
+        if (waitUs > taskStats.MaxWaitUs)
+        {
+            taskStats.MaxWaitUs = waitUs;
+        }
+    }
+
+    sHoldStartUs[lock] = now;
+    sHolder[lock]      = task;
+    AppendTrace(now, lock, kTrace_Acquire, task);
+
+    taskEXIT_CRITICAL();
+}
+
+void LockProfiler::OnRelease(LockId lock)
+{
+    uint32_t now = Now();
+
+    taskENTER_CRITICAL();
+
+    LockStats & stats = sLockStats[lock];
+    uint32_t holdUs   = now - sHoldStartUs[lock];
+
+    if (holdUs > stats.MaxHoldUs)
+    {
+        stats.MaxHoldUs   = holdUs;
+        stats.MaxHoldTask = sHolder[lock];
+    }
+    AppendTrace(now, lock, kTrace_Release, sHolder[lock]);
+
+    taskEXIT_CRITICAL();
+}
+
+void LockProfiler::GetLockStats(LockId lock, LockStats & stats)
+{
+    taskENTER_CRITICAL();
+    stats = sLockStats[lock];
+    taskEXIT_CRITICAL();
+}
+
+const char * LockProfiler::GetTaskName(uint8_t task)
+{
+    return (task < sTaskCount) ? sTaskNames[task] : "?";
+}
+
+const char * LockProfiler::GetLockName(LockId lock)
+{
+    switch (lock)
+    {
+    case kLock_LwIPCore:
+        return "lwip";
+    case kLock_ChipStack:
+        return "chip";
+    default:
+        return "?";
+    }
+}
+
+const char * LockProfiler::GetTraceEventName(uint8_t event)
+{
+    switch (event)
+    {
+    case kTrace_Wait:
+        return "wait";
+    case kTrace_Acquire:
+        return "acquire";
+    case kTrace_Release:
+        return "release";
+    default:
+        return "?";
+    }
+}
+
+size_t LockProfiler::GetTrace(TraceRecord * records, size_t maxRecords, uint32_t * dropped)
+{
+    taskENTER_CRITICAL();
+
+    size_t available = (sTraceCount < kTraceDepth) ? sTraceCount : kTraceDepth;
+    size_t count     = (available < maxRecords) ? available : maxRecords;
+    uint32_t first   = sTraceCount - static_cast<uint32_t>(available);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        records[i] = sTrace[(first + i) % kTraceDepth];
+    }
+    if (dropped != nullptr)
+    {
+        *dropped = first;
+    }
+
+    taskEXIT_CRITICAL();
+    return count;
+}
+
+void LockProfiler::Reset()
+{
+    taskENTER_CRITICAL();
+    for (LockStats & stats : sLockStats)
+    {
+        memset(&stats, 0, sizeof(stats));
+        stats.MaxHoldTask = kNoTask;
+    }
+    sTraceCount = 0;
+    taskEXIT_CRITICAL();
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
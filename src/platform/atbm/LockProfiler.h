@@ -0,0 +1,125 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Contention statistics for the LwIP core lock and the CHIP stack lock
+ *          on ATBM platforms (CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING).
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Records, per profiled lock, how often each task acquires it, how long tasks wait for it
+ * (as a histogram), and the longest hold together with the name of the task that held it.
+ * Every acquire, contended wait and release is also appended to a small trace ring that
+ * can be exported as CSV for offline analysis on the host.
+ *
+ * The lock wrappers call OnAcquired() right after taking the lock and OnRelease() right
+ * before giving it back; the bookkeeping itself runs in a short critical section.
+ */
+class LockProfiler
+{
+public:
+    enum LockId : uint8_t
+    {
+        kLock_LwIPCore = 0,
+        kLock_ChipStack,
+        kLock_Max,
+    };
+
+    enum TraceEvent : uint8_t
+    {
+        kTrace_Wait = 0, // Lock was busy; the record time is when the task started waiting.
+        kTrace_Acquire,
+        kTrace_Release,
+    };
+
+    // Wait histogram bucket upper bounds: <10us, <100us, <1ms, <10ms, <100ms, >=100ms.
+    static constexpr size_t kWaitBuckets = 6;
+    static constexpr size_t kMaxTasks    = 12;
+    static constexpr size_t kTraceDepth  = 128;
+    static constexpr uint8_t kNoTask     = 0xFF;
+
+    struct TaskStats
+    {
+        uint32_t Acquires;
+        uint32_t Contended;
+        uint32_t TotalWaitUs;
+        uint32_t MaxWaitUs;
+    };
+
+    struct LockStats
+    {
+        uint32_t Acquires;
+        uint32_t Contended;
+        uint32_t WaitHistogram[kWaitBuckets];
+        uint32_t MaxWaitUs;
+        uint32_t MaxHoldUs;
+        uint8_t MaxHoldTask; // Index into the task table, kNoTask if unknown.
+        TaskStats Tasks[kMaxTasks];
+    };
+
+    struct TraceRecord
+    {
+        uint32_t TimestampUs;
+        uint8_t Lock;
+        uint8_t Event;
+        uint8_t Task;
+    };
+
+    /** Returns the current time for a subsequent OnAcquired(..., contended = true, waitStartUs). */
+    static uint32_t Now();
+
+    static void OnAcquired(LockId lock, bool contended, uint32_t waitStartUs);
+    static void OnRelease(LockId lock);
+
+    /** Copies the statistics of a lock, consistent with respect to concurrent updates. */
+    static void GetLockStats(LockId lock, LockStats & stats);
+
+    /** Returns the name recorded for a task table index, or "?" for kNoTask. */
+    static const char * GetTaskName(uint8_t task);
+    static const char * GetLockName(LockId lock);
+    static const char * GetTraceEventName(uint8_t event);
+
+    /**
+     * Copies up to maxRecords trace records, oldest first, and returns the number copied.
+     * Records older than the ring depth are lost; the count of lost records is returned in
+     * dropped when not null.
+     */
+    static size_t GetTrace(TraceRecord * records, size_t maxRecords, uint32_t * dropped);
+
+    static void Reset();
+
+private:
+    static uint8_t FindOrAddCurrentTask();
+    static void AppendTrace(uint32_t timestampUs, LockId lock, TraceEvent event, uint8_t task);
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,250 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/LogFilter.h>
+
+#include <lib/support/CodeUtils.h>
+#include <platform/KeyValueStoreManager.h>
+
+#include <string.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr char kLogFilterKeyName[] = "log-filter";
+constexpr uint8_t kLogFilterVersion = 1;
+
+// Twice the number of entries keeps probe sequences short.
+constexpr size_t kSlots = LogFilter::kMaxModules * 2;
+static_assert((kSlots & (kSlots - 1)) == 0, "kSlots must be a power of two");
+
+struct Slot
+{
+    uint32_t Key; // Packed module name, 0 when free.
+    uint8_t Mask;
+};
+
+Slot sSlots[kSlots];
+size_t sModuleCount;
+uint8_t sDefaultMask = LogFilter::kAllCategories;
+
+// Persisted form: version, default mask, count, then count x (name[4], mask).
+struct PersistedEntry
+{
+    char Name[LogFilter::kMaxModuleNameLen];
+    uint8_t Mask;
+};
+
+uint32_t PackName(const char * module)
+{
+    uint32_t key = 0;
+
+    for (size_t i = 0; i < LogFilter::kMaxModuleNameLen && module[i] != '\0'; i++)
+    {
+        key |= static_cast<uint32_t>(static_cast<uint8_t>(module[i])) << (8 * i);
+    }
+    return key;
+}
+
+void UnpackName(uint32_t key, char (&name)[LogFilter::kMaxModuleNameLen + 1])
+{
+    for (size_t i = 0; i < LogFilter::kMaxModuleNameLen; i++)
+    {
+        name[i] = static_cast<char>((key >> (8 * i)) & 0xFF);
+    }
+    name[LogFilter::kMaxModuleNameLen] = '\0';
+}
+
+size_t SlotIndex(uint32_t key)
+{
+    return static_cast<size_t>((key * 2654435761u) >> 16) & (kSlots - 1);
+}
+
+Slot * FindSlot(uint32_t key, bool insert)
+{
+    size_t index = SlotIndex(key);
+
+    for (size_t probes = 0; probes < kSlots; probes++)
+    {
+        Slot & slot = sSlots[index];
+        if (slot.Key == key)
+        {
+            return &slot;
+        }
+        if (slot.Key == 0)
+        {
+            return insert ? &slot : nullptr;
+        }
+        index = (index + 1) & (kSlots - 1);
+    }
+    return nullptr;
+}
+
+uint8_t LevelToMask(uint8_t maxCategory)
+{
+    return (maxCategory >= 7) ? LogFilter::kAllCategories : static_cast<uint8_t>((1u << (maxCategory + 1)) - 1);
+}
+
+CHIP_ERROR SetModuleMask(const char * module, uint8_t mask)
+{
+    uint32_t key = PackName(module);
+    VerifyOrReturnError(key != 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    Slot * slot = FindSlot(key, true);
+    VerifyOrReturnError(slot != nullptr, CHIP_ERROR_NO_MEMORY);
+    if (slot->Key == 0)
+    {
+        VerifyOrReturnError(sModuleCount < LogFilter::kMaxModules, CHIP_ERROR_NO_MEMORY);
+        sModuleCount++;
+    }
+
+    // Readers match the key first, so publish the mask before the key.
+    slot->Mask = mask;
+    slot->Key  = key;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR Store()
+{
+    uint8_t buf[3 + LogFilter::kMaxModules * sizeof(PersistedEntry)];
+    size_t len = 3;
+
+    buf[0] = kLogFilterVersion;
+    buf[1] = sDefaultMask;
+    buf[2] = static_cast<uint8_t>(sModuleCount);
+    for (const Slot & slot : sSlots)
+    {
+        if (slot.Key != 0)
+        {
+            PersistedEntry entry;
+            memcpy(entry.Name, &slot.Key, sizeof(entry.Name));
+            entry.Mask = slot.Mask;
+            memcpy(&buf[len], &entry, sizeof(entry));
+            len += sizeof(entry);
+        }
+    }
+    return PersistedStorage::KeyValueStoreMgr().Put(kLogFilterKeyName, buf, len);
+}
+
+} // namespace
+
+CHIP_ERROR LogFilter::Init()
+{
+    uint8_t buf[3 + kMaxModules * sizeof(PersistedEntry)];
+    size_t len = 0;
+
+    CHIP_ERROR err = PersistedStorage::KeyValueStoreMgr().Get(kLogFilterKeyName, buf, sizeof(buf), &len);
+    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        return CHIP_NO_ERROR;
+    }
+    ReturnErrorOnFailure(err);
+    VerifyOrReturnError(len >= 3 && buf[0] == kLogFilterVersion, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(len == 3 + buf[2] * sizeof(PersistedEntry), CHIP_ERROR_INCORRECT_STATE);
+
+    sDefaultMask = buf[1];
+    for (size_t i = 0; i < buf[2]; i++)
+    {
+        PersistedEntry entry;
+        char name[kMaxModuleNameLen + 1] = {};
+
+        memcpy(&entry, &buf[3 + i * sizeof(entry)], sizeof(entry));
+        memcpy(name, entry.Name, sizeof(entry.Name));
+        ReturnErrorOnFailure(SetModuleMask(name, entry.Mask));
+    }
+    return CHIP_NO_ERROR;
+}
+
+bool LogFilter::IsEnabled(const char * module, uint8_t category)
+{
+    uint8_t mask = sDefaultMask;
+
+    if (sModuleCount > 0)
+    {
+        Slot * slot = FindSlot(PackName(module), false);
+        if (slot != nullptr)
+        {
+            mask = slot->Mask;
+        }
+    }
+    return (category < 8) && (mask & (1u << category)) != 0;
+}
+
+CHIP_ERROR LogFilter::SetLevel(const char * module, uint8_t maxCategory)
+{
+    if (module == nullptr)
+    {
+        sDefaultMask = LevelToMask(maxCategory);
+    }
+    else
+    {
+        ReturnErrorOnFailure(SetModuleMask(module, LevelToMask(maxCategory)));
+    }
+    return Store();
+}
+
+CHIP_ERROR LogFilter::Reset()
+{
+    for (Slot & slot : sSlots)
+    {
+        slot.Key = 0;
+    }
+    sModuleCount = 0;
+    sDefaultMask = kAllCategories;
+
+    CHIP_ERROR err = PersistedStorage::KeyValueStoreMgr().Delete(kLogFilterKeyName);
+    return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+}
+
+uint8_t LogFilter::GetDefaultMask()
+{
+    return sDefaultMask;
+}
+
+void LogFilter::ForEachModule(Visitor visitor, void * context)
+{
+    for (const Slot & slot : sSlots)
+    {
+        if (slot.Key != 0)
+        {
+            char name[kMaxModuleNameLen + 1];
+            UnpackName(slot.Key, name);
+            visitor(name, slot.Mask, context);
+        }
+    }
+}
+
+uint8_t LogFilter::MaskToLevel(uint8_t mask)
+{
+    uint8_t level = 0;
+
+    while (level < 7 && (mask & (1u << (level + 1))) != 0)
+    {
+        level++;
+    }
+    return level;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
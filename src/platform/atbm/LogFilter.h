@@ -0,0 +1,76 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Runtime per-module log level filter for ATBM platforms
+ *          (CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Decides, before a log message is formatted, whether its module and category are
+ * enabled.
+ *
+ * Each module has a bit mask of enabled categories (bit n enables category n, see
+ * lib/support/logging/Constants.h); modules without an entry use the default mask.
+ * Entries live in a small open addressing table keyed by the module name, so a check
+ * costs one hash and, normally, one probe.  The table is persisted in the KVS and
+ * loaded by Init().
+ */
+class LogFilter
+{
+public:
+    static constexpr size_t kMaxModules       = 32;
+    static constexpr size_t kMaxModuleNameLen = 4;
+    static constexpr uint8_t kAllCategories   = 0xFF;
+
+    using Visitor = void (*)(const char * module, uint8_t mask, void * context);
+
+    static CHIP_ERROR Init();
+
+    static bool IsEnabled(const char * module, uint8_t category);
+
+    /**
+     * Enables the categories up to and including maxCategory for a module, or for all
+     * modules without their own entry when module is nullptr, and persists the table.
+     */
+    static CHIP_ERROR SetLevel(const char * module, uint8_t maxCategory);
+
+    /** Removes every module entry, enables all categories and erases the persisted table. */
+    static CHIP_ERROR Reset();
+
+    static uint8_t GetDefaultMask();
+    static void ForEachModule(Visitor visitor, void * context);
+
+    /** Converts a mask back to the highest enabled category, for display. */
+    static uint8_t MaskToLevel(uint8_t mask);
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -4,11 +4,24 @@
 
 #include <lib/core/CHIPConfig.h>
 #include <lib/support/logging/Constants.h>
+#include <platform/CHIPDeviceConfig.h>
 
 #include <stdio.h>
 
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+#include <platform/atbm/DeferredLog.h>
+#if CHIP_PW_TOKENIZER_LOGGING
+#include <lib/support/BytesToHex.h>
+#include <string.h>
+#endif
+#else
 extern "C" void Console_SetPolling(int polling);
 extern "C" void Console_Putc(unsigned char data);
+#endif
+
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+#include <platform/atbm/LogFilter.h>
+#endif
 
 #ifdef LOG_LOCAL_LEVEL
 #undef LOG_LOCAL_LEVEL
@@ -18,6 +31,52 @@ namespace chip {
 namespace Logging {
 namespace Platform {
 
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+void LogV(const char * module, uint8_t category, const char * msg, va_list v)
+{
+	using chip::DeviceLayer::Internal::DeferredLog;
+
+	char formattedMsg[CHIP_CONFIG_LOG_MESSAGE_MAX_SIZE];
+	int len;
+
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+	if (!chip::DeviceLayer::Internal::LogFilter::IsEnabled(module, category))
+	{
+		return;
+	}
+#endif
+
+#if CHIP_PW_TOKENIZER_LOGGING
+	// Tokenized records arrive hex encoded as the single "%s" argument; keep them binary.
+	if (strcmp(msg, "%s") == 0)
+	{
+		va_list args;
+		va_copy(args, v);
+		const char * hex = va_arg(args, const char *);
+		va_end(args);
+
+		size_t recordLen = Encoding::HexToBytes(hex, strlen(hex), reinterpret_cast<uint8_t *>(formattedMsg),
+		                                        sizeof(formattedMsg));
+		if (recordLen > 0)
+		{
+			DeferredLog::Log(module, DeferredLog::kRecord_Tokenized, formattedMsg, recordLen);
+			return;
+		}
+	}
+#endif
+
+	len = vsnprintf(formattedMsg, sizeof(formattedMsg), msg, v);
+	if (len < 0)
+	{
+		return;
+	}
+	if (static_cast<size_t>(len) >= sizeof(formattedMsg))
+	{
+		len = sizeof(formattedMsg) - 1;
+	}
+	DeferredLog::Log(module, DeferredLog::kRecord_Text, formattedMsg, static_cast<size_t>(len));
+}
+#else
 void LogV(const char * module, uint8_t category, const char * msg, va_list v)
 {
 	int i = 0;
@@ -26,6 +85,13 @@ void LogV(const char * module, uint8_t category, const char * msg, va_list v)
 	char outputMsg[CHIP_CONFIG_LOG_MESSAGE_MAX_SIZE+11];
 	char *p = &outputMsg[0];
 
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+	if (!chip::DeviceLayer::Internal::LogFilter::IsEnabled(module, category))
+	{
+		return;
+	}
+#endif
+
 	vsnprintf(formattedMsg, sizeof(formattedMsg), msg, v);
 	len = snprintf(outputMsg, sizeof(outputMsg), "\n[%s] %s\r\n", module, formattedMsg);
 	Console_SetPolling(1);
@@ -35,6 +101,7 @@ void LogV(const char * module, uint8_t category, const char * msg, va_list v)
 	}
 	Console_SetPolling(0);
 }
+#endif // CHIP_DEVICE_CONFIG_LOG_DEFERRED
 
 } // namespace Platform
 } // namespace Logging
@@ -21,6 +21,12 @@
 
 #include <lib/support/logging/CHIPLogging.h>
 
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+#include <platform/atbm/LockProfiler.h>
+
+using chip::DeviceLayer::Internal::LockProfiler;
+#endif
+
 namespace {
 
 SemaphoreHandle_t LwIPCoreLock;
@@ -52,10 +58,25 @@ CHIP_ERROR InitLwIPCoreLock(void)
 
 extern "C" void lock_lwip_core()
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+    if (xSemaphoreTake(LwIPCoreLock, 0) == pdTRUE)
+    {
+        LockProfiler::OnAcquired(LockProfiler::kLock_LwIPCore, false, 0);
+        return;
+    }
+
+    uint32_t waitStartUs = LockProfiler::Now();
+    xSemaphoreTake(LwIPCoreLock, portMAX_DELAY);
+    LockProfiler::OnAcquired(LockProfiler::kLock_LwIPCore, true, waitStartUs);
+#else
     xSemaphoreTake(LwIPCoreLock, portMAX_DELAY);
+#endif
 }
 
 extern "C" void unlock_lwip_core()
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+    LockProfiler::OnRelease(LockProfiler::kLock_LwIPCore);
+#endif
     xSemaphoreGive(LwIPCoreLock);
 }
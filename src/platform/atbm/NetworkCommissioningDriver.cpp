@@ -15,14 +15,18 @@
  *    limitations under the License.
  */
 
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <platform/CHIPDeviceLayer.h>
 #include <platform/atbm/ATBMUtils.h>
+#include <platform/atbm/HeapTracker.h>
 #include <platform/atbm/NetworkCommissioningDriver.h>
+#include <platform/internal/BLEManager.h>
 
 #include "atbm_general.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -35,6 +39,17 @@ namespace NetworkCommissioning {
 namespace {
 constexpr char kWiFiSSIDKeyName[]        = "wifi-ssid";
 constexpr char kWiFiCredentialsKeyName[] = "wifi-pass";
+constexpr char kWiFiFastConnectKeyName[] = "wifi-fast";
+constexpr char kWiFiNetworksKeyName[]    = "wifi-nets";
+
+constexpr uint8_t kWiFiNetworksRecordVersion = 1;
+constexpr size_t kWiFiNetworksRecordMaxSize =
+    2 + kMaxWiFiNetworks * (2 + DeviceLayer::Internal::kMaxWiFiSSIDLength + DeviceLayer::Internal::kMaxWiFiKeyLength);
+
+int DefaultAuthMode(size_t credentialsLen)
+{
+    return credentialsLen == 0 ? KEY_NONE : KEY_WPA2;
+}
 static uint8_t WiFiSSIDStr[DeviceLayer::Internal::kMaxWiFiSSIDLength];
 } // namespace
 
@@ -67,6 +82,27 @@ BitFlags<WiFiSecurityBitmap> ConvertSecurityType(int authMode)
     return securityType;
 }
 
+int GetScanResultAuthMode(const struct atbmwifi_scan_result_info & info)
+{
+    if (!info.encrypt)
+    {
+        return KEY_NONE;
+    }
+    if (info.wpa3Only)
+    {
+        return KEY_WPA3;
+    }
+    if (info.rsn)
+    {
+        return KEY_WPA2;
+    }
+    if (info.wpa)
+    {
+        return KEY_WPA;
+    }
+    return KEY_WEP;
+}
+
 CHIP_ERROR GetConfiguredNetwork(Network & network)
 {
     struct atbmwifi_configure config;
@@ -84,58 +120,124 @@ CHIP_ERROR GetConfiguredNetwork(Network & network)
 
 CHIP_ERROR ATBMWiFiDriver::Init(NetworkStatusChangeCallback * networkStatusChangeCallback)
 {
-    CHIP_ERROR err;
-    size_t ssidLen        = 0;
-    size_t credentialsLen = 0;
+    mpScanCallback         = nullptr;
+    mpConnectCallback      = nullptr;
+    mpStatusChangeCallback = networkStatusChangeCallback;
 
-    err = PersistedStorage::KeyValueStoreMgr().Get(kWiFiCredentialsKeyName, mSavedNetwork.credentials,
-                                                   sizeof(mSavedNetwork.credentials), &credentialsLen);
-    if (err == CHIP_ERROR_NOT_FOUND)
-    {
-        return CHIP_NO_ERROR;
-    }
+    ReturnErrorOnFailure(LoadNetworks());
+
+    size_t fastConnectLen = 0;
+    mFastConnectValid     = PersistedStorage::KeyValueStoreMgr().Get(kWiFiFastConnectKeyName, &mFastConnectInfo,
+                                                                 sizeof(mFastConnectInfo), &fastConnectLen) == CHIP_NO_ERROR &&
+        fastConnectLen == sizeof(mFastConnectInfo);
+
+    memcpy(mStagingNetworks, mSavedNetworks, sizeof(mSavedNetworks));
+    mStagingNetworkCount = mSavedNetworkCount;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ATBMWiFiDriver::LoadNetworks()
+{
+    uint8_t buf[kWiFiNetworksRecordMaxSize];
+    size_t len = 0;
+
+    mSavedNetworkCount = 0;
 
-    err = PersistedStorage::KeyValueStoreMgr().Get(kWiFiSSIDKeyName, mSavedNetwork.ssid, sizeof(mSavedNetwork.ssid), &ssidLen);
+    CHIP_ERROR err = PersistedStorage::KeyValueStoreMgr().Get(kWiFiNetworksKeyName, buf, sizeof(buf), &len);
     if (err == CHIP_ERROR_NOT_FOUND)
     {
-        return CHIP_NO_ERROR;
+        return LoadLegacyNetwork();
     }
-    if (!CanCastTo<uint8_t>(credentialsLen))
+    ReturnErrorOnFailure(err);
+
+    // Record layout: version, count, then per network (in priority order):
+    // ssidLen, ssid, credentialsLen, credentials.
+    VerifyOrReturnError(len >= 2 && buf[0] == kWiFiNetworksRecordVersion && buf[1] <= kMaxWiFiNetworks,
+                        CHIP_ERROR_INCORRECT_STATE);
+    size_t offset = 2;
+    for (uint8_t i = 0; i < buf[1]; i++)
     {
-        return CHIP_ERROR_INCORRECT_STATE;
+        WiFiNetwork & network = mSavedNetworks[i];
+
+        VerifyOrReturnError(offset < len && buf[offset] <= sizeof(network.ssid) && offset + 1 + buf[offset] < len,
+                            CHIP_ERROR_INCORRECT_STATE);
+        network.ssidLen = buf[offset++];
+        memcpy(network.ssid, &buf[offset], network.ssidLen);
+        offset += network.ssidLen;
+
+        VerifyOrReturnError(buf[offset] <= sizeof(network.credentials) && offset + 1 + buf[offset] <= len,
+                            CHIP_ERROR_INCORRECT_STATE);
+        network.credentialsLen = buf[offset++];
+        memcpy(network.credentials, &buf[offset], network.credentialsLen);
+        offset += network.credentialsLen;
     }
-    mSavedNetwork.credentialsLen = static_cast<uint8_t>(credentialsLen);
+    mSavedNetworkCount = buf[1];
+    return CHIP_NO_ERROR;
+}
 
-    if (!CanCastTo<uint8_t>(ssidLen))
-    {
-        return CHIP_ERROR_INCORRECT_STATE;
-    }
-    mSavedNetwork.ssidLen = static_cast<uint8_t>(ssidLen);
+CHIP_ERROR ATBMWiFiDriver::LoadLegacyNetwork()
+{
+    WiFiNetwork & network = mSavedNetworks[0];
+    size_t ssidLen        = 0;
+    size_t credentialsLen = 0;
 
-    mStagingNetwork        = mSavedNetwork;
-    mpScanCallback         = nullptr;
-    mpConnectCallback      = nullptr;
-    mpStatusChangeCallback = networkStatusChangeCallback;
-    return err;
+    CHIP_ERROR err = PersistedStorage::KeyValueStoreMgr().Get(kWiFiCredentialsKeyName, network.credentials,
+                                                              sizeof(network.credentials), &credentialsLen);
+    VerifyOrReturnError(err != CHIP_ERROR_NOT_FOUND, CHIP_NO_ERROR);
+    ReturnErrorOnFailure(err);
+
+    err = PersistedStorage::KeyValueStoreMgr().Get(kWiFiSSIDKeyName, network.ssid, sizeof(network.ssid), &ssidLen);
+    VerifyOrReturnError(err != CHIP_ERROR_NOT_FOUND, CHIP_NO_ERROR);
+    ReturnErrorOnFailure(err);
+
+    VerifyOrReturnError(CanCastTo<uint8_t>(credentialsLen) && CanCastTo<uint8_t>(ssidLen), CHIP_ERROR_INCORRECT_STATE);
+    network.credentialsLen = static_cast<uint8_t>(credentialsLen);
+    network.ssidLen        = static_cast<uint8_t>(ssidLen);
+    mSavedNetworkCount     = 1;
+    return CHIP_NO_ERROR;
 }
 
 void ATBMWiFiDriver::Shutdown()
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+    DeviceLayer::SystemLayer().CancelTimer(OnRoamCheckTimer, this);
+#endif
     mpStatusChangeCallback = nullptr;
 }
 
 CHIP_ERROR ATBMWiFiDriver::CommitConfiguration()
 {
-    ReturnErrorOnFailure(PersistedStorage::KeyValueStoreMgr().Put(kWiFiSSIDKeyName, mStagingNetwork.ssid, mStagingNetwork.ssidLen));
-    ReturnErrorOnFailure(PersistedStorage::KeyValueStoreMgr().Put(kWiFiCredentialsKeyName, mStagingNetwork.credentials,
-                                                                  mStagingNetwork.credentialsLen));
-    mSavedNetwork = mStagingNetwork;
+    uint8_t buf[kWiFiNetworksRecordMaxSize];
+    size_t len = 0;
+
+    buf[len++] = kWiFiNetworksRecordVersion;
+    buf[len++] = mStagingNetworkCount;
+    for (uint8_t i = 0; i < mStagingNetworkCount; i++)
+    {
+        const WiFiNetwork & network = mStagingNetworks[i];
+
+        buf[len++] = network.ssidLen;
+        memcpy(&buf[len], network.ssid, network.ssidLen);
+        len += network.ssidLen;
+        buf[len++] = network.credentialsLen;
+        memcpy(&buf[len], network.credentials, network.credentialsLen);
+        len += network.credentialsLen;
+    }
+    ReturnErrorOnFailure(PersistedStorage::KeyValueStoreMgr().Put(kWiFiNetworksKeyName, buf, len));
+
+    // The single-network keys are superseded by the record above.
+    PersistedStorage::KeyValueStoreMgr().Delete(kWiFiSSIDKeyName);
+    PersistedStorage::KeyValueStoreMgr().Delete(kWiFiCredentialsKeyName);
+
+    memcpy(mSavedNetworks, mStagingNetworks, sizeof(mStagingNetworks));
+    mSavedNetworkCount = mStagingNetworkCount;
     return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR ATBMWiFiDriver::RevertConfiguration()
 {
-    mStagingNetwork = mSavedNetwork;
+    memcpy(mStagingNetworks, mSavedNetworks, sizeof(mSavedNetworks));
+    mStagingNetworkCount = mSavedNetworkCount;
     return CHIP_NO_ERROR;
 }
 
@@ -144,21 +246,41 @@ bool ATBMWiFiDriver::NetworkMatch(const WiFiNetwork & network, ByteSpan networkI
     return networkId.size() == network.ssidLen && memcmp(networkId.data(), network.ssid, network.ssidLen) == 0;
 }
 
+int ATBMWiFiDriver::FindNetwork(const WiFiNetwork * networks, uint8_t count, ByteSpan networkId)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (NetworkMatch(networks[i], networkId))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
 Status ATBMWiFiDriver::AddOrUpdateNetwork(ByteSpan ssid, ByteSpan credentials, MutableCharSpan & outDebugText,
                                          uint8_t & outNetworkIndex)
 {
     outDebugText.reduce_size(0);
     outNetworkIndex = 0;
-    VerifyOrReturnError(mStagingNetwork.ssidLen == 0 || NetworkMatch(mStagingNetwork, ssid), Status::kBoundsExceeded);
-    VerifyOrReturnError(credentials.size() <= sizeof(mStagingNetwork.credentials), Status::kOutOfRange);
-    VerifyOrReturnError(ssid.size() <= sizeof(mStagingNetwork.ssid), Status::kOutOfRange);
+    VerifyOrReturnError(credentials.size() <= sizeof(mStagingNetworks[0].credentials), Status::kOutOfRange);
+    VerifyOrReturnError(ssid.size() <= sizeof(mStagingNetworks[0].ssid), Status::kOutOfRange);
 
-    memcpy(mStagingNetwork.credentials, credentials.data(), credentials.size());
-    mStagingNetwork.credentialsLen = static_cast<decltype(mStagingNetwork.credentialsLen)>(credentials.size());
+    int index = FindNetwork(mStagingNetworks, mStagingNetworkCount, ssid);
+    if (index < 0)
+    {
+        VerifyOrReturnError(mStagingNetworkCount < kMaxWiFiNetworks, Status::kBoundsExceeded);
+        index = mStagingNetworkCount++;
+    }
+
+    WiFiNetwork & network = mStagingNetworks[index];
+    memcpy(network.credentials, credentials.data(), credentials.size());
+    network.credentialsLen = static_cast<decltype(network.credentialsLen)>(credentials.size());
 
-    memcpy(mStagingNetwork.ssid, ssid.data(), ssid.size());
-    mStagingNetwork.ssidLen = static_cast<decltype(mStagingNetwork.ssidLen)>(ssid.size());
+    memcpy(network.ssid, ssid.data(), ssid.size());
+    network.ssidLen = static_cast<decltype(network.ssidLen)>(ssid.size());
 
+    outNetworkIndex = static_cast<uint8_t>(index);
     return Status::kSuccess;
 }
 
@@ -166,10 +288,17 @@ Status ATBMWiFiDriver::RemoveNetwork(ByteSpan networkId, MutableCharSpan & outDe
 {
     outDebugText.reduce_size(0);
     outNetworkIndex = 0;
-    VerifyOrReturnError(NetworkMatch(mStagingNetwork, networkId), Status::kNetworkIDNotFound);
 
-    // Use empty ssid for representing invalid network
-    mStagingNetwork.ssidLen = 0;
+    int index = FindNetwork(mStagingNetworks, mStagingNetworkCount, networkId);
+    VerifyOrReturnError(index >= 0, Status::kNetworkIDNotFound);
+
+    for (uint8_t i = static_cast<uint8_t>(index); i + 1 < mStagingNetworkCount; i++)
+    {
+        mStagingNetworks[i] = mStagingNetworks[i + 1];
+    }
+    mStagingNetworkCount--;
+
+    outNetworkIndex = static_cast<uint8_t>(index);
     return Status::kSuccess;
 }
 
@@ -177,9 +306,21 @@ Status ATBMWiFiDriver::ReorderNetwork(ByteSpan networkId, uint8_t index, Mutable
 {
     outDebugText.reduce_size(0);
 
-    // Only one network is supported now
-    VerifyOrReturnError(index == 0, Status::kOutOfRange);
-    VerifyOrReturnError(NetworkMatch(mStagingNetwork, networkId), Status::kNetworkIDNotFound);
+    int current = FindNetwork(mStagingNetworks, mStagingNetworkCount, networkId);
+    VerifyOrReturnError(current >= 0, Status::kNetworkIDNotFound);
+    VerifyOrReturnError(index < mStagingNetworkCount, Status::kOutOfRange);
+
+    // The list order is the connection priority: index 0 is tried first.
+    WiFiNetwork network = mStagingNetworks[current];
+    for (; current < index; current++)
+    {
+        mStagingNetworks[current] = mStagingNetworks[current + 1];
+    }
+    for (; current > index; current--)
+    {
+        mStagingNetworks[current] = mStagingNetworks[current - 1];
+    }
+    mStagingNetworks[index] = network;
     return Status::kSuccess;
 }
 
@@ -202,7 +343,11 @@ CHIP_ERROR ATBMWiFiDriver::ConnectWiFiNetwork(const char * ssid, uint8_t ssidLen
 
     ReturnErrorOnFailure(ConnectivityMgr().SetWiFiStationMode(ConnectivityManager::kWiFiStationMode_Disabled));
 
-    atbm_wifi_set_config((u8 *)ssid, ssidLen, (u8 *)key, keyLen, KEY_WPA2, 0, NULL);
+    // A network supplied by the commissioner may live on a different AP, so start with a full scan.
+    ClearFastConnectInfo();
+    mRoamPending     = false;
+    mExplicitConnect = true;
+    atbm_wifi_set_config((u8 *)ssid, ssidLen, (u8 *)key, keyLen, DefaultAuthMode(keyLen), 0, NULL);
 
     ReturnErrorOnFailure(ConnectivityMgr().SetWiFiStationMode(ConnectivityManager::kWiFiStationMode_Disabled));
     return ConnectivityMgr().SetWiFiStationMode(ConnectivityManager::kWiFiStationMode_Enabled);
@@ -210,6 +355,13 @@ CHIP_ERROR ATBMWiFiDriver::ConnectWiFiNetwork(const char * ssid, uint8_t ssidLen
 
 void ATBMWiFiDriver::OnConnectWiFiNetwork()
 {
+    mExplicitConnect = false;
+    UpdateFastConnectInfo();
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+    mRoamBackoff = 0;
+    ArmRoamCheckTimer();
+#endif
+
     if (mpConnectCallback)
     {
         DeviceLayer::SystemLayer().CancelTimer(OnConnectWiFiNetworkFailed, NULL);
@@ -220,6 +372,7 @@ void ATBMWiFiDriver::OnConnectWiFiNetwork()
 
 void ATBMWiFiDriver::OnConnectWiFiNetworkFailed()
 {
+    mExplicitConnect = false;
     if (mpConnectCallback)
     {
         mpConnectCallback->OnResult(Status::kNetworkNotFound, CharSpan(), 0);
@@ -227,6 +380,254 @@ void ATBMWiFiDriver::OnConnectWiFiNetworkFailed()
     }
 }
 
+void ATBMWiFiDriver::ApplyStationConfig(const WiFiNetwork & network, int authMode, const uint8_t * bssid)
+{
+    static const uint8_t kAnyBssid[6] = { 0 };
+    struct atbmwifi_configure config;
+
+    // atbm_wifi_set_config() persists the configuration, so skip it when nothing changes.
+    atbm_wifi_get_config(&config);
+    if (config.ssid_len == network.ssidLen && memcmp(config.ssid, network.ssid, network.ssidLen) == 0 &&
+        config.password_len == network.credentialsLen && memcmp(config.password, network.credentials, network.credentialsLen) == 0 &&
+        config.key_mgmt == authMode && memcmp(config.bssid, (bssid != nullptr) ? bssid : kAnyBssid, sizeof(config.bssid)) == 0)
+    {
+        return;
+    }
+
+    atbm_wifi_set_config((u8 *) network.ssid, network.ssidLen, (u8 *) network.credentials, network.credentialsLen, authMode, 0,
+                         (u8 *) bssid);
+}
+
+void ATBMWiFiDriver::StartStationConnect()
+{
+    // A network handed over by ConnectNetwork() is already configured and may not be saved yet.
+    if (mExplicitConnect)
+    {
+        atbm_wifi_connect_ap_autoMgmt();
+        return;
+    }
+
+    const FastConnectInfo * target = mRoamPending ? &mRoamTarget : (mFastConnectValid ? &mFastConnectInfo : nullptr);
+    int index = (target != nullptr) ? FindNetwork(mSavedNetworks, mSavedNetworkCount, ByteSpan(target->ssid, target->ssidLen)) : -1;
+    if (index >= 0)
+    {
+        // Pin the saved network to the last-good (or roaming target) BSSID and security mode so
+        // the WiFi layer can join it directly instead of scanning every channel first.
+        ChipLogProgress(DeviceLayer, "WiFi fast connect to %02x:%02x:%02x:%02x:%02x:%02x (channel %u)", target->bssid[0],
+                        target->bssid[1], target->bssid[2], target->bssid[3], target->bssid[4], target->bssid[5],
+                        target->channel);
+        ApplyStationConfig(mSavedNetworks[index], target->authMode, target->bssid);
+        mFastConnectPending = true;
+        atbm_wifi_connect_ap();
+        return;
+    }
+    mRoamPending = false;
+
+    // With several networks saved, scan first and join the best one in range.
+    if (mSavedNetworkCount > 1 && StartInternalScan(InternalScan::kConnect) == CHIP_NO_ERROR)
+    {
+        return;
+    }
+
+    if (mSavedNetworkCount > 0)
+    {
+        ApplyStationConfig(mSavedNetworks[0], DefaultAuthMode(mSavedNetworks[0].credentialsLen), nullptr);
+    }
+    atbm_wifi_connect_ap_autoMgmt();
+}
+
+bool ATBMWiFiDriver::OnStationConnectFailed()
+{
+    VerifyOrReturnValue(mFastConnectPending, false);
+    mFastConnectPending = false;
+
+    // The AP moved or went away: forget it and let the next attempt scan for the network.
+    ChipLogProgress(DeviceLayer, "WiFi fast connect failed, falling back to full scan");
+    if (mRoamPending)
+    {
+        mRoamPending = false;
+    }
+    else
+    {
+        ClearFastConnectInfo();
+    }
+    return true;
+}
+
+void ATBMWiFiDriver::UpdateFastConnectInfo()
+{
+    struct atbmwifi_configure config;
+    FastConnectInfo info;
+
+    mFastConnectPending = false;
+    mRoamPending        = false;
+
+    memset(&info, 0, sizeof(info));
+    atbm_wifi_get_config(&config);
+    atbm_wifi_get_connected_destAddr(info.bssid);
+    info.channel  = atbm_wifi_get_channel();
+    info.authMode = config.key_mgmt;
+    info.ssidLen  = std::min<uint8_t>(config.ssid_len, sizeof(info.ssid));
+    memcpy(info.ssid, config.ssid, info.ssidLen);
+
+    // Only touch flash when the AP actually changed.
+    VerifyOrReturn(!mFastConnectValid || memcmp(&info, &mFastConnectInfo, sizeof(info)) != 0);
+
+    mFastConnectInfo  = info;
+    mFastConnectValid = true;
+
+    CHIP_ERROR err =
+        PersistedStorage::KeyValueStoreMgr().Put(kWiFiFastConnectKeyName, &mFastConnectInfo, sizeof(mFastConnectInfo));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Failed to save WiFi fast connect info: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void ATBMWiFiDriver::ClearFastConnectInfo()
+{
+    VerifyOrReturn(mFastConnectValid);
+    mFastConnectValid = false;
+    PersistedStorage::KeyValueStoreMgr().Delete(kWiFiFastConnectKeyName);
+}
+
+CHIP_ERROR ATBMWiFiDriver::StartInternalScan(InternalScan scan)
+{
+    VerifyOrReturnError(mInternalScan == InternalScan::kNone, CHIP_ERROR_BUSY);
+
+    // A ScanNetworks request already in flight delivers the results for both.
+    if (mpScanCallback == nullptr)
+    {
+        VerifyOrReturnError(atbm_wifi_scan() == 0, CHIP_ERROR_INTERNAL);
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+        Internal::BLEMgrImpl().SetWiFiCoexActive(Internal::BLEManagerImpl::WiFiCoexReason::kScan, true);
+#endif
+    }
+    mInternalScan = scan;
+    return CHIP_NO_ERROR;
+}
+
+void ATBMWiFiDriver::ConnectBestNetwork(const struct atbmwifi_scan_result * scanResult, size_t count)
+{
+    const struct atbmwifi_scan_result_info * bestAp = nullptr;
+    int bestIndex                                   = -1;
+
+    VerifyOrReturn(mSavedNetworkCount > 0);
+
+    // Highest-priority saved network in range wins; RSSI breaks ties between its APs.
+    for (size_t i = 0; i < count; i++)
+    {
+        const struct atbmwifi_scan_result_info & ap = scanResult->info[i];
+        int index = FindNetwork(mSavedNetworks, mSavedNetworkCount,
+                                ByteSpan(ap.ssid, strnlen(reinterpret_cast<const char *>(ap.ssid), sizeof(ap.ssid))));
+        if (index < 0)
+        {
+            continue;
+        }
+        if (bestAp == nullptr || index < bestIndex || (index == bestIndex && ap.rssi > bestAp->rssi))
+        {
+            bestAp    = &ap;
+            bestIndex = index;
+        }
+    }
+
+    if (bestAp != nullptr)
+    {
+        ChipLogProgress(DeviceLayer, "Connecting to saved network %d (%.*s), RSSI %d", bestIndex,
+                        static_cast<int>(mSavedNetworks[bestIndex].ssidLen), mSavedNetworks[bestIndex].ssid, bestAp->rssi);
+        ApplyStationConfig(mSavedNetworks[bestIndex], GetScanResultAuthMode(*bestAp), bestAp->bssid);
+        atbm_wifi_connect_ap();
+        return;
+    }
+
+    ChipLogProgress(DeviceLayer, "No saved network in range");
+    ApplyStationConfig(mSavedNetworks[0], DefaultAuthMode(mSavedNetworks[0].credentialsLen), nullptr);
+    atbm_wifi_connect_ap_autoMgmt();
+}
+
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+void ATBMWiFiDriver::ArmRoamCheckTimer()
+{
+    System::Clock::Milliseconds32 interval(CHIP_DEVICE_CONFIG_WIFI_ROAM_CHECK_INTERVAL << mRoamBackoff);
+    DeviceLayer::SystemLayer().StartTimer(interval, OnRoamCheckTimer, this);
+}
+
+void ATBMWiFiDriver::OnRoamCheckTimer(System::Layer * aLayer, void * aAppState)
+{
+    static_cast<ATBMWiFiDriver *>(aAppState)->CheckRoaming();
+}
+
+void ATBMWiFiDriver::CheckRoaming()
+{
+    bool connected = false;
+
+    VerifyOrReturn(ATBMUtils::IsStationConnected(connected) == CHIP_NO_ERROR && connected);
+
+    int rssi = atbm_wifi_get_rssi();
+    if (rssi >= CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_THRESHOLD)
+    {
+        mRoamBackoff = 0;
+    }
+    else if (mpScanCallback == nullptr && StartInternalScan(InternalScan::kRoam) == CHIP_NO_ERROR)
+    {
+        // The timer is re-armed once the scan completes.
+        ChipLogProgress(DeviceLayer, "WiFi RSSI %d below roaming threshold, scanning", rssi);
+        mRoamRssi = static_cast<int8_t>(rssi);
+        return;
+    }
+    ArmRoamCheckTimer();
+}
+
+void ATBMWiFiDriver::RoamToBestAP(const struct atbmwifi_scan_result * scanResult, size_t count)
+{
+    const struct atbmwifi_scan_result_info * bestAp = nullptr;
+    uint8_t currentBssid[6];
+
+    atbm_wifi_get_connected_destAddr(currentBssid);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const struct atbmwifi_scan_result_info & ap = scanResult->info[i];
+        if (ap.rssi < mRoamRssi + CHIP_DEVICE_CONFIG_WIFI_ROAM_RSSI_HYSTERESIS ||
+            memcmp(ap.bssid, currentBssid, sizeof(currentBssid)) == 0 ||
+            FindNetwork(mSavedNetworks, mSavedNetworkCount,
+                        ByteSpan(ap.ssid, strnlen(reinterpret_cast<const char *>(ap.ssid), sizeof(ap.ssid)))) < 0)
+        {
+            continue;
+        }
+        if (bestAp == nullptr || ap.rssi > bestAp->rssi)
+        {
+            bestAp = &ap;
+        }
+    }
+
+    if (bestAp == nullptr)
+    {
+        // Nothing better around: back off so a weak but stable link is not scanned continuously.
+        if (mRoamBackoff < kWiFiMaxRoamBackoff)
+        {
+            mRoamBackoff++;
+        }
+        ArmRoamCheckTimer();
+        return;
+    }
+
+    memset(&mRoamTarget, 0, sizeof(mRoamTarget));
+    memcpy(mRoamTarget.bssid, bestAp->bssid, sizeof(mRoamTarget.bssid));
+    mRoamTarget.channel  = bestAp->channel;
+    mRoamTarget.authMode = static_cast<uint8_t>(GetScanResultAuthMode(*bestAp));
+    mRoamTarget.ssidLen  = static_cast<uint8_t>(strnlen(reinterpret_cast<const char *>(bestAp->ssid), sizeof(mRoamTarget.ssid)));
+    memcpy(mRoamTarget.ssid, bestAp->ssid, mRoamTarget.ssidLen);
+    mRoamPending = true;
+
+    ChipLogProgress(DeviceLayer, "Roaming to %02x:%02x:%02x:%02x:%02x:%02x (channel %u, RSSI %d -> %d)", mRoamTarget.bssid[0],
+                    mRoamTarget.bssid[1], mRoamTarget.bssid[2], mRoamTarget.bssid[3], mRoamTarget.bssid[4], mRoamTarget.bssid[5],
+                    mRoamTarget.channel, mRoamRssi, bestAp->rssi);
+    // ConnectivityManagerImpl reconnects straight away, through StartStationConnect().
+    atbm_wifi_disconnect_call_task();
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+
 void ATBMWiFiDriver::OnConnectWiFiNetworkFailed(chip::System::Layer * aLayer, void * aAppState)
 {
     CHIP_ERROR error = chip::DeviceLayer::Internal::ATBMUtils::ClearWiFiStationProvision();
@@ -243,14 +644,15 @@ void ATBMWiFiDriver::ConnectNetwork(ByteSpan networkId, ConnectCallback * callba
     Status networkingStatus = Status::kSuccess;
     Network configuredNetwork;
     const uint32_t secToMiliSec = 1000;
+    int index                   = FindNetwork(mStagingNetworks, mStagingNetworkCount, networkId);
 
-    VerifyOrExit(NetworkMatch(mStagingNetwork, networkId), networkingStatus = Status::kNetworkIDNotFound);
+    VerifyOrExit(index >= 0, networkingStatus = Status::kNetworkIDNotFound);
     VerifyOrExit(mpConnectCallback == nullptr, networkingStatus = Status::kUnknownError);
     ChipLogProgress(NetworkProvisioning, "ATBM NetworkCommissioningDelegate: SSID: %.*s", static_cast<int>(networkId.size()),
                     networkId.data());
     if (CHIP_NO_ERROR == GetConfiguredNetwork(configuredNetwork))
     {
-        if (NetworkMatch(mStagingNetwork, ByteSpan(configuredNetwork.networkID, configuredNetwork.networkIDLen)))
+        if (NetworkMatch(mStagingNetworks[index], ByteSpan(configuredNetwork.networkID, configuredNetwork.networkIDLen)))
         {
             if (callback)
             {
@@ -259,8 +661,9 @@ void ATBMWiFiDriver::ConnectNetwork(ByteSpan networkId, ConnectCallback * callba
             return;
         }
     }
-    err = ConnectWiFiNetwork(reinterpret_cast<const char *>(mStagingNetwork.ssid), mStagingNetwork.ssidLen,
-                             reinterpret_cast<const char *>(mStagingNetwork.credentials), mStagingNetwork.credentialsLen);
+    err = ConnectWiFiNetwork(reinterpret_cast<const char *>(mStagingNetworks[index].ssid), mStagingNetworks[index].ssidLen,
+                             reinterpret_cast<const char *>(mStagingNetworks[index].credentials),
+                             mStagingNetworks[index].credentialsLen);
 
     err = DeviceLayer::SystemLayer().StartTimer(
         static_cast<System::Clock::Timeout>(kWiFiConnectNetworkTimeoutSeconds * secToMiliSec), OnConnectWiFiNetworkFailed, NULL);
@@ -283,17 +686,61 @@ CHIP_ERROR ATBMWiFiDriver::StartScanWiFiNetworks(ByteSpan ssid)
 {
     int err = 0;
 
-    ChipLogProgress(NetworkProvisioning, "ATBM Scan ALL...");
+    VerifyOrReturnError(ssid.size() <= sizeof(mScanSSID), CHIP_ERROR_INVALID_ARGUMENT);
+    memcpy(mScanSSID, ssid.data(), ssid.size());
+    mScanSSIDLen = static_cast<uint8_t>(ssid.size());
+
+    // The ATBM WiFi layer has no directed (SSID-specific probe) scan, so the SSID filter is
+    // applied when the results are collected.
+    if (mScanSSIDLen != 0)
+    {
+        ChipLogProgress(NetworkProvisioning, "ATBM Scan for SSID %.*s...", static_cast<int>(mScanSSIDLen), mScanSSID);
+    }
+    else
+    {
+        ChipLogProgress(NetworkProvisioning, "ATBM Scan ALL...");
+    }
+    // A connect or roaming scan already in flight delivers the results for both.
+    VerifyOrReturnError(mInternalScan == InternalScan::kNone, CHIP_NO_ERROR);
+
     err = atbm_wifi_scan();
     if (err != 0)
     {
         return CHIP_ERROR_INTERNAL;
     }
+#if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
+    Internal::BLEMgrImpl().SetWiFiCoexActive(Internal::BLEManagerImpl::WiFiCoexReason::kScan, true);
+#endif
     return CHIP_NO_ERROR;
 }
 
 void ATBMWiFiDriver::OnScanWiFiNetworkDone()
 {
+    InternalScan internalScan = mInternalScan;
+    mInternalScan             = InternalScan::kNone;
+
+    if (internalScan != InternalScan::kNone)
+    {
+        int apCount                                = atbm_wifi_scan_is_done();
+        struct atbmwifi_scan_result * scanResult = (apCount > 0) ? atbm_wifi_scan_get_result() : nullptr;
+        size_t count = (scanResult != nullptr && scanResult->info != nullptr) ? static_cast<size_t>(apCount) : 0;
+
+        if (internalScan == InternalScan::kConnect)
+        {
+            ConnectBestNetwork(scanResult, count);
+        }
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+        else
+        {
+            RoamToBestAP(scanResult, count);
+        }
+#endif
+        if (!mpScanCallback && count != 0)
+        {
+            atbm_wifi_process_scan_result(NULL);
+        }
+    }
+
     if (!mpScanCallback)
     {
         ChipLogProgress(DeviceLayer, "No scan callback");
@@ -319,8 +766,24 @@ void ATBMWiFiDriver::OnScanWiFiNetworkDone()
         return;
     }
 
-    if (CHIP_NO_ERROR == DeviceLayer::SystemLayer().ScheduleLambda([ap_number, scan_result]() {
-            ATBMScanResponseIterator iter(ap_number, scan_result);
+    // Copy the ranked results out of the WiFi layer, which releases its scan list below.
+    WiFiScanResponse * results =
+        static_cast<WiFiScanResponse *>(HeapTracker::Calloc(HeapTracker::kTag_WiFi, kWiFiMaxScanResults, sizeof(WiFiScanResponse)));
+    if (results == nullptr)
+    {
+        ChipLogError(DeviceLayer, "can't get memory for scan results");
+        atbm_wifi_process_scan_result(NULL);
+        mpScanCallback->OnFinished(Status::kUnknownError, CharSpan(), nullptr);
+        mpScanCallback = nullptr;
+        return;
+    }
+    size_t resultCount = CollectScanResults(scan_result, static_cast<size_t>(ap_number), results, kWiFiMaxScanResults);
+    atbm_wifi_process_scan_result(NULL);
+
+    ChipLogProgress(DeviceLayer, "Scan found %d APs, reporting %u", ap_number, static_cast<unsigned>(resultCount));
+
+    if (CHIP_NO_ERROR != DeviceLayer::SystemLayer().ScheduleLambda([resultCount, results]() {
+            ATBMScanResponseIterator iter(resultCount, results);
             if (GetInstance().mpScanCallback)
             {
                 GetInstance().mpScanCallback->OnFinished(Status::kSuccess, CharSpan(), &iter);
@@ -330,18 +793,89 @@ void ATBMWiFiDriver::OnScanWiFiNetworkDone()
             {
                 ChipLogError(DeviceLayer, "can't find the ScanCallback function");
             }
+            HeapTracker::Free(results);
         }))
-    {
-        atbm_wifi_process_scan_result(NULL);
-    }
-    else
     {
         ChipLogError(DeviceLayer, "can't get ap_records ");
+        HeapTracker::Free(results);
         mpScanCallback->OnFinished(Status::kUnknownError, CharSpan(), nullptr);
         mpScanCallback = nullptr;
     }
 }
 
+size_t ATBMWiFiDriver::CollectScanResults(const struct atbmwifi_scan_result * scanResult, size_t count, WiFiScanResponse * out,
+                                          size_t maxOut)
+{
+    size_t outCount = 0;
+
+    static_assert(chip::DeviceLayer::Internal::kMaxWiFiSSIDLength <= UINT8_MAX, "SSID length might not fit in item.ssidLen");
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const struct atbmwifi_scan_result_info & info = scanResult->info[i];
+        uint8_t ssidLen = static_cast<uint8_t>(
+            strnlen(reinterpret_cast<const char *>(info.ssid), chip::DeviceLayer::Internal::kMaxWiFiSSIDLength));
+        size_t slot = outCount;
+
+        if (mScanSSIDLen != 0 && (ssidLen != mScanSSIDLen || memcmp(info.ssid, mScanSSID, ssidLen) != 0))
+        {
+            continue;
+        }
+
+        // Keep one entry per BSSID (the strongest); once full, replace the weakest entry.
+        for (size_t j = 0; j < outCount; j++)
+        {
+            if (memcmp(out[j].bssid, info.bssid, sizeof(out[j].bssid)) == 0)
+            {
+                slot = j;
+                break;
+            }
+        }
+        if (slot < outCount)
+        {
+            VerifyOrDo(info.rssi > out[slot].rssi, continue);
+        }
+        else if (outCount == maxOut)
+        {
+            slot = 0;
+            for (size_t j = 1; j < outCount; j++)
+            {
+                if (out[j].rssi < out[slot].rssi)
+                {
+                    slot = j;
+                }
+            }
+            VerifyOrDo(info.rssi > out[slot].rssi, continue);
+        }
+        else
+        {
+            outCount++;
+        }
+
+        out[slot].security = ConvertSecurityType(GetScanResultAuthMode(info));
+        out[slot].ssidLen  = ssidLen;
+        out[slot].channel  = info.channel;
+        out[slot].wiFiBand = chip::DeviceLayer::NetworkCommissioning::WiFiBand::k2g4;
+        out[slot].rssi     = info.rssi;
+        memcpy(out[slot].ssid, info.ssid, ssidLen);
+        memcpy(out[slot].bssid, info.bssid, sizeof(out[slot].bssid));
+    }
+
+    // Strongest first.
+    for (size_t i = 1; i < outCount; i++)
+    {
+        WiFiScanResponse item = out[i];
+        size_t j              = i;
+        for (; j > 0 && out[j - 1].rssi < item.rssi; j--)
+        {
+            out[j] = out[j - 1];
+        }
+        out[j] = item;
+    }
+
+    return outCount;
+}
+
 void ATBMWiFiDriver::OnNetworkStatusChange()
 {
     Network configuredNetwork;
@@ -400,19 +934,19 @@ uint16_t ATBMWiFiDriver::GetLastDisconnectReason()
 
 size_t ATBMWiFiDriver::WiFiNetworkIterator::Count()
 {
-    return mDriver->mStagingNetwork.ssidLen == 0 ? 0 : 1;
+    return mDriver->mStagingNetworkCount;
 }
 
 bool ATBMWiFiDriver::WiFiNetworkIterator::Next(Network & item)
 {
-    if (mExhausted || mDriver->mStagingNetwork.ssidLen == 0)
+    if (mIndex >= mDriver->mStagingNetworkCount)
     {
         return false;
     }
-    memcpy(item.networkID, mDriver->mStagingNetwork.ssid, mDriver->mStagingNetwork.ssidLen);
-    item.networkIDLen = mDriver->mStagingNetwork.ssidLen;
+    const WiFiNetwork & network = mDriver->mStagingNetworks[mIndex++];
+    memcpy(item.networkID, network.ssid, network.ssidLen);
+    item.networkIDLen = network.ssidLen;
     item.connected    = false;
-    mExhausted        = true;
 
     Network configuredNetwork;
     CHIP_ERROR err = GetConfiguredNetwork(configuredNetwork);
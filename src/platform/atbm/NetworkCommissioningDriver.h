@@ -16,6 +16,7 @@
  */
 
 #pragma once
+#include <platform/CHIPDeviceConfig.h>
 #include <platform/NetworkCommissioning.h>
 
 using chip::BitFlags;
@@ -25,17 +26,26 @@ namespace chip {
 namespace DeviceLayer {
 namespace NetworkCommissioning {
 namespace {
-inline constexpr uint8_t kMaxWiFiNetworks                  = 1;
+inline constexpr uint8_t kMaxWiFiNetworks                  = CHIP_DEVICE_CONFIG_WIFI_MAX_NETWORKS;
 inline constexpr uint8_t kWiFiScanNetworksTimeOutSeconds   = 10;
 inline constexpr uint8_t kWiFiConnectNetworkTimeoutSeconds = 30;
+// Strongest unique BSSIDs reported in a ScanNetworks response.
+inline constexpr uint8_t kWiFiMaxScanResults = 10;
+// Roaming checks back off up to 2^kWiFiMaxRoamBackoff times the check interval.
+inline constexpr uint8_t kWiFiMaxRoamBackoff = 3;
 } // namespace
 
 BitFlags<WiFiSecurityBitmap> ConvertSecurityType(int authMode);
+int GetScanResultAuthMode(const struct atbmwifi_scan_result_info & info);
 
+/**
+ * Iterates over the filtered, deduplicated and RSSI-ranked scan results collected by
+ * ATBMWiFiDriver::CollectScanResults().
+ */
 class ATBMScanResponseIterator : public Iterator<WiFiScanResponse>
 {
 public:
-    ATBMScanResponseIterator(const size_t size, const struct atbmwifi_scan_result * scanResults) : mSize(size), mpScanResults(scanResults) {}
+    ATBMScanResponseIterator(const size_t size, const WiFiScanResponse * scanResults) : mSize(size), mpScanResults(scanResults) {}
     size_t Count() override { return mSize; }
     bool Next(WiFiScanResponse & item) override
     {
@@ -44,16 +54,7 @@ public:
             return false;
         }
 
-        //item.security.ConvertSecurityType(mpScanResults[mIternum].authmode);
-        static_assert(chip::DeviceLayer::Internal::kMaxWiFiSSIDLength <= UINT8_MAX, "SSID length might not fit in item.ssidLen");
-        item.ssidLen = static_cast<uint8_t>(
-            strnlen(reinterpret_cast<const char *>(mpScanResults->info[mIternum].ssid), chip::DeviceLayer::Internal::kMaxWiFiSSIDLength));
-        item.channel  = mpScanResults->info[mIternum].channel;
-        item.wiFiBand = chip::DeviceLayer::NetworkCommissioning::WiFiBand::k2g4;
-        item.rssi     = mpScanResults->info[mIternum].rssi;
-        memcpy(item.ssid, mpScanResults->info[mIternum].ssid, item.ssidLen);
-        memcpy(item.bssid, mpScanResults->info[mIternum].bssid, 6);
-
+        item = mpScanResults[mIternum];
         mIternum++;
         return true;
     }
@@ -61,7 +62,7 @@ public:
 
 private:
     const size_t mSize;
-    const struct atbmwifi_scan_result * mpScanResults;
+    const WiFiScanResponse * mpScanResults;
     size_t mIternum = 0;
 };
 
@@ -79,7 +80,7 @@ public:
 
     private:
         ATBMWiFiDriver * mDriver;
-        bool mExhausted = false;
+        uint8_t mIndex = 0;
     };
 
     struct WiFiNetwork
@@ -90,6 +91,16 @@ public:
         uint8_t credentialsLen = 0;
     };
 
+    // Where a saved network was last joined, persisted so that a reconnect can skip the full scan.
+    struct FastConnectInfo
+    {
+        uint8_t ssid[DeviceLayer::Internal::kMaxWiFiSSIDLength];
+        uint8_t ssidLen;
+        uint8_t bssid[6];
+        uint8_t channel;
+        uint8_t authMode;
+    };
+
     // BaseDriver
     NetworkIterator * GetNetworks() override { return new WiFiNetworkIterator(this); }
     CHIP_ERROR Init(NetworkStatusChangeCallback * networkStatusChangeCallback) override;
@@ -119,6 +130,10 @@ public:
     void OnScanWiFiNetworkDone();
     void OnNetworkStatusChange();
 
+    void StartStationConnect();
+    bool OnStationConnectFailed();
+    bool IsRoamPending() const { return mRoamPending; }
+
     CHIP_ERROR SetLastDisconnectReason(const ChipDeviceEvent * event);
     uint16_t GetLastDisconnectReason();
 
@@ -129,15 +144,52 @@ public:
     }
 
 private:
+    enum class InternalScan : uint8_t
+    {
+        kNone,
+        kConnect,
+        kRoam,
+    };
+
+    CHIP_ERROR LoadNetworks();
+    CHIP_ERROR LoadLegacyNetwork();
     bool NetworkMatch(const WiFiNetwork & network, ByteSpan networkId);
+    int FindNetwork(const WiFiNetwork * networks, uint8_t count, ByteSpan networkId);
     CHIP_ERROR StartScanWiFiNetworks(ByteSpan ssid);
-
-    WiFiNetwork mSavedNetwork;
-    WiFiNetwork mStagingNetwork;
+    size_t CollectScanResults(const struct atbmwifi_scan_result * scanResult, size_t count, WiFiScanResponse * out,
+                              size_t maxOut);
+    void UpdateFastConnectInfo();
+    void ClearFastConnectInfo();
+    void ApplyStationConfig(const WiFiNetwork & network, int authMode, const uint8_t * bssid);
+    CHIP_ERROR StartInternalScan(InternalScan scan);
+    void ConnectBestNetwork(const struct atbmwifi_scan_result * scanResult, size_t count);
+#if CHIP_DEVICE_CONFIG_ENABLE_WIFI_ROAMING
+    void ArmRoamCheckTimer();
+    void CheckRoaming();
+    void RoamToBestAP(const struct atbmwifi_scan_result * scanResult, size_t count);
+    static void OnRoamCheckTimer(System::Layer * aLayer, void * aAppState);
+#endif
+
+    // Index order is the connection priority.
+    WiFiNetwork mSavedNetworks[kMaxWiFiNetworks];
+    WiFiNetwork mStagingNetworks[kMaxWiFiNetworks];
+    uint8_t mSavedNetworkCount   = 0;
+    uint8_t mStagingNetworkCount = 0;
     ScanCallback * mpScanCallback;
+    uint8_t mScanSSID[DeviceLayer::Internal::kMaxWiFiSSIDLength];
+    uint8_t mScanSSIDLen = 0;
     ConnectCallback * mpConnectCallback;
     NetworkStatusChangeCallback * mpStatusChangeCallback = nullptr;
     uint16_t mLastDisconnectedReason;
+    FastConnectInfo mFastConnectInfo;
+    bool mFastConnectValid   = false;
+    bool mFastConnectPending = false;
+    bool mExplicitConnect    = false;
+    InternalScan mInternalScan = InternalScan::kNone;
+    FastConnectInfo mRoamTarget;
+    bool mRoamPending  = false;
+    int8_t mRoamRssi   = 0;
+    uint8_t mRoamBackoff = 0;
 };
 
 } // namespace NetworkCommissioning
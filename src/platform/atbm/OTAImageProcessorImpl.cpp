@@ -18,6 +18,13 @@
 #include <app/clusters/ota-requestor/OTADownloader.h>
 #include <app/clusters/ota-requestor/OTARequestorInterface.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <platform/atbm/HeapTracker.h>
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+#include <platform/atbm/DeferredLog.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+#include <platform/atbm/FlashTrace.h>
+#endif
 
 #include "OTAImageProcessorImpl.h"
 #include "lib/core/CHIPError.h"
@@ -31,6 +38,12 @@ namespace {
 
 void HandleRestart(Layer * systemLayer, void * appState)
 {
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+    DeferredLog::Flush();
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+    FlashTrace::Checkpoint(FlashTrace::kReason_Reboot);
+#endif
     hal_sys_reboot();
 }
 
@@ -224,7 +237,7 @@ CHIP_ERROR OTAImageProcessorImpl::SetBlock(ByteSpan & block)
         {
             ReleaseBlock();
         }
-        uint8_t * mBlock_ptr = static_cast<uint8_t *>(Platform::MemoryAlloc(block.size()));
+        uint8_t * mBlock_ptr = static_cast<uint8_t *>(HeapTracker::Alloc(HeapTracker::kTag_Ota, block.size()));
         if (mBlock_ptr == nullptr)
         {
             return CHIP_ERROR_NO_MEMORY;
@@ -244,7 +257,7 @@ CHIP_ERROR OTAImageProcessorImpl::ReleaseBlock()
 {
     if (mBlock.data() != nullptr)
     {
-        Platform::MemoryFree(mBlock.data());
+        HeapTracker::Free(mBlock.data());
     }
     mBlock = MutableByteSpan();
     return CHIP_NO_ERROR;
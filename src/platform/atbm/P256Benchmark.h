@@ -0,0 +1,71 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          P-256 throughput benchmark for ATBM platforms (CHIP_DEVICE_CONFIG_ENABLE_P256_BENCHMARK).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Times the P-256 operations of PASE and CASE through the CHIP crypto PAL, so that the
+ * numbers include everything a session establishment pays: key generation, keypair
+ * import (what a signature costs without AttestationCache), ECDSA sign and verify, and
+ * ECDH.  Runs on the device through the "atbm p256" shell command and on the host
+ * through the atbm-p256-bench executable.
+ *
+ * Run() blocks the calling task for iterations x all operations.
+ */
+class P256Benchmark
+{
+public:
+    enum Op : uint8_t
+    {
+        kOp_Keygen = 0,
+        kOp_Import,
+        kOp_Sign,
+        kOp_Verify,
+        kOp_ECDH,
+        kOp_Max,
+    };
+
+    struct Result
+    {
+        uint32_t Iterations;
+        uint64_t TotalUs;
+    };
+
+    static CHIP_ERROR Run(uint32_t iterations, Result (&results)[kOp_Max]);
+
+    static const char * GetOpName(Op op);
+
+    /** Describes the mbedTLS ECP build options the benchmark was compiled against. */
+    static const char * GetBackendDescription();
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
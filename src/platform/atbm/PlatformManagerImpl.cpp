@@ -27,6 +27,27 @@
 
 #include <crypto/CHIPCryptoPAL.h>
 #include <platform/atbm/DiagnosticDataProviderImpl.h>
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+#include <platform/atbm/DeferredLog.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+#include <platform/atbm/LockProfiler.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+#include <platform/atbm/PowerGovernor.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+#include <platform/atbm/TaskProfiler.h>
+#endif
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+#include <platform/atbm/LogFilter.h>
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+#include <platform/atbm/FlashTrace.h>
+#endif
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+#include <platform/atbm/mbedtls/atbm_crypto_accel.h>
+#endif
 #include <platform/atbm/ATBMUtils.h>
 #include <platform/atbm/SystemTimeSupport.h>
 #include <platform/PlatformManager.h>
@@ -40,28 +61,72 @@ extern CHIP_ERROR InitLwIPCoreLock(void);
 }
 
 PlatformManagerImpl PlatformManagerImpl::sInstance;
+static_assert(WIFI_IP_EVENT_MAX <= UINT8_MAX, "ATBM event Ids must fit in the pending event ring");
+uint8_t PlatformManagerImpl::sPendingATBMEvents[kATBMEventRingSize];
+uint8_t PlatformManagerImpl::sPendingATBMEventHead;
+uint8_t PlatformManagerImpl::sPendingATBMEventCount;
+uint16_t PlatformManagerImpl::sDroppedATBMEvents;
+bool PlatformManagerImpl::sATBMEventDispatchScheduled;
 
 static int app_entropy_source(void * data, unsigned char * output, size_t len, size_t * olen)
 {
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+    if (atbm_crypto_random(output, len) != 0)
+    {
+        return -1;
+    }
+#else
     random_get_bytes(output, len);
+#endif
     *olen = len;
     return 0;
 }
 
 CHIP_ERROR PlatformManagerImpl::_InitChipStack(void)
 {
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+    Internal::LockProfiler::Reset();
+#endif
+
+#if CHIP_DEVICE_CONFIG_LOG_DEFERRED
+    ReturnErrorOnFailure(Internal::DeferredLog::Start());
+#endif
+
+#if CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE
+    ReturnErrorOnFailure(Internal::FlashTrace::Init());
+#endif
+
     // Make sure the LwIP core lock has been initialized
     ReturnErrorOnFailure(Internal::InitLwIPCoreLock());
 
     atbm_wifi_matter_event_handler_register(PlatformManagerImpl::HandleATBMSystemEvent);
     mStartTime = System::SystemClock().GetMonotonicTimestamp();
     ReturnErrorOnFailure(chip::Crypto::add_entropy_source(app_entropy_source, NULL, 16));
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+    const atbm_crypto_accel_t * accel = atbm_crypto_accel_get();
+    ChipLogProgress(DeviceLayer, "Crypto accelerator: %s", (accel != nullptr) ? accel->name : "none (software)");
+#endif
 
     // Call _InitChipStack() on the generic implementation base class
     // to finish the initialization process.
     ReturnErrorOnFailure(Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_InitChipStack());
 
+#if CHIP_DEVICE_CONFIG_LOG_RUNTIME_FILTER
+    // A corrupt filter record must not keep the stack from starting; log everything instead.
+    CHIP_ERROR err = Internal::LogFilter::Init();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Failed to load log filter: %" CHIP_ERROR_FORMAT, err.Format());
+        Internal::LogFilter::Reset();
+    }
+#endif
+
     ReturnErrorOnFailure(System::Clock::InitClock_RealTime());
+
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+    // Needs the system layer timers, started by the generic implementation.
+    ReturnErrorOnFailure(Internal::TaskProfiler::Start());
+#endif
     return CHIP_NO_ERROR;
 }
 
@@ -87,43 +152,147 @@ void PlatformManagerImpl::_Shutdown()
         ChipLogError(DeviceLayer, "Failed to get current uptime since the Node’s last reboot");
     }
 
+    // Carries the clock and its drift estimate over the reboot.
+    System::Clock::SaveClock_RealTime();
+
+#if CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER
+    Internal::TaskProfiler::Stop();
+#endif
+
     Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_Shutdown();
 }
 
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+CHIP_ERROR PlatformManagerImpl::_PostEvent(const ChipDeviceEvent * event)
+{
+    // Events the event loop posts to itself do not wake it up.
+    if (xTaskGetCurrentTaskHandle() != mEventLoopTask)
+    {
+        Internal::PowerGovernor::OnEventPosted(*event);
+    }
+    return Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_PostEvent(event);
+}
+
+CHIP_ERROR PlatformManagerImpl::_StartChipTimer(System::Clock::Timeout duration)
+{
+    Internal::PowerGovernor::OnChipTimerStarted(duration);
+    return Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_StartChipTimer(duration);
+}
+
+void PlatformManagerImpl::_DispatchEvent(const ChipDeviceEvent * event)
+{
+    Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_DispatchEvent(event);
+    if (uxQueueMessagesWaiting(mChipEventQueue) == 0)
+    {
+        Internal::PowerGovernor::OnEventLoopIdle();
+    }
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+void PlatformManagerImpl::_LockChipStack(void)
+{
+    if (Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_TryLockChipStack())
+    {
+        Internal::LockProfiler::OnAcquired(Internal::LockProfiler::kLock_ChipStack, false, 0);
+        return;
+    }
+
+    uint32_t waitStartUs = Internal::LockProfiler::Now();
+    Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_LockChipStack();
+    Internal::LockProfiler::OnAcquired(Internal::LockProfiler::kLock_ChipStack, true, waitStartUs);
+}
+
+bool PlatformManagerImpl::_TryLockChipStack(void)
+{
+    VerifyOrReturnValue(Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_TryLockChipStack(), false);
+    Internal::LockProfiler::OnAcquired(Internal::LockProfiler::kLock_ChipStack, false, 0);
+    return true;
+}
+
+void PlatformManagerImpl::_UnlockChipStack(void)
+{
+    Internal::LockProfiler::OnRelease(Internal::LockProfiler::kLock_ChipStack);
+    Internal::GenericPlatformManagerImpl_FreeRTOS<PlatformManagerImpl>::_UnlockChipStack();
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+
 void PlatformManagerImpl::HandleATBMSystemEvent(unsigned int eventId)//(int32_t eventId, void * eventData)
 {
-    ChipDeviceEvent event;
-    memset(&event, 0, sizeof(event));
-    event.Type                         = DeviceEventType::kATBMSystemEvent;
-    event.Platform.ATBMSystemEvent.Id   = eventId;
+    bool scheduleDispatch = false;
+
+    VerifyOrReturn(eventId < WIFI_IP_EVENT_MAX);
 
-    switch (eventId)
+    // Runs in the WiFi task: append the event to the ring and, unless a dispatch is already
+    // queued, queue one, so a burst costs at most one slot in the CHIP event queue.  Only an
+    // immediate repeat of the last pending event is merged; the handlers read the current
+    // WiFi/IP state, so it would not tell them anything new.  Events keep their arrival
+    // order, so e.g. a disconnect followed by a connect is seen as such.
+    taskENTER_CRITICAL();
+    uint8_t tail = static_cast<uint8_t>((sPendingATBMEventHead + sPendingATBMEventCount + kATBMEventRingSize - 1) %
+                                        kATBMEventRingSize);
+    if (sPendingATBMEventCount == 0 || sPendingATBMEvents[tail] != eventId)
     {
-#if CHIP_DEVICE_CONFIG_ENABLE_WIFI
-    case IP_EVENT_STA_GOT_IP:
-        //memcpy(&event.Platform.ATBMSystemEvent.Data.IpGotIp, eventData, sizeof(event.Platform.ATBMSystemEvent.Data.IpGotIp));
-        break;
-    case IP_EVENT_GOT_IP6:
-        //memcpy(&event.Platform.ATBMSystemEvent.Data.IpGotIp6, eventData, sizeof(event.Platform.ATBMSystemEvent.Data.IpGotIp6));
-        break;
-    case WIFI_EVENT_SCAN_DONE:
-        //memcpy(&event.Platform.ATBMSystemEvent.Data.WiFiStaScanDone, eventData,
-        //       sizeof(event.Platform.ATBMSystemEvent.Data.WiFiStaScanDone));
-        break;
-    case WIFI_EVENT_STA_CONNECTED:
-        //memcpy(&event.Platform.ATBMSystemEvent.Data.WiFiStaConnected, eventData,
-        //       sizeof(event.Platform.ATBMSystemEvent.Data.WiFiStaConnected));
-        break;
-    case WIFI_EVENT_STA_DISCONNECTED:
-        //memcpy(&event.Platform.ATBMSystemEvent.Data.WiFiStaDisconnected, eventData,
-        //       sizeof(event.Platform.ATBMSystemEvent.Data.WiFiStaDisconnected));
-        break;
-#endif
-    default:
-        break;
+        if (sPendingATBMEventCount == kATBMEventRingSize)
+        {
+            // Full: the oldest event goes, the latest transitions matter most.
+            sPendingATBMEventHead = static_cast<uint8_t>((sPendingATBMEventHead + 1) % kATBMEventRingSize);
+            sPendingATBMEventCount--;
+            sDroppedATBMEvents++;
+        }
+        tail                     = static_cast<uint8_t>((sPendingATBMEventHead + sPendingATBMEventCount) % kATBMEventRingSize);
+        sPendingATBMEvents[tail] = static_cast<uint8_t>(eventId);
+        sPendingATBMEventCount++;
+    }
+    if (!sATBMEventDispatchScheduled)
+    {
+        sATBMEventDispatchScheduled = true;
+        scheduleDispatch            = true;
     }
+    taskEXIT_CRITICAL();
+
+    if (scheduleDispatch && sInstance.ScheduleWork(DispatchATBMSystemEvents) != CHIP_NO_ERROR)
+    {
+        // The events stay pending; the next ATBM event retries the dispatch.
+        ChipLogError(DeviceLayer, "Failed to schedule ATBM event dispatch");
+        taskENTER_CRITICAL();
+        sATBMEventDispatchScheduled = false;
+        taskEXIT_CRITICAL();
+    }
+}
+
+void PlatformManagerImpl::DispatchATBMSystemEvents(intptr_t arg)
+{
+    uint8_t pending[kATBMEventRingSize];
+    uint8_t count;
+    uint16_t dropped;
 
-    sInstance.PostEventOrDie(&event);
+    taskENTER_CRITICAL();
+    count = sPendingATBMEventCount;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        pending[i] = sPendingATBMEvents[(sPendingATBMEventHead + i) % kATBMEventRingSize];
+    }
+    dropped                     = sDroppedATBMEvents;
+    sPendingATBMEventHead       = 0;
+    sPendingATBMEventCount      = 0;
+    sDroppedATBMEvents          = 0;
+    sATBMEventDispatchScheduled = false;
+    taskEXIT_CRITICAL();
+
+    if (dropped != 0)
+    {
+        ChipLogError(DeviceLayer, "ATBM event ring full: %u oldest events dropped", static_cast<unsigned>(dropped));
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        ChipDeviceEvent event;
+        memset(&event, 0, sizeof(event));
+        event.Type                        = DeviceEventType::kATBMSystemEvent;
+        event.Platform.ATBMSystemEvent.Id = pending[i];
+        sInstance.DispatchEvent(&event);
+    }
 }
 
 } // namespace DeviceLayer
@@ -58,6 +58,16 @@ private:
 
     CHIP_ERROR _InitChipStack(void);
     void _Shutdown();
+#if CHIP_DEVICE_CONFIG_ENABLE_LOCK_PROFILING
+    void _LockChipStack(void);
+    bool _TryLockChipStack(void);
+    void _UnlockChipStack(void);
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+    CHIP_ERROR _PostEvent(const ChipDeviceEvent * event);
+    CHIP_ERROR _StartChipTimer(System::Clock::Timeout duration);
+    void _DispatchEvent(const ChipDeviceEvent * event);
+#endif
 
     // ===== Members for internal use by the following friends.
 
@@ -66,6 +76,16 @@ private:
 
     System::Clock::Timestamp mStartTime = System::Clock::kZero;
 
+    static void DispatchATBMSystemEvents(intptr_t arg);
+
+    // ATBM events (WIFI_IP_EVENT) received but not dispatched yet, in arrival order.
+    static constexpr uint8_t kATBMEventRingSize = 16;
+    static uint8_t sPendingATBMEvents[kATBMEventRingSize];
+    static uint8_t sPendingATBMEventHead;
+    static uint8_t sPendingATBMEventCount;
+    static uint16_t sDroppedATBMEvents;
+    static bool sATBMEventDispatchScheduled;
+
     static PlatformManagerImpl sInstance;
 };
 
@@ -0,0 +1,290 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/PowerGovernor.h>
+
+#include <lib/support/CodeUtils.h>
+
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+#include <lwip/tcpip.h>
+#include <lwip/timeouts.h>
+#if CONFIG_ENABLE_ROUTE_HOOK
+#include <platform/atbm/route_hook/atbm_route_table.h>
+#endif
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+namespace {
+
+const char * const kSourceNames[PowerGovernor::kSource_Max]   = { "chip", "lwip", "route" };
+const char * const kWakeReasonNames[PowerGovernor::kWake_Max] = { "timer", "work", "ble", "network", "platform", "other" };
+
+constexpr uint32_t kSleepBucketLimitsMs[PowerGovernor::kSleepBuckets - 1] = { 10, 100, 1000, 10000 };
+
+// Updated from the CHIP thread and from the tasks posting events.
+PowerGovernor::Stats sStats;
+uint64_t sChipDeadlineMs;
+bool sChipTimerArmed;
+uint64_t sLastWakeMs;
+// Set by the first event posted while the event loop is idle; cleared once its queue drains.
+bool sLoopBusy;
+
+uint64_t NowMs()
+{
+    return System::SystemClock().GetMonotonicMilliseconds64().count();
+}
+
+size_t SleepBucket(uint64_t sleepMs)
+{
+    size_t bucket = 0;
+    while (bucket < ArraySize(kSleepBucketLimitsMs) && sleepMs >= kSleepBucketLimitsMs[bucket])
+    {
+        bucket++;
+    }
+    return bucket;
+}
+
+// Must be called in a critical section.
+void CountWake(PowerGovernor::WakeReason reason, uint64_t wakeMs)
+{
+    sStats.Wakes[reason]++;
+    sStats.SleepHistogram[SleepBucket((wakeMs > sLastWakeMs) ? wakeMs - sLastWakeMs : 0)]++;
+    sLastWakeMs = wakeMs;
+}
+
+// The CHIP timer expiry is not signalled to the platform, so it is counted the next time
+// the event loop is seen busy: when it re-arms the timer or receives an event.
+// Must be called in a critical section.
+void CountExpiredChipTimer(uint64_t nowMs)
+{
+    if (sChipTimerArmed && nowMs >= sChipDeadlineMs)
+    {
+        sChipTimerArmed = false;
+        CountWake(PowerGovernor::kWake_Timer, sChipDeadlineMs);
+    }
+}
+
+PowerGovernor::WakeReason GetWakeReason(const ChipDeviceEvent & event)
+{
+    switch (event.Type)
+    {
+    case DeviceEventType::kCallWorkFunction:
+        return PowerGovernor::kWake_Work;
+    case DeviceEventType::kCHIPoBLESubscribe:
+    case DeviceEventType::kCHIPoBLEUnsubscribe:
+    case DeviceEventType::kCHIPoBLEWriteReceived:
+    case DeviceEventType::kCHIPoBLEIndicateConfirm:
+    case DeviceEventType::kCHIPoBLEConnectionEstablished:
+    case DeviceEventType::kCHIPoBLEConnectionClosed:
+    case DeviceEventType::kCHIPoBLENotifyConfirm:
+        return PowerGovernor::kWake_Ble;
+    case DeviceEventType::kWiFiConnectivityChange:
+    case DeviceEventType::kInternetConnectivityChange:
+    case DeviceEventType::kInterfaceIpAddressChanged:
+        return PowerGovernor::kWake_Network;
+    default:
+        return DeviceEventType::IsPlatformSpecific(event.Type) ? PowerGovernor::kWake_Platform : PowerGovernor::kWake_Other;
+    }
+}
+
+// Earliest known wake-up in [earliestMs, latestMs], or 0.
+uint64_t FindScheduledWake(uint64_t nowMs, uint64_t earliestMs, uint64_t latestMs)
+{
+    uint64_t candidates[2] = { 0, 0 };
+    uint64_t wakeMs        = 0;
+
+    taskENTER_CRITICAL();
+    if (sChipTimerArmed)
+    {
+        candidates[0] = sChipDeadlineMs;
+    }
+    taskEXIT_CRITICAL();
+
+    LOCK_TCPIP_CORE();
+    u32_t lwipSleepMs = sys_timeouts_sleeptime();
+    UNLOCK_TCPIP_CORE();
+    if (lwipSleepMs != SYS_TIMEOUTS_SLEEPTIME_INFINITE)
+    {
+        candidates[1] = nowMs + lwipSleepMs;
+    }
+
+    for (uint64_t candidate : candidates)
+    {
+        if (candidate >= earliestMs && candidate <= latestMs && (wakeMs == 0 || candidate < wakeMs))
+        {
+            wakeMs = candidate;
+        }
+    }
+    return wakeMs;
+}
+
+} // namespace
+#endif // CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+
+CHIP_ERROR PowerGovernor::StartDeferrableTimer(System::Clock::Milliseconds32 delay, System::Clock::Milliseconds32 slack,
+                                               System::TimerCompleteCallback onComplete, void * appState)
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+    if (slack.count() > 0)
+    {
+        uint64_t nowMs      = NowMs();
+        uint64_t earliestMs = nowMs + delay.count();
+        uint64_t targetMs   = FindScheduledWake(nowMs, earliestMs, earliestMs + slack.count());
+
+        if (targetMs != 0)
+        {
+            taskENTER_CRITICAL();
+            sStats.CoalescedTimers++;
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            // Deferrable timers with the same slack end up on the same boundary.
+            targetMs = (earliestMs + slack.count() - 1) / slack.count() * slack.count();
+        }
+
+        taskENTER_CRITICAL();
+        sStats.DeferredTimers++;
+        taskEXIT_CRITICAL();
+        delay = System::Clock::Milliseconds32(static_cast<uint32_t>(targetMs - nowMs));
+    }
+#endif
+    return DeviceLayer::SystemLayer().StartTimer(delay, onComplete, appState);
+}
+
+CHIP_ERROR PowerGovernor::StartDeferrableTimer(System::Clock::Milliseconds32 delay, System::TimerCompleteCallback onComplete,
+                                               void * appState)
+{
+    return StartDeferrableTimer(delay, System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_POWER_GOVERNOR_TIMER_SLACK), onComplete,
+                                appState);
+}
+
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+void PowerGovernor::OnChipTimerStarted(System::Clock::Timeout duration)
+{
+    uint64_t nowMs = NowMs();
+
+    taskENTER_CRITICAL();
+    CountExpiredChipTimer(nowMs);
+    sChipDeadlineMs = nowMs + duration.count();
+    sChipTimerArmed = true;
+    taskEXIT_CRITICAL();
+}
+
+void PowerGovernor::OnEventPosted(const ChipDeviceEvent & event)
+{
+    uint64_t nowMs    = NowMs();
+    WakeReason reason = GetWakeReason(event);
+
+    taskENTER_CRITICAL();
+    CountExpiredChipTimer(nowMs);
+    if (!sLoopBusy)
+    {
+        sLoopBusy = true;
+        CountWake(reason, nowMs);
+    }
+    taskEXIT_CRITICAL();
+}
+
+void PowerGovernor::OnEventLoopIdle()
+{
+    taskENTER_CRITICAL();
+    sLoopBusy = false;
+    taskEXIT_CRITICAL();
+}
+
+void PowerGovernor::GetSleepPlan(SleepPlan & plan)
+{
+    uint64_t nowMs = NowMs();
+
+    for (uint32_t & sourceMs : plan.SourceMs)
+    {
+        sourceMs = kNoDeadline;
+    }
+
+    taskENTER_CRITICAL();
+    if (sChipTimerArmed)
+    {
+        plan.SourceMs[kSource_ChipTimer] = (sChipDeadlineMs > nowMs) ? static_cast<uint32_t>(sChipDeadlineMs - nowMs) : 0;
+    }
+    taskEXIT_CRITICAL();
+
+    LOCK_TCPIP_CORE();
+    plan.SourceMs[kSource_LwIPTimeout] = sys_timeouts_sleeptime();
+#if CONFIG_ENABLE_ROUTE_HOOK
+    plan.SourceMs[kSource_RouteExpiry] = atbm_route_table_next_expiry_ms();
+#endif
+    UNLOCK_TCPIP_CORE();
+
+    plan.SleepMs   = kNoDeadline;
+    plan.LimitedBy = kSource_ChipTimer;
+    for (uint8_t source = 0; source < kSource_Max; source++)
+    {
+        if (plan.SourceMs[source] < plan.SleepMs)
+        {
+            plan.SleepMs   = plan.SourceMs[source];
+            plan.LimitedBy = static_cast<Source>(source);
+        }
+    }
+}
+
+void PowerGovernor::GetStats(Stats & stats)
+{
+    uint64_t nowMs = NowMs();
+
+    taskENTER_CRITICAL();
+    CountExpiredChipTimer(nowMs);
+    stats = sStats;
+    taskEXIT_CRITICAL();
+}
+
+const char * PowerGovernor::GetSourceName(Source source)
+{
+    return (source < kSource_Max) ? kSourceNames[source] : "?";
+}
+
+const char * PowerGovernor::GetWakeReasonName(WakeReason reason)
+{
+    return (reason < kWake_Max) ? kWakeReasonNames[reason] : "?";
+}
+
+void PowerGovernor::Reset()
+{
+    uint64_t nowMs = NowMs();
+
+    taskENTER_CRITICAL();
+    memset(&sStats, 0, sizeof(sStats));
+    sLastWakeMs = nowMs;
+    taskEXIT_CRITICAL();
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,132 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Wake-up accounting and timer coalescing for the CHIP event loop on ATBM
+ *          platforms, on top of the FreeRTOS tickless idle.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <platform/CHIPDeviceEvent.h>
+#include <system/SystemLayer.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * With configUSE_TICKLESS_IDLE the kernel already light sleeps until the earliest task
+ * timeout, so the length of each sleep is set by the deadlines the tasks block on: the
+ * CHIP timers (CHIP event loop), the lwIP sys_timeouts including the route table expiries
+ * (tcpip thread) and the NimBLE callouts (FreeRTOS timer task).  What is left to the
+ * platform is to not create wake-ups that could have been merged:
+ *
+ *  - StartDeferrableTimer() is for housekeeping timers that tolerate some lateness.  Their
+ *    expiry is moved within the allowed slack onto a wake-up that is already scheduled,
+ *    or else onto a common CHIP_DEVICE_CONFIG_POWER_GOVERNOR_TIMER_SLACK boundary so that
+ *    they fire together.  Timers that a controller or user waits on keep using
+ *    SystemLayer().StartTimer() directly and are never delayed.
+ *
+ *  - With CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR, the CHIP event loop wake-ups are
+ *    counted by reason along with the time slept before each, and GetSleepPlan() reports
+ *    which deadline currently bounds the sleep.
+ */
+class PowerGovernor
+{
+public:
+    enum Source : uint8_t
+    {
+        kSource_ChipTimer = 0,
+        kSource_LwIPTimeout,
+        kSource_RouteExpiry, // Also an lwIP timeout; reported on its own. Needs CONFIG_ENABLE_ROUTE_HOOK.
+        kSource_Max,
+    };
+
+    enum WakeReason : uint8_t
+    {
+        kWake_Timer = 0,
+        kWake_Work, // ScheduleWork(), including the dispatch of ATBM system events.
+        kWake_Ble,
+        kWake_Network,
+        kWake_Platform,
+        kWake_Other,
+        kWake_Max,
+    };
+
+    static constexpr uint32_t kNoDeadline = UINT32_MAX;
+
+    // Sleep histogram bucket upper bounds: <10ms, <100ms, <1s, <10s, >=10s.
+    static constexpr size_t kSleepBuckets = 5;
+
+    struct SleepPlan
+    {
+        uint32_t SleepMs; // Until the earliest deadline, kNoDeadline if there is none.
+        Source LimitedBy;
+        uint32_t SourceMs[kSource_Max];
+    };
+
+    struct Stats
+    {
+        uint32_t Wakes[kWake_Max];
+        uint32_t SleepHistogram[kSleepBuckets];
+        uint32_t DeferredTimers;
+        uint32_t CoalescedTimers; // Deferrable timers that shared an already scheduled wake-up.
+    };
+
+    /**
+     * Starts a timer that may fire up to slack later than delay, to share a wake-up.
+     * Must be called with the CHIP stack lock held, like SystemLayer().StartTimer().
+     */
+    static CHIP_ERROR StartDeferrableTimer(System::Clock::Milliseconds32 delay, System::Clock::Milliseconds32 slack,
+                                           System::TimerCompleteCallback onComplete, void * appState);
+
+    /** Same, with a slack of CHIP_DEVICE_CONFIG_POWER_GOVERNOR_TIMER_SLACK. */
+    static CHIP_ERROR StartDeferrableTimer(System::Clock::Milliseconds32 delay, System::TimerCompleteCallback onComplete,
+                                           void * appState);
+
+#if CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+    /** Called by PlatformManagerImpl when the system layer arms the CHIP timer. */
+    static void OnChipTimerStarted(System::Clock::Timeout duration);
+
+    /**
+     * Called by PlatformManagerImpl for events posted to the CHIP event loop from another task.
+     * Only the first event posted while the loop is idle is counted as a wake.
+     */
+    static void OnEventPosted(const ChipDeviceEvent & event);
+
+    /** Called by PlatformManagerImpl when the CHIP event queue has been drained. */
+    static void OnEventLoopIdle();
+
+    /** Reads the deadlines; takes the LwIP core lock. */
+    static void GetSleepPlan(SleepPlan & plan);
+
+    static void GetStats(Stats & stats);
+    static const char * GetSourceName(Source source);
+    static const char * GetWakeReasonName(WakeReason reason);
+    static void Reset();
+#endif // CHIP_DEVICE_CONFIG_ENABLE_POWER_GOVERNOR
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
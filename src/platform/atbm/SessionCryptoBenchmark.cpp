@@ -0,0 +1,132 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/SessionCryptoBenchmark.h>
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <crypto/RawKeySessionKeystore.h>
+#include <lib/support/CodeUtils.h>
+#include <system/SystemClock.h>
+
+#include <string.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+const char * const kOpNames[SessionCryptoBenchmark::kOp_Max] = { "encrypt", "decrypt", "sha256" };
+
+// A single attribute report, a small invoke, a typical report and a full IM chunk.
+const size_t kPayloadSizes[SessionCryptoBenchmark::kNumPayloadSizes] = { 64, 256, 512, 1024 };
+
+// Unsecured message header with source node ID, the usual AAD of a session message.
+constexpr size_t kAadLen = 16;
+
+// Static: the shell task stack is too small for these.
+uint8_t sPlaintext[1024];
+uint8_t sCiphertext[sizeof(sPlaintext)];
+uint8_t sDecrypted[sizeof(sPlaintext)];
+
+// The ATBM microsecond clock is 32 bits wide; single operations are far shorter than a wrap.
+uint32_t NowUs()
+{
+    return static_cast<uint32_t>(System::SystemClock().GetMonotonicMicroseconds64().count());
+}
+
+void Add(SessionCryptoBenchmark::Result & result, uint32_t startUs)
+{
+    result.Iterations++;
+    result.TotalUs += static_cast<uint32_t>(NowUs() - startUs);
+}
+
+CHIP_ERROR RunSize(const Crypto::Aes128KeyHandle & key, size_t len, uint8_t index, SessionCryptoBenchmark::Results & results)
+{
+    uint8_t aad[kAadLen];
+    uint8_t nonce[Crypto::kAES_CCM128_Nonce_Length];
+    uint8_t tag[Crypto::kAES_CCM128_Tag_Length];
+    uint8_t hash[Crypto::kSHA256_Hash_Length];
+    uint32_t start;
+
+    ReturnErrorOnFailure(Crypto::DRBG_get_bytes(aad, sizeof(aad)));
+    ReturnErrorOnFailure(Crypto::DRBG_get_bytes(nonce, sizeof(nonce)));
+
+    start = NowUs();
+    ReturnErrorOnFailure(
+        Crypto::AES_CCM_encrypt(sPlaintext, len, aad, sizeof(aad), key, nonce, sizeof(nonce), sCiphertext, tag, sizeof(tag)));
+    Add(results[SessionCryptoBenchmark::kOp_Encrypt][index], start);
+
+    start = NowUs();
+    ReturnErrorOnFailure(
+        Crypto::AES_CCM_decrypt(sCiphertext, len, aad, sizeof(aad), tag, sizeof(tag), key, nonce, sizeof(nonce), sDecrypted));
+    Add(results[SessionCryptoBenchmark::kOp_Decrypt][index], start);
+    VerifyOrReturnError(memcmp(sPlaintext, sDecrypted, len) == 0, CHIP_ERROR_INTERNAL);
+
+    start = NowUs();
+    ReturnErrorOnFailure(Crypto::Hash_SHA256(sPlaintext, len, hash));
+    Add(results[SessionCryptoBenchmark::kOp_SHA256][index], start);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace
+
+CHIP_ERROR SessionCryptoBenchmark::Run(uint32_t iterations, Results & results)
+{
+    Crypto::RawKeySessionKeystore keystore;
+    Crypto::Symmetric128BitsKeyByteArray keyMaterial;
+    Crypto::Aes128KeyHandle key;
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    memset(results, 0, sizeof(results));
+    VerifyOrReturnError(iterations > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReturnErrorOnFailure(Crypto::DRBG_get_bytes(sPlaintext, sizeof(sPlaintext)));
+    ReturnErrorOnFailure(Crypto::DRBG_get_bytes(keyMaterial, sizeof(keyMaterial)));
+    ReturnErrorOnFailure(keystore.CreateKey(keyMaterial, key));
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        for (uint8_t index = 0; index < kNumPayloadSizes; index++)
+        {
+            err = RunSize(key, kPayloadSizes[index], index, results);
+            SuccessOrExit(err);
+        }
+    }
+
+exit:
+    keystore.DestroyKey(key);
+    Crypto::ClearSecretData(keyMaterial);
+    return err;
+}
+
+const char * SessionCryptoBenchmark::GetOpName(Op op)
+{
+    return (op < kOp_Max) ? kOpNames[op] : "?";
+}
+
+size_t SessionCryptoBenchmark::GetPayloadSize(uint8_t index)
+{
+    return (index < kNumPayloadSizes) ? kPayloadSizes[index] : 0;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
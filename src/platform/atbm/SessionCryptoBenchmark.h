@@ -0,0 +1,73 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Per-message crypto cost benchmark for ATBM platforms
+ *          (CHIP_DEVICE_CONFIG_ENABLE_SESSION_CRYPTO_BENCHMARK).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Times what a secure session pays per message through the CHIP crypto PAL: AES-CCM
+ * encryption and decryption (with a message header sized AAD) and SHA-256, for
+ * Interaction Model payloads from a single attribute report up to a full chunk.
+ * Runs on the device through the "atbm crypto" shell command and on the host through
+ * the atbm-crypto-bench executable.
+ *
+ * Run() blocks the calling task for iterations x all operations x all sizes.
+ */
+class SessionCryptoBenchmark
+{
+public:
+    enum Op : uint8_t
+    {
+        kOp_Encrypt = 0,
+        kOp_Decrypt,
+        kOp_SHA256,
+        kOp_Max,
+    };
+
+    static constexpr uint8_t kNumPayloadSizes = 4;
+
+    struct Result
+    {
+        uint32_t Iterations;
+        uint64_t TotalUs;
+    };
+
+    using Results = Result[kOp_Max][kNumPayloadSizes];
+
+    static CHIP_ERROR Run(uint32_t iterations, Results & results);
+
+    static const char * GetOpName(Op op);
+    static size_t GetPayloadSize(uint8_t index);
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
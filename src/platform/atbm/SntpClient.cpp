@@ -0,0 +1,297 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/SntpClient.h>
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/atbm/PowerGovernor.h>
+#include <platform/atbm/SystemTimeSupport.h>
+
+#include <lwip/apps/sntp_opts.h>
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
+
+#include <string.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+SntpClient * sClient = nullptr;
+
+constexpr size_t kPacketLen = 48;
+
+// LI 0, version 4, mode 3 (client).
+constexpr uint8_t kRequestFlags = 0x23;
+constexpr uint8_t kModeServer   = 4;
+constexpr uint8_t kLeapAlarm    = 3;
+
+constexpr size_t kOriginateOffset = 24;
+constexpr size_t kReceiveOffset   = 32;
+constexpr size_t kTransmitOffset  = 40;
+
+// Seconds from the NTP epoch (1900) to the Unix epoch.
+constexpr uint64_t kNtpToUnixSec = UINT64_C(2208988800);
+
+// Handed over from the TCP/IP thread; one exchange is in flight at a time.
+ip_addr_t sServerAddr;
+uint8_t sResponse[kPacketLen];
+uint64_t sResponseMonotonicUs;
+
+uint64_t NtpToUnixUs(const uint8_t * timestamp)
+{
+    uint64_t sec  = Encoding::BigEndian::Get32(timestamp);
+    uint64_t frac = Encoding::BigEndian::Get32(timestamp + 4);
+
+    // NTP era 1 starts in 2036; timestamps with the top bit clear belong to it.
+    if ((sec & 0x80000000) == 0)
+    {
+        sec += UINT64_C(1) << 32;
+    }
+    return (sec - kNtpToUnixSec) * 1000000 + ((frac * 1000000) >> 32);
+}
+
+void * GenerationArg(uint8_t generation)
+{
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(generation));
+}
+
+} // namespace
+
+void SntpClient::Init()
+{
+    sClient       = this;
+    mRetryDelayMs = SNTP_RETRY_TIMEOUT;
+}
+
+void SntpClient::OnConnectivityChanged(bool haveConnectivity)
+{
+    VerifyOrReturn(haveConnectivity != mConnected);
+    mConnected = haveConnectivity;
+
+    Abort();
+    if (mConnected)
+    {
+        // Leave the first seconds of the connection to commissioning traffic.
+        mState = State::kWaitStart;
+        DeviceLayer::SystemLayer().StartTimer(System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_SNTP_STARTUP_DELAY), HandleTimer,
+                                              this);
+    }
+}
+
+void SntpClient::Start()
+{
+    ip_addr_t addr;
+    err_t err;
+
+    mState = State::kResolving;
+    mGeneration++;
+    DeviceLayer::SystemLayer().StartTimer(System::Clock::Milliseconds32(SNTP_RECV_TIMEOUT), HandleTimer, this);
+
+    LOCK_TCPIP_CORE();
+    err = dns_gethostbyname(CHIP_DEVICE_CONFIG_SNTP_SERVER, &addr, HandleDnsFound, GenerationArg(mGeneration));
+    UNLOCK_TCPIP_CORE();
+
+    if (err == ERR_OK)
+    {
+        SendRequest(addr);
+    }
+    else if (err != ERR_INPROGRESS)
+    {
+        ChipLogError(DeviceLayer, "SNTP: cannot resolve %s: %d", CHIP_DEVICE_CONFIG_SNTP_SERVER, err);
+        Finish(false);
+    }
+}
+
+void SntpClient::SendRequest(const ip_addr_t & server)
+{
+    err_t err = ERR_MEM;
+
+    // A random transmit timestamp does not disclose the local clock and lets the
+    // originate timestamp of the response authenticate it.
+    if (Crypto::DRBG_get_bytes(mCookie, sizeof(mCookie)) != CHIP_NO_ERROR)
+    {
+        Finish(false);
+        return;
+    }
+
+    LOCK_TCPIP_CORE();
+    if (mPcb == nullptr)
+    {
+        mPcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+    }
+    struct pbuf * p = pbuf_alloc(PBUF_TRANSPORT, kPacketLen, PBUF_RAM);
+    if (mPcb != nullptr && p != nullptr)
+    {
+        uint8_t * packet = static_cast<uint8_t *>(p->payload);
+        memset(packet, 0, kPacketLen);
+        packet[0] = kRequestFlags;
+        memcpy(packet + kTransmitOffset, mCookie, sizeof(mCookie));
+
+        udp_recv(mPcb, HandleRecv, GenerationArg(mGeneration));
+        mRequestMonotonicUs = System::SystemClock().GetMonotonicMicroseconds64().count();
+        err                 = udp_sendto(mPcb, p, &server, SNTP_PORT);
+    }
+    if (p != nullptr)
+    {
+        pbuf_free(p);
+    }
+    UNLOCK_TCPIP_CORE();
+
+    if (err != ERR_OK)
+    {
+        ChipLogError(DeviceLayer, "SNTP: send failed: %d", err);
+        Finish(false);
+        return;
+    }
+    mState = State::kWaitResponse;
+}
+
+void SntpClient::OnResponse(const uint8_t * packet, uint64_t receiveMonotonicUs)
+{
+    uint8_t stratum = packet[1];
+
+    if ((packet[0] & 0x07) != kModeServer || (packet[0] >> 6) == kLeapAlarm || stratum == 0 || stratum > 15 ||
+        memcmp(packet + kOriginateOffset, mCookie, sizeof(mCookie)) != 0)
+    {
+        ChipLogError(DeviceLayer, "SNTP: invalid response (stratum %u)", stratum);
+        Finish(false);
+        return;
+    }
+
+    // The server's transmit time plus half the network round trip.
+    uint64_t serverReceiveUs  = NtpToUnixUs(packet + kReceiveOffset);
+    uint64_t serverTransmitUs = NtpToUnixUs(packet + kTransmitOffset);
+    uint64_t roundTripUs      = receiveMonotonicUs - mRequestMonotonicUs;
+    uint64_t serverUs         = (serverTransmitUs > serverReceiveUs) ? serverTransmitUs - serverReceiveUs : 0;
+    uint64_t delayUs          = (roundTripUs > serverUs) ? roundTripUs - serverUs : 0;
+
+    CHIP_ERROR err = System::Clock::SetClock_NetworkTime(System::Clock::Microseconds64(serverTransmitUs + delayUs / 2),
+                                                         System::Clock::Microseconds64(receiveMonotonicUs));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "SNTP: time rejected: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+    Finish(err == CHIP_NO_ERROR);
+}
+
+void SntpClient::Finish(bool success)
+{
+    uint32_t delayMs;
+
+    Abort();
+    VerifyOrReturn(mConnected);
+
+    if (success)
+    {
+        mRetryDelayMs = SNTP_RETRY_TIMEOUT;
+        delayMs       = CHIP_DEVICE_CONFIG_SNTP_RESYNC_INTERVAL;
+    }
+    else
+    {
+        delayMs       = mRetryDelayMs;
+        mRetryDelayMs = (mRetryDelayMs * 2 < SNTP_RETRY_TIMEOUT_MAX) ? mRetryDelayMs * 2 : SNTP_RETRY_TIMEOUT_MAX;
+    }
+    mState = State::kWaitStart;
+    PowerGovernor::StartDeferrableTimer(System::Clock::Milliseconds32(delayMs), HandleTimer, this);
+}
+
+void SntpClient::Abort()
+{
+    DeviceLayer::SystemLayer().CancelTimer(HandleTimer, this);
+    if (mPcb != nullptr)
+    {
+        LOCK_TCPIP_CORE();
+        udp_remove(mPcb);
+        UNLOCK_TCPIP_CORE();
+        mPcb = nullptr;
+    }
+    // Results of the aborted exchange still queued for the CHIP thread are ignored.
+    mGeneration++;
+    mState = State::kIdle;
+}
+
+void SntpClient::HandleTimer(System::Layer * aLayer, void * aAppState)
+{
+    auto * self = static_cast<SntpClient *>(aAppState);
+
+    if (self->mState == State::kWaitStart)
+    {
+        self->Start();
+        return;
+    }
+    ChipLogError(DeviceLayer, "SNTP: no response from %s", CHIP_DEVICE_CONFIG_SNTP_SERVER);
+    self->Finish(false);
+}
+
+void SntpClient::HandleDnsFound(const char * name, const ip_addr_t * ipaddr, void * callbackArg)
+{
+    // Runs in the TCP/IP thread.
+    uintptr_t generation = reinterpret_cast<uintptr_t>(callbackArg);
+    if (ipaddr != nullptr)
+    {
+        sServerAddr = *ipaddr;
+    }
+    PlatformMgr().ScheduleWork(HandleDnsWork, static_cast<intptr_t>(generation | ((ipaddr != nullptr) ? 0x100 : 0)));
+}
+
+void SntpClient::HandleDnsWork(intptr_t arg)
+{
+    VerifyOrReturn(sClient != nullptr && sClient->mState == State::kResolving);
+    VerifyOrReturn(static_cast<uint8_t>(arg) == sClient->mGeneration);
+
+    if ((arg & 0x100) == 0)
+    {
+        ChipLogError(DeviceLayer, "SNTP: cannot resolve %s", CHIP_DEVICE_CONFIG_SNTP_SERVER);
+        sClient->Finish(false);
+        return;
+    }
+    sClient->SendRequest(sServerAddr);
+}
+
+void SntpClient::HandleRecv(void * arg, struct udp_pcb * pcb, struct pbuf * p, const ip_addr_t * addr, u16_t port)
+{
+    // Runs in the TCP/IP thread.  Only the first datagram is taken, so that sResponse is
+    // not rewritten while the CHIP thread reads it.
+    uint64_t nowUs = System::SystemClock().GetMonotonicMicroseconds64().count();
+
+    if (p->tot_len >= kPacketLen && pbuf_copy_partial(p, sResponse, kPacketLen, 0) == kPacketLen)
+    {
+        sResponseMonotonicUs = nowUs;
+        udp_recv(pcb, nullptr, nullptr);
+        PlatformMgr().ScheduleWork(HandleRecvWork, static_cast<intptr_t>(reinterpret_cast<uintptr_t>(arg)));
+    }
+    pbuf_free(p);
+}
+
+void SntpClient::HandleRecvWork(intptr_t arg)
+{
+    VerifyOrReturn(sClient != nullptr && sClient->mState == State::kWaitResponse);
+    VerifyOrReturn(static_cast<uint8_t>(arg) == sClient->mGeneration);
+    sClient->OnResponse(sResponse, sResponseMonotonicUs);
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,87 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          SNTP client setting the real time clock on ATBM platforms.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <system/SystemLayer.h>
+
+#include <lwip/ip_addr.h>
+#include <lwip/pbuf.h>
+#include <lwip/udp.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Sets the real time clock (System::Clock::SetClock_NetworkTime) from
+ * CHIP_DEVICE_CONFIG_SNTP_SERVER, once CHIP_DEVICE_CONFIG_SNTP_STARTUP_DELAY after IP
+ * connectivity comes up and then every CHIP_DEVICE_CONFIG_SNTP_RESYNC_INTERVAL, which
+ * also feeds the drift estimate.  Failed attempts are retried with the exponential
+ * backoff of lwIP's sntp_opts.h.
+ *
+ * The exchange is a single unicast request on the lwIP raw UDP API: nothing blocks, and
+ * the DNS and receive callbacks only hand their result over to the CHIP thread.
+ *
+ * All methods must be called from the CHIP thread.
+ */
+class SntpClient
+{
+public:
+    void Init();
+
+    void OnConnectivityChanged(bool haveConnectivity);
+
+private:
+    enum class State : uint8_t
+    {
+        kIdle,
+        kWaitStart,
+        kResolving,
+        kWaitResponse,
+    };
+
+    void Start();
+    void SendRequest(const ip_addr_t & server);
+    void OnResponse(const uint8_t * packet, uint64_t receiveMonotonicUs);
+    void Finish(bool success);
+    void Abort();
+
+    static void HandleTimer(System::Layer * aLayer, void * aAppState);
+    static void HandleDnsFound(const char * name, const ip_addr_t * ipaddr, void * callbackArg);
+    static void HandleDnsWork(intptr_t arg);
+    static void HandleRecv(void * arg, struct udp_pcb * pcb, struct pbuf * p, const ip_addr_t * addr, u16_t port);
+    static void HandleRecvWork(intptr_t arg);
+
+    struct udp_pcb * mPcb = nullptr;
+    uint64_t mRequestMonotonicUs;
+    uint32_t mRetryDelayMs;
+    uint8_t mCookie[8];
+    uint8_t mGeneration = 0;
+    State mState        = State::kIdle;
+    bool mConnected     = false;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
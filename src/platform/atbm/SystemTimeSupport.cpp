@@ -25,7 +25,10 @@
 /* this file behaves like a config.h, comes first */
 #include <platform/internal/CHIPDeviceLayerInternal.h>
 
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <platform/atbm/ATBMConfig.h>
 #include <platform/atbm/SystemTimeSupport.h>
 
 namespace chip {
@@ -36,9 +39,90 @@ namespace Internal {
 ClockImpl gClockImpl;
 } // namespace Internal
 
+namespace {
+
+using DeviceLayer::Internal::ATBMConfig;
+
+// Largest oscillator error the drift estimate may correct.
+constexpr int32_t kMaxDriftPpb = 500000;
+
+// Shortest interval between two network updates that is used to estimate the drift, and
+// largest correction still treated as drift rather than as a step of the clock.
+constexpr uint64_t kMinDriftIntervalUs = 10 * 60 * UINT64_C(1000000);
+constexpr int64_t kMaxDriftErrorUs     = 1000000;
+
+// Saved record: UTC time (us), drift (ppb), record version.
+constexpr uint32_t kRealTimeRecordVersion = 1;
+constexpr size_t kRealTimeRecordLen       = 16;
+
+// hal_get_os_us_time() wraps every ~71.6 minutes; the wraps are counted here.
+uint32_t sLastMonotonicUs;
+uint64_t sMonotonicEpochUs;
+
+// Real time is RefUtcUs + elapsed + elapsed * DriftPpb / 10^9, elapsed being the
+// monotonic time since RefMonotonicUs.  Updated under a critical section so that
+// readers on any task see a consistent reference.
+struct RealTimeState
+{
+    uint64_t RefMonotonicUs;
+    uint64_t RefUtcUs;
+    int32_t DriftPpb;
+    bool Valid;
+    bool NetworkSynced;
+};
+
+RealTimeState sRealTime;
+
+int32_t ClampDrift(int64_t driftPpb)
+{
+    return static_cast<int32_t>(driftPpb < -kMaxDriftPpb ? -kMaxDriftPpb : (driftPpb > kMaxDriftPpb ? kMaxDriftPpb : driftPpb));
+}
+
+int64_t DriftCorrectionUs(uint64_t elapsedUs, int32_t driftPpb)
+{
+    // Split to stay within 64 bits for elapsed times of years.
+    return static_cast<int64_t>(elapsedUs / 1000) * driftPpb / 1000000;
+}
+
+uint64_t RealTimeAt(const RealTimeState & state, uint64_t monotonicUs)
+{
+    // A timestamp older than the reference (e.g. one passed to SetClock_NetworkTime()) counts
+    // as no time elapsed rather than wrapping the difference.
+    uint64_t elapsedUs = (monotonicUs > state.RefMonotonicUs) ? monotonicUs - state.RefMonotonicUs : 0;
+    return state.RefUtcUs + elapsedUs + static_cast<uint64_t>(DriftCorrectionUs(elapsedUs, state.DriftPpb));
+}
+
+// Called with the critical section held.  The CHIP event loop reads the clock far more
+// often than once per wrap.
+uint64_t ReadMonotonicUsLocked()
+{
+    uint32_t halUs = ::hal_get_os_us_time();
+    if (halUs < sLastMonotonicUs)
+    {
+        sMonotonicEpochUs += UINT64_C(1) << 32;
+    }
+    sLastMonotonicUs = halUs;
+    return sMonotonicEpochUs + halUs;
+}
+
+void SetReference(uint64_t utcUs, uint64_t monotonicUs)
+{
+    sRealTime.RefUtcUs       = utcUs;
+    sRealTime.RefMonotonicUs = monotonicUs;
+    sRealTime.Valid          = true;
+}
+
+} // namespace
+
 Microseconds64 ClockImpl::GetMonotonicMicroseconds64(void)
 {
-    return Clock::Microseconds64(::hal_get_os_us_time());
+    uint64_t nowUs;
+
+    taskENTER_CRITICAL();
+    nowUs = ReadMonotonicUsLocked();
+    taskEXIT_CRITICAL();
+
+    return Clock::Microseconds64(nowUs);
 }
 
 Milliseconds64 ClockImpl::GetMonotonicMilliseconds64(void)
@@ -48,7 +132,18 @@ Milliseconds64 ClockImpl::GetMonotonicMilliseconds64(void)
 
 CHIP_ERROR ClockImpl::GetClock_RealTime(Microseconds64 & aCurTime)
 {
-    return CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE;
+    uint64_t monotonicUs;
+    RealTimeState state;
+
+    // Sample the clock with the reference it is compared to.
+    taskENTER_CRITICAL();
+    monotonicUs = ReadMonotonicUsLocked();
+    state       = sRealTime;
+    taskEXIT_CRITICAL();
+
+    VerifyOrReturnError(state.Valid, CHIP_ERROR_REAL_TIME_NOT_SYNCED);
+    aCurTime = Microseconds64(RealTimeAt(state, monotonicUs));
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR ClockImpl::GetClock_RealTimeMS(Milliseconds64 & aCurTime)
@@ -61,28 +156,106 @@ CHIP_ERROR ClockImpl::GetClock_RealTimeMS(Milliseconds64 & aCurTime)
 
 CHIP_ERROR ClockImpl::SetClock_RealTime(Microseconds64 aNewCurTime)
 {
-#if 0
-    struct timeval tv;
-    tv.tv_sec  = static_cast<time_t>(aNewCurTime.count() / UINT64_C(1000000));
-    tv.tv_usec = static_cast<long>(aNewCurTime.count() % UINT64_C(1000000));
-    if (settimeofday(&tv, nullptr) != 0)
+    uint64_t monotonicUs = GetMonotonicMicroseconds64().count();
+
+    taskENTER_CRITICAL();
+    SetReference(aNewCurTime.count(), monotonicUs);
+    taskEXIT_CRITICAL();
+
+    SaveClock_RealTime();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SetClock_NetworkTime(Microseconds64 utcTime, Microseconds64 monotonicTime)
+{
+    uint64_t utcUs       = utcTime.count();
+    uint64_t monotonicUs = monotonicTime.count();
+    int64_t errorUs      = 0;
+    int32_t driftPpb;
+
+    VerifyOrReturnError(utcUs >= static_cast<uint64_t>(CHIP_SYSTEM_CONFIG_VALID_REAL_TIME_THRESHOLD) * UINT64_C(1000000),
+                        CHIP_ERROR_INVALID_TIME);
+
+    taskENTER_CRITICAL();
+    if (sRealTime.NetworkSynced && monotonicUs > sRealTime.RefMonotonicUs &&
+        monotonicUs - sRealTime.RefMonotonicUs >= kMinDriftIntervalUs)
     {
-        return (errno == EPERM) ? CHIP_ERROR_ACCESS_DENIED : CHIP_ERROR_POSIX(errno);
+        errorUs = static_cast<int64_t>(utcUs - RealTimeAt(sRealTime, monotonicUs));
+        if (errorUs > -kMaxDriftErrorUs && errorUs < kMaxDriftErrorUs)
+        {
+            // 1 us of error per second is 1000 ppb; the previous estimate is already in the prediction.
+            int64_t elapsedSec = static_cast<int64_t>((monotonicUs - sRealTime.RefMonotonicUs) / 1000000);
+            sRealTime.DriftPpb = ClampDrift(sRealTime.DriftPpb + errorUs * 1000 / elapsedSec);
+        }
     }
-#endif
+    SetReference(utcUs, monotonicUs);
+    sRealTime.NetworkSynced = true;
+    driftPpb                = sRealTime.DriftPpb;
+    taskEXIT_CRITICAL();
+
+    ChipLogProgress(DeviceLayer, "Real time set from network: %" PRIu32 " s, error %" PRId32 " ms, drift %" PRId32 " ppb",
+                    static_cast<uint32_t>(utcUs / 1000000), static_cast<int32_t>(errorUs / 1000), driftPpb);
+    SaveClock_RealTime();
     return CHIP_NO_ERROR;
 }
 
+bool IsClock_NetworkSynced()
+{
+    return sRealTime.NetworkSynced;
+}
+
+int32_t GetClock_DriftPpb()
+{
+    return sRealTime.DriftPpb;
+}
+
+void SaveClock_RealTime()
+{
+    uint8_t record[kRealTimeRecordLen];
+    Microseconds64 utcTime;
+    int32_t driftPpb = sRealTime.DriftPpb;
+
+    VerifyOrReturn(SystemClock().GetClock_RealTime(utcTime) == CHIP_NO_ERROR);
+
+    Encoding::LittleEndian::Put64(&record[0], utcTime.count());
+    Encoding::LittleEndian::Put32(&record[8], static_cast<uint32_t>(driftPpb));
+    Encoding::LittleEndian::Put32(&record[12], kRealTimeRecordVersion);
+
+    CHIP_ERROR err = ATBMConfig::WriteConfigValueBin(ATBMConfig::kConfigKey_RealTime, record, sizeof(record));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Failed to save real time: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
 CHIP_ERROR InitClock_RealTime()
 {
-    Clock::Microseconds64 curTime =
-        Clock::Microseconds64((static_cast<uint64_t>(CHIP_SYSTEM_CONFIG_VALID_REAL_TIME_THRESHOLD) * UINT64_C(1000000)));
-    // Use CHIP_SYSTEM_CONFIG_VALID_REAL_TIME_THRESHOLD as the initial value of RealTime.
-    // Then the RealTime obtained from GetClock_RealTime will be always valid.
-    //
-    // TODO(19081): This is broken because it causes the platform to report
-    //              that it does have wall clock time when it actually doesn't.
-    return System::SystemClock().SetClock_RealTime(curTime);
+    uint8_t record[kRealTimeRecordLen];
+    size_t recordLen = 0;
+
+    // Without a usable record, real time stays unavailable until set by the stack or from the network.
+    CHIP_ERROR err = ATBMConfig::ReadConfigValueBin(ATBMConfig::kConfigKey_RealTime, record, sizeof(record), recordLen);
+    VerifyOrReturnError(err != CHIP_DEVICE_ERROR_CONFIG_NOT_FOUND, CHIP_NO_ERROR);
+    if (err != CHIP_NO_ERROR || recordLen != sizeof(record) ||
+        Encoding::LittleEndian::Get32(&record[12]) != kRealTimeRecordVersion)
+    {
+        ChipLogError(DeviceLayer, "Ignoring saved real time: %" CHIP_ERROR_FORMAT, err.Format());
+        return CHIP_NO_ERROR;
+    }
+
+    // The oscillator keeps its drift across reboots.
+    sRealTime.DriftPpb = ClampDrift(static_cast<int32_t>(Encoding::LittleEndian::Get32(&record[8])));
+
+#if CHIP_DEVICE_CONFIG_REAL_TIME_RESTORE
+    // The saved time misses the time spent powered off, so it is only a lower bound
+    // until the next network update.
+    uint64_t utcUs = Encoding::LittleEndian::Get64(&record[0]);
+    taskENTER_CRITICAL();
+    SetReference(utcUs, System::SystemClock().GetMonotonicMicroseconds64().count());
+    taskEXIT_CRITICAL();
+    ChipLogProgress(DeviceLayer, "Real time restored: %" PRIu32 " s", static_cast<uint32_t>(utcUs / 1000000));
+#endif
+    return CHIP_NO_ERROR;
 }
 
 } // namespace Clock
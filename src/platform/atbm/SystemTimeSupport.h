@@ -16,13 +16,31 @@
  */
 
 #include <lib/support/TimeUtils.h>
+#include <system/SystemClock.h>
 
 namespace chip {
 namespace System {
 namespace Clock {
 
+/** Restores the real time clock saved by SaveClock_RealTime(), if any. */
 CHIP_ERROR InitClock_RealTime();
 
+/**
+ * Sets the real time clock from a network time source; utcTime is the UTC time at the
+ * monotonic time monotonicTime.  Consecutive network updates also estimate the drift of
+ * the local oscillator, which is applied to GetClock_RealTime() and saved across reboots.
+ */
+CHIP_ERROR SetClock_NetworkTime(Microseconds64 utcTime, Microseconds64 monotonicTime);
+
+/** Whether the real time clock was set from the network since boot. */
+bool IsClock_NetworkSynced();
+
+/** Current drift correction, in parts per billion. */
+int32_t GetClock_DriftPpb();
+
+/** Persists the current real time and drift, e.g. before a reboot. */
+void SaveClock_RealTime();
+
 } // namespace Clock
 } // namespace System
 } // namespace chip
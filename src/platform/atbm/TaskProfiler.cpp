@@ -0,0 +1,242 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/PowerGovernor.h>
+#include <platform/atbm/TaskProfiler.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
+#if !configUSE_TRACE_FACILITY || !INCLUDE_uxTaskGetStackHighWaterMark
+#error "The task profiler needs configUSE_TRACE_FACILITY and INCLUDE_uxTaskGetStackHighWaterMark"
+#endif
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+const char * const kStateNames[] = { "running", "ready", "blocked", "suspended", "deleted" };
+
+// Written by the CHIP thread only; the ring is also read by the shell task.
+TaskProfiler::Snapshot sRing[TaskProfiler::kHistoryDepth];
+size_t sRingHead; // Next slot to write.
+size_t sRingCount;
+
+TaskProfiler::Snapshot sNext;
+uint32_t sRunTimes[TaskProfiler::kMaxTasks];
+
+// Run time counters of the previous snapshot, to turn the totals into shares.
+uint32_t sPrevNumbers[TaskProfiler::kMaxTasks];
+uint32_t sPrevRunTimes[TaskProfiler::kMaxTasks];
+size_t sPrevCount;
+uint32_t sPrevTotalRunTime;
+bool sPrevValid;
+
+bool sStarted;
+
+/**
+ * Reads up to maxTasks tasks, ordered by task number, and their run time counters when
+ * runTimes is not null.  Returns the number of tasks read.
+ */
+size_t Collect(TaskProfiler::TaskSample * tasks, uint32_t * runTimes, size_t maxTasks, uint32_t * totalRunTime, bool * truncated)
+{
+    // Room for tasks created between the two calls.
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + 2;
+    auto * status        = static_cast<TaskStatus_t *>(Platform::MemoryCalloc(capacity, sizeof(TaskStatus_t)));
+    uint32_t total       = 0;
+    size_t count         = 0;
+
+    VerifyOrReturnValue(status != nullptr, 0);
+    UBaseType_t numTasks = uxTaskGetSystemState(status, capacity, &total);
+
+    // Insertion by task number keeps the order stable from one snapshot to the next.
+    for (UBaseType_t i = 0; i < numTasks; i++)
+    {
+        const TaskStatus_t & task = status[i];
+        size_t pos                = count;
+
+        while (pos > 0 && tasks[pos - 1].Number > task.xTaskNumber)
+        {
+            pos--;
+        }
+        if (pos >= maxTasks)
+        {
+            continue;
+        }
+
+        size_t last = (count < maxTasks) ? count : maxTasks - 1;
+        memmove(&tasks[pos + 1], &tasks[pos], (last - pos) * sizeof(tasks[0]));
+        if (runTimes != nullptr)
+        {
+            memmove(&runTimes[pos + 1], &runTimes[pos], (last - pos) * sizeof(runTimes[0]));
+            runTimes[pos] = task.ulRunTimeCounter;
+        }
+
+        TaskProfiler::TaskSample & sample = tasks[pos];
+        Platform::CopyString(sample.Name, task.pcTaskName);
+        sample.Number            = static_cast<uint32_t>(task.xTaskNumber);
+        sample.StackFreeMinBytes = static_cast<uint32_t>(task.usStackHighWaterMark * sizeof(StackType_t));
+        sample.CpuPermille       = TaskProfiler::kNoCpu;
+        sample.Priority          = static_cast<uint8_t>(task.uxCurrentPriority);
+        sample.State             = static_cast<uint8_t>(task.eCurrentState);
+        if (count < maxTasks)
+        {
+            count++;
+        }
+    }
+
+    Platform::MemoryFree(status);
+    if (totalRunTime != nullptr)
+    {
+        *totalRunTime = total;
+    }
+    if (truncated != nullptr)
+    {
+        *truncated = (numTasks > maxTasks);
+    }
+    return count;
+}
+
+} // namespace
+
+CHIP_ERROR TaskProfiler::Start()
+{
+    VerifyOrReturnError(!sStarted, CHIP_NO_ERROR);
+
+    Sample();
+    ReturnErrorOnFailure(PowerGovernor::StartDeferrableTimer(
+        System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_TASK_PROFILER_INTERVAL), HandleTimer, nullptr));
+    sStarted = true;
+    return CHIP_NO_ERROR;
+}
+
+void TaskProfiler::Stop()
+{
+    DeviceLayer::SystemLayer().CancelTimer(HandleTimer, nullptr);
+    sStarted = false;
+}
+
+void TaskProfiler::HandleTimer(System::Layer * aLayer, void * aAppState)
+{
+    Sample();
+    PowerGovernor::StartDeferrableTimer(System::Clock::Milliseconds32(CHIP_DEVICE_CONFIG_TASK_PROFILER_INTERVAL), HandleTimer,
+                                        nullptr);
+}
+
+void TaskProfiler::Sample()
+{
+    uint32_t totalRunTime = 0;
+    bool truncated        = false;
+    size_t count          = Collect(sNext.Tasks, sRunTimes, kMaxTasks, &totalRunTime, &truncated);
+
+    VerifyOrReturn(count > 0);
+
+    // The run time counter is the 32 bit microsecond clock; deltas stay valid across a wrap.
+    uint32_t elapsed  = sPrevValid ? totalRunTime - sPrevTotalRunTime : 0;
+    sNext.TimestampMs = static_cast<uint32_t>(System::SystemClock().GetMonotonicMilliseconds64().count());
+    sNext.RunTimeUs   = elapsed;
+    sNext.TaskCount   = static_cast<uint8_t>(count);
+    sNext.Truncated   = truncated;
+
+#if configGENERATE_RUN_TIME_STATS
+    for (size_t i = 0; elapsed > 0 && i < count; i++)
+    {
+        for (size_t j = 0; j < sPrevCount; j++)
+        {
+            if (sPrevNumbers[j] == sNext.Tasks[i].Number)
+            {
+                uint32_t taskRunTime       = sRunTimes[i] - sPrevRunTimes[j];
+                sNext.Tasks[i].CpuPermille = static_cast<uint16_t>(static_cast<uint64_t>(taskRunTime) * 1000 / elapsed);
+                break;
+            }
+        }
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++)
+    {
+        sPrevNumbers[i]  = sNext.Tasks[i].Number;
+        sPrevRunTimes[i] = sRunTimes[i];
+    }
+    sPrevCount        = count;
+    sPrevTotalRunTime = totalRunTime;
+    sPrevValid        = true;
+
+    taskENTER_CRITICAL();
+    sRing[sRingHead] = sNext;
+    sRingHead        = (sRingHead + 1) % kHistoryDepth;
+    if (sRingCount < kHistoryDepth)
+    {
+        sRingCount++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+size_t TaskProfiler::GetSnapshotCount()
+{
+    return sRingCount;
+}
+
+bool TaskProfiler::GetSnapshot(size_t age, Snapshot & snapshot)
+{
+    bool found = false;
+
+    taskENTER_CRITICAL();
+    if (age < sRingCount)
+    {
+        snapshot = sRing[(sRingHead + kHistoryDepth - 1 - age) % kHistoryDepth];
+        found    = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return found;
+}
+
+size_t TaskProfiler::ReadTasks(TaskSample * tasks, size_t maxTasks)
+{
+    return Collect(tasks, nullptr, maxTasks, nullptr, nullptr);
+}
+
+const char * TaskProfiler::GetStateName(uint8_t state)
+{
+    return (state < ArraySize(kStateNames)) ? kStateNames[state] : "?";
+}
+
+void TaskProfiler::Reset()
+{
+    taskENTER_CRITICAL();
+    sRingHead  = 0;
+    sRingCount = 0;
+    taskEXIT_CRITICAL();
+
+    // The next snapshot starts a new CPU share baseline.
+    sPrevCount = 0;
+    sPrevValid = false;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,103 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Periodic per-task CPU share and stack headroom snapshots on ATBM platforms
+ *          (CHIP_DEVICE_CONFIG_ENABLE_TASK_PROFILER).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <system/SystemLayer.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Every CHIP_DEVICE_CONFIG_TASK_PROFILER_INTERVAL the CHIP thread snapshots all tasks with
+ * uxTaskGetSystemState(): the CPU share of each task since the previous snapshot (from the
+ * run time stats, configGENERATE_RUN_TIME_STATS) and the smallest free stack seen so far.
+ * The last CHIP_DEVICE_CONFIG_TASK_PROFILER_HISTORY snapshots are kept in a ring.
+ *
+ * uxTaskGetSystemState() suspends the scheduler while it walks the task lists and
+ * the stacks, so the interval should stay in the order of seconds.
+ */
+class TaskProfiler
+{
+public:
+    static constexpr size_t kMaxTasks     = CHIP_DEVICE_CONFIG_TASK_PROFILER_MAX_TASKS;
+    static constexpr size_t kHistoryDepth = CHIP_DEVICE_CONFIG_TASK_PROFILER_HISTORY;
+    static constexpr uint16_t kNoCpu      = 0xFFFF; // No run time stats, or the first snapshot of a task.
+
+    struct TaskSample
+    {
+        char Name[configMAX_TASK_NAME_LEN];
+        uint32_t Number;
+        uint32_t StackFreeMinBytes;
+        uint16_t CpuPermille;
+        uint8_t Priority;
+        uint8_t State; // eTaskState
+    };
+
+    struct Snapshot
+    {
+        uint32_t TimestampMs;
+        uint32_t RunTimeUs; // Run time covered by the CPU shares.
+        uint8_t TaskCount;
+        bool Truncated; // More than kMaxTasks tasks existed.
+        TaskSample Tasks[kMaxTasks];
+    };
+
+    /** Takes a first snapshot and starts the periodic sampling. */
+    static CHIP_ERROR Start();
+    static void Stop();
+
+    /** Takes a snapshot now, in addition to the periodic ones.  CHIP thread only. */
+    static void Sample();
+
+    /** Number of snapshots in the ring. */
+    static size_t GetSnapshotCount();
+
+    /** Copies a snapshot, age 0 being the latest; returns false past the oldest one. */
+    static bool GetSnapshot(size_t age, Snapshot & snapshot);
+
+    /**
+     * Fills tasks with the current state of up to maxTasks tasks, without CPU shares and
+     * without touching the ring; returns the number filled.
+     */
+    static size_t ReadTasks(TaskSample * tasks, size_t maxTasks);
+
+    static const char * GetStateName(uint8_t state);
+
+    static void Reset();
+
+private:
+    static void HandleTimer(System::Layer * aLayer, void * aAppState);
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,159 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/* this file behaves like a config.h, comes first */
+#include <platform/internal/CHIPDeviceLayerInternal.h>
+
+#include <platform/atbm/WiFiReconnectPolicy.h>
+
+#include "atbm_general.h"
+
+namespace chip {
+namespace DeviceLayer {
+
+namespace {
+// IEEE 802.11 reason codes (Table 9-49).
+constexpr uint16_t kReasonUnspecified              = 1;
+constexpr uint16_t kReasonPrevAuthNotValid         = 2;
+constexpr uint16_t kReasonDeauthLeaving            = 3;
+constexpr uint16_t kReasonDisassocInactivity       = 4;
+constexpr uint16_t kReasonDisassocApBusy           = 5;
+constexpr uint16_t kReasonClass2FrameFromNonAuth   = 6;
+constexpr uint16_t kReasonClass3FrameFromNonAssoc  = 7;
+constexpr uint16_t kReasonDisassocStaLeaving       = 8;
+constexpr uint16_t kReasonMicFailure               = 14;
+constexpr uint16_t kReason4WayHandshakeTimeout     = 15;
+constexpr uint16_t kReasonGroupKeyHandshakeTimeout = 16;
+constexpr uint16_t kReasonIeee8021XAuthFailed      = 23;
+constexpr uint16_t kReasonDisassocLowAck           = 34;
+
+// Keeps the shifted interval well inside 64 bits.
+constexpr uint8_t kMaxBackoffShift = 16;
+} // namespace
+
+void ExponentialBackoffReconnectPolicy::Init(System::Clock::Timeout baseInterval)
+{
+    uint8_t mac[6];
+
+    mBaseInterval = baseInterval;
+    mAttempt      = 0;
+
+    // FNV-1a over the MAC address: stable per device, different across devices.
+    atbm_wifi_get_mac_addr(mac);
+    mRandomState = 2166136261u;
+    for (uint8_t b : mac)
+    {
+        mRandomState = (mRandomState ^ b) * 16777619u;
+    }
+    if (mRandomState == 0)
+    {
+        mRandomState = 1;
+    }
+}
+
+bool ExponentialBackoffReconnectPolicy::IsTransientReason(uint16_t reasonCode)
+{
+    switch (reasonCode)
+    {
+    case kReasonUnspecified:
+    case kReasonPrevAuthNotValid:
+    case kReasonDeauthLeaving:
+    case kReasonDisassocInactivity:
+    case kReasonDisassocApBusy:
+    case kReasonClass2FrameFromNonAuth:
+    case kReasonClass3FrameFromNonAssoc:
+    case kReasonDisassocStaLeaving:
+    case kReasonDisassocLowAck:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ExponentialBackoffReconnectPolicy::IsAuthFailureReason(uint16_t reasonCode)
+{
+    switch (reasonCode)
+    {
+    case kReasonMicFailure:
+    case kReason4WayHandshakeTimeout:
+    case kReasonGroupKeyHandshakeTimeout:
+    case kReasonIeee8021XAuthFailed:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t ExponentialBackoffReconnectPolicy::NextRandom()
+{
+    // xorshift32
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+    return mRandomState;
+}
+
+System::Clock::Timeout ExponentialBackoffReconnectPolicy::GetNextRetryDelay(uint16_t reasonCode, bool connectionLost,
+                                                                            RetryClass & retryClass)
+{
+    uint64_t baseMs  = System::Clock::Milliseconds32(mBaseInterval).count();
+    uint8_t attempt  = mAttempt;
+    uint64_t delayMs = 0;
+
+    if (IsAuthFailureReason(reasonCode))
+    {
+        retryClass = RetryClass::kAuthFailure;
+        baseMs     = CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_AUTH_FAIL_INTERVAL;
+    }
+    else if (IsTransientReason(reasonCode) && attempt < CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_FAST_RETRIES)
+    {
+        retryClass = RetryClass::kFast;
+        attempt    = 0;
+    }
+    else
+    {
+        retryClass = RetryClass::kBackoff;
+    }
+
+    delayMs = baseMs << (attempt < kMaxBackoffShift ? attempt : kMaxBackoffShift);
+    if (delayMs > CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_MAX_INTERVAL)
+    {
+        delayMs = CHIP_DEVICE_CONFIG_WIFI_STATION_RECONNECT_MAX_INTERVAL;
+    }
+
+    // The first retry after losing a connection uses the whole interval as jitter so that
+    // a building full of devices does not return to a restarted AP at the same time; later
+    // retries keep at least half of the backoff.
+    if (connectionLost && mAttempt == 0)
+    {
+        delayMs = NextRandom() % (delayMs + 1);
+    }
+    else
+    {
+        delayMs = delayMs / 2 + NextRandom() % (delayMs / 2 + 1);
+    }
+
+    if (mAttempt < UINT8_MAX)
+    {
+        mAttempt++;
+    }
+
+    return System::Clock::Milliseconds32(static_cast<uint32_t>(delayMs));
+}
+
+} // namespace DeviceLayer
+} // namespace chip
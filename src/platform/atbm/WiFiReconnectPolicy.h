@@ -0,0 +1,108 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Reconnect policies for the WiFi station interface on ATBM platforms.
+ */
+
+#pragma once
+
+#include <system/SystemClock.h>
+
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+
+/**
+ * Counters describing the WiFi station reconnect activity since boot (or since the
+ * last WiFi Network Diagnostics counter reset).
+ */
+struct WiFiReconnectCounters
+{
+    uint32_t ConnectAttempts;
+    uint32_t ConnectFailures;
+    uint32_t FastRetries;
+    uint32_t BackoffRetries;
+    uint32_t AuthFailureRetries;
+    uint32_t LastRetryDelayMs;
+};
+
+/**
+ * Decides how long the WiFi station waits before the next connection attempt.
+ *
+ * ConnectivityManagerImpl asks the policy for a delay each time the station loses its
+ * connection or a connection attempt fails, and resets it once the station connects.
+ * Install a custom policy with ConnectivityMgrImpl().SetWiFiReconnectPolicy().
+ */
+class WiFiReconnectPolicy
+{
+public:
+    enum class RetryClass : uint8_t
+    {
+        kFast,
+        kBackoff,
+        kAuthFailure,
+    };
+
+    virtual ~WiFiReconnectPolicy() = default;
+
+    /**
+     * Returns the delay before the next connection attempt.
+     *
+     * @param[in] reasonCode       IEEE 802.11 reason code of the last disconnect.
+     * @param[in] connectionLost   True if an established connection was lost, false if a
+     *                             connection attempt failed.
+     * @param[out] retryClass      How the retry was classified, for diagnostics.
+     */
+    virtual System::Clock::Timeout GetNextRetryDelay(uint16_t reasonCode, bool connectionLost, RetryClass & retryClass) = 0;
+
+    /** Called once the station is connected. */
+    virtual void Reset() = 0;
+};
+
+/**
+ * Default policy: jittered exponential backoff between a base and a maximum interval.
+ *
+ * Transient disconnects are retried a few times at the base interval, and failed
+ * authentications start at a much longer interval.  Every delay is jittered with a
+ * generator seeded from the station MAC address, so that devices which lose the same AP
+ * at the same moment spread their reconnects out instead of retrying in lockstep.
+ */
+class ExponentialBackoffReconnectPolicy : public WiFiReconnectPolicy
+{
+public:
+    void Init(System::Clock::Timeout baseInterval);
+    void SetBaseInterval(System::Clock::Timeout baseInterval) { mBaseInterval = baseInterval; }
+
+    System::Clock::Timeout GetNextRetryDelay(uint16_t reasonCode, bool connectionLost, RetryClass & retryClass) override;
+    void Reset() override { mAttempt = 0; }
+
+    static bool IsTransientReason(uint16_t reasonCode);
+    static bool IsAuthFailureReason(uint16_t reasonCode);
+
+private:
+    uint32_t NextRandom();
+
+    System::Clock::Timeout mBaseInterval;
+    uint32_t mRandomState = 0;
+    uint8_t mAttempt      = 0;
+};
+
+} // namespace DeviceLayer
+} // namespace chip
@@ -51,8 +51,12 @@
 /* using IAP function */
 /* #define EF_USING_IAP */
 
-/* using save log function */
-/* #define EF_USING_LOG */
+/* using save log function, for the CHIP flash trace recorder (CHIP_DEVICE_CONFIG_ENABLE_FLASH_TRACE).
+ * The log area directly follows the ENV area, i.e. it is the user data2 section, which it shares
+ * with the SDK debug event records (FLASH_DEBUG_EVENT_*): build the SDK with only one of them. */
+#if defined(CONFIG_EF_USING_LOG) && CONFIG_EF_USING_LOG
+#define EF_USING_LOG
+#endif
 
 /* The minimum size of flash erasure. May be a flash sector size. */
 #define EF_ERASE_MIN_SIZE         DEVICE_SECTOR_SIZE/* @note you must define it for a value */
@@ -92,7 +96,7 @@
 #define ENV_AREA_SIZE             FLASH_USR_DATA_SECTION_LEN/* @note you must define it for a value if you used ENV */
 
 /* saved log area size */
-#define LOG_AREA_SIZE             /* @note you must define it for a value if you used log */
+#define LOG_AREA_SIZE             FLASH_USR_DATA_SECTION2_LEN/* @note you must define it for a value if you used log */
 
 /* print debug information of flash */
 #define PRINT_DEBUG
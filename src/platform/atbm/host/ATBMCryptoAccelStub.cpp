@@ -0,0 +1,111 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ATBMCryptoAccelStub.h"
+
+#include <platform/atbm/mbedtls/atbm_crypto_accel.h>
+
+#include <mbedtls/aes.h>
+#include <mbedtls/sha256.h>
+
+#include <string.h>
+
+#include "atbm_general.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+ATBMCryptoAccelStub::Config sConfig;
+
+int StubAesBlock(const unsigned char * key, unsigned int keybits, int encrypt, const unsigned char input[16],
+                 unsigned char output[16])
+{
+    mbedtls_aes_context ctx;
+    int ret;
+
+    if (!sConfig.Aes || (sConfig.Aes128Only && keybits != 128))
+    {
+        return ATBM_CRYPTO_ACCEL_UNSUPPORTED;
+    }
+
+    // The internal block functions are not wrapped by atbm_crypto_alt.c, so this does not
+    // come back to the accelerator.
+    mbedtls_aes_init(&ctx);
+    ret = encrypt ? mbedtls_aes_setkey_enc(&ctx, key, keybits) : mbedtls_aes_setkey_dec(&ctx, key, keybits);
+    if (ret == 0)
+    {
+        ret = encrypt ? mbedtls_internal_aes_encrypt(&ctx, input, output) : mbedtls_internal_aes_decrypt(&ctx, input, output);
+    }
+    mbedtls_aes_free(&ctx);
+    return (ret == 0) ? 0 : ATBM_CRYPTO_ACCEL_UNSUPPORTED;
+}
+
+int StubSha256Blocks(uint32_t state[8], const unsigned char * data, size_t nblocks)
+{
+    mbedtls_sha256_context ctx;
+
+    if (!sConfig.Sha256)
+    {
+        return ATBM_CRYPTO_ACCEL_UNSUPPORTED;
+    }
+
+    mbedtls_sha256_init(&ctx);
+    memcpy(ctx.MBEDTLS_PRIVATE(state), state, sizeof(ctx.MBEDTLS_PRIVATE(state)));
+    for (; nblocks > 0; nblocks--, data += 64)
+    {
+        mbedtls_internal_sha256_process(&ctx, data);
+    }
+    memcpy(state, ctx.MBEDTLS_PRIVATE(state), sizeof(ctx.MBEDTLS_PRIVATE(state)));
+    mbedtls_sha256_free(&ctx);
+    return 0;
+}
+
+int StubTrng(unsigned char * buf, size_t len)
+{
+    if (!sConfig.Trng)
+    {
+        return ATBM_CRYPTO_ACCEL_UNSUPPORTED;
+    }
+    return random_get_bytes(buf, len);
+}
+
+const atbm_crypto_accel_t sStubAccel = {
+    "host stub",
+    StubAesBlock,
+    StubSha256Blocks,
+    StubTrng,
+};
+
+} // namespace
+
+void ATBMCryptoAccelStub::Register(const Config & config)
+{
+    sConfig = config;
+    atbm_crypto_accel_register(&sStubAccel);
+}
+
+void ATBMCryptoAccelStub::Unregister()
+{
+    atbm_crypto_accel_register(nullptr);
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
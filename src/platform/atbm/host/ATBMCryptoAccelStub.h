@@ -0,0 +1,55 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Stand-in crypto accelerator for the host build (chip_use_atbm_crypto_accel).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Registers an accelerator whose operations compute in software, so that the host
+ * build exercises the same dispatch as a device with a crypto engine.  Each operation
+ * can be turned off, and AES can be limited to 128 bit keys like the smaller engines,
+ * to exercise the software fallback.  Progress is reported by
+ * atbm_crypto_accel_get_stats().
+ */
+class ATBMCryptoAccelStub
+{
+public:
+    struct Config
+    {
+        bool Aes        = true;
+        bool Sha256     = true;
+        bool Trng       = true;
+        bool Aes128Only = false;
+    };
+
+    static void Register(const Config & config);
+    static void Unregister();
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,714 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ATBMHalFake.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <easyflash.h>
+
+#include "timers.h"
+
+#include <lwip/etharp.h>
+#include <lwip/ethip6.h>
+#include <lwip/netifapi.h>
+#include <lwip/tcpip.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr size_t kMaxScanResults = 32;
+constexpr uint16_t kStaMtu       = 1500;
+// EasyFlash log area: 3 sectors, each with a 12 byte header (see ef_log.c).
+constexpr size_t kLogSectors       = 3;
+constexpr size_t kLogSectorPayload = 4096 - 12;
+
+struct FakeState
+{
+    atbm_wifi_matter_event_cb_t EventHandler = nullptr;
+
+    uint8_t Mac[6] = { 0x02, 0xA7, 0xB3, 0x00, 0x00, 0x01 };
+    struct atbmwifi_configure Config;
+    bool Connected       = false;
+    bool StationMode     = true;
+    int8_t Rssi          = -50;
+    uint8_t Channel      = 6;
+    uint16_t ReasonCode  = 0;
+    uint32_t HeapFree    = 160 * 1024;
+    uint32_t HeapTotal   = 256 * 1024;
+    uint32_t RandomState = 0x2545F491;
+
+    struct atbmwifi_scan_result_info ScanInfo[kMaxScanResults];
+    struct atbmwifi_scan_result ScanResult;
+    bool ScanDone = false;
+
+    struct netif StaNetif;
+    ip4_addr_t StaAddr;
+    ip4_addr_t StaNetmask;
+    ip4_addr_t StaGateway;
+
+    std::map<std::string, std::vector<uint8_t>> Kvs;
+    std::vector<uint8_t> FlashLog;
+};
+
+FakeState sState;
+
+TimerHandle_t sScanTimer;
+TimerHandle_t sConnectTimer;
+TimerHandle_t sDhcpTimer;
+SemaphoreHandle_t sKvsLock;
+
+ATBMHalFake::ConnectScript sConnectScript;
+uint32_t sScanLatencyMs = 100;
+uint32_t sKvsReadUs;
+uint32_t sKvsWriteUs;
+int sFirmwareWriteResult;
+ATBMHalFake::LinkOutputHandler sLinkOutputHandler;
+ATBMHalFake::RebootHandler sRebootHandler;
+
+uint32_t sRebootCount;
+uint32_t sFirmwareBytes;
+uint32_t sLinkOutputCount;
+
+uint64_t MonotonicUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000u + static_cast<uint64_t>(ts.tv_nsec) / 1000u;
+}
+
+// Models flash timing: sleeps for whole ticks, then spins for the rest.
+void DelayUs(uint32_t us)
+{
+    VerifyOrReturn(us > 0);
+
+    uint64_t end = MonotonicUs() + us;
+    if (us >= 1000)
+    {
+        vTaskDelay(pdMS_TO_TICKS(us / 1000));
+    }
+    while (MonotonicUs() < end)
+    {
+    }
+}
+
+void PostEvent(WIFI_IP_EVENT event)
+{
+    if (sState.EventHandler != nullptr)
+    {
+        sState.EventHandler(static_cast<unsigned int>(event));
+    }
+}
+
+void StartTimer(TimerHandle_t timer, uint32_t delayMs)
+{
+    TickType_t ticks = pdMS_TO_TICKS(delayMs);
+    xTimerChangePeriod(timer, ticks > 0 ? ticks : 1, portMAX_DELAY);
+}
+
+err_t StaLinkOutput(struct netif * netif, struct pbuf * p)
+{
+    sLinkOutputCount++;
+    return (sLinkOutputHandler != nullptr) ? sLinkOutputHandler(netif, p) : ERR_OK;
+}
+
+err_t StaNetifInit(struct netif * netif)
+{
+    netif->name[0]    = 's';
+    netif->name[1]    = 't';
+    netif->mtu        = kStaMtu;
+    netif->hwaddr_len = sizeof(sState.Mac);
+    memcpy(netif->hwaddr, sState.Mac, sizeof(sState.Mac));
+    netif->flags      = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET | NETIF_FLAG_IGMP | NETIF_FLAG_MLD6;
+    netif->output     = etharp_output;
+    netif->output_ip6 = ethip6_output;
+    netif->linkoutput = StaLinkOutput;
+    return ERR_OK;
+}
+
+void ScanTimerHandler(TimerHandle_t timer)
+{
+    sState.ScanDone = true;
+    PostEvent(WIFI_EVENT_SCAN_DONE);
+}
+
+void ConnectTimerHandler(TimerHandle_t timer)
+{
+    if (!sConnectScript.Succeed)
+    {
+        sState.ReasonCode = sConnectScript.ReasonCode;
+        PostEvent(WIFI_EVENT_STA_DISCONNECTED);
+        return;
+    }
+
+    sState.Connected  = true;
+    sState.ReasonCode = 0;
+    netifapi_netif_set_link_up(&sState.StaNetif);
+    PostEvent(WIFI_EVENT_STA_CONNECTED);
+    StartTimer(sDhcpTimer, sConnectScript.DhcpLatencyMs);
+}
+
+void DhcpTimerHandler(TimerHandle_t timer)
+{
+    VerifyOrReturn(sState.Connected);
+
+    netifapi_netif_set_addr(&sState.StaNetif, &sState.StaAddr, &sState.StaNetmask, &sState.StaGateway);
+    PostEvent(IP_EVENT_STA_GOT_IP);
+}
+
+} // namespace
+
+ATBMHalFake ATBMHalFake::sInstance;
+
+CHIP_ERROR ATBMHalFake::Init()
+{
+    VerifyOrReturnError(sKvsLock == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    sKvsLock      = xSemaphoreCreateMutex();
+    sScanTimer    = xTimerCreate("scan", 1, pdFALSE, nullptr, ScanTimerHandler);
+    sConnectTimer = xTimerCreate("conn", 1, pdFALSE, nullptr, ConnectTimerHandler);
+    sDhcpTimer    = xTimerCreate("dhcp", 1, pdFALSE, nullptr, DhcpTimerHandler);
+    VerifyOrReturnError(sKvsLock != nullptr && sScanTimer != nullptr && sConnectTimer != nullptr && sDhcpTimer != nullptr,
+                        CHIP_ERROR_NO_MEMORY);
+
+    Reset();
+
+    tcpip_init(nullptr, nullptr);
+    VerifyOrReturnError(netifapi_netif_add(&sState.StaNetif, nullptr, nullptr, nullptr, nullptr, StaNetifInit, tcpip_input) ==
+                            ERR_OK,
+                        CHIP_ERROR_INTERNAL);
+    netifapi_netif_set_default(&sState.StaNetif);
+    netifapi_netif_set_up(&sState.StaNetif);
+    return CHIP_NO_ERROR;
+}
+
+void ATBMHalFake::Reset()
+{
+    sConnectScript       = ConnectScript();
+    sScanLatencyMs       = 100;
+    sKvsReadUs           = 0;
+    sKvsWriteUs          = 0;
+    sFirmwareWriteResult = 0;
+    sRebootCount         = 0;
+    sFirmwareBytes       = 0;
+    sLinkOutputCount     = 0;
+
+    memset(&sState.Config, 0, sizeof(sState.Config));
+    sState.Connected      = false;
+    sState.ScanDone       = false;
+    sState.ScanResult.len = 0;
+    IP4_ADDR(&sState.StaAddr, 192, 168, 1, 100);
+    IP4_ADDR(&sState.StaNetmask, 255, 255, 255, 0);
+    IP4_ADDR(&sState.StaGateway, 192, 168, 1, 1);
+
+    if (sKvsLock != nullptr)
+    {
+        xSemaphoreTake(sKvsLock, portMAX_DELAY);
+        sState.Kvs.clear();
+        sState.FlashLog.clear();
+        xSemaphoreGive(sKvsLock);
+    }
+}
+
+void ATBMHalFake::SetMacAddress(const uint8_t mac[6])
+{
+    memcpy(sState.Mac, mac, sizeof(sState.Mac));
+}
+
+CHIP_ERROR ATBMHalFake::AddScanResult(const struct atbmwifi_scan_result_info & info)
+{
+    VerifyOrReturnError(sState.ScanResult.len < static_cast<int>(kMaxScanResults), CHIP_ERROR_NO_MEMORY);
+    sState.ScanInfo[sState.ScanResult.len++] = info;
+    return CHIP_NO_ERROR;
+}
+
+void ATBMHalFake::ClearScanResults()
+{
+    sState.ScanResult.len = 0;
+}
+
+void ATBMHalFake::SetScanLatency(uint32_t latencyMs)
+{
+    sScanLatencyMs = latencyMs;
+}
+
+void ATBMHalFake::SetConnectScript(const ConnectScript & script)
+{
+    sConnectScript = script;
+}
+
+void ATBMHalFake::SetStationIPv4(const ip4_addr_t & addr, const ip4_addr_t & netmask, const ip4_addr_t & gateway)
+{
+    sState.StaAddr    = addr;
+    sState.StaNetmask = netmask;
+    sState.StaGateway = gateway;
+}
+
+void ATBMHalFake::SetRssi(int8_t rssi)
+{
+    sState.Rssi = rssi;
+}
+
+void ATBMHalFake::SetChannel(uint8_t channel)
+{
+    sState.Channel = channel;
+}
+
+void ATBMHalFake::SetHeapSize(uint32_t freeBytes, uint32_t totalBytes)
+{
+    sState.HeapFree  = freeBytes;
+    sState.HeapTotal = totalBytes;
+}
+
+void ATBMHalFake::SetKvsLatency(uint32_t readUs, uint32_t writeUs)
+{
+    sKvsReadUs  = readUs;
+    sKvsWriteUs = writeUs;
+}
+
+void ATBMHalFake::SetFirmwareWriteResult(int result)
+{
+    sFirmwareWriteResult = result;
+}
+
+void ATBMHalFake::SetLinkOutputHandler(LinkOutputHandler handler)
+{
+    sLinkOutputHandler = handler;
+}
+
+void ATBMHalFake::SetRebootHandler(RebootHandler handler)
+{
+    sRebootHandler = handler;
+}
+
+void ATBMHalFake::InjectEvent(WIFI_IP_EVENT event)
+{
+    PostEvent(event);
+}
+
+void ATBMHalFake::DropLink(uint16_t reasonCode)
+{
+    VerifyOrReturn(sState.Connected);
+
+    sState.Connected  = false;
+    sState.ReasonCode = reasonCode;
+    netifapi_netif_set_addr(&sState.StaNetif, IP4_ADDR_ANY4, IP4_ADDR_ANY4, IP4_ADDR_ANY4);
+    netifapi_netif_set_link_down(&sState.StaNetif);
+    PostEvent(IP_EVENT_STA_LOST_IP);
+    PostEvent(WIFI_EVENT_STA_DISCONNECTED);
+}
+
+uint32_t ATBMHalFake::GetRebootCount() const
+{
+    return sRebootCount;
+}
+
+uint32_t ATBMHalFake::GetFirmwareBytesWritten() const
+{
+    return sFirmwareBytes;
+}
+
+uint32_t ATBMHalFake::GetLinkOutputCount() const
+{
+    return sLinkOutputCount;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
+
+using namespace chip::DeviceLayer::Internal;
+
+// ===== ATBM SDK entry points used by the platform layer.
+
+extern "C" {
+
+void atbm_wifi_matter_event_handler_register(atbm_wifi_matter_event_cb_t event_cb)
+{
+    sState.EventHandler = event_cb;
+}
+
+void atbm_console_matter_cmd_register(atbm_wifi_matter_cmd_cb_t matter_cmd_handler) {}
+
+void atbm_wifi_get_mac_addr(u8 * mac_addr)
+{
+    memcpy(mac_addr, sState.Mac, sizeof(sState.Mac));
+}
+
+void atbm_wifi_get_connected_destAddr(u8 * destMacAddr)
+{
+    memcpy(destMacAddr, sState.Config.bssid, sizeof(sState.Config.bssid));
+}
+
+u8 atbm_wifi_get_channel(void)
+{
+    return sState.Channel;
+}
+
+int atbm_wifi_get_rssi(void)
+{
+    return sState.Rssi;
+}
+
+int atbm_wifi_scan(void)
+{
+    sState.ScanDone = false;
+    StartTimer(sScanTimer, sScanLatencyMs);
+    return 0;
+}
+
+// Like the SDK, the number of APs found once the scan is over.
+int atbm_wifi_scan_is_done(void)
+{
+    return sState.ScanDone ? sState.ScanResult.len : 0;
+}
+
+struct atbmwifi_scan_result * atbm_wifi_scan_get_result(void)
+{
+    sState.ScanResult.info = sState.ScanInfo;
+    return &sState.ScanResult;
+}
+
+// A NULL callback only releases the results in the SDK; the scripted ones are kept.
+int atbm_wifi_process_scan_result(atbm_wifi_scanRet_cb_t proc_scanResult)
+{
+    if (proc_scanResult != nullptr)
+    {
+        proc_scanResult(atbm_wifi_scan_get_result());
+    }
+    return 0;
+}
+
+int atbm_wifi_connect_ap(void)
+{
+    StartTimer(sConnectTimer, sConnectScript.LatencyMs);
+    return 0;
+}
+
+int atbm_wifi_connect_ap_autoMgmt(void)
+{
+    return atbm_wifi_connect_ap();
+}
+
+u8 atbm_wifi_is_connect_ok(void)
+{
+    return sState.Connected ? 1 : 0;
+}
+
+void atbm_wifi_set_config(u8 * essid, int essid_len, u8 * key, int key_len, int key_mgmt, int keyid, u8 * bssid)
+{
+    struct atbmwifi_configure & config = sState.Config;
+
+    memset(&config, 0, sizeof(config));
+    config.ssid_len = static_cast<u8>(essid_len < static_cast<int>(sizeof(config.ssid)) ? essid_len : sizeof(config.ssid));
+    memcpy(config.ssid, essid, config.ssid_len);
+    config.password_len =
+        static_cast<u8>(key_len < static_cast<int>(sizeof(config.password)) ? key_len : sizeof(config.password));
+    memcpy(config.password, key, config.password_len);
+    config.key_mgmt = static_cast<u8>(key_mgmt);
+    config.key_id   = static_cast<u8>(keyid);
+    if (bssid != nullptr)
+    {
+        memcpy(config.bssid, bssid, sizeof(config.bssid));
+    }
+}
+
+void atbm_wifi_get_config(struct atbmwifi_configure * config)
+{
+    *config = sState.Config;
+}
+
+void atbm_wifi_clear_config(void)
+{
+    memset(&sState.Config, 0, sizeof(sState.Config));
+}
+
+void atbm_wifi_disconnect_call_task(void)
+{
+    ATBMHalFake::Instance().DropLink(0);
+}
+
+u16 atbm_wifi_get_disconn_reason_code(void)
+{
+    return sState.ReasonCode;
+}
+
+void atbm_wifi_start_station_call_task(void)
+{
+    sState.StationMode = true;
+    PostEvent(WIFI_EVENT_STA_START);
+}
+
+void atbm_wifi_stop_station_call_task(void)
+{
+    PostEvent(WIFI_EVENT_STA_STOP);
+}
+
+void atbm_wifi_startap_call_task(void)
+{
+    sState.StationMode = false;
+    PostEvent(WIFI_EVENT_AP_START);
+}
+
+void atbm_wifi_stopap_call_task(void)
+{
+    sState.StationMode = true;
+    PostEvent(WIFI_EVENT_AP_STOP);
+}
+
+u8 atbm_wifi_is_iftype_ap(void)
+{
+    return sState.StationMode ? 0 : 1;
+}
+
+u8 atbm_wifi_is_iftype_station(void)
+{
+    return sState.StationMode ? 1 : 0;
+}
+
+struct netif * atbm_wifi_get_sta_netif(void)
+{
+    return &sState.StaNetif;
+}
+
+struct netif * atbm_wifi_get_netdev(void)
+{
+    return &sState.StaNetif;
+}
+
+// Console of the SDK; the host prints to stdout.
+void Console_SetPolling(int polling) {}
+
+void Console_Putc(unsigned char data)
+{
+    putchar(data);
+}
+
+bool hal_in_irq(void)
+{
+    return false;
+}
+
+unsigned int hal_get_os_ms_time(void)
+{
+    return static_cast<unsigned int>(MonotonicUs() / 1000u);
+}
+
+unsigned int hal_get_os_us_time(void)
+{
+    return static_cast<unsigned int>(MonotonicUs());
+}
+
+void hal_sys_reboot(void)
+{
+    sRebootCount++;
+    if (sRebootHandler != nullptr)
+    {
+        sRebootHandler();
+    }
+}
+
+// Deterministic (xorshift32) so that runs are repeatable.
+int random_get_bytes(u8 * buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint32_t x = sState.RandomState;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        sState.RandomState = x;
+        buf[i]             = static_cast<u8>(x);
+    }
+    return 0;
+}
+
+u32 sys_mem_free_size_get(void)
+{
+    return sState.HeapFree;
+}
+
+u32 sys_mem_total_size_get(void)
+{
+    return sState.HeapTotal;
+}
+
+int HAL_Firmware_Persistence_Start(void)
+{
+    sFirmwareBytes = 0;
+    return sFirmwareWriteResult;
+}
+
+int HAL_Firmware_Persistence_Write_By_Matter(unsigned char * buffer, unsigned int length)
+{
+    DelayUs(sKvsWriteUs);
+    sFirmwareBytes += length;
+    return sFirmwareWriteResult;
+}
+
+int HAL_Firmware_Persistence_Stop(void)
+{
+    return sFirmwareWriteResult;
+}
+
+// ===== EasyFlash, served from RAM.
+
+size_t ef_get_env_blob(const char * key, void * value_buf, size_t buf_len, size_t * saved_value_len)
+{
+    size_t copied = 0;
+
+    DelayUs(sKvsReadUs);
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    auto it = sState.Kvs.find(key);
+    if (it != sState.Kvs.end())
+    {
+        copied = (it->second.size() < buf_len) ? it->second.size() : buf_len;
+        memcpy(value_buf, it->second.data(), copied);
+        if (saved_value_len != nullptr)
+        {
+            *saved_value_len = it->second.size();
+        }
+    }
+    else if (saved_value_len != nullptr)
+    {
+        *saved_value_len = 0;
+    }
+    xSemaphoreGive(sKvsLock);
+    return copied;
+}
+
+bool ef_get_env_obj(const char * key, env_node_obj_t env)
+{
+    bool found = false;
+
+    DelayUs(sKvsReadUs);
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    auto it = sState.Kvs.find(key);
+    if (it != sState.Kvs.end())
+    {
+        memset(env, 0, sizeof(*env));
+        env->status    = ENV_WRITE;
+        env->crc_is_ok = true;
+        env->name_len  = static_cast<uint8_t>(strnlen(key, EF_ENV_NAME_MAX));
+        env->value_len = static_cast<uint32_t>(it->second.size());
+        memcpy(env->name, key, env->name_len);
+        found = true;
+    }
+    xSemaphoreGive(sKvsLock);
+    return found;
+}
+
+EfErrCode ef_set_env_blob(const char * key, const void * value_buf, size_t buf_len)
+{
+    VerifyOrReturnValue(key != nullptr && strlen(key) < EF_ENV_NAME_MAX, EF_ENV_NAME_ERR);
+
+    DelayUs(sKvsWriteUs);
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    const uint8_t * bytes = static_cast<const uint8_t *>(value_buf);
+    sState.Kvs[key].assign(bytes, bytes + buf_len);
+    xSemaphoreGive(sKvsLock);
+    return EF_NO_ERR;
+}
+
+EfErrCode ef_set_env(const char * key, const char * value)
+{
+    return ef_set_env_blob(key, value, strlen(value));
+}
+
+EfErrCode ef_del_env(const char * key)
+{
+    DelayUs(sKvsWriteUs);
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    sState.Kvs.erase(key);
+    xSemaphoreGive(sKvsLock);
+    return EF_NO_ERR;
+}
+
+EfErrCode ef_env_set_default(void)
+{
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    sState.Kvs.clear();
+    xSemaphoreGive(sKvsLock);
+    return EF_NO_ERR;
+}
+
+// Like the flash ring, the oldest sector is dropped as a whole when the area is full.
+EfErrCode ef_log_write(const uint32_t * log, size_t size)
+{
+    VerifyOrReturnValue(size % 4 == 0, EF_WRITE_ERR);
+
+    DelayUs(sKvsWriteUs);
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    const uint8_t * bytes = reinterpret_cast<const uint8_t *>(log);
+    sState.FlashLog.insert(sState.FlashLog.end(), bytes, bytes + size);
+    while (sState.FlashLog.size() > kLogSectors * kLogSectorPayload)
+    {
+        sState.FlashLog.erase(sState.FlashLog.begin(), sState.FlashLog.begin() + kLogSectorPayload);
+    }
+    xSemaphoreGive(sKvsLock);
+    return EF_NO_ERR;
+}
+
+EfErrCode ef_log_read(size_t index, uint32_t * log, size_t size)
+{
+    EfErrCode err = EF_READ_ERR;
+
+    DelayUs(sKvsReadUs);
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    if (index % 4 == 0 && size % 4 == 0 && index + size <= sState.FlashLog.size())
+    {
+        memcpy(log, sState.FlashLog.data() + index, size);
+        err = EF_NO_ERR;
+    }
+    xSemaphoreGive(sKvsLock);
+    return err;
+}
+
+EfErrCode ef_log_clean(void)
+{
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    sState.FlashLog.clear();
+    xSemaphoreGive(sKvsLock);
+    return EF_NO_ERR;
+}
+
+size_t ef_log_get_used_size(void)
+{
+    xSemaphoreTake(sKvsLock, portMAX_DELAY);
+    size_t used = sState.FlashLog.size();
+    xSemaphoreGive(sKvsLock);
+    return used;
+}
+
+size_t ef_log_get_total_size(void)
+{
+    return kLogSectors * kLogSectorPayload;
+}
+
+} // extern "C"
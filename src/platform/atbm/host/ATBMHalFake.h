@@ -0,0 +1,105 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Scriptable replacement of the ATBM SDK (atbm_wifi_*, hal_*, EasyFlash and
+ *          firmware persistence) for the host build of the ATBM platform layer.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include "atbm_general.h"
+
+#include <lwip/err.h>
+#include <lwip/ip4_addr.h>
+#include <lwip/netif.h>
+#include <lwip/pbuf.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Stands in for the ATBM WiFi firmware and SDK services on the host.
+ *
+ * The fake behaves like the SDK as seen from the platform layer: scans and connects
+ * complete asynchronously on a FreeRTOS timer after a configurable latency and are
+ * reported through the handler registered with atbm_wifi_matter_event_handler_register().
+ * On a successful connect the station netif goes up with the scripted IPv4 address.
+ * Frames sent on the station netif go to the link output handler, if any, so that a
+ * harness can loop them back or feed them to a peer stack.
+ *
+ * The EasyFlash API is served from RAM, optionally with a per-operation delay to model
+ * flash timing.
+ *
+ * Call Init() once after the FreeRTOS scheduler has started and before the CHIP stack.
+ */
+class ATBMHalFake
+{
+public:
+    using LinkOutputHandler = err_t (*)(struct netif * netif, struct pbuf * p);
+    using RebootHandler     = void (*)();
+
+    struct ConnectScript
+    {
+        bool Succeed           = true;
+        uint16_t ReasonCode    = 0; // Reported by atbm_wifi_get_disconn_reason_code() on failure.
+        uint32_t LatencyMs     = 50;
+        uint32_t DhcpLatencyMs = 20;
+    };
+
+    static ATBMHalFake & Instance() { return sInstance; }
+
+    CHIP_ERROR Init();
+
+    /** Restores the default script, forgets scan results and clears the KVS. */
+    void Reset();
+
+    void SetMacAddress(const uint8_t mac[6]);
+    CHIP_ERROR AddScanResult(const struct atbmwifi_scan_result_info & info);
+    void ClearScanResults();
+    void SetScanLatency(uint32_t latencyMs);
+    void SetConnectScript(const ConnectScript & script);
+    void SetStationIPv4(const ip4_addr_t & addr, const ip4_addr_t & netmask, const ip4_addr_t & gateway);
+    void SetRssi(int8_t rssi);
+    void SetChannel(uint8_t channel);
+    void SetHeapSize(uint32_t freeBytes, uint32_t totalBytes);
+    void SetKvsLatency(uint32_t readUs, uint32_t writeUs);
+    void SetFirmwareWriteResult(int result);
+    void SetLinkOutputHandler(LinkOutputHandler handler);
+    void SetRebootHandler(RebootHandler handler);
+
+    /** Reports an event to the platform layer immediately, from the calling task. */
+    void InjectEvent(WIFI_IP_EVENT event);
+
+    /** Drops the station link as if the AP went away. */
+    void DropLink(uint16_t reasonCode);
+
+    uint32_t GetRebootCount() const;
+    uint32_t GetFirmwareBytesWritten() const;
+    uint32_t GetLinkOutputCount() const;
+
+private:
+    static ATBMHalFake sInstance;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
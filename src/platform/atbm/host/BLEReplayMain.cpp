@@ -0,0 +1,719 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          atbm-ble-replay: drives the ATBM BLE manager through the NimBLE fake with a
+ *          commissioner-side BTP session and checks the CHIPoBLE data path.
+ *
+ *              atbm-ble-replay [rounds] [trace]
+ *
+ *          The central connects and checks that advertising is refreshed correctly around
+ *          the connection. It then performs the BTP capabilities handshake and replays a
+ *          PASE plus commissioning exchange `rounds` times: the central writes the commissioner
+ *          SDUs, and a scripted peer on the CHIP task answers with the device SDUs. Reports
+ *          bytes/sec, per-fragment latency, allocations per message and CHIP task time, and
+ *          exits non-zero on any protocol error, payload mismatch, timeout or stats
+ *          inconsistency.
+ *
+ *          Without a trace the reference exchange of BLEReplayTrace.h is replayed. A trace
+ *          file holds one SDU per line, "c <hex>" for the commissioner and "d <hex>" for the
+ *          device, with '#' starting a comment; the first SDU must be the commissioner's.
+ */
+
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/atbm/BLEManagerImpl.h>
+
+#include <ble/Ble.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+
+#include <atomic>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ATBMHalFake.h"
+#include "BLEReplayTrace.h"
+#include "NimBLEFake.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+using namespace chip;
+using namespace chip::DeviceLayer;
+using chip::DeviceLayer::Internal::ATBMHalFake;
+using chip::DeviceLayer::Internal::BLEManagerImpl;
+using chip::DeviceLayer::Internal::BLEReplayRecord;
+using chip::DeviceLayer::Internal::NimBLEFake;
+
+namespace {
+
+constexpr uint32_t kDefaultRounds = 1;
+constexpr uint32_t kTimeoutMs     = 5000;
+constexpr uint16_t kConnHandle    = 1;
+constexpr uint16_t kAttMtu        = 247;
+constexpr uint8_t kCentralWindow  = 6;
+constexpr uint16_t kMaxSduSize    = 1024;
+constexpr size_t kMaxTraceLength  = 64;
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+constexpr uint8_t kExtAdvSets = 0x03; // Legacy fallback set and extended set.
+#endif
+
+// BTP capabilities request written by a commissioner: protocol version 4, ATT MTU 247,
+// receive window 6.
+constexpr uint8_t kHandshakeRequest[]      = { 0x65, 0x6C, 0x04, 0x00, 0x00, 0x00, 0xF7, 0x00, 0x06 };
+constexpr uint8_t kHandshakeResponseLength = 6;
+
+// BTP header flags.
+constexpr uint8_t kBtpStart    = 0x01;
+constexpr uint8_t kBtpContinue = 0x02;
+constexpr uint8_t kBtpEnd      = 0x04;
+constexpr uint8_t kBtpAck      = 0x08;
+
+const ble_uuid128_t kCHIPoBLEChar_RX = {
+    { BLE_UUID_TYPE_128 }, { 0x11, 0x9D, 0x9F, 0x42, 0x9C, 0x4F, 0x9F, 0x95, 0x59, 0x45, 0x3D, 0x26, 0xF5, 0x2E, 0xEE, 0x18 }
+};
+const ble_uuid128_t kCHIPoBLEChar_TX = {
+    { BLE_UUID_TYPE_128 }, { 0x12, 0x9D, 0x9F, 0x42, 0x9C, 0x4F, 0x9F, 0x95, 0x59, 0x45, 0x3D, 0x26, 0xF5, 0x2E, 0xEE, 0x18 }
+};
+
+uint64_t NowUs()
+{
+    return System::SystemClock().GetMonotonicMicroseconds64().count();
+}
+
+template <typename Predicate>
+bool WaitUntil(Predicate predicate)
+{
+    for (uint32_t waited = 0; !predicate(); waited++)
+    {
+        if (waited == kTimeoutMs)
+        {
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return true;
+}
+
+// The exchange being replayed; set up before the CHIP task starts and read-only afterwards.
+struct TraceMessage
+{
+    bool FromDevice;
+    uint16_t Length;
+    const char * Name;
+    const uint8_t * Data; // nullptr: regenerated by GetTracePayload().
+};
+
+TraceMessage sTrace[kMaxTraceLength];
+size_t sTraceLength;
+uint32_t sTraceBytes;
+uint8_t sCapturedData[kMaxTraceLength][kMaxSduSize];
+
+void GetTracePayload(size_t index, uint8_t * buf)
+{
+    const TraceMessage & message = sTrace[index];
+
+    if (message.Data != nullptr)
+    {
+        memcpy(buf, message.Data, message.Length);
+        return;
+    }
+    for (uint16_t b = 0; b < message.Length; b++)
+    {
+        buf[b] = static_cast<uint8_t>(index * 31 + b);
+    }
+}
+
+// Plays the device side of the trace: checks every commissioner SDU and answers with the device
+// SDUs that follow it. Runs on the CHIP task.
+class ScriptedPeer : public Ble::BleLayerDelegate
+{
+public:
+    void OnBleConnectionComplete(Ble::BLEEndPoint * endpoint) override {}
+    void OnBleConnectionError(CHIP_ERROR err) override {}
+    void OnEndPointConnectComplete(Ble::BLEEndPoint * endPoint, CHIP_ERROR err) override { mConnected = (err == CHIP_NO_ERROR); }
+    void OnEndPointMessageReceived(Ble::BLEEndPoint * endPoint, System::PacketBufferHandle && msg) override
+    {
+        const TraceMessage & expected = sTrace[mNext];
+
+        GetTracePayload(mNext, mSdu);
+        if (expected.FromDevice || msg->DataLength() != expected.Length || memcmp(msg->Start(), mSdu, expected.Length) != 0)
+        {
+            mMismatches++;
+        }
+        mNext = (mNext + 1) % sTraceLength;
+
+        // The trace starts with a commissioner SDU, so this stops at the end of a round.
+        while (sTrace[mNext].FromDevice)
+        {
+            GetTracePayload(mNext, mSdu);
+            System::PacketBufferHandle response = System::PacketBufferHandle::NewWithData(mSdu, sTrace[mNext].Length);
+            if (response.IsNull() || endPoint->Send(std::move(response)) != CHIP_NO_ERROR)
+            {
+                mSendFailures++;
+            }
+            mNext = (mNext + 1) % sTraceLength;
+        }
+    }
+    void OnEndPointConnectionClosed(Ble::BLEEndPoint * endPoint, CHIP_ERROR err) override { mClosed = true; }
+    CHIP_ERROR SetEndPoint(Ble::BLEEndPoint * endPoint) override { return CHIP_NO_ERROR; }
+
+    std::atomic<bool> mConnected{ false };
+    std::atomic<bool> mClosed{ false };
+    std::atomic<uint32_t> mSendFailures{ 0 };
+    std::atomic<uint32_t> mMismatches{ 0 };
+
+private:
+    size_t mNext = 0;
+    uint8_t mSdu[kMaxSduSize];
+};
+
+// Commissioner side of a BTP session, on top of the central actions of the NimBLE fake.
+class BtpCentral
+{
+public:
+    CHIP_ERROR Handshake(uint16_t rxHandle, uint16_t txHandle)
+    {
+        NimBLEFake::Indication indication;
+
+        mRxHandle = rxHandle;
+        ReturnErrorOnFailure(Write(kHandshakeRequest, sizeof(kHandshakeRequest)));
+        ReturnErrorOnFailure(NimBLEFake::Instance().Subscribe(kConnHandle, txHandle, true));
+
+        VerifyOrReturnError(NimBLEFake::Instance().WaitIndication(indication, kTimeoutMs), CHIP_ERROR_TIMEOUT);
+        VerifyOrReturnError(indication.AttrHandle == txHandle, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(indication.Length == kHandshakeResponseLength && indication.Data[0] == 0x65 &&
+                                indication.Data[1] == 0x6C && indication.Data[2] == 0x04,
+                            CHIP_ERROR_INVALID_MESSAGE_TYPE);
+        mIndications++;
+
+        mFragmentSize = static_cast<uint16_t>(indication.Data[3] | (indication.Data[4] << 8));
+        mPeerWindow   = indication.Data[5];
+        VerifyOrReturnError(mFragmentSize >= 20 && mFragmentSize <= kAttMtu - 3 && mPeerWindow > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+        // The handshake response is the peripheral's packet 0; the first data packet acks it.
+        mRxLastSeq = 0;
+        mRxUnacked = 1;
+        return NimBLEFake::Instance().ConfirmIndication(kConnHandle, txHandle);
+    }
+
+    CHIP_ERROR SendSdu(const uint8_t * sdu, uint16_t len)
+    {
+        uint16_t offset = 0;
+
+        while (offset < len)
+        {
+            while (InFlight() >= mPeerWindow)
+            {
+                ReturnErrorOnFailure(Pump());
+            }
+
+            bool start      = (offset == 0);
+            uint16_t header = static_cast<uint16_t>(1 + (mRxUnacked ? 1 : 0) + 1 + (start ? 2 : 0));
+            uint16_t chunk  = static_cast<uint16_t>(len - offset);
+            if (chunk > mFragmentSize - header)
+            {
+                chunk = static_cast<uint16_t>(mFragmentSize - header);
+            }
+            bool end      = (offset + chunk == len);
+            uint8_t flags = static_cast<uint8_t>((start ? kBtpStart : 0) | (end ? kBtpEnd : 0) | (!start && !end ? kBtpContinue : 0));
+            ReturnErrorOnFailure(SendPacket(flags, sdu + offset, chunk, start ? len : 0));
+            offset = static_cast<uint16_t>(offset + chunk);
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    // The device only answers once it has the whole commissioner SDU, so no device SDU can
+    // complete while SendSdu() waits for window credits.
+    CHIP_ERROR ReceiveSdu(const uint8_t * expected, uint16_t len)
+    {
+        while (!mRxComplete)
+        {
+            ReturnErrorOnFailure(Pump());
+        }
+        mRxComplete = false;
+
+        VerifyOrReturnError(mRxLength == len && memcmp(mRxSdu, expected, len) == 0, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR Flush()
+    {
+        while (mRxUnacked != 0 && InFlight() >= mPeerWindow)
+        {
+            ReturnErrorOnFailure(Pump());
+        }
+        return (mRxUnacked != 0) ? SendPacket(0, nullptr, 0, 0) : CHIP_NO_ERROR;
+    }
+
+    uint32_t GetWrites() const { return mWrites; }
+    uint32_t GetWriteBytes() const { return mWriteBytes; }
+    uint32_t GetIndications() const { return mIndications; }
+    uint16_t GetFragmentSize() const { return mFragmentSize; }
+    uint8_t GetPeerWindow() const { return mPeerWindow; }
+
+private:
+    uint8_t InFlight() const { return static_cast<uint8_t>(mTxNextSeq - mTxOldestUnacked); }
+
+    CHIP_ERROR Write(const uint8_t * data, uint16_t len)
+    {
+        mWrites++;
+        mWriteBytes += len;
+        return NimBLEFake::Instance().Write(kConnHandle, mRxHandle, data, len);
+    }
+
+    CHIP_ERROR SendPacket(uint8_t flags, const uint8_t * payload, uint16_t payloadLen, uint16_t sduLen)
+    {
+        uint8_t packet[kAttMtu];
+        uint16_t index = 1;
+
+        if (mRxUnacked != 0)
+        {
+            flags           = static_cast<uint8_t>(flags | kBtpAck);
+            packet[index++] = mRxLastSeq;
+            mRxUnacked      = 0;
+        }
+        packet[0]       = flags;
+        packet[index++] = mTxNextSeq++;
+        if (flags & kBtpStart)
+        {
+            packet[index++] = static_cast<uint8_t>(sduLen & 0xFF);
+            packet[index++] = static_cast<uint8_t>(sduLen >> 8);
+        }
+        VerifyOrReturnError(index + payloadLen <= mFragmentSize, CHIP_ERROR_BUFFER_TOO_SMALL);
+        if (payloadLen != 0)
+        {
+            memcpy(&packet[index], payload, payloadLen);
+        }
+        return Write(packet, static_cast<uint16_t>(index + payloadLen));
+    }
+
+    // Handles the next indication from the peripheral.
+    CHIP_ERROR Pump()
+    {
+        NimBLEFake::Indication indication;
+        uint16_t index = 1;
+
+        VerifyOrReturnError(NimBLEFake::Instance().WaitIndication(indication, kTimeoutMs), CHIP_ERROR_TIMEOUT);
+        mIndications++;
+        ReturnErrorOnFailure(NimBLEFake::Instance().ConfirmIndication(indication.ConnHandle, indication.AttrHandle));
+
+        const uint8_t * packet = indication.Data;
+        uint8_t flags          = packet[0];
+        VerifyOrReturnError(indication.Length >= 2, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+        if (flags & kBtpAck)
+        {
+            mTxOldestUnacked = static_cast<uint8_t>(packet[index++] + 1);
+        }
+        VerifyOrReturnError(index < indication.Length, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+        uint8_t seq = packet[index++];
+        VerifyOrReturnError(seq == static_cast<uint8_t>(mRxLastSeq + 1), CHIP_ERROR_INVALID_MESSAGE_TYPE);
+        mRxLastSeq = seq;
+        mRxUnacked++;
+
+        if (flags & kBtpStart)
+        {
+            VerifyOrReturnError(index + 2 <= indication.Length, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+            mRxExpected = static_cast<uint16_t>(packet[index] | (packet[index + 1] << 8));
+            mRxLength   = 0;
+            index       = static_cast<uint16_t>(index + 2);
+        }
+        uint16_t payloadLen = static_cast<uint16_t>(indication.Length - index);
+        VerifyOrReturnError(mRxLength + payloadLen <= sizeof(mRxSdu), CHIP_ERROR_BUFFER_TOO_SMALL);
+        memcpy(&mRxSdu[mRxLength], &packet[index], payloadLen);
+        mRxLength = static_cast<uint16_t>(mRxLength + payloadLen);
+        if (flags & kBtpEnd)
+        {
+            VerifyOrReturnError(mRxLength == mRxExpected, CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+            mRxComplete = true;
+        }
+
+        // Open the window again before the peripheral stalls on it.
+        if (mRxUnacked >= kCentralWindow / 2 && InFlight() < mPeerWindow)
+        {
+            ReturnErrorOnFailure(SendPacket(0, nullptr, 0, 0));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    uint16_t mRxHandle     = 0;
+    uint16_t mFragmentSize = 0;
+    uint8_t mPeerWindow    = 0;
+
+    uint8_t mTxNextSeq       = 0;
+    uint8_t mTxOldestUnacked = 0;
+    uint8_t mRxLastSeq       = 0;
+    uint8_t mRxUnacked       = 0;
+
+    uint8_t mRxSdu[kMaxSduSize];
+    uint16_t mRxLength   = 0;
+    uint16_t mRxExpected = 0;
+    bool mRxComplete     = false;
+
+    uint32_t mWrites      = 0;
+    uint32_t mWriteBytes  = 0;
+    uint32_t mIndications = 0;
+};
+
+uint32_t sRounds = kDefaultRounds;
+ScriptedPeer sTransport;
+BtpCentral sCentral;
+uint8_t sSdu[kMaxSduSize];
+uint64_t sReplayUs;
+// Time from the end of the previous SDU to the completion of each device SDU.
+uint64_t sTurnTotalUs[kMaxTraceLength];
+uint64_t sTurnMaxUs[kMaxTraceLength];
+
+bool Check(bool condition, const char * what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAILED: %s\n", what);
+    }
+    return condition;
+}
+
+void UseReferenceTrace()
+{
+    for (const BLEReplayRecord & record : Internal::kPaseCommissioningTrace)
+    {
+        sTrace[sTraceLength++] = { record.FromDevice, record.Length, record.Name, nullptr };
+    }
+}
+
+int HexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool LoadTrace(const char * path)
+{
+    static char line[2 * kMaxSduSize + 64];
+    FILE * file = fopen(path, "r");
+    bool ok     = (file != nullptr);
+
+    while (ok && fgets(line, sizeof(line), file) != nullptr)
+    {
+        char * cursor = line;
+        while (*cursor == ' ' || *cursor == '\t')
+        {
+            cursor++;
+        }
+        if (*cursor == '#' || *cursor == '\n' || *cursor == '\r' || *cursor == '\0')
+        {
+            continue;
+        }
+
+        ok = (sTraceLength < kMaxTraceLength) && (*cursor == 'c' || *cursor == 'd');
+        if (!ok)
+        {
+            break;
+        }
+        TraceMessage & message = sTrace[sTraceLength];
+        uint8_t * data         = sCapturedData[sTraceLength];
+        uint16_t length        = 0;
+
+        message.FromDevice = (*cursor++ == 'd');
+        message.Name       = message.FromDevice ? "device" : "commissioner";
+        while (ok && *cursor != '\0' && *cursor != '#')
+        {
+            if (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r')
+            {
+                cursor++;
+                continue;
+            }
+            int high = HexValue(cursor[0]);
+            int low  = (high >= 0) ? HexValue(cursor[1]) : -1;
+            ok       = (low >= 0 && length < kMaxSduSize);
+            if (ok)
+            {
+                data[length++] = static_cast<uint8_t>((high << 4) | low);
+                cursor += 2;
+            }
+        }
+        ok &= (length > 0);
+        message.Length = length;
+        message.Data   = data;
+        sTraceLength++;
+    }
+
+    if (file != nullptr)
+    {
+        fclose(file);
+    }
+    return ok;
+}
+
+bool CheckTrace()
+{
+    VerifyOrReturnValue(sTraceLength > 0 && !sTrace[0].FromDevice, false);
+    for (size_t i = 0; i < sTraceLength; i++)
+    {
+        sTraceBytes += sTrace[i].Length;
+    }
+    return true;
+}
+
+bool IsFullyAdvertising()
+{
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+    return NimBLEFake::Instance().GetExtAdvertisingSets() == kExtAdvSets;
+#else
+    return NimBLEFake::Instance().IsAdvertising();
+#endif
+}
+
+uint32_t GetAdvertisingUpdates()
+{
+    BLEManagerImpl::AdvertisingMetrics metrics;
+
+    PlatformMgr().LockChipStack();
+    Internal::BLEMgrImpl().GetAdvertisingMetrics(metrics);
+    PlatformMgr().UnlockChipStack();
+    return metrics.ParamUpdates + metrics.DataOnlyUpdates;
+}
+
+bool IsCHIPoBLEEnabled()
+{
+    PlatformMgr().LockChipStack();
+    bool enabled = Internal::BLEMgr().GetCHIPoBLEServiceMode() == ConnectivityManager::kCHIPoBLEServiceMode_Enabled;
+    PlatformMgr().UnlockChipStack();
+    return enabled;
+}
+
+// A connection stops only the advertising set it came in on. The refresh that follows it, and
+// a later one, must restart advertising without tripping over the set that kept running.
+bool ConnectAndRefreshAdvertising()
+{
+    uint32_t startCount = NimBLEFake::Instance().GetAdvertisingStartCount();
+
+    VerifyOrReturnValue(Check(NimBLEFake::Instance().Connect(kConnHandle, kAttMtu) == CHIP_NO_ERROR, "connect"), false);
+    VerifyOrReturnValue(Check(WaitUntil([] {
+                                  PlatformMgr().LockChipStack();
+                                  uint16_t numConnections = Internal::BLEMgr().NumConnections();
+                                  PlatformMgr().UnlockChipStack();
+                                  return numConnections == 1;
+                              }),
+                              "connection state"),
+                        false);
+
+#if CHIP_DEVICE_CONFIG_CHIPOBLE_SINGLE_CONNECTION
+    return Check(WaitUntil([] { return !NimBLEFake::Instance().IsAdvertising(); }), "advertising stopped on connect") &&
+        Check(IsCHIPoBLEEnabled(), "CHIPoBLE enabled after connect");
+#else
+    VerifyOrReturnValue(Check(WaitUntil([startCount] {
+                                  return NimBLEFake::Instance().GetAdvertisingStartCount() != startCount && IsFullyAdvertising();
+                              }),
+                              "advertising restarted on connect"),
+                        false);
+
+    uint32_t updates = GetAdvertisingUpdates();
+    VerifyOrReturnValue(Check(Internal::BLEMgrImpl().TriggerAdvertisingBurst() == CHIP_NO_ERROR, "advertising burst"), false);
+    VerifyOrReturnValue(Check(WaitUntil([updates] { return GetAdvertisingUpdates() != updates; }), "advertising refresh"), false);
+    return Check(IsCHIPoBLEEnabled(), "CHIPoBLE enabled after refresh") && Check(IsFullyAdvertising(), "advertising after refresh");
+#endif
+}
+
+bool RunSession()
+{
+    VerifyOrReturnValue(Check(WaitUntil([] { return IsFullyAdvertising(); }), "advertising"), false);
+
+    uint16_t rxHandle = NimBLEFake::Instance().FindCharacteristic(&kCHIPoBLEChar_RX.u);
+    uint16_t txHandle = NimBLEFake::Instance().FindCharacteristic(&kCHIPoBLEChar_TX.u);
+    VerifyOrReturnValue(Check(rxHandle != 0 && txHandle != 0, "CHIPoBLE service registration"), false);
+
+    VerifyOrReturnValue(ConnectAndRefreshAdvertising(), false);
+    VerifyOrReturnValue(Check(sCentral.Handshake(rxHandle, txHandle) == CHIP_NO_ERROR, "BTP handshake"), false);
+    VerifyOrReturnValue(Check(WaitUntil([] { return sTransport.mConnected.load(); }), "BTP connection"), false);
+
+    uint64_t replayStartUs = NowUs();
+    for (uint32_t round = 0; round < sRounds; round++)
+    {
+        uint64_t turnStartUs = NowUs();
+        for (size_t i = 0; i < sTraceLength; i++)
+        {
+            CHIP_ERROR err;
+
+            GetTracePayload(i, sSdu);
+            if (sTrace[i].FromDevice)
+            {
+                err = sCentral.ReceiveSdu(sSdu, sTrace[i].Length);
+
+                uint64_t nowUs = NowUs();
+                sTurnTotalUs[i] += nowUs - turnStartUs;
+                sTurnMaxUs[i] = (nowUs - turnStartUs > sTurnMaxUs[i]) ? nowUs - turnStartUs : sTurnMaxUs[i];
+                turnStartUs   = nowUs;
+            }
+            else
+            {
+                err         = sCentral.SendSdu(sSdu, sTrace[i].Length);
+                turnStartUs = NowUs();
+            }
+            if (err != CHIP_NO_ERROR)
+            {
+                fprintf(stderr, "FAILED: %s (%u bytes): %" CHIP_ERROR_FORMAT "\n", sTrace[i].Name, sTrace[i].Length, err.Format());
+                return false;
+            }
+        }
+    }
+    sReplayUs = NowUs() - replayStartUs;
+    return Check(sCentral.Flush() == CHIP_NO_ERROR, "final ack");
+}
+
+void PrintTurns()
+{
+    printf("%-36s %6s %10s %10s\n", "device message", "bytes", "avg us", "max us");
+    for (size_t i = 0; i < sTraceLength; i++)
+    {
+        if (sTrace[i].FromDevice)
+        {
+            printf("%-36s %6u %10.1f %10" PRIu64 "\n", sTrace[i].Name, sTrace[i].Length,
+                   static_cast<double>(sTurnTotalUs[i]) / sRounds, sTurnMaxUs[i]);
+        }
+    }
+}
+
+bool CheckPathStats()
+{
+    BLEManagerImpl::BLEPathStats stats;
+    uint32_t indications = sCentral.GetIndications();
+
+    // The last confirmation is still on its way to the CHIP task.
+    bool settled = WaitUntil([indications] {
+        BLEManagerImpl::BLEPathStats current;
+        PlatformMgr().LockChipStack();
+        Internal::BLEMgrImpl().GetBLEPathStats(current);
+        PlatformMgr().UnlockChipStack();
+        return current.IndicationConfirms == indications && current.RxFragments == sCentral.GetWrites();
+    });
+
+    PlatformMgr().LockChipStack();
+    Internal::BLEMgrImpl().GetBLEPathStats(stats);
+    PlatformMgr().UnlockChipStack();
+
+    printf("BTP: fragment size %u, peer window %u\n", sCentral.GetFragmentSize(), sCentral.GetPeerWindow());
+    printf("TX: %" PRIu32 " bytes, %" PRIu32 " fragments, %" PRIu32 " allocs\n", stats.TxBytes, stats.TxFragments,
+           stats.TxAllocs);
+    printf("RX: %" PRIu32 " bytes, %" PRIu32 " fragments, %" PRIu32 " allocs\n", stats.RxBytes, stats.RxFragments,
+           stats.RxAllocs);
+
+    // The four figures the BLE path optimizations are judged by.
+    uint32_t messages = static_cast<uint32_t>(sTraceLength * sRounds);
+    printf("Throughput: %" PRIu32 " SDU bytes in %" PRIu64 " us, %.0f bytes/s\n", sTraceBytes * sRounds, sReplayUs,
+           sReplayUs ? static_cast<double>(sTraceBytes) * sRounds * 1000000.0 / static_cast<double>(sReplayUs) : 0.0);
+    printf("Per-fragment latency (indication to confirm): avg %" PRIu32 " us, max %" PRIu32 " us (%" PRIu32 " confirms)\n",
+           stats.IndicationConfirms ? static_cast<uint32_t>(stats.IndicationLatencyTotalUs / stats.IndicationConfirms) : 0,
+           stats.IndicationLatencyMaxUs, stats.IndicationConfirms);
+    printf("Allocations per message: %.2f (%" PRIu32 " messages)\n",
+           static_cast<double>(stats.TxAllocs + stats.RxAllocs) / static_cast<double>(messages), messages);
+    printf("CHIP task time: %.1f us per message, %" PRIu32 " events, max %" PRIu32 " us\n",
+           static_cast<double>(stats.ChipEventTimeTotalUs) / static_cast<double>(messages), stats.ChipEvents,
+           stats.ChipEventTimeMaxUs);
+
+    bool ok = Check(settled, "path stats settle");
+    ok &= Check(stats.RxFragments == sCentral.GetWrites() && stats.RxBytes == sCentral.GetWriteBytes(), "RX stats");
+    ok &= Check(stats.TxFragments == indications && stats.TxAllocs == indications, "TX stats");
+    ok &= Check(stats.IndicationConfirms == indications, "indication confirms");
+    return ok;
+}
+
+void ReplayTask(void *)
+{
+    if (Platform::MemoryInit() != CHIP_NO_ERROR || ATBMHalFake::Instance().Init() != CHIP_NO_ERROR ||
+        PlatformMgr().InitChipStack() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "initialization failed\n");
+        exit(1);
+    }
+
+    PlatformMgr().LockChipStack();
+    ConnectivityMgr().GetBleLayer()->mBleTransport = &sTransport;
+    PlatformMgr().UnlockChipStack();
+
+    if (PlatformMgr().StartEventLoopTask() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "CHIP stack start failed\n");
+        exit(1);
+    }
+
+    bool ok = RunSession();
+
+    PrintTurns();
+    ok &= CheckPathStats();
+    ok &= Check(sTransport.mSendFailures == 0, "device sends");
+    ok &= Check(sTransport.mMismatches == 0, "commissioner SDUs");
+
+    // The central leaves; the end point closes and advertising resumes.
+    ok &= Check(NimBLEFake::Instance().Disconnect(kConnHandle, BLE_ERR_REM_USER_CONN_TERM) == CHIP_NO_ERROR, "disconnect");
+    ok &= Check(WaitUntil([] { return sTransport.mClosed.load(); }), "end point closed");
+    ok &= Check(WaitUntil([] { return NimBLEFake::Instance().IsAdvertising(); }), "advertising restarted");
+
+    exit(ok ? 0 : 1);
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    sRounds = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : kDefaultRounds;
+    if (sRounds == 0)
+    {
+        fprintf(stderr, "rounds must be at least 1\n");
+        return 1;
+    }
+    if (argc > 2)
+    {
+        if (!LoadTrace(argv[2]))
+        {
+            fprintf(stderr, "cannot load trace %s\n", argv[2]);
+            return 1;
+        }
+    }
+    else
+    {
+        UseReferenceTrace();
+    }
+    if (!CheckTrace())
+    {
+        fprintf(stderr, "the trace must start with a commissioner SDU\n");
+        return 1;
+    }
+
+    if (xTaskCreate(ReplayTask, "replay", 8192, nullptr, tskIDLE_PRIORITY + 1, nullptr) != pdPASS)
+    {
+        fprintf(stderr, "replay task creation failed\n");
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 1;
+}
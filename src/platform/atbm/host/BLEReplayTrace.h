@@ -0,0 +1,83 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Reference CHIPoBLE trace for atbm-ble-replay: the BTP SDUs of a PASE session
+ *          followed by BLE-WiFi commissioning with chip-tool, up to ConnectNetwork.
+ *
+ *          Only the direction and the SDU length of every message are kept. The payloads are
+ *          random, encrypted or device-specific, so the harness regenerates them; the BLE path
+ *          sees the same fragmentation, windowing and turn-taking as with a commissioner.
+ *          Lengths include the message header (unsecured: 16 bytes with the source node ID;
+ *          secured: 8 bytes plus the 16-byte MIC) and the 6-byte protocol header.
+ *
+ *          A capture can be replayed instead; see BLEReplayMain.cpp for the file format.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+struct BLEReplayRecord
+{
+    bool FromDevice;
+    uint16_t Length;
+    const char * Name;
+};
+
+inline constexpr BLEReplayRecord kPaseCommissioningTrace[] = {
+    // PASE, unsecured session.
+    { false, 87, "PBKDFParamRequest" },
+    { true, 160, "PBKDFParamResponse" },
+    { false, 92, "Pake1" },
+    { true, 127, "Pake2" },
+    { false, 59, "Pake3" },
+    { true, 30, "StatusReport" },
+
+    // Commissioning over the PASE session.
+    { false, 140, "ReadRequest (commissioning info)" },
+    { true, 262, "ReportData" },
+    { false, 70, "ArmFailSafe" },
+    { true, 75, "ArmFailSafeResponse" },
+    { false, 78, "SetRegulatoryConfig" },
+    { true, 75, "SetRegulatoryConfigResponse" },
+    { false, 68, "CertificateChainRequest (DAC)" },
+    { true, 541, "CertificateChainResponse (DAC)" },
+    { false, 68, "CertificateChainRequest (PAI)" },
+    { true, 498, "CertificateChainResponse (PAI)" },
+    { false, 105, "AttestationRequest" },
+    { true, 468, "AttestationResponse" },
+    { false, 105, "CSRRequest" },
+    { true, 420, "CSRResponse" },
+    { false, 300, "AddTrustedRootCertificate" },
+    { true, 68, "InvokeResponse (status)" },
+    { false, 572, "AddNOC" },
+    { true, 80, "NOCResponse" },
+    { false, 105, "AddOrUpdateWiFiNetwork" },
+    { true, 80, "NetworkConfigResponse" },
+    { false, 85, "ConnectNetwork" },
+    { true, 82, "ConnectNetworkResponse" },
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
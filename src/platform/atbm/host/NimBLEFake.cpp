@@ -0,0 +1,707 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "NimBLEFake.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <lib/support/CodeUtils.h>
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+
+#include "gap/ble_svc_gap.h"
+#include "gatt/ble_svc_gatt.h"
+#include "nimble/nimble_port.h"
+#include "nimble/nimble_port_freertos.h"
+#include "util/util.h"
+
+struct ble_hs_cfg ble_hs_cfg;
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr size_t kMaxConnections     = MYNEWT_VAL(BLE_MAX_CONNECTIONS);
+constexpr size_t kMaxCharacteristics = 8;
+constexpr size_t kHostQueueDepth     = 16;
+constexpr size_t kIndicationDepth    = 8;
+constexpr uint16_t kMbufCapacity     = NimBLEFake::kMaxAttrLen;
+constexpr uint16_t kHostTaskStack    = 4096;
+
+enum class HostOpType : uint8_t
+{
+    kConnect,
+    kSubscribe,
+    kWrite,
+    kConfirm,
+    kDisconnect,
+};
+
+struct HostOp
+{
+    HostOpType Type;
+    uint16_t ConnHandle;
+    uint16_t AttrHandle;
+    uint16_t Value; // MTU, subscription state or disconnect reason.
+    uint16_t Length;
+    uint8_t Data[NimBLEFake::kMaxAttrLen];
+};
+
+struct Characteristic
+{
+    const struct ble_gatt_chr_def * Def;
+    uint16_t ValHandle;
+};
+
+struct Connection
+{
+    bool InUse;
+    uint16_t ConnHandle;
+    uint16_t Mtu;
+};
+
+QueueHandle_t sHostQueue;
+QueueHandle_t sIndicationQueue;
+HostOp sHostOp; // Only used by the NimBLE host task.
+
+// Shared between the CHIP task, the NimBLE host task and the harness; guarded by a critical section.
+ble_gap_event_fn * sGapEventCb;
+void * sGapEventArg;
+bool sAdvActive;
+uint8_t sExtAdvSets;            // Bit per enabled extended advertising instance.
+uint8_t sExtAdvConnectableSets; // Bit per instance configured connectable.
+uint32_t sAdvStartCount;
+Characteristic sChrs[kMaxCharacteristics];
+size_t sChrCount;
+uint16_t sNextHandle = 1;
+Connection sCons[kMaxConnections];
+uint8_t sRandomAddr[6];
+
+struct os_mbuf * AllocMbuf()
+{
+    auto * om = static_cast<struct os_mbuf *>(calloc(1, sizeof(struct os_mbuf) + sizeof(struct os_mbuf_pkthdr) + kMbufCapacity));
+    VerifyOrReturnValue(om != nullptr, nullptr);
+    om->om_pkthdr_len = sizeof(struct os_mbuf_pkthdr);
+    om->om_data       = om->om_databuf + om->om_pkthdr_len;
+    return om;
+}
+
+Connection * FindConnection(uint16_t connHandle)
+{
+    for (Connection & con : sCons)
+    {
+        if (con.InUse && con.ConnHandle == connHandle)
+        {
+            return &con;
+        }
+    }
+    return nullptr;
+}
+
+const Characteristic * FindByHandle(uint16_t valHandle)
+{
+    for (size_t i = 0; i < sChrCount; i++)
+    {
+        if (sChrs[i].ValHandle == valHandle)
+        {
+            return &sChrs[i];
+        }
+    }
+    return nullptr;
+}
+
+bool UuidEqual(const ble_uuid_t * a, const ble_uuid_t * b)
+{
+    VerifyOrReturnValue(a->type == b->type, false);
+    switch (a->type)
+    {
+    case BLE_UUID_TYPE_16:
+        return reinterpret_cast<const ble_uuid16_t *>(a)->value == reinterpret_cast<const ble_uuid16_t *>(b)->value;
+    case BLE_UUID_TYPE_32:
+        return reinterpret_cast<const ble_uuid32_t *>(a)->value == reinterpret_cast<const ble_uuid32_t *>(b)->value;
+    default:
+        return memcmp(reinterpret_cast<const ble_uuid128_t *>(a)->value, reinterpret_cast<const ble_uuid128_t *>(b)->value,
+                      sizeof(ble_uuid128_t::value)) == 0;
+    }
+}
+
+CHIP_ERROR PostHostOp(const HostOp & op)
+{
+    VerifyOrReturnError(sHostQueue != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(xQueueSendToBack(sHostQueue, &op, portMAX_DELAY) == pdTRUE, CHIP_ERROR_NO_MEMORY);
+    return CHIP_NO_ERROR;
+}
+
+void DeliverGapEvent(struct ble_gap_event & event)
+{
+    taskENTER_CRITICAL();
+    ble_gap_event_fn * cb = sGapEventCb;
+    void * arg            = sGapEventArg;
+    taskEXIT_CRITICAL();
+
+    if (cb != nullptr)
+    {
+        cb(&event, arg);
+    }
+}
+
+void HandleConnect(const HostOp & op)
+{
+    struct ble_gap_event event;
+    Connection * slot = nullptr;
+
+    taskENTER_CRITICAL();
+    for (Connection & con : sCons)
+    {
+        if (!con.InUse)
+        {
+            slot = &con;
+            break;
+        }
+    }
+    if (slot != nullptr)
+    {
+        *slot = { true, op.ConnHandle, op.Value };
+    }
+    // Like the controller, a connection ends legacy advertising, or only the extended
+    // advertising set it came in on (the lowest enabled connectable instance).
+    sAdvActive       = false;
+    int connectedSet = -1;
+    for (uint8_t instance = 0; instance < 8 && slot != nullptr; instance++)
+    {
+        if (sExtAdvSets & sExtAdvConnectableSets & (1 << instance))
+        {
+            sExtAdvSets  = static_cast<uint8_t>(sExtAdvSets & ~(1 << instance));
+            connectedSet = instance;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    memset(&event, 0, sizeof(event));
+    event.type                = BLE_GAP_EVENT_CONNECT;
+    event.connect.status      = (slot != nullptr) ? 0 : BLE_HS_ENOMEM;
+    event.connect.conn_handle = op.ConnHandle;
+    DeliverGapEvent(event);
+    VerifyOrReturn(slot != nullptr);
+
+#if MYNEWT_VAL(BLE_EXT_ADV)
+    // The host reports the terminated set after the connection, as NimBLE does.
+    if (connectedSet >= 0)
+    {
+        memset(&event, 0, sizeof(event));
+        event.type                     = BLE_GAP_EVENT_ADV_COMPLETE;
+        event.adv_complete.reason      = 0;
+        event.adv_complete.instance    = static_cast<uint8_t>(connectedSet);
+        event.adv_complete.conn_handle = op.ConnHandle;
+        DeliverGapEvent(event);
+    }
+#endif
+
+    memset(&event, 0, sizeof(event));
+    event.type            = BLE_GAP_EVENT_MTU;
+    event.mtu.conn_handle = op.ConnHandle;
+    event.mtu.channel_id  = BLE_L2CAP_CID_ATT;
+    event.mtu.value       = op.Value;
+    DeliverGapEvent(event);
+}
+
+void HandleSubscribe(const HostOp & op)
+{
+    struct ble_gap_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.type                    = BLE_GAP_EVENT_SUBSCRIBE;
+    event.subscribe.conn_handle   = op.ConnHandle;
+    event.subscribe.attr_handle   = op.AttrHandle;
+    event.subscribe.reason        = BLE_GAP_SUBSCRIBE_REASON_WRITE;
+    event.subscribe.prev_indicate = !op.Value;
+    event.subscribe.cur_indicate  = op.Value;
+    DeliverGapEvent(event);
+}
+
+void HandleWrite(const HostOp & op)
+{
+    taskENTER_CRITICAL();
+    const Characteristic * chr = FindByHandle(op.AttrHandle);
+    taskEXIT_CRITICAL();
+    VerifyOrReturn(chr != nullptr && chr->Def->access_cb != nullptr);
+
+    struct ble_gatt_access_ctxt ctxt;
+    memset(&ctxt, 0, sizeof(ctxt));
+    ctxt.op  = BLE_GATT_ACCESS_OP_WRITE_CHR;
+    ctxt.om  = ble_hs_mbuf_from_flat(op.Data, op.Length);
+    ctxt.chr = chr->Def;
+    VerifyOrReturn(ctxt.om != nullptr);
+
+    chr->Def->access_cb(op.ConnHandle, op.AttrHandle, &ctxt, chr->Def->arg);
+    os_mbuf_free_chain(ctxt.om);
+}
+
+void HandleConfirm(const HostOp & op)
+{
+    struct ble_gap_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.type                  = BLE_GAP_EVENT_NOTIFY_TX;
+    event.notify_tx.status      = BLE_HS_EDONE;
+    event.notify_tx.conn_handle = op.ConnHandle;
+    event.notify_tx.attr_handle = op.AttrHandle;
+    event.notify_tx.indication  = 1;
+    DeliverGapEvent(event);
+}
+
+void HandleDisconnect(const HostOp & op)
+{
+    struct ble_gap_event event;
+
+    taskENTER_CRITICAL();
+    Connection * con = FindConnection(op.ConnHandle);
+    if (con != nullptr)
+    {
+        con->InUse = false;
+    }
+    taskEXIT_CRITICAL();
+    VerifyOrReturn(con != nullptr);
+
+    memset(&event, 0, sizeof(event));
+    event.type                        = BLE_GAP_EVENT_DISCONNECT;
+    event.disconnect.reason           = BLE_HS_HCI_ERR(op.Value);
+    event.disconnect.conn.conn_handle = op.ConnHandle;
+    DeliverGapEvent(event);
+}
+
+} // namespace
+
+NimBLEFake NimBLEFake::sInstance;
+
+bool NimBLEFake::IsAdvertising() const
+{
+    taskENTER_CRITICAL();
+    bool active = sAdvActive || sExtAdvSets != 0;
+    taskEXIT_CRITICAL();
+    return active;
+}
+
+uint8_t NimBLEFake::GetExtAdvertisingSets() const
+{
+    taskENTER_CRITICAL();
+    uint8_t sets = sExtAdvSets;
+    taskEXIT_CRITICAL();
+    return sets;
+}
+
+uint32_t NimBLEFake::GetAdvertisingStartCount() const
+{
+    taskENTER_CRITICAL();
+    uint32_t count = sAdvStartCount;
+    taskEXIT_CRITICAL();
+    return count;
+}
+
+uint16_t NimBLEFake::FindCharacteristic(const ble_uuid_t * uuid) const
+{
+    uint16_t handle = 0;
+
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < sChrCount && handle == 0; i++)
+    {
+        if (UuidEqual(sChrs[i].Def->uuid, uuid))
+        {
+            handle = sChrs[i].ValHandle;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return handle;
+}
+
+CHIP_ERROR NimBLEFake::Connect(uint16_t connHandle, uint16_t mtu)
+{
+    HostOp op = { HostOpType::kConnect, connHandle, 0, mtu, 0, {} };
+    return PostHostOp(op);
+}
+
+CHIP_ERROR NimBLEFake::Subscribe(uint16_t connHandle, uint16_t attrHandle, bool indicate)
+{
+    HostOp op = { HostOpType::kSubscribe, connHandle, attrHandle, static_cast<uint16_t>(indicate), 0, {} };
+    return PostHostOp(op);
+}
+
+CHIP_ERROR NimBLEFake::Write(uint16_t connHandle, uint16_t attrHandle, const uint8_t * data, uint16_t len)
+{
+    VerifyOrReturnError(len <= kMaxAttrLen, CHIP_ERROR_INVALID_ARGUMENT);
+
+    HostOp op = { HostOpType::kWrite, connHandle, attrHandle, 0, len, {} };
+    memcpy(op.Data, data, len);
+    return PostHostOp(op);
+}
+
+CHIP_ERROR NimBLEFake::ConfirmIndication(uint16_t connHandle, uint16_t attrHandle)
+{
+    HostOp op = { HostOpType::kConfirm, connHandle, attrHandle, 0, 0, {} };
+    return PostHostOp(op);
+}
+
+CHIP_ERROR NimBLEFake::Disconnect(uint16_t connHandle, uint8_t hciReason)
+{
+    HostOp op = { HostOpType::kDisconnect, connHandle, 0, hciReason, 0, {} };
+    return PostHostOp(op);
+}
+
+bool NimBLEFake::WaitIndication(Indication & indication, uint32_t timeoutMs)
+{
+    VerifyOrReturnValue(sIndicationQueue != nullptr, false);
+    return xQueueReceive(sIndicationQueue, &indication, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
+
+using namespace chip::DeviceLayer::Internal;
+
+// ===== NimBLE port
+
+void nimble_port_init(void)
+{
+    if (sHostQueue == nullptr)
+    {
+        sHostQueue       = xQueueCreate(kHostQueueDepth, sizeof(HostOp));
+        sIndicationQueue = xQueueCreate(kIndicationDepth, sizeof(NimBLEFake::Indication));
+    }
+}
+
+void nimble_port_freertos_init(TaskFunction_t host_task_fn)
+{
+    xTaskCreate(host_task_fn, "nimble_host", kHostTaskStack, nullptr, configMAX_PRIORITIES - 2, nullptr);
+}
+
+void nimble_port_run(void)
+{
+    if (ble_hs_cfg.sync_cb != nullptr)
+    {
+        ble_hs_cfg.sync_cb();
+    }
+
+    while (xQueueReceive(sHostQueue, &sHostOp, portMAX_DELAY) == pdTRUE)
+    {
+        switch (sHostOp.Type)
+        {
+        case HostOpType::kConnect:
+            HandleConnect(sHostOp);
+            break;
+        case HostOpType::kSubscribe:
+            HandleSubscribe(sHostOp);
+            break;
+        case HostOpType::kWrite:
+            HandleWrite(sHostOp);
+            break;
+        case HostOpType::kConfirm:
+            HandleConfirm(sHostOp);
+            break;
+        case HostOpType::kDisconnect:
+            HandleDisconnect(sHostOp);
+            break;
+        }
+    }
+}
+
+// ===== mbufs
+
+struct os_mbuf * ble_hs_mbuf_from_flat(const void * buf, uint16_t len)
+{
+    struct os_mbuf * om = nullptr;
+
+    if (len <= kMbufCapacity && (om = AllocMbuf()) != nullptr)
+    {
+        memcpy(om->om_data, buf, len);
+        om->om_len         = len;
+        OS_MBUF_PKTLEN(om) = len;
+    }
+    return om;
+}
+
+int ble_hs_mbuf_to_flat(const struct os_mbuf * om, void * flat, uint16_t max_len, uint16_t * out_copy_len)
+{
+    uint16_t len = (om->om_len < max_len) ? om->om_len : max_len;
+
+    memcpy(flat, om->om_data, len);
+    if (out_copy_len != nullptr)
+    {
+        *out_copy_len = len;
+    }
+    return (len < om->om_len) ? BLE_HS_EMSGSIZE : 0;
+}
+
+int os_mbuf_append(struct os_mbuf * om, const void * data, uint16_t len)
+{
+    VerifyOrReturnValue(om->om_len + len <= kMbufCapacity, OS_ENOMEM);
+    memcpy(om->om_data + om->om_len, data, len);
+    om->om_len         = static_cast<uint16_t>(om->om_len + len);
+    OS_MBUF_PKTLEN(om) = om->om_len;
+    return 0;
+}
+
+int os_mbuf_free_chain(struct os_mbuf * om)
+{
+    free(om);
+    return 0;
+}
+
+// ===== GAP
+
+int ble_gap_adv_set_data(const uint8_t * data, int data_len)
+{
+    return (data_len <= BLE_HS_ADV_MAX_SZ) ? 0 : BLE_HS_EMSGSIZE;
+}
+
+int ble_gap_adv_rsp_set_data(const uint8_t * data, int data_len)
+{
+    return (data_len <= BLE_HS_ADV_MAX_SZ) ? 0 : BLE_HS_EMSGSIZE;
+}
+
+int ble_gap_adv_start(uint8_t own_addr_type, const ble_addr_t * direct_addr, int32_t duration_ms,
+                      const struct ble_gap_adv_params * adv_params, ble_gap_event_fn * cb, void * cb_arg)
+{
+    int rc = 0;
+
+    taskENTER_CRITICAL();
+    if (sAdvActive)
+    {
+        rc = BLE_HS_EALREADY;
+    }
+    else
+    {
+        sAdvActive   = true;
+        sGapEventCb  = cb;
+        sGapEventArg = cb_arg;
+        sAdvStartCount++;
+    }
+    taskEXIT_CRITICAL();
+    return rc;
+}
+
+int ble_gap_adv_stop(void)
+{
+    taskENTER_CRITICAL();
+    int rc     = sAdvActive ? 0 : BLE_HS_EALREADY;
+    sAdvActive = false;
+    taskEXIT_CRITICAL();
+    return rc;
+}
+
+int ble_gap_adv_active(void)
+{
+    taskENTER_CRITICAL();
+    bool active = sAdvActive;
+    taskEXIT_CRITICAL();
+    return active;
+}
+
+int ble_gap_terminate(uint16_t conn_handle, uint8_t hci_reason)
+{
+    taskENTER_CRITICAL();
+    bool connected = FindConnection(conn_handle) != nullptr;
+    taskEXIT_CRITICAL();
+    VerifyOrReturnValue(connected, BLE_HS_ENOTCONN);
+
+    // The reason reported locally is not the one sent to the peer.
+    return NimBLEFake::Instance().Disconnect(conn_handle, BLE_ERR_CONN_TERM_LOCAL) == CHIP_NO_ERROR ? 0 : BLE_HS_ENOMEM;
+}
+
+#if MYNEWT_VAL(BLE_EXT_ADV)
+int ble_gap_ext_adv_configure(uint8_t instance, const struct ble_gap_ext_adv_params * params, int8_t * selected_tx_power,
+                              ble_gap_event_fn * cb, void * cb_arg)
+{
+    int rc = 0;
+
+    VerifyOrReturnValue(instance < MYNEWT_VAL(BLE_MULTI_ADV_INSTANCES) + 1, BLE_HS_EINVAL);
+
+    taskENTER_CRITICAL();
+    // Like NimBLE, an enabled set cannot be reconfigured.
+    if (sExtAdvSets & (1 << instance))
+    {
+        rc = BLE_HS_EBUSY;
+    }
+    else
+    {
+        sGapEventCb            = cb;
+        sGapEventArg           = cb_arg;
+        sExtAdvConnectableSets = static_cast<uint8_t>(params->connectable ? (sExtAdvConnectableSets | (1 << instance))
+                                                                          : (sExtAdvConnectableSets & ~(1 << instance)));
+    }
+    taskEXIT_CRITICAL();
+    return rc;
+}
+
+int ble_gap_ext_adv_set_data(uint8_t instance, struct os_mbuf * data)
+{
+    os_mbuf_free_chain(data);
+    return 0;
+}
+
+int ble_gap_ext_adv_rsp_set_data(uint8_t instance, struct os_mbuf * data)
+{
+    os_mbuf_free_chain(data);
+    return 0;
+}
+
+int ble_gap_ext_adv_start(uint8_t instance, int duration, int max_events)
+{
+    int rc = 0;
+
+    taskENTER_CRITICAL();
+    if (sExtAdvSets & (1 << instance))
+    {
+        rc = BLE_HS_EALREADY;
+    }
+    else
+    {
+        sExtAdvSets = static_cast<uint8_t>(sExtAdvSets | (1 << instance));
+        sAdvStartCount++;
+    }
+    taskEXIT_CRITICAL();
+    return rc;
+}
+
+int ble_gap_ext_adv_stop(uint8_t instance)
+{
+    taskENTER_CRITICAL();
+    int rc      = (sExtAdvSets & (1 << instance)) ? 0 : BLE_HS_EALREADY;
+    sExtAdvSets = static_cast<uint8_t>(sExtAdvSets & ~(1 << instance));
+    taskEXIT_CRITICAL();
+    return rc;
+}
+#endif // MYNEWT_VAL(BLE_EXT_ADV)
+
+// ===== GATT
+
+int ble_gatts_count_cfg(const struct ble_gatt_svc_def * defs)
+{
+    return 0;
+}
+
+int ble_gatts_add_svcs(const struct ble_gatt_svc_def * svcs)
+{
+    int rc = 0;
+
+    taskENTER_CRITICAL();
+    for (const struct ble_gatt_svc_def * svc = svcs; svc->type != BLE_GATT_SVC_TYPE_END && rc == 0; svc++)
+    {
+        sNextHandle++; // Service declaration.
+        for (const struct ble_gatt_chr_def * chr = svc->characteristics; chr != nullptr && chr->uuid != nullptr; chr++)
+        {
+            if (sChrCount == kMaxCharacteristics)
+            {
+                rc = BLE_HS_ENOMEM;
+                break;
+            }
+            // Declaration, value and, for notifiable characteristics, the CCCD.
+            uint16_t valHandle = static_cast<uint16_t>(sNextHandle + 1);
+            sNextHandle        = static_cast<uint16_t>(sNextHandle +
+                                                (chr->flags & (BLE_GATT_CHR_F_NOTIFY | BLE_GATT_CHR_F_INDICATE) ? 3 : 2));
+            if (chr->val_handle != nullptr)
+            {
+                *chr->val_handle = valHandle;
+            }
+            sChrs[sChrCount++] = { chr, valHandle };
+        }
+    }
+    taskEXIT_CRITICAL();
+    return rc;
+}
+
+int ble_gattc_indicate_custom(uint16_t conn_handle, uint16_t chr_val_handle, struct os_mbuf * txom)
+{
+    NimBLEFake::Indication indication;
+    int rc = 0;
+
+    taskENTER_CRITICAL();
+    bool connected = FindConnection(conn_handle) != nullptr;
+    taskEXIT_CRITICAL();
+
+    // Like NimBLE, the mbuf is consumed whatever the outcome.
+    if (!connected)
+    {
+        rc = BLE_HS_ENOTCONN;
+    }
+    else
+    {
+        indication.ConnHandle = conn_handle;
+        indication.AttrHandle = chr_val_handle;
+        ble_hs_mbuf_to_flat(txom, indication.Data, sizeof(indication.Data), &indication.Length);
+        if (xQueueSendToBack(sIndicationQueue, &indication, 0) != pdTRUE)
+        {
+            rc = BLE_HS_ENOMEM;
+        }
+    }
+    os_mbuf_free_chain(txom);
+    return rc;
+}
+
+uint16_t ble_att_mtu(uint16_t conn_handle)
+{
+    taskENTER_CRITICAL();
+    Connection * con = FindConnection(conn_handle);
+    uint16_t mtu     = (con != nullptr) ? con->Mtu : 0;
+    taskEXIT_CRITICAL();
+    return mtu;
+}
+
+// ===== Host services, identity and store
+
+void ble_svc_gap_init(void) {}
+
+void ble_svc_gatt_init(void) {}
+
+int ble_svc_gap_device_name_set(const char * name)
+{
+    return (strlen(name) <= MYNEWT_VAL(BLE_SVC_GAP_DEVICE_NAME_MAX_LENGTH)) ? 0 : BLE_HS_EINVAL;
+}
+
+int ble_hs_id_gen_rnd(int nrpa, ble_addr_t * out_addr)
+{
+    out_addr->type = BLE_ADDR_RANDOM;
+    for (uint8_t & b : out_addr->val)
+    {
+        b = static_cast<uint8_t>(rand());
+    }
+    // Static random addresses have the two most significant bits set, NRPAs cleared.
+    out_addr->val[5] = static_cast<uint8_t>(nrpa ? (out_addr->val[5] & 0x3F) : (out_addr->val[5] | 0xC0));
+    return 0;
+}
+
+int ble_hs_id_set_rnd(const uint8_t * rnd_addr)
+{
+    memcpy(sRandomAddr, rnd_addr, sizeof(sRandomAddr));
+    return 0;
+}
+
+int ble_hs_util_ensure_addr(int prefer_random)
+{
+    return 0;
+}
+
+int ble_store_util_status_rr(struct ble_store_status_event * event, void * arg)
+{
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Scriptable replacement of the NimBLE host (ble_gap_*, ble_gatts_*,
+ *          ble_gattc_indicate_custom, ble_hs_mbuf_*, nimble_port_*) for the host
+ *          build of the ATBM BLE manager.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include "host/ble_hs.h"
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+/**
+ * Stands in for the NimBLE host and controller on the host, playing the central.
+ *
+ * The fake keeps the threading of the real stack: nimble_port_run() reports host/controller
+ * sync and then delivers GAP events and GATT accesses on the NimBLE host task, in the order
+ * the central actions were requested. Characteristics registered with ble_gatts_add_svcs()
+ * get consecutive attribute handles. Indications sent by the peripheral are queued for the
+ * harness, which confirms them explicitly so that flow control can be exercised.
+ */
+class NimBLEFake
+{
+public:
+    static constexpr uint16_t kMaxAttrLen = 512;
+
+    struct Indication
+    {
+        uint16_t ConnHandle;
+        uint16_t AttrHandle;
+        uint16_t Length;
+        uint8_t Data[kMaxAttrLen];
+    };
+
+    static NimBLEFake & Instance() { return sInstance; }
+
+    /** True while legacy advertising or any extended advertising set is enabled. */
+    bool IsAdvertising() const;
+    /** Bit per enabled extended advertising instance. */
+    uint8_t GetExtAdvertisingSets() const;
+    uint32_t GetAdvertisingStartCount() const;
+
+    /** Value handle of a registered characteristic, or 0. */
+    uint16_t FindCharacteristic(const ble_uuid_t * uuid) const;
+
+    /** Central actions; delivered on the NimBLE host task. */
+    CHIP_ERROR Connect(uint16_t connHandle, uint16_t mtu);
+    CHIP_ERROR Subscribe(uint16_t connHandle, uint16_t attrHandle, bool indicate);
+    CHIP_ERROR Write(uint16_t connHandle, uint16_t attrHandle, const uint8_t * data, uint16_t len);
+    CHIP_ERROR ConfirmIndication(uint16_t connHandle, uint16_t attrHandle);
+    CHIP_ERROR Disconnect(uint16_t connHandle, uint8_t hciReason);
+
+    /** Waits for the next indication sent with ble_gattc_indicate_custom(). */
+    bool WaitIndication(Indication & indication, uint32_t timeoutMs);
+
+private:
+    static NimBLEFake sInstance;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,82 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          atbm-p256-bench: P-256 operations per second on the host, with the mbedTLS
+ *          configuration of the ATBM build.
+ *
+ *              atbm-p256-bench [iterations]
+ */
+
+#include <platform/atbm/P256Benchmark.h>
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/support/CHIPMem.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "atbm_general.h"
+
+using namespace chip;
+using chip::DeviceLayer::Internal::P256Benchmark;
+
+namespace {
+
+constexpr uint32_t kDefaultIterations = 50;
+
+// Same entropy source as PlatformManagerImpl, served by the HAL fake.
+int HostEntropySource(void * data, unsigned char * output, size_t len, size_t * olen)
+{
+    random_get_bytes(output, len);
+    *olen = len;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : kDefaultIterations;
+    P256Benchmark::Result results[P256Benchmark::kOp_Max];
+
+    if (Platform::MemoryInit() != CHIP_NO_ERROR || Crypto::add_entropy_source(HostEntropySource, nullptr, 16) != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "initialization failed\n");
+        return 1;
+    }
+
+    CHIP_ERROR err = P256Benchmark::Run(iterations, results);
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "benchmark failed: %" CHIP_ERROR_FORMAT "\n", err.Format());
+        return 1;
+    }
+
+    printf("%s\n", P256Benchmark::GetBackendDescription());
+    printf("%-8s %10s %10s %10s\n", "op", "count", "avg us", "ops/s");
+    for (uint8_t op = 0; op < P256Benchmark::kOp_Max; op++)
+    {
+        const P256Benchmark::Result & result = results[op];
+        uint64_t avgUs                       = result.TotalUs / result.Iterations;
+        printf("%-8s %10" PRIu32 " %10" PRIu64 " %10.1f\n", P256Benchmark::GetOpName(static_cast<P256Benchmark::Op>(op)),
+               result.Iterations, avgUs, (result.TotalUs > 0) ? 1e6 * result.Iterations / result.TotalUs : 0.0);
+    }
+    return 0;
+}
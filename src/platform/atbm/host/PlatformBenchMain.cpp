@@ -0,0 +1,387 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          atbm-platform-bench: event loop, KVS and network path latency of the ATBM
+ *          platform layer running on the host against the HAL fake.
+ *
+ *              atbm-platform-bench [iterations] [kvs_write_us]
+ *
+ *          kvs_write_us adds a per-write delay to the fake EasyFlash, to model flash
+ *          timing. Exits non-zero if any operation fails or times out.
+ */
+
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/KeyValueStoreManager.h>
+#include <platform/atbm/NetworkCommissioningDriver.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ATBMHalFake.h"
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#include <lwip/ip_addr.h>
+#include <lwip/tcpip.h>
+#include <lwip/udp.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer;
+using chip::DeviceLayer::Internal::ATBMHalFake;
+using chip::DeviceLayer::NetworkCommissioning::ATBMWiFiDriver;
+
+namespace {
+
+constexpr uint32_t kDefaultIterations = 200;
+constexpr uint32_t kTimerDelayMs      = 5;
+constexpr uint32_t kWaitTimeoutMs     = 5000;
+constexpr uint8_t kKvsKeyCount        = 8;
+constexpr size_t kKvsValueSize        = 64;
+constexpr uint16_t kUdpPayloadSize    = 128;
+constexpr uint16_t kUdpPort           = CHIP_PORT;
+
+constexpr char kBenchSsid[]     = "atbm-bench";
+constexpr char kBenchPassword[] = "atbm-bench-pass";
+
+struct Stat
+{
+    const char * Name;
+    uint32_t Count    = 0;
+    uint32_t Failures = 0;
+    uint64_t TotalUs  = 0;
+    uint64_t MinUs    = UINT64_MAX;
+    uint64_t MaxUs    = 0;
+
+    explicit Stat(const char * name) : Name(name) {}
+
+    void Add(uint64_t us)
+    {
+        Count++;
+        TotalUs += us;
+        MinUs = (us < MinUs) ? us : MinUs;
+        MaxUs = (us > MaxUs) ? us : MaxUs;
+    }
+
+    void Print() const
+    {
+        if (Count == 0)
+        {
+            printf("%-12s %8s %10s %10s %10s %8" PRIu32 "\n", Name, "-", "-", "-", "-", Failures);
+            return;
+        }
+        printf("%-12s %8" PRIu32 " %10" PRIu64 " %10.1f %10" PRIu64 " %8" PRIu32 "\n", Name, Count, MinUs,
+               static_cast<double>(TotalUs) / Count, MaxUs, Failures);
+    }
+};
+
+uint32_t sIterations = kDefaultIterations;
+uint32_t sKvsWriteUs = 0;
+SemaphoreHandle_t sDone;
+volatile uint64_t sMarkUs;
+
+Stat sWorkStat("work");
+Stat sTimerStat("timer-late");
+Stat sKvsPutStat("kvs-put");
+Stat sKvsGetStat("kvs-get");
+Stat sConnectStat("connect");
+Stat sUdpStat("udp-send");
+
+uint64_t NowUs()
+{
+    return System::SystemClock().GetMonotonicMicroseconds64().count();
+}
+
+bool WaitDone()
+{
+    return xSemaphoreTake(sDone, pdMS_TO_TICKS(kWaitTimeoutMs)) == pdTRUE;
+}
+
+void MarkDone()
+{
+    sMarkUs = NowUs();
+    xSemaphoreGive(sDone);
+}
+
+void OnWork(intptr_t)
+{
+    MarkDone();
+}
+
+void OnTimer(System::Layer *, void *)
+{
+    MarkDone();
+}
+
+class BenchConnectCallback : public NetworkCommissioning::WiFiDriver::ConnectCallback
+{
+public:
+    void OnResult(NetworkCommissioning::Status status, CharSpan debugText, int32_t connectStatus) override
+    {
+        mStatus = status;
+        MarkDone();
+    }
+
+    NetworkCommissioning::Status mStatus = NetworkCommissioning::Status::kUnknownError;
+};
+
+BenchConnectCallback sConnectCallback;
+
+// Time from ScheduleWork() on this task to the work running on the CHIP task, and how late
+// a short System::Layer timer fires.
+void RunEventLoopBench()
+{
+    for (uint32_t i = 0; i < sIterations; i++)
+    {
+        uint64_t start = NowUs();
+        if (PlatformMgr().ScheduleWork(OnWork) != CHIP_NO_ERROR || !WaitDone())
+        {
+            sWorkStat.Failures++;
+            continue;
+        }
+        sWorkStat.Add(sMarkUs - start);
+    }
+
+    for (uint32_t i = 0; i < sIterations; i++)
+    {
+        PlatformMgr().LockChipStack();
+        uint64_t start = NowUs();
+        CHIP_ERROR err = SystemLayer().StartTimer(System::Clock::Milliseconds32(kTimerDelayMs), OnTimer, nullptr);
+        PlatformMgr().UnlockChipStack();
+        if (err != CHIP_NO_ERROR || !WaitDone())
+        {
+            sTimerStat.Failures++;
+            continue;
+        }
+        uint64_t elapsed = sMarkUs - start;
+        sTimerStat.Add((elapsed > kTimerDelayMs * 1000) ? elapsed - kTimerDelayMs * 1000 : 0);
+    }
+}
+
+// Put/Get round trips through the KVS manager and the RAM-backed EasyFlash of the fake.
+void RunKvsBench()
+{
+    uint8_t value[kKvsValueSize];
+    uint8_t readBack[kKvsValueSize];
+    char key[16];
+
+    for (uint32_t i = 0; i < sIterations; i++)
+    {
+        snprintf(key, sizeof(key), "bench/%u", static_cast<unsigned>(i % kKvsKeyCount));
+        memset(value, static_cast<int>(i), sizeof(value));
+
+        PlatformMgr().LockChipStack();
+        uint64_t start = NowUs();
+        CHIP_ERROR err = PersistedStorage::KeyValueStoreMgr().Put(key, value, sizeof(value));
+        uint64_t putUs = NowUs() - start;
+
+        size_t readLen = 0;
+        start          = NowUs();
+        if (err == CHIP_NO_ERROR)
+        {
+            err = PersistedStorage::KeyValueStoreMgr().Get(key, readBack, sizeof(readBack), &readLen);
+        }
+        uint64_t getUs = NowUs() - start;
+        PlatformMgr().UnlockChipStack();
+
+        if (err != CHIP_NO_ERROR || readLen != sizeof(value) || memcmp(value, readBack, sizeof(value)) != 0)
+        {
+            sKvsPutStat.Failures++;
+            continue;
+        }
+        sKvsPutStat.Add(putUs);
+        sKvsGetStat.Add(getUs);
+    }
+
+    PlatformMgr().LockChipStack();
+    for (uint8_t i = 0; i < kKvsKeyCount; i++)
+    {
+        snprintf(key, sizeof(key), "bench/%u", static_cast<unsigned>(i));
+        PersistedStorage::KeyValueStoreMgr().Delete(key);
+    }
+    PlatformMgr().UnlockChipStack();
+}
+
+// One commissioning-style connect through the network commissioning driver, from
+// ConnectNetwork() to the connect callback (after DHCP on the fake).
+void RunConnectBench()
+{
+    struct atbmwifi_scan_result_info ap = {};
+    memcpy(ap.ssid, kBenchSsid, strlen(kBenchSsid));
+    ap.ssidlen  = static_cast<u8>(strlen(kBenchSsid));
+    ap.channel  = 6;
+    ap.rsn      = 1;
+    ap.encrypt  = 1;
+    ap.rssi     = -40;
+    ap.bssid[0] = 0x02;
+
+    ATBMHalFake::ConnectScript script;
+    script.LatencyMs     = 1;
+    script.DhcpLatencyMs = 1;
+    ATBMHalFake::Instance().SetConnectScript(script);
+    ATBMHalFake::Instance().SetScanLatency(1);
+    ATBMHalFake::Instance().AddScanResult(ap);
+
+    ATBMWiFiDriver & driver = ATBMWiFiDriver::GetInstance();
+    ByteSpan ssid(reinterpret_cast<const uint8_t *>(kBenchSsid), strlen(kBenchSsid));
+    ByteSpan password(reinterpret_cast<const uint8_t *>(kBenchPassword), strlen(kBenchPassword));
+    char debugBuffer[32];
+    MutableCharSpan debugText(debugBuffer);
+    uint8_t networkIndex = 0;
+
+    PlatformMgr().LockChipStack();
+    bool added = driver.Init(nullptr) == CHIP_NO_ERROR &&
+        driver.AddOrUpdateNetwork(ssid, password, debugText, networkIndex) == NetworkCommissioning::Status::kSuccess;
+    uint64_t start = NowUs();
+    if (added)
+    {
+        driver.ConnectNetwork(ssid, &sConnectCallback);
+    }
+    PlatformMgr().UnlockChipStack();
+
+    if (!added || !WaitDone() || sConnectCallback.mStatus != NetworkCommissioning::Status::kSuccess)
+    {
+        sConnectStat.Failures++;
+        return;
+    }
+    sConnectStat.Add(sMarkUs - start);
+}
+
+// Cost of a UDP send from the application down to the station netif link output.
+void RunUdpBench()
+{
+    LOCK_TCPIP_CORE();
+    struct udp_pcb * pcb = udp_new();
+    if (pcb != nullptr)
+    {
+        ip_set_option(pcb, SOF_BROADCAST);
+    }
+    UNLOCK_TCPIP_CORE();
+    if (pcb == nullptr)
+    {
+        sUdpStat.Failures = sIterations;
+        return;
+    }
+
+    uint32_t outputBefore = ATBMHalFake::Instance().GetLinkOutputCount();
+    uint32_t sent         = 0;
+    for (uint32_t i = 0; i < sIterations; i++)
+    {
+        struct pbuf * p = pbuf_alloc(PBUF_TRANSPORT, kUdpPayloadSize, PBUF_RAM);
+        if (p == nullptr)
+        {
+            sUdpStat.Failures++;
+            continue;
+        }
+        memset(p->payload, static_cast<int>(i), kUdpPayloadSize);
+
+        LOCK_TCPIP_CORE();
+        uint64_t start  = NowUs();
+        err_t err       = udp_sendto(pcb, p, IP_ADDR_BROADCAST, kUdpPort);
+        uint64_t sendUs = NowUs() - start;
+        UNLOCK_TCPIP_CORE();
+        pbuf_free(p);
+
+        if (err != ERR_OK)
+        {
+            sUdpStat.Failures++;
+            continue;
+        }
+        sUdpStat.Add(sendUs);
+        sent++;
+    }
+
+    if (ATBMHalFake::Instance().GetLinkOutputCount() - outputBefore != sent)
+    {
+        fprintf(stderr, "link output saw %" PRIu32 " of %" PRIu32 " frames\n",
+                ATBMHalFake::Instance().GetLinkOutputCount() - outputBefore, sent);
+        sUdpStat.Failures++;
+    }
+
+    LOCK_TCPIP_CORE();
+    udp_remove(pcb);
+    UNLOCK_TCPIP_CORE();
+}
+
+void BenchTask(void *)
+{
+    sDone = xSemaphoreCreateBinary();
+    if (sDone == nullptr || Platform::MemoryInit() != CHIP_NO_ERROR || ATBMHalFake::Instance().Init() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "initialization failed\n");
+        exit(1);
+    }
+    ATBMHalFake::Instance().SetKvsLatency(0, sKvsWriteUs);
+
+    CHIP_ERROR err = PlatformMgr().InitChipStack();
+    if (err == CHIP_NO_ERROR)
+    {
+        err = PlatformMgr().StartEventLoopTask();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "CHIP stack start failed: %" CHIP_ERROR_FORMAT "\n", err.Format());
+        exit(1);
+    }
+
+    RunEventLoopBench();
+    RunKvsBench();
+    RunConnectBench();
+    if (sConnectStat.Count != 0)
+    {
+        RunUdpBench();
+    }
+
+    printf("%-12s %8s %10s %10s %10s %8s\n", "us", "count", "min", "avg", "max", "failed");
+    const Stat * stats[] = { &sWorkStat, &sTimerStat, &sKvsPutStat, &sKvsGetStat, &sConnectStat, &sUdpStat };
+    uint32_t failures    = 0;
+    for (const Stat * stat : stats)
+    {
+        stat->Print();
+        failures += stat->Failures;
+    }
+    if (sConnectStat.Count == 0)
+    {
+        failures++;
+    }
+    exit(failures == 0 ? 0 : 1);
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    sIterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : kDefaultIterations;
+    sKvsWriteUs = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0)) : 0;
+
+    // Below the CHIP task, so that the measured latencies include the hand-off to it.
+    if (xTaskCreate(BenchTask, "bench", 8192, nullptr, tskIDLE_PRIORITY + 1, nullptr) != pdPASS)
+    {
+        fprintf(stderr, "bench task creation failed\n");
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 1;
+}
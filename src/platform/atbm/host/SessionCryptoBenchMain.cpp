@@ -0,0 +1,130 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          atbm-crypto-bench: per-message AES-CCM and SHA-256 cost on the host.
+ *
+ *              atbm-crypto-bench [iterations] [sw|stub|stub128]
+ *
+ *          With chip_use_atbm_crypto_accel, "stub" runs through the host stand-in
+ *          accelerator and "stub128" limits it to AES-128, like the smaller engines.
+ */
+
+#include <platform/atbm/SessionCryptoBenchmark.h>
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/support/CHIPMem.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atbm_general.h"
+
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+#include "ATBMCryptoAccelStub.h"
+#include <platform/atbm/mbedtls/atbm_crypto_accel.h>
+#endif
+
+using namespace chip;
+using chip::DeviceLayer::Internal::SessionCryptoBenchmark;
+
+namespace {
+
+constexpr uint32_t kDefaultIterations = 200;
+
+SessionCryptoBenchmark::Results sResults;
+
+// Same entropy source as PlatformManagerImpl, served by the HAL fake.
+int HostEntropySource(void * data, unsigned char * output, size_t len, size_t * olen)
+{
+    random_get_bytes(output, len);
+    *olen = len;
+    return 0;
+}
+
+bool SelectBackend(const char * name)
+{
+    if (strcmp(name, "sw") == 0)
+    {
+        return true;
+    }
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+    using chip::DeviceLayer::Internal::ATBMCryptoAccelStub;
+
+    ATBMCryptoAccelStub::Config config;
+    if (strcmp(name, "stub") == 0 || strcmp(name, "stub128") == 0)
+    {
+        config.Aes128Only = (strcmp(name, "stub128") == 0);
+        ATBMCryptoAccelStub::Register(config);
+        return true;
+    }
+#endif
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : kDefaultIterations;
+
+    if (argc > 2 && !SelectBackend(argv[2]))
+    {
+        fprintf(stderr, "unknown backend: %s\n", argv[2]);
+        return 1;
+    }
+    if (Platform::MemoryInit() != CHIP_NO_ERROR || Crypto::add_entropy_source(HostEntropySource, nullptr, 16) != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "initialization failed\n");
+        return 1;
+    }
+
+    CHIP_ERROR err = SessionCryptoBenchmark::Run(iterations, sResults);
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "benchmark failed: %" CHIP_ERROR_FORMAT "\n", err.Format());
+        return 1;
+    }
+
+    printf("%-8s", "us/msg");
+    for (uint8_t size = 0; size < SessionCryptoBenchmark::kNumPayloadSizes; size++)
+    {
+        printf(" %8uB", static_cast<unsigned>(SessionCryptoBenchmark::GetPayloadSize(size)));
+    }
+    printf("\n");
+    for (uint8_t op = 0; op < SessionCryptoBenchmark::kOp_Max; op++)
+    {
+        printf("%-8s", SessionCryptoBenchmark::GetOpName(static_cast<SessionCryptoBenchmark::Op>(op)));
+        for (uint8_t size = 0; size < SessionCryptoBenchmark::kNumPayloadSizes; size++)
+        {
+            const SessionCryptoBenchmark::Result & result = sResults[op][size];
+            printf(" %9.2f", static_cast<double>(result.TotalUs) / result.Iterations);
+        }
+        printf("\n");
+    }
+
+#if CONFIG_USE_ATBM_CRYPTO_ACCEL
+    atbm_crypto_accel_stats_t stats;
+    atbm_crypto_accel_get_stats(&stats);
+    printf("AES blocks: %" PRIu32 " hw, %" PRIu32 " sw; SHA-256 blocks: %" PRIu32 " hw, %" PRIu32 " sw\n", stats.aes_blocks_hw,
+           stats.aes_blocks_sw, stats.sha256_blocks_hw, stats.sha256_blocks_sw);
+#endif
+    return 0;
+}
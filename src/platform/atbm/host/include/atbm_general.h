@@ -0,0 +1,45 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+
+/**
+ *    @file
+ *          Host build replacement for the ATBM SDK header common/atbm_general.h.
+ *
+ *          The SDK header pulls in the SDK's own lwIP port (common/arch), which
+ *          conflicts with the lwIP FreeRTOS/unix ports used on the host. Include the
+ *          host port headers first and mask the SDK ones, then reuse the SDK
+ *          declarations unchanged; they are implemented by ATBMHalFake.cpp.
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#include "lwip/arch.h"
+#include "lwip/sys.h"
+
+#ifndef CC_H_
+#define CC_H_
+#endif
+#ifndef SYS_ARCH_H_
+#define SYS_ARCH_H_
+#endif
+
+#include "../../common/atbm_general.h"
@@ -0,0 +1,118 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+
+/**
+ *    @file
+ *          lwIP options for the host build of the ATBM platform layer. Enables the
+ *          same protocol features as the ATBM SDK lwIP (IPv4/IPv6, DHCP, DNS, MLD,
+ *          mDNS responder, IPv6 route hooks, core locking) with sizes suited to a
+ *          host process.
+ */
+
+#pragma once
+
+#define NO_SYS 0
+#define SYS_LIGHTWEIGHT_PROT 1
+
+#define MEM_LIBC_MALLOC 1
+#define MEMP_MEM_MALLOC 1
+// Heap usage of lwIP for the HeapTracker report.
+#define MEM_STATS 1
+#define MEM_ALIGNMENT 8
+#define MEMP_NUM_SYS_TIMEOUT 24
+#define MEMP_NUM_NETCONN 8
+#define MEMP_NUM_UDP_PCB 8
+#define MEMP_NUM_TCP_PCB 8
+#define MEMP_NUM_TCP_PCB_LISTEN 8
+#define MEMP_NUM_RAW_PCB 4
+
+#define LWIP_IPV4 1
+#define LWIP_IPV6 1
+#define LWIP_IPV6_MLD 1
+#define LWIP_IPV6_SCOPES 0
+#define LWIP_IPV6_DUP_DETECT_ATTEMPTS 0
+#define LWIP_IPV6_FORWARD 1
+#define LWIP_IGMP 1
+#define LWIP_RAW 1
+#define LWIP_DHCP 1
+#define LWIP_DNS 1
+#define DNS_MAX_SERVERS 3
+#define LWIP_HAVE_LOOPIF 1
+#define LWIP_NETIF_HOSTNAME 1
+#define LWIP_NETIF_STATUS_CALLBACK 1
+#define LWIP_NETIF_LINK_CALLBACK 1
+
+#define LWIP_MDNS_RESPONDER 1
+#define LWIP_NUM_NETIF_CLIENT_DATA 1
+
+#define TCP_MSS 1460
+#define TCP_SND_BUF (8 * TCP_MSS)
+#define TCP_WND (8 * TCP_MSS)
+#define LWIP_TCP_KEEPALIVE 1
+
+#define LWIP_SOCKET 1
+#define LWIP_NETCONN 1
+#define LWIP_COMPAT_SOCKETS 0
+#define LWIP_POSIX_SOCKETS_IO_NAMES 0
+#define LWIP_SO_RCVTIMEO 1
+#define LWIP_SO_SNDTIMEO 1
+#define LWIP_NETBUF_RECVINFO 1
+#define SO_REUSE 1
+#define LWIP_TIMEVAL_PRIVATE 0
+
+#define TCPIP_THREAD_NAME "tcpip"
+#define TCPIP_THREAD_PRIO 5
+#define TCPIP_THREAD_STACKSIZE 4096
+#define TCPIP_MBOX_SIZE 64
+#define DEFAULT_THREAD_STACKSIZE 2048
+#define DEFAULT_RAW_RECVMBOX_SIZE 32
+#define DEFAULT_UDP_RECVMBOX_SIZE 32
+#define DEFAULT_TCP_RECVMBOX_SIZE 32
+#define DEFAULT_ACCEPTMBOX_SIZE 32
+
+/* The CHIP stack and the platform share one core lock (LwIPCoreLock.cpp). */
+#define LWIP_TCPIP_CORE_LOCKING 1
+#define LWIP_TCPIP_CORE_LOCKING_INPUT 1
+#ifdef __cplusplus
+extern "C" {
+#endif
+void lock_lwip_core(void);
+void unlock_lwip_core(void);
+#ifdef __cplusplus
+}
+#endif
+#define LOCK_TCPIP_CORE() lock_lwip_core()
+#define UNLOCK_TCPIP_CORE() unlock_lwip_core()
+
+/* IPv6 routes learnt from router advertisements (route_hook/). */
+#define LWIP_HOOK_FILENAME "route_hook/atbm_route_table.h"
+#define LWIP_HOOK_IP6_ROUTE(src, dest) lwip_hook_ip6_route(src, dest)
+#define LWIP_HOOK_ND6_GET_GW(netif, dest) lwip_hook_nd6_get_gw(netif, dest)
+
+/* mem_malloc() from fixed-size pools (pkt_pool/), as with ATBM_LWIP_MEM_POOL on the target. */
+#ifndef ATBM_LWIP_MEM_POOL
+#define ATBM_LWIP_MEM_POOL 1
+#endif
+#if ATBM_LWIP_MEM_POOL
+#include "pkt_pool/atbm_pkt_pool.h"
+#define mem_clib_malloc atbm_pkt_pool_malloc
+#define mem_clib_calloc atbm_pkt_pool_calloc
+#define mem_clib_free atbm_pkt_pool_free
+#endif
+
+#define LWIP_FREERTOS_CHECK_CORE_LOCKING 0
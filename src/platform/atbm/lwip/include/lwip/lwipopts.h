@@ -220,6 +220,21 @@
 #define TCP_SYNMAXRTX_TCPCLOSE  4//tx max retry when tx close tcp packet
 #define TCP_MAXRTO_NORMAL       1000//500S 1000*500ms
 
+/*
+ * ATBM_LWIP_MEM_POOL==1: serve mem_malloc(), and so pbufs, CHIP packet buffers and
+ * memp objects, from the fixed-size pools of pkt_pool/atbm_pkt_pool.c instead of the
+ * C library heap.  The SDK lwIP library must be rebuilt with that file, as for route_hook/.
+ */
+#ifndef ATBM_LWIP_MEM_POOL
+#define ATBM_LWIP_MEM_POOL      0
+#endif
+#if ATBM_LWIP_MEM_POOL
+#include "pkt_pool/atbm_pkt_pool.h"
+#define mem_clib_malloc         atbm_pkt_pool_malloc
+#define mem_clib_calloc         atbm_pkt_pool_calloc
+#define mem_clib_free           atbm_pkt_pool_free
+#endif
+
 
 
 #endif /* LWIPOPTS_H_ */
@@ -0,0 +1,83 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Pluggable crypto accelerator behind mbedTLS AES and SHA-256 (atbm_crypto_alt.c)
+ *          and the CHIP entropy source.
+ *
+ *          A driver fills an atbm_crypto_accel_t and registers it before the CHIP stack
+ *          starts.  This tree does not ship a driver for the device; only the host build
+ *          registers a software stand-in (host/ATBMCryptoAccelStub.cpp).  Any operation left NULL, or returning ATBM_CRYPTO_ACCEL_UNSUPPORTED
+ *          (e.g. for a key size the engine lacks), runs in the stock mbedTLS software, as
+ *          does everything while no accelerator is registered, so a partial driver is
+ *          always safe.  The operations may be called from any task concurrently and
+ *          must serialize access to the engine themselves.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ATBM_CRYPTO_ACCEL_UNSUPPORTED (-1)
+
+typedef struct atbm_crypto_accel
+{
+    const char * name;
+
+    /* Encrypts (encrypt != 0) or decrypts one 16 byte block with the raw key of keybits bits.
+     * Only called to encrypt: mbedTLS keeps decryption keys in a form the engine cannot take. */
+    int (*aes_block)(const unsigned char * key, unsigned int keybits, int encrypt, const unsigned char input[16],
+                     unsigned char output[16]);
+
+    /* Runs the SHA-256 compression function over nblocks consecutive 64 byte blocks. */
+    int (*sha256_blocks)(uint32_t state[8], const unsigned char * data, size_t nblocks);
+
+    /* Fills buf with output of the true random number generator. */
+    int (*trng)(unsigned char * buf, size_t len);
+} atbm_crypto_accel_t;
+
+typedef struct atbm_crypto_accel_stats
+{
+    uint32_t aes_blocks_hw;
+    uint32_t aes_blocks_sw;
+    uint32_t sha256_blocks_hw;
+    uint32_t sha256_blocks_sw;
+    uint32_t trng_bytes_hw;
+    uint32_t trng_bytes_sw;
+} atbm_crypto_accel_stats_t;
+
+/* Registers the accelerator; NULL returns everything to software.  Not thread safe. */
+void atbm_crypto_accel_register(const atbm_crypto_accel_t * accel);
+
+/* Returns the registered accelerator, or NULL. */
+const atbm_crypto_accel_t * atbm_crypto_accel_get(void);
+
+void atbm_crypto_accel_get_stats(atbm_crypto_accel_stats_t * stats);
+void atbm_crypto_accel_reset_stats(void);
+
+/* Random bytes from the accelerator's TRNG, or from random_get_bytes(). */
+int atbm_crypto_random(unsigned char * buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
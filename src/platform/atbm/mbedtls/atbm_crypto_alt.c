@@ -0,0 +1,284 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Routes mbedTLS AES encryption and SHA-256 through the registered crypto
+ *          accelerator (atbm_crypto_accel.h).
+ *
+ *          The stock mbedTLS entry points are wrapped at link time (-Wl,--wrap, see
+ *          atbm_crypto_accel_ldflags in atbm_mbedtls.gni), so the mbedTLS library and its
+ *          context layouts stay as they are.  On the device the flags must be added to the
+ *          SDK link of libMatter.a, from libMatter.ldflags.  Without an accelerator, and for whatever it declines,
+ *          the wrappers call the stock mbedTLS software implementation.
+ */
+
+/* The wrappers read the stock AES and SHA-256 contexts. */
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+
+#include "atbm_crypto_accel.h"
+
+#include <mbedtls/aes.h>
+#include <mbedtls/platform_util.h>
+#include <mbedtls/sha256.h>
+
+#include <string.h>
+
+#include "atbm_general.h"
+
+/* The wrappers follow the mbedTLS 3.x SHA-256 API (int returning mbedtls_sha256(), no _ret variants). */
+#if MBEDTLS_VERSION_NUMBER < 0x03000000
+#error "chip_use_atbm_crypto_accel requires mbedTLS 3.x"
+#endif
+
+int __real_mbedtls_aes_crypt_ecb(mbedtls_aes_context * ctx, int mode, const unsigned char input[16], unsigned char output[16]);
+int __real_mbedtls_sha256_update(mbedtls_sha256_context * ctx, const unsigned char * input, size_t ilen);
+int __real_mbedtls_sha256(const unsigned char * input, size_t ilen, unsigned char * output, int is224);
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+int __real_mbedtls_aes_crypt_ctr(mbedtls_aes_context * ctx, size_t length, size_t * nc_off, unsigned char nonce_counter[16],
+                                 unsigned char stream_block[16], const unsigned char * input, unsigned char * output);
+#endif
+
+static const atbm_crypto_accel_t * s_accel;
+static atbm_crypto_accel_stats_t s_stats;
+
+/* ========== Registry ========== */
+
+void atbm_crypto_accel_register(const atbm_crypto_accel_t * accel)
+{
+    s_accel = accel;
+}
+
+const atbm_crypto_accel_t * atbm_crypto_accel_get(void)
+{
+    return s_accel;
+}
+
+void atbm_crypto_accel_get_stats(atbm_crypto_accel_stats_t * stats)
+{
+    *stats = s_stats;
+}
+
+void atbm_crypto_accel_reset_stats(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+int atbm_crypto_random(unsigned char * buf, size_t len)
+{
+    const atbm_crypto_accel_t * accel = s_accel;
+
+    if (accel != NULL && accel->trng != NULL && accel->trng(buf, len) == 0)
+    {
+        s_stats.trng_bytes_hw += (uint32_t) len;
+        return 0;
+    }
+    s_stats.trng_bytes_sw += (uint32_t) len;
+    return random_get_bytes(buf, len);
+}
+
+/* ========== AES ========== */
+
+/*
+ * The stock encryption key schedule starts with the raw key (FIPS 197 key expansion),
+ * stored as little-endian words, which is what the accelerator takes.  A decryption
+ * schedule does not, so decryption always runs in software; Matter only encrypts (CCM and
+ * CTR are built on the forward cipher).
+ */
+static int aes_encrypt_accel(const atbm_crypto_accel_t * accel, const mbedtls_aes_context * ctx, const unsigned char input[16],
+                             unsigned char output[16])
+{
+#if MBEDTLS_VERSION_NUMBER >= 0x03040000
+    /* mbedTLS 3.4 replaced the round key pointer with an offset into buf. */
+    const uint32_t * rk = ctx->buf + ctx->rk_offset;
+#else
+    const uint32_t * rk = ctx->rk;
+#endif
+    unsigned char key[32];
+    unsigned int words;
+    int ret;
+
+    switch (ctx->nr)
+    {
+    case 10:
+        words = 4;
+        break;
+    case 12:
+        words = 6;
+        break;
+    case 14:
+        words = 8;
+        break;
+    default:
+        return ATBM_CRYPTO_ACCEL_UNSUPPORTED;
+    }
+    for (unsigned int i = 0; i < words; i++)
+    {
+        key[4 * i]     = (unsigned char) (rk[i]);
+        key[4 * i + 1] = (unsigned char) (rk[i] >> 8);
+        key[4 * i + 2] = (unsigned char) (rk[i] >> 16);
+        key[4 * i + 3] = (unsigned char) (rk[i] >> 24);
+    }
+    ret = accel->aes_block(key, words * 32, 1, input, output);
+    mbedtls_platform_zeroize(key, sizeof(key));
+    return ret;
+}
+
+int __wrap_mbedtls_aes_crypt_ecb(mbedtls_aes_context * ctx, int mode, const unsigned char input[16], unsigned char output[16])
+{
+    const atbm_crypto_accel_t * accel = s_accel;
+
+    if (mode == MBEDTLS_AES_ENCRYPT && accel != NULL && accel->aes_block != NULL &&
+        aes_encrypt_accel(accel, ctx, input, output) == 0)
+    {
+        s_stats.aes_blocks_hw++;
+        return 0;
+    }
+    s_stats.aes_blocks_sw++;
+    return __real_mbedtls_aes_crypt_ecb(ctx, mode, input, output);
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+int __wrap_mbedtls_aes_crypt_ctr(mbedtls_aes_context * ctx, size_t length, size_t * nc_off, unsigned char nonce_counter[16],
+                                 unsigned char stream_block[16], const unsigned char * input, unsigned char * output)
+{
+    const atbm_crypto_accel_t * accel = s_accel;
+    size_t n                          = *nc_off;
+    int ret;
+
+    if (accel == NULL || accel->aes_block == NULL || n > 0x0F)
+    {
+        /* Keystream blocks the stock implementation is about to compute. */
+        if (length > 0 && n <= 0x0F)
+        {
+            s_stats.aes_blocks_sw += (uint32_t) ((n + length + 15) / 16 - (n != 0));
+        }
+        return __real_mbedtls_aes_crypt_ctr(ctx, length, nc_off, nonce_counter, stream_block, input, output);
+    }
+
+    /* Same keystream handling as the stock mbedtls_aes_crypt_ctr(). */
+    while (length--)
+    {
+        if (n == 0)
+        {
+            if ((ret = __wrap_mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream_block)) != 0)
+            {
+                return ret;
+            }
+            for (int i = 16; i > 0; i--)
+            {
+                if (++nonce_counter[i - 1] != 0)
+                {
+                    break;
+                }
+            }
+        }
+        *output++ = (unsigned char) (*input++ ^ stream_block[n]);
+        n         = (n + 1) & 0x0F;
+    }
+    *nc_off = n;
+    return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CTR */
+
+/* ========== SHA-256 ========== */
+
+static void sha256_blocks(const atbm_crypto_accel_t * accel, mbedtls_sha256_context * ctx, const unsigned char * data,
+                          size_t nblocks)
+{
+    if (accel->sha256_blocks(ctx->state, data, nblocks) == 0)
+    {
+        s_stats.sha256_blocks_hw += (uint32_t) nblocks;
+        return;
+    }
+    s_stats.sha256_blocks_sw += (uint32_t) nblocks;
+    for (; nblocks > 0; nblocks--, data += 64)
+    {
+        mbedtls_internal_sha256_process(ctx, data);
+    }
+}
+
+/*
+ * Same buffering as the stock mbedtls_sha256_update(), with whole blocks handed to the
+ * accelerator in one call.  The padding blocks of mbedtls_sha256_finish() stay in software.
+ */
+int __wrap_mbedtls_sha256_update(mbedtls_sha256_context * ctx, const unsigned char * input, size_t ilen)
+{
+    const atbm_crypto_accel_t * accel = s_accel;
+    uint32_t left                     = ctx->total[0] & 0x3F;
+    size_t fill                       = 64 - left;
+
+    if (accel == NULL || accel->sha256_blocks == NULL)
+    {
+        s_stats.sha256_blocks_sw += (uint32_t) ((left + ilen) / 64);
+        return __real_mbedtls_sha256_update(ctx, input, ilen);
+    }
+    if (ilen == 0)
+    {
+        return 0;
+    }
+
+    ctx->total[0] += (uint32_t) ilen;
+    if (ctx->total[0] < (uint32_t) ilen)
+    {
+        ctx->total[1]++;
+    }
+
+    if (left && ilen >= fill)
+    {
+        memcpy(ctx->buffer + left, input, fill);
+        sha256_blocks(accel, ctx, ctx->buffer, 1);
+        input += fill;
+        ilen -= fill;
+        left = 0;
+    }
+
+    if (ilen >= 64)
+    {
+        size_t nblocks = ilen / 64;
+        sha256_blocks(accel, ctx, input, nblocks);
+        input += nblocks * 64;
+        ilen -= nblocks * 64;
+    }
+
+    if (ilen > 0)
+    {
+        memcpy(ctx->buffer + left, input, ilen);
+    }
+    return 0;
+}
+
+/* The one-shot hash calls the stock update internally, where the wrapper does not apply. */
+int __wrap_mbedtls_sha256(const unsigned char * input, size_t ilen, unsigned char * output, int is224)
+{
+    mbedtls_sha256_context ctx;
+    int ret;
+
+    if (s_accel == NULL || s_accel->sha256_blocks == NULL)
+    {
+        s_stats.sha256_blocks_sw += (uint32_t) (ilen / 64);
+        return __real_mbedtls_sha256(input, ilen, output, is224);
+    }
+
+    mbedtls_sha256_init(&ctx);
+    if ((ret = mbedtls_sha256_starts(&ctx, is224)) == 0 && (ret = __wrap_mbedtls_sha256_update(&ctx, input, ilen)) == 0)
+    {
+        ret = mbedtls_sha256_finish(&ctx, output);
+    }
+    mbedtls_sha256_free(&ctx);
+    return ret;
+}
@@ -0,0 +1,51 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          mbedTLS user configuration for Matter on ATBM platforms: curve pruning.
+ *
+ *          Matter only uses secp256r1, so every other curve is disabled.  This drops their
+ *          parameters and reduction code from the image and shrinks MBEDTLS_ECP_MAX_BITS,
+ *          and with it the ECP buffers sized from it.  The remaining P-256 options (fixed
+ *          point comb, window size, NIST reduction) are left at the mbedTLS defaults.
+ *
+ *          Everything that includes mbedTLS headers must be built with the same file, or the
+ *          callers and the library disagree on those sizes:
+ *
+ *          - The atbm_mbedtls_config config in BUILD.gn applies it to the CHIP tree when
+ *            atbm_mbedtls_user_config is set; the host build also compiles mbedTLS with it.
+ *          - On the device, mbedTLS is prebuilt in the SDK.  Rebuild that library with
+ *            -DMBEDTLS_USER_CONFIG_FILE=\"atbm_mbedtls_config.h\" and this directory on
+ *            its include path before linking an image built with atbm_mbedtls_user_config.
+ */
+
+#pragma once
+
+#undef MBEDTLS_ECP_DP_SECP192R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP224R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP384R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP521R1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP192K1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP224K1_ENABLED
+#undef MBEDTLS_ECP_DP_SECP256K1_ENABLED
+#undef MBEDTLS_ECP_DP_BP256R1_ENABLED
+#undef MBEDTLS_ECP_DP_BP384R1_ENABLED
+#undef MBEDTLS_ECP_DP_BP512R1_ENABLED
+#undef MBEDTLS_ECP_DP_CURVE25519_ENABLED
+#undef MBEDTLS_ECP_DP_CURVE448_ENABLED
+#define MBEDTLS_ECP_DP_SECP256R1_ENABLED
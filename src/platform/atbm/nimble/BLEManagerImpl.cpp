@@ -27,6 +27,7 @@
 #include <platform/DeviceInstanceInfoProvider.h>
 #include <platform/internal/CHIPDeviceLayerInternal.h>
 #include <setup_payload/AdditionalDataPayloadGenerator.h>
+#include <lib/support/TypeTraits.h>
 #include <lib/support/logging/CHIPLogging.h>
 
 #if CHIP_DEVICE_CONFIG_ENABLE_CHIPOBLE
@@ -36,6 +37,7 @@
 #endif
 
 #include <platform/atbm/BLEManagerImpl.h>
+#include <platform/atbm/FlashTrace.h>
 
 #include "nimble/ble.h"
 #include "nimble/nimble_port.h"
@@ -44,8 +46,10 @@
 #include "gap/ble_svc_gap.h"
 #include "util/util.h"
 
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING && !MYNEWT_VAL(BLE_EXT_ADV)
+#error "CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING requires NimBLE built with BLE_EXT_ADV"
+#endif
 
-#define MAX_ADV_DATA_LEN 31
 #define CHIP_ADV_DATA_TYPE_FLAGS 0x01
 #define CHIP_ADV_DATA_FLAGS 0x06
 #define CHIP_ADV_DATA_TYPE_SERVICE_DATA 0x16
@@ -95,6 +99,8 @@ uint8_t own_addr_type = BLE_OWN_ADDR_RANDOM;
 
 BLEManagerImpl BLEManagerImpl::sInstance;
 constexpr System::Clock::Timeout BLEManagerImpl::kFastAdvertiseTimeout;
+constexpr System::Clock::Timeout BLEManagerImpl::kMediumAdvertiseTimeout;
+constexpr System::Clock::Timeout BLEManagerImpl::kBurstAdvertiseTimeout;
 
 const struct ble_gatt_svc_def BLEManagerImpl::CHIPoBLEGATTAttrs[] = {
     { .type = BLE_GATT_SVC_TYPE_PRIMARY,
@@ -147,10 +153,21 @@ CHIP_ERROR BLEManagerImpl::_Init()
     mTXCharCCCDAttrHandle = 0;
 
     mFlags.ClearAll().Set(Flags::kAdvertisingEnabled, CHIP_DEVICE_CONFIG_CHIPOBLE_ENABLE_ADVERTISING_AUTOSTART);
-    mFlags.Set(Flags::kFastAdvertisingEnabled, true);
+    mAdvPhase          = AdvertisingPhase::kFast;
+    mActiveAdvItvlMin  = 0;
+    mActiveAdvItvlMax  = 0;
+    mActiveAdvConnMode = BLE_GAP_CONN_MODE_NON;
+    mWiFiCoexMask      = 0;
+    mDiscoveryPending  = false;
+    mExtAdvSets        = 0;
+    memset(&mAdvMetrics, 0, sizeof(mAdvMetrics));
+    memset(&mPathStats, 0, sizeof(mPathStats));
 
     mNumGAPCons = 0;
-    memset(reinterpret_cast<void *>(mCons), 0, sizeof(mCons));
+    for (uint16_t i = 0; i < kMaxConnections; i++)
+    {
+        mCons[i].Reset();
+    }
     mServiceMode = ConnectivityManager::kCHIPoBLEServiceMode_Enabled;
     memset(mDeviceName, 0, sizeof(mDeviceName));
 
@@ -166,54 +183,193 @@ CHIP_ERROR BLEManagerImpl::_SetAdvertisingEnabled(bool val)
 	
     VerifyOrExit(mServiceMode != ConnectivityManager::kCHIPoBLEServiceMode_NotSupported, err = CHIP_ERROR_UNSUPPORTED_CHIP_FEATURE);
 
+    mFlags.Set(Flags::kAdvertisingEnabled, val);
     if (val)
     {
-        mAdvertiseStartTime = System::SystemClock().GetMonotonicTimestamp();
-        ReturnErrorOnFailure(DeviceLayer::SystemLayer().StartTimer(kFastAdvertiseTimeout, HandleFastAdvertisementTimer, this));
+        EnterAdvertisingPhase(AdvertisingPhase::kFast);
+    }
+    else
+    {
+        DeviceLayer::SystemLayer().CancelTimer(HandleAdvertisingPhaseTimer, this);
+        mFlags.Set(Flags::kAdvertisingRefreshNeeded, 1);
+        PlatformMgr().ScheduleWork(DriveBLEState, 0);
     }
-
-    mFlags.Set(Flags::kFastAdvertisingEnabled, val);
-    mFlags.Set(Flags::kAdvertisingRefreshNeeded, 1);
-    mFlags.Set(Flags::kAdvertisingEnabled, val);
-    PlatformMgr().ScheduleWork(DriveBLEState, 0);
 
 exit:
     return err;
 }
 
-void BLEManagerImpl::HandleFastAdvertisementTimer(System::Layer * systemLayer, void * context)
+CHIP_ERROR BLEManagerImpl::_SetAdvertisingMode(BLEAdvertisingMode mode)
+{
+    switch (mode)
+    {
+    case BLEAdvertisingMode::kFastAdvertising:
+        EnterAdvertisingPhase(AdvertisingPhase::kFast);
+        break;
+    case BLEAdvertisingMode::kSlowAdvertising:
+        EnterAdvertisingPhase(AdvertisingPhase::kSlow);
+        break;
+    default:
+        return CHIP_ERROR_INVALID_ARGUMENT;
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BLEManagerImpl::TriggerAdvertisingBurst(void)
+{
+    VerifyOrReturnError(mServiceMode == ConnectivityManager::kCHIPoBLEServiceMode_Enabled, CHIP_ERROR_INCORRECT_STATE);
+
+    // May be called from the application task (e.g. a button handler), so hop onto the CHIP task.
+    return PlatformMgr().ScheduleWork(HandleAdvertisingBurst, 0);
+}
+
+void BLEManagerImpl::HandleAdvertisingBurst(intptr_t arg)
 {
-    static_cast<BLEManagerImpl *>(context)->HandleFastAdvertisementTimer();
+    if (sInstance.mFlags.Has(Flags::kAdvertisingEnabled))
+    {
+        ChipLogProgress(DeviceLayer, "CHIPoBLE advertising burst requested");
+        sInstance.EnterAdvertisingPhase(AdvertisingPhase::kBurst);
+    }
 }
 
-void BLEManagerImpl::HandleFastAdvertisementTimer()
+void BLEManagerImpl::SetWiFiCoexActive(WiFiCoexReason reason, bool active)
 {
-    System::Clock::Timestamp currentTimestamp = System::SystemClock().GetMonotonicTimestamp();
+    uint8_t mask = static_cast<uint8_t>(active ? (mWiFiCoexMask | to_underlying(reason)) : (mWiFiCoexMask & ~to_underlying(reason)));
+
+    VerifyOrReturn((mask != 0) != (mWiFiCoexMask != 0), mWiFiCoexMask = mask);
+
+    ChipLogProgress(DeviceLayer, "CHIPoBLE WiFi coexistence window %s", (mask != 0) ? "opened" : "closed");
+    AccountAdvertisingTime();
+    mWiFiCoexMask = mask;
 
-    if (currentTimestamp - mAdvertiseStartTime >= kFastAdvertiseTimeout)
+    // The interval only changes if the current phase is faster than the coexistence cap.
+    if (mAdvPhase == AdvertisingPhase::kFast || mAdvPhase == AdvertisingPhase::kBurst)
     {
-        mFlags.Set(Flags::kFastAdvertisingEnabled, 0);
-        mFlags.Set(Flags::kAdvertisingRefreshNeeded, 1);
+        mFlags.Set(Flags::kAdvertisingRefreshNeeded);
         PlatformMgr().ScheduleWork(DriveBLEState, 0);
     }
 }
 
-CHIP_ERROR BLEManagerImpl::_SetAdvertisingMode(BLEAdvertisingMode mode)
+void BLEManagerImpl::GetAdvertisingMetrics(AdvertisingMetrics & metrics)
 {
-    switch (mode)
+    AccountAdvertisingTime();
+    metrics = mAdvMetrics;
+}
+
+void BLEManagerImpl::EnterAdvertisingPhase(AdvertisingPhase phase)
+{
+    AccountAdvertisingTime();
+    mAdvPhase = phase;
+    ArmAdvertisingPhaseTimer();
+
+    mFlags.Set(Flags::kAdvertisingRefreshNeeded);
+    PlatformMgr().ScheduleWork(DriveBLEState, 0);
+}
+
+void BLEManagerImpl::ArmAdvertisingPhaseTimer(void)
+{
+    System::Clock::Timeout timeout = System::Clock::kZero;
+
+    DeviceLayer::SystemLayer().CancelTimer(HandleAdvertisingPhaseTimer, this);
+
+    switch (mAdvPhase)
     {
-    case BLEAdvertisingMode::kFastAdvertising:
-        mFlags.Set(Flags::kFastAdvertisingEnabled, true);
+    case AdvertisingPhase::kFast:
+        timeout = kFastAdvertiseTimeout;
         break;
-    case BLEAdvertisingMode::kSlowAdvertising:
-        mFlags.Set(Flags::kFastAdvertisingEnabled, false);
+    case AdvertisingPhase::kMedium:
+        timeout = kMediumAdvertiseTimeout;
+        break;
+    case AdvertisingPhase::kBurst:
+        timeout = kBurstAdvertiseTimeout;
         break;
     default:
-        return CHIP_ERROR_INVALID_ARGUMENT;
+        break;
+    }
+
+    if (timeout != System::Clock::kZero)
+    {
+        DeviceLayer::SystemLayer().StartTimer(timeout, HandleAdvertisingPhaseTimer, this);
+    }
+}
+
+void BLEManagerImpl::HandleAdvertisingPhaseTimer(System::Layer * systemLayer, void * context)
+{
+    static_cast<BLEManagerImpl *>(context)->HandleAdvertisingPhaseTimer();
+}
+
+void BLEManagerImpl::HandleAdvertisingPhaseTimer()
+{
+    VerifyOrReturn(mFlags.Has(Flags::kAdvertisingEnabled));
+
+    // Ramp down one step.  A burst falls back to the medium phase rather than restarting the
+    // whole ramp, so a button press does not extend the high duty cycle window.
+    switch (mAdvPhase)
+    {
+    case AdvertisingPhase::kFast:
+    case AdvertisingPhase::kBurst:
+        EnterAdvertisingPhase(AdvertisingPhase::kMedium);
+        break;
+    case AdvertisingPhase::kMedium:
+        EnterAdvertisingPhase(AdvertisingPhase::kSlow);
+        break;
+    default:
+        break;
+    }
+}
+
+void BLEManagerImpl::AccountAdvertisingTime(void)
+{
+    System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+
+    if (mFlags.Has(Flags::kAdvertising) && mActiveAdvItvlMax != 0)
+    {
+        uint32_t elapsedMs = System::Clock::Milliseconds32(now - mAdvPhaseStartTime).count();
+        // The controller picks an interval in [min, max] and adds a 0-10ms random advDelay.
+        uint64_t eventPeriodUs = ((uint64_t) (mActiveAdvItvlMin + mActiveAdvItvlMax) * 625) / 2 + 5000;
+
+        mAdvMetrics.PhaseTimeMs[static_cast<uint8_t>(mAdvPhase)] += elapsedMs;
+        mAdvMetrics.RadioOnTimeUs += ((uint64_t) elapsedMs * 1000 / eventPeriodUs) * CHIP_DEVICE_CONFIG_BLE_ADV_EVENT_AIRTIME_US;
+    }
+
+    mAdvPhaseStartTime = now;
+}
+
+void BLEManagerImpl::GetAdvertisingIntervals(bool connectable, uint16_t & itvlMin, uint16_t & itvlMax)
+{
+    AdvertisingPhase phase = mAdvPhase;
+
+    // Only connectable advertising is worth a high duty cycle.
+    if (!connectable)
+    {
+        phase = AdvertisingPhase::kSlow;
+    }
+    // While the WiFi station is scanning or associating, cap the duty cycle so BLE does not
+    // starve the shared 2.4GHz radio.
+    else if (mWiFiCoexMask != 0 && (phase == AdvertisingPhase::kFast || phase == AdvertisingPhase::kBurst))
+    {
+        phase = AdvertisingPhase::kMedium;
+    }
+
+    switch (phase)
+    {
+    case AdvertisingPhase::kFast:
+        itvlMin = CHIP_DEVICE_CONFIG_BLE_FAST_ADVERTISING_INTERVAL_MIN;
+        itvlMax = CHIP_DEVICE_CONFIG_BLE_FAST_ADVERTISING_INTERVAL_MAX;
+        break;
+    case AdvertisingPhase::kMedium:
+        itvlMin = CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MIN;
+        itvlMax = CHIP_DEVICE_CONFIG_BLE_MEDIUM_ADVERTISING_INTERVAL_MAX;
+        break;
+    case AdvertisingPhase::kBurst:
+        itvlMin = CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MIN;
+        itvlMax = CHIP_DEVICE_CONFIG_BLE_BURST_ADVERTISING_INTERVAL_MAX;
+        break;
+    default:
+        itvlMin = CHIP_DEVICE_CONFIG_BLE_SLOW_ADVERTISING_INTERVAL_MIN;
+        itvlMax = CHIP_DEVICE_CONFIG_BLE_SLOW_ADVERTISING_INTERVAL_MAX;
+        break;
     }
-    mFlags.Set(Flags::kAdvertisingRefreshNeeded);
-    PlatformMgr().ScheduleWork(DriveBLEState, 0);
-    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR BLEManagerImpl::_GetDeviceName(char * buf, size_t bufSize)
@@ -252,9 +408,18 @@ exit:
 
 void BLEManagerImpl::_OnPlatformEvent(const ChipDeviceEvent * event)
 {
+    uint64_t startUs = System::SystemClock().GetMonotonicMicroseconds64().count();
+
     switch (event->Type)
     {
     case DeviceEventType::kCHIPoBLESubscribe:
+        {
+            CHIPoBLEConState * conState = GetConnectionState(event->CHIPoBLESubscribe.ConId);
+            if (conState != nullptr)
+            {
+                conState->Subscribed = 1;
+            }
+        }
         HandleSubscribeReceived(event->CHIPoBLESubscribe.ConId, &CHIP_BLE_SVC_ID, &chipUUID_CHIPoBLEChar_TX);
         {
             ChipDeviceEvent connectionEvent;
@@ -264,15 +429,33 @@ void BLEManagerImpl::_OnPlatformEvent(const ChipDeviceEvent * event)
         break;
 
     case DeviceEventType::kCHIPoBLEUnsubscribe:
+        {
+            CHIPoBLEConState * conState = GetConnectionState(event->CHIPoBLEUnsubscribe.ConId);
+            if (conState != nullptr)
+            {
+                conState->Subscribed = 0;
+                conState->TxCredits  = kIndicationCredits;
+            }
+        }
         HandleUnsubscribeReceived(event->CHIPoBLEUnsubscribe.ConId, &CHIP_BLE_SVC_ID, &chipUUID_CHIPoBLEChar_TX);
         break;
 
     case DeviceEventType::kCHIPoBLEWriteReceived:
-        HandleWriteReceived(event->CHIPoBLEWriteReceived.ConId, &CHIP_BLE_SVC_ID, &chipUUID_CHIPoBLEChar_RX,
-                            PacketBufferHandle::Adopt(event->CHIPoBLEWriteReceived.Data));
+        {
+            PacketBufferHandle data = PacketBufferHandle::Adopt(event->CHIPoBLEWriteReceived.Data);
+
+            // Counted here rather than in HandleRXCharWrite() so that the path stats are only
+            // touched by the CHIP task.
+            mPathStats.RxAllocs++;
+            mPathStats.RxFragments++;
+            mPathStats.RxBytes += data->DataLength();
+            HandleWriteReceived(event->CHIPoBLEWriteReceived.ConId, &CHIP_BLE_SVC_ID, &chipUUID_CHIPoBLEChar_RX,
+                                std::move(data));
+        }
         break;
 
     case DeviceEventType::kCHIPoBLEIndicateConfirm:
+        OnIndicationConfirmed(event->CHIPoBLEIndicateConfirm.ConId);
         HandleIndicationConfirmation(event->CHIPoBLEIndicateConfirm.ConId, &CHIP_BLE_SVC_ID, &chipUUID_CHIPoBLEChar_TX);
         break;
 
@@ -288,10 +471,22 @@ void BLEManagerImpl::_OnPlatformEvent(const ChipDeviceEvent * event)
         mFlags.Set(Flags::kAdvertisingRefreshNeeded);
 
         DriveBLEState();
-        break;
+        return;
 
     default:
-        break;
+        return;
+    }
+
+    // Only the CHIPoBLE data path events get here.
+    {
+        uint32_t elapsedUs = static_cast<uint32_t>(System::SystemClock().GetMonotonicMicroseconds64().count() - startUs);
+
+        mPathStats.ChipEvents++;
+        mPathStats.ChipEventTimeTotalUs += elapsedUs;
+        if (elapsedUs > mPathStats.ChipEventTimeMaxUs)
+        {
+            mPathStats.ChipEventTimeMaxUs = elapsedUs;
+        }
     }
 }
 
@@ -337,36 +532,81 @@ uint16_t BLEManagerImpl::GetMTU(BLE_CONNECTION_OBJECT conId) const
 CHIP_ERROR BLEManagerImpl::SendIndication(BLE_CONNECTION_OBJECT conId, const ChipBleUUID * svcId, const ChipBleUUID * charId,
                                     chip::System::PacketBufferHandle data)
 {
-    CHIP_ERROR err = CHIP_NO_ERROR;
-    struct os_mbuf * om;
+    CHIP_ERROR err              = CHIP_NO_ERROR;
+    CHIPoBLEConState * conState = GetConnectionState(conId);
 
-    VerifyOrExit(IsSubscribed(conId), err = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(conState != nullptr && conState->Subscribed, err = CHIP_ERROR_INCORRECT_STATE);
 
-    ChipLogProgress(DeviceLayer, "Sending indication for CHIPoBLE TX characteristic (con %u, len %u)", conId, data->DataLength());
+    // BTP keeps at most one indication in flight per connection and waits for its confirmation,
+    // so a missing credit means the caller and the stack disagree on the connection state.
+    VerifyOrExit(conState->TxCredits > 0, err = CHIP_ERROR_INCORRECT_STATE);
+
+    err = SendIndicationNow(*conState, data);
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "BLEManagerImpl::SendIndication() failed: %s", ErrorStr(err));
+    }
+    return err;
+}
+
+CHIP_ERROR BLEManagerImpl::SendIndicationNow(CHIPoBLEConState & conState, const chip::System::PacketBufferHandle & data)
+{
+    CHIP_ERROR err;
+    struct os_mbuf * om;
+
+    ChipLogProgress(DeviceLayer, "Sending indication for CHIPoBLE TX characteristic (con %u, len %u)", conState.ConId,
+                    data->DataLength());
 
     om = ble_hs_mbuf_from_flat(data->Start(), data->DataLength());
     if (om == NULL)
     {
         ChipLogError(DeviceLayer, "ble_hs_mbuf_from_flat failed");
-        err = CHIP_ERROR_NO_MEMORY;
-        ExitNow();
+        return CHIP_ERROR_NO_MEMORY;
     }
+    mPathStats.TxAllocs++;
 
-	ChipLogProgress(DeviceLayer, "Sending indication custom");
-    err = MapBLEError(ble_gattc_indicate_custom(conId, mTXCharCCCDAttrHandle, om));
+    err = MapBLEError(ble_gattc_indicate_custom(conState.ConId, mTXCharCCCDAttrHandle, om));
     if (err != CHIP_NO_ERROR)
     {
         ChipLogError(DeviceLayer, "ble_gattc_indicate_custom() failed: %s", ErrorStr(err));
-        ExitNow();
+        return err;
     }
 
-exit:
-    if (err != CHIP_NO_ERROR)
+    conState.TxCredits--;
+    conState.IndicationSentAtUs = System::SystemClock().GetMonotonicMicroseconds64().count();
+    mPathStats.TxFragments++;
+    mPathStats.TxBytes += data->DataLength();
+
+    return CHIP_NO_ERROR;
+}
+
+void BLEManagerImpl::OnIndicationConfirmed(uint16_t conId)
+{
+    CHIPoBLEConState * conState = GetConnectionState(conId);
+
+    VerifyOrReturn(conState != nullptr);
+
+    if (conState->IndicationSentAtUs != 0)
     {
-        ChipLogError(DeviceLayer, "BLEManagerImpl::SendIndication() failed: %s", ErrorStr(err));
-        return CHIP_ERROR_NOT_IMPLEMENTED;
+        uint32_t latencyUs =
+            static_cast<uint32_t>(System::SystemClock().GetMonotonicMicroseconds64().count() - conState->IndicationSentAtUs);
+
+        conState->IndicationSentAtUs = 0;
+        mPathStats.IndicationConfirms++;
+        mPathStats.IndicationLatencyLastUs = latencyUs;
+        mPathStats.IndicationLatencyTotalUs += latencyUs;
+        if (latencyUs > mPathStats.IndicationLatencyMaxUs)
+        {
+            mPathStats.IndicationLatencyMaxUs = latencyUs;
+        }
+    }
+
+    if (conState->TxCredits < kIndicationCredits)
+    {
+        conState->TxCredits++;
     }
-    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR BLEManagerImpl::SendWriteRequest(BLE_CONNECTION_OBJECT conId, const ChipBleUUID * svcId, const ChipBleUUID * charId,
@@ -482,6 +722,10 @@ void BLEManagerImpl::DriveBLEState(void)
                 ChipLogProgress(DeviceLayer, "CHIPoBLE advertising started");
 
                 mFlags.Set(Flags::kAdvertising);
+                mAdvertiseStartTime = System::SystemClock().GetMonotonicTimestamp();
+                mAdvPhaseStartTime  = mAdvertiseStartTime;
+                mDiscoveryPending   = true;
+                ArmAdvertisingPhaseTimer();
 
                 // Post a CHIPoBLEAdvertisingChange(Started) event.
                 {
@@ -498,12 +742,12 @@ void BLEManagerImpl::DriveBLEState(void)
         if (mFlags.Has(Flags::kAdvertising))
         {
         	 ChipLogProgress(DeviceLayer, "Check BLE gap advertising Active...");
-            if (ble_gap_adv_active())
+            if (IsAdvertiserActive())
             {
-                err = MapBLEError(ble_gap_adv_stop());
+                err = StopAdvertiser();
                 if (err != CHIP_NO_ERROR)
                 {
-                    ChipLogError(DeviceLayer, "ble_gap_adv_stop() failed: %s", ErrorStr(err));
+                    ChipLogError(DeviceLayer, "Stopping advertiser failed: %s", ErrorStr(err));
                     ExitNow();
                 }
             }
@@ -513,8 +757,12 @@ void BLEManagerImpl::DriveBLEState(void)
             // Transition to the not Advertising state...
             if (mFlags.Has(Flags::kAdvertising))
             {
+                AccountAdvertisingTime();
                 mFlags.Clear(Flags::kAdvertising);
-                mFlags.Set(Flags::kFastAdvertisingEnabled, true);
+                mActiveAdvItvlMin = 0;
+                mActiveAdvItvlMax = 0;
+                mAdvPhase         = AdvertisingPhase::kFast;
+                DeviceLayer::SystemLayer().CancelTimer(HandleAdvertisingPhaseTimer, this);
 
                 ChipLogProgress(DeviceLayer, "CHIPoBLE advertising stopped");
 
@@ -619,11 +867,6 @@ CHIP_ERROR BLEManagerImpl::InitATBMBleLayer(void)
         ExitNow();
     }
 
-    for (int i = 0; i < kMaxConnections; i++)
-    {
-        mSubscribedConIds[i] = BLE_CONNECTION_UNINITIALIZED;
-    }
-
 	ChipLogProgress(DeviceLayer, "BLE nim port init...");
     nimble_port_init();
 
@@ -674,8 +917,8 @@ exit:
 CHIP_ERROR BLEManagerImpl::ConfigureAdvertisingData(void)
 {
     CHIP_ERROR err;
-    uint8_t advData[MAX_ADV_DATA_LEN];
-    uint8_t index = 0;
+    uint8_t * advData = mAdvData;
+    uint8_t index     = 0;
 
     constexpr uint8_t kServiceDataTypeSize = 1;
 
@@ -701,7 +944,7 @@ CHIP_ERROR BLEManagerImpl::ConfigureAdvertisingData(void)
         ExitNow();
     }
 
-    memset(advData, 0, sizeof(advData));
+    memset(advData, 0, sizeof(mAdvData));
     advData[index++] = 0x02;                                                                // length
     advData[index++] = CHIP_ADV_DATA_TYPE_FLAGS;                                            // AD type : flags
     advData[index++] = CHIP_ADV_DATA_FLAGS;                                                 // AD value
@@ -721,18 +964,20 @@ CHIP_ERROR BLEManagerImpl::ConfigureAdvertisingData(void)
     deviceIdInfo.SetAdditionalDataFlag(true);
 #endif
 
-    VerifyOrExit(index + sizeof(deviceIdInfo) <= sizeof(advData), err = CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG);
+    VerifyOrExit(index + sizeof(deviceIdInfo) <= sizeof(mAdvData), err = CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG);
     memcpy(&advData[index], &deviceIdInfo, sizeof(deviceIdInfo));
     index = static_cast<uint8_t>(index + sizeof(deviceIdInfo));
 
+#if !CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
 	ChipLogProgress(DeviceLayer, "Construct the Chip BLE Service Data");
     // Construct the Chip BLE Service Data to be sent in the scan response packet.
-    err = MapBLEError(ble_gap_adv_set_data(advData, sizeof(advData)));
+    err = MapBLEError(ble_gap_adv_set_data(advData, sizeof(mAdvData)));
     if (err != CHIP_NO_ERROR)
     {
         ChipLogError(DeviceLayer, "ble_gap_adv_set_data failed: %s %d", ErrorStr(err), discriminator);
         ExitNow();
     }
+#endif // Extended advertising sets are configured and filled in StartAdvertising().
 
 exit:
     return err;
@@ -816,27 +1061,9 @@ void BLEManagerImpl::HandleTXCharCCCDWrite(struct ble_gap_event * gapEvent)
     // Determine if the client is enabling or disabling indications.
     indicationsEnabled = gapEvent->subscribe.cur_indicate;
 
-    // If the client has requested to enabled indications
-    if (indicationsEnabled)
-    {
-        // If indications are not already enabled for the connection...
-        if (!IsSubscribed(gapEvent->subscribe.conn_handle))
-        {
-            // Record that indications have been enabled for this connection.  If this fails because
-            err = SetSubscribed(gapEvent->subscribe.conn_handle);
-            VerifyOrExit(err != CHIP_ERROR_NO_MEMORY, err = CHIP_NO_ERROR);
-            SuccessOrExit(err);
-        }
-    }
-    else
-    {
-        // If indications had previously been enabled for this connection, record that they are no longer
-        // enabled.
-        UnsetSubscribed(gapEvent->subscribe.conn_handle);
-    }
-
     // Post an event to the Chip queue to process either a CHIPoBLE Subscribe or Unsubscribe based on
-    // whether the client is enabling or disabling indications.
+    // whether the client is enabling or disabling indications.  The per-connection subscription
+    // state is updated when the event is handled on the CHIP task.
     {
         ChipDeviceEvent event;
         event.Type = (indicationsEnabled) ? DeviceEventType::kCHIPoBLESubscribe : DeviceEventType::kCHIPoBLEUnsubscribe;
@@ -846,7 +1073,6 @@ void BLEManagerImpl::HandleTXCharCCCDWrite(struct ble_gap_event * gapEvent)
 
     ChipLogProgress(DeviceLayer, "CHIPoBLE %s received", (indicationsEnabled) ? "subscribe" : "unsubscribe");
 
-exit:
     if (err != CHIP_NO_ERROR)
     {
         ChipLogError(DeviceLayer, "HandleTXCharCCCDWrite() failed: %s", ErrorStr(err));
@@ -872,6 +1098,9 @@ CHIP_ERROR BLEManagerImpl::HandleTXComplete(struct ble_gap_event * gapEvent)
     }
     else
     {
+        ATBM_FLASH_TRACE(kEvent_BLEIndicationFailed, gapEvent->notify_tx.conn_handle,
+                         static_cast<uint32_t>(gapEvent->notify_tx.status));
+
         ChipDeviceEvent event;
         event.Type                           = DeviceEventType::kCHIPoBLEConnectionError;
         event.CHIPoBLEConnectionError.ConId  = gapEvent->notify_tx.conn_handle;
@@ -887,7 +1116,7 @@ uint16_t BLEManagerImpl::_NumConnections(void)
     uint16_t numCons = 0;
     for (uint16_t i = 0; i < kMaxConnections; i++)
     {
-        if (mSubscribedConIds[i] != BLE_CONNECTION_UNINITIALIZED)
+        if (mCons[i].Allocated)
         {
             numCons++;
         }
@@ -903,9 +1132,13 @@ CHIP_ERROR BLEManagerImpl::HandleGAPPeripheralConnect(struct ble_gap_event * gap
 
     // Track the number of active GAP connections.
     mNumGAPCons++;
-    err = SetSubscribed(gapEvent->connect.conn_handle);
-    VerifyOrExit(err != CHIP_ERROR_NO_MEMORY, err = CHIP_NO_ERROR);
-    SuccessOrExit(err);
+
+    if (gapEvent->connect.status == 0)
+    {
+        ATBM_FLASH_TRACE(kEvent_BLEConnected, gapEvent->connect.conn_handle);
+        err = PlatformMgr().ScheduleWork(HandleGAPConnectWork, static_cast<intptr_t>(gapEvent->connect.conn_handle));
+        SuccessOrExit(err);
+    }
 
     mFlags.Set(Flags::kAdvertisingRefreshNeeded);
     mFlags.Clear(Flags::kAdvertisingConfigured);
@@ -914,6 +1147,28 @@ exit:
     return err;
 }
 
+void BLEManagerImpl::HandleGAPConnectWork(intptr_t arg)
+{
+    uint16_t conId = static_cast<uint16_t>(arg);
+
+    // The advertising metrics belong to the CHIP task, so the discovery latency is taken here
+    // rather than on the NimBLE host task.
+    if (sInstance.mDiscoveryPending)
+    {
+        sInstance.mDiscoveryPending                  = false;
+        sInstance.mAdvMetrics.LastDiscoveryLatencyMs =
+            System::Clock::Milliseconds32(System::SystemClock().GetMonotonicTimestamp() - sInstance.mAdvertiseStartTime).count();
+        sInstance.mAdvMetrics.DiscoveryCount++;
+        ChipLogProgress(DeviceLayer, "CHIPoBLE discovered after %" PRIu32 " ms (phase %u)",
+                        sInstance.mAdvMetrics.LastDiscoveryLatencyMs, static_cast<unsigned>(sInstance.mAdvPhase));
+    }
+
+    if (sInstance.GetConnectionState(conId, true) == nullptr)
+    {
+        ChipLogError(DeviceLayer, "No free CHIPoBLE connection slot (con %u)", conId);
+    }
+}
+
 CHIP_ERROR BLEManagerImpl::HandleGAPConnect(struct ble_gap_event * gapEvent)
 {
     return HandleGAPPeripheralConnect(gapEvent);
@@ -923,6 +1178,8 @@ CHIP_ERROR BLEManagerImpl::HandleGAPDisconnect(struct ble_gap_event * gapEvent)
 {
     ChipLogProgress(DeviceLayer, "BLE GAP connection terminated (con %u reason 0x%02x)", gapEvent->disconnect.conn.conn_handle,
                     gapEvent->disconnect.reason);
+    ATBM_FLASH_TRACE(kEvent_BLEDisconnected, gapEvent->disconnect.conn.conn_handle,
+                     static_cast<uint32_t>(gapEvent->disconnect.reason));
 
     // Update the number of GAP connections.
     if (mNumGAPCons > 0)
@@ -930,23 +1187,11 @@ CHIP_ERROR BLEManagerImpl::HandleGAPDisconnect(struct ble_gap_event * gapEvent)
         mNumGAPCons--;
     }
 
-    if (UnsetSubscribed(gapEvent->disconnect.conn.conn_handle))
-    {
-        CHIP_ERROR disconReason;
-        switch (gapEvent->disconnect.reason)
-        {
-        case BLE_ERR_REM_USER_CONN_TERM:
-            disconReason = BLE_ERROR_REMOTE_DEVICE_DISCONNECTED;
-            break;
-        case BLE_ERR_CONN_TERM_LOCAL:
-            disconReason = BLE_ERROR_APP_CLOSED_CONNECTION;
-            break;
-        default:
-            disconReason = BLE_ERROR_CHIPOBLE_PROTOCOL_ABORT;
-            break;
-        }
-        HandleConnectionError(gapEvent->disconnect.conn.conn_handle, disconReason);
-    }
+    // Release the connection state on the CHIP task, ahead of the ConnectionClosed event below.
+    ReturnErrorOnFailure(PlatformMgr().ScheduleWork(
+        HandleGAPDisconnectWork,
+        static_cast<intptr_t>((static_cast<uint32_t>(gapEvent->disconnect.reason & 0xFFFF) << 16) |
+                              gapEvent->disconnect.conn.conn_handle)));
 
     ChipDeviceEvent disconnectEvent;
     disconnectEvent.Type = DeviceEventType::kCHIPoBLEConnectionClosed;
@@ -960,59 +1205,68 @@ CHIP_ERROR BLEManagerImpl::HandleGAPDisconnect(struct ble_gap_event * gapEvent)
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR BLEManagerImpl::SetSubscribed(uint16_t conId)
+void BLEManagerImpl::HandleGAPDisconnectWork(intptr_t arg)
 {
-    uint16_t freeIndex = kMaxConnections;
+    uint16_t conId  = static_cast<uint16_t>(static_cast<uint32_t>(arg) & 0xFFFF);
+    uint16_t reason = static_cast<uint16_t>(static_cast<uint32_t>(arg) >> 16);
+    CHIP_ERROR disconReason;
 
-    for (uint16_t i = 0; i < kMaxConnections; i++)
-    {
-        if (mSubscribedConIds[i] == conId)
-        {
-            return CHIP_NO_ERROR;
-        }
-        else if (mSubscribedConIds[i] == BLE_CONNECTION_UNINITIALIZED && i < freeIndex)
-        {
-            freeIndex = i;
-        }
-    }
+    VerifyOrReturn(sInstance.GetConnectionState(conId) != nullptr);
+    sInstance.ReleaseConnectionState(conId);
 
-    if (freeIndex < kMaxConnections)
+    switch (reason)
     {
-        mSubscribedConIds[freeIndex] = conId;
-        return CHIP_NO_ERROR;
-    }
-    else
-    {
-        return CHIP_ERROR_NO_MEMORY;
+    case BLE_ERR_REM_USER_CONN_TERM:
+        disconReason = BLE_ERROR_REMOTE_DEVICE_DISCONNECTED;
+        break;
+    case BLE_ERR_CONN_TERM_LOCAL:
+        disconReason = BLE_ERROR_APP_CLOSED_CONNECTION;
+        break;
+    default:
+        disconReason = BLE_ERROR_CHIPOBLE_PROTOCOL_ABORT;
+        break;
     }
+    sInstance.HandleConnectionError(conId, disconReason);
 }
 
-bool BLEManagerImpl::UnsetSubscribed(uint16_t conId)
+BLEManagerImpl::CHIPoBLEConState * BLEManagerImpl::GetConnectionState(uint16_t conId, bool allocate)
 {
-    for (uint16_t i = 0; i < kMaxConnections; i++)
+    CHIPoBLEConState * freeState = nullptr;
+
+    VerifyOrReturnValue(conId != BLE_CONNECTION_UNINITIALIZED, nullptr);
+
+    // Connection handles are small controller-assigned integers, so the home slot almost
+    // always matches; probe the remaining slots for collisions.
+    for (uint16_t probe = 0; probe < kMaxConnections; probe++)
     {
-        if (mSubscribedConIds[i] == conId)
+        CHIPoBLEConState & conState = mCons[(conId + probe) % kMaxConnections];
+
+        if (conState.Allocated && conState.ConId == conId)
+        {
+            return &conState;
+        }
+        if (!conState.Allocated && freeState == nullptr)
         {
-            mSubscribedConIds[i] = BLE_CONNECTION_UNINITIALIZED;
-            return true;
+            freeState = &conState;
         }
     }
-    return false;
+
+    if (allocate && freeState != nullptr)
+    {
+        freeState->Set(conId);
+        return freeState;
+    }
+    return nullptr;
 }
 
-bool BLEManagerImpl::IsSubscribed(uint16_t conId)
+void BLEManagerImpl::ReleaseConnectionState(uint16_t conId)
 {
-    if (conId != BLE_CONNECTION_UNINITIALIZED)
+    CHIPoBLEConState * conState = GetConnectionState(conId);
+
+    if (conState != nullptr)
     {
-        for (uint16_t i = 0; i < kMaxConnections; i++)
-        {
-            if (mSubscribedConIds[i] == conId)
-            {
-                return true;
-            }
-        }
+        conState->Reset();
     }
-    return false;
 }
 
 int BLEManagerImpl::ble_svr_gap_event(struct ble_gap_event * event, void * arg)
@@ -1034,6 +1288,14 @@ int BLEManagerImpl::ble_svr_gap_event(struct ble_gap_event * event, void * arg)
 
     case BLE_GAP_EVENT_ADV_COMPLETE:
         ChipLogProgress(DeviceLayer, "BLE_GAP_EVENT_ADV_COMPLETE event");
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+        // Only the set that was connected to (or timed out) stops; the other one keeps
+        // advertising until the next refresh restarts both.
+        taskENTER_CRITICAL();
+        sInstance.mExtAdvSets = static_cast<uint8_t>(sInstance.mExtAdvSets & ~(1 << event->adv_complete.instance));
+        taskEXIT_CRITICAL();
+        sInstance.mFlags.Set(Flags::kAdvertisingRefreshNeeded);
+#endif
         break;
 
     case BLE_GAP_EVENT_SUBSCRIBE:
@@ -1074,10 +1336,9 @@ exit:
 }
 
 #if CHIP_ENABLE_ADDITIONAL_DATA_ADVERTISING
-void BLEManagerImpl::HandleC3CharRead(struct ble_gatt_char_context * param)
+CHIP_ERROR BLEManagerImpl::GenerateAdditionalDataPayload(chip::System::PacketBufferHandle & bufferHandle)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
-    chip::System::PacketBufferHandle bufferHandle;
 
     BitFlags<AdditionalDataFields> additionalDataFields;
     AdditionalDataPayloadGeneratorParams additionalDataPayloadParams;
@@ -1096,6 +1357,17 @@ void BLEManagerImpl::HandleC3CharRead(struct ble_gatt_char_context * param)
 
     err = AdditionalDataPayloadGenerator().generateAdditionalDataPayload(additionalDataPayloadParams, bufferHandle,
                                                                          additionalDataFields);
+
+exit:
+    return err;
+}
+
+void BLEManagerImpl::HandleC3CharRead(struct ble_gatt_char_context * param)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    chip::System::PacketBufferHandle bufferHandle;
+
+    err = GenerateAdditionalDataPayload(bufferHandle);
     SuccessOrExit(err);
 	ChipLogProgress(DeviceLayer, "BLE os_mbuf_append...");
     os_mbuf_append(param->ctxt->om, bufferHandle->Start(), bufferHandle->DataLength());
@@ -1197,58 +1469,258 @@ CHIP_ERROR BLEManagerImpl::StartAdvertising(void)
     bool connectable     = (numCons < kMaxConnections);
     adv_params.conn_mode = connectable ? BLE_GAP_CONN_MODE_UND : BLE_GAP_CONN_MODE_NON;
 
-    // Advertise in fast mode if it is connectable advertisement and
-    // the application has expressly requested fast advertising.
-    if (connectable && mFlags.Has(Flags::kFastAdvertisingEnabled))
-    {
-        adv_params.itvl_min = CHIP_DEVICE_CONFIG_BLE_FAST_ADVERTISING_INTERVAL_MIN;
-        adv_params.itvl_max = CHIP_DEVICE_CONFIG_BLE_FAST_ADVERTISING_INTERVAL_MAX;
-    }
-    else
-    {
-        adv_params.itvl_min = CHIP_DEVICE_CONFIG_BLE_SLOW_ADVERTISING_INTERVAL_MIN;
-        adv_params.itvl_max = CHIP_DEVICE_CONFIG_BLE_SLOW_ADVERTISING_INTERVAL_MAX;
-    }
+    // Pick the interval for the current scheduler phase.
+    GetAdvertisingIntervals(connectable, adv_params.itvl_min, adv_params.itvl_max);
 
     ChipLogProgress(DeviceLayer, "Configuring CHIPoBLE advertising (interval %" PRIu32 " ms, %sconnectable)",
                     (((uint32_t) adv_params.itvl_min) * 10) / 16, (connectable) ? "" : "non-");
 
-	ChipLogProgress(DeviceLayer, "Check BLE gap advertising active");
-    if (ble_gap_adv_active())
+#if !CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+    if (mScanResponse.HasValue())
     {
-        /* Advertising is already active. Stop and restart with the new parameters */
-        ChipLogProgress(DeviceLayer, "Device already advertising, stop active advertisement and restart");
-        err = MapBLEError(ble_gap_adv_stop());
+    	ChipLogProgress(DeviceLayer, "BLE set advertising response data...");
+        err = MapBLEError(ble_gap_adv_rsp_set_data(mScanResponse.Value().data(), mScanResponse.Value().size()));
         if (err != CHIP_NO_ERROR)
         {
-            ChipLogError(DeviceLayer, "ble_gap_adv_stop() failed: %s, cannot restart", ErrorStr(err));
+            ChipLogError(DeviceLayer, "ble_gap_adv_rsp_set_data failed: %s", ErrorStr(err));
             return err;
         }
     }
+#endif
 
-    if (mScanResponse.HasValue())
+	ChipLogProgress(DeviceLayer, "Check BLE gap advertising active");
+    if (IsAdvertiserActive())
     {
-    	ChipLogProgress(DeviceLayer, "BLE set advertising response data...");
-        err = MapBLEError(ble_gap_adv_rsp_set_data(mScanResponse.Value().data(), mScanResponse.Value().size()));
+        // Advertising and scan response data can be replaced while the advertiser is running,
+        // so only cycle the controller when the interval or connectable mode actually changed.
+        if (adv_params.itvl_min == mActiveAdvItvlMin && adv_params.itvl_max == mActiveAdvItvlMax &&
+            adv_params.conn_mode == mActiveAdvConnMode)
+        {
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+            // A set stopped by a connection needs a restart.  Some controllers refuse fragmented
+            // extended data while the set is enabled; fall back to a restart in that case too.
+            if (GetExtAdvertisingSets() == kAllExtAdvSets && SetExtAdvertisingData() == CHIP_NO_ERROR)
+#endif
+            {
+                mAdvMetrics.DataOnlyUpdates++;
+                return CHIP_NO_ERROR;
+            }
+        }
+
+        /* Advertising is already active. Stop and restart with the new parameters */
+        ChipLogProgress(DeviceLayer, "Device already advertising, stop active advertisement and restart");
+        err = StopAdvertiser();
         if (err != CHIP_NO_ERROR)
         {
-            ChipLogError(DeviceLayer, "ble_gap_adv_rsp_set_data failed: %s", ErrorStr(err));
+            ChipLogError(DeviceLayer, "Stopping advertiser failed: %s, cannot restart", ErrorStr(err));
             return err;
         }
+        mAdvMetrics.ParamUpdates++;
     }
+
 	ChipLogProgress(DeviceLayer, "Start BLE gap advertising");
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+    err = StartExtAdvertising(adv_params);
+#else
     err = MapBLEError(ble_gap_adv_start(own_addr_type, NULL, BLE_HS_FOREVER, &adv_params, (ble_gap_event_fn *)ble_svr_gap_event, NULL));
+#endif
     if (err == CHIP_NO_ERROR)
     {
+        // Close out the airtime accounting at the old interval before switching.
+        AccountAdvertisingTime();
+        mActiveAdvItvlMin  = adv_params.itvl_min;
+        mActiveAdvItvlMax  = adv_params.itvl_max;
+        mActiveAdvConnMode = adv_params.conn_mode;
         return CHIP_NO_ERROR;
     }
     else
     {
-        ChipLogError(DeviceLayer, "ble_gap_adv_start() failed: %s", ErrorStr(err));
+        ChipLogError(DeviceLayer, "Starting advertiser failed: %s", ErrorStr(err));
         return err;
     }
 }
 
+bool BLEManagerImpl::IsAdvertiserActive(void)
+{
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+    // Active while either set is still enabled.
+    return GetExtAdvertisingSets() != 0;
+#else
+    return ble_gap_adv_active();
+#endif
+}
+
+CHIP_ERROR BLEManagerImpl::StopAdvertiser(void)
+{
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+    // A set that was consumed by an incoming connection is already stopped.
+    int rc = ble_gap_ext_adv_stop(kExtAdvInstance);
+    if (rc == 0 || rc == BLE_HS_EALREADY)
+    {
+        rc = ble_gap_ext_adv_stop(kLegacyAdvInstance);
+    }
+    if (rc == BLE_HS_EALREADY)
+    {
+        rc = 0;
+    }
+    if (rc == 0)
+    {
+        taskENTER_CRITICAL();
+        mExtAdvSets = 0;
+        taskEXIT_CRITICAL();
+    }
+    return MapBLEError(rc);
+#else
+    return MapBLEError(ble_gap_adv_stop());
+#endif
+}
+
+#if CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+uint8_t BLEManagerImpl::GetExtAdvertisingSets(void)
+{
+    taskENTER_CRITICAL();
+    uint8_t sets = mExtAdvSets;
+    taskEXIT_CRITICAL();
+    return sets;
+}
+
+CHIP_ERROR BLEManagerImpl::BuildExtAdvertisingData(uint8_t * buf, size_t bufSize, size_t & len)
+{
+    size_t nameLen = strlen(mDeviceName);
+    size_t index;
+
+    // The legacy payload (flags + CHIPoBLE service data) is a valid prefix of the extended one.
+    VerifyOrReturnError(bufSize >= sizeof(mAdvData) + 2 + nameLen, CHIP_ERROR_BUFFER_TOO_SMALL);
+    memcpy(buf, mAdvData, sizeof(mAdvData));
+    index = static_cast<size_t>(mAdvData[0] + 1);
+    index += static_cast<size_t>(mAdvData[index] + 1);
+
+    buf[index++] = static_cast<uint8_t>(nameLen + 1);
+    buf[index++] = BLE_HS_ADV_TYPE_COMP_NAME;
+    memcpy(&buf[index], mDeviceName, nameLen);
+    index += nameLen;
+
+#if CHIP_ENABLE_ADDITIONAL_DATA_ADVERTISING
+    // Carry the C3 additional data (rotating device ID) as 128-bit service data keyed by the
+    // C3 characteristic UUID, so commissioners do not need a GATT read to get it.
+    {
+        constexpr size_t kUUID128Size = sizeof(UUID_CHIPoBLEChar_C3.value);
+        chip::System::PacketBufferHandle additionalData;
+        if (GenerateAdditionalDataPayload(additionalData) == CHIP_NO_ERROR)
+        {
+            size_t dataLen = additionalData->DataLength();
+            if (index + 2 + kUUID128Size + dataLen <= bufSize && 1 + kUUID128Size + dataLen <= UINT8_MAX)
+            {
+                buf[index++] = static_cast<uint8_t>(1 + kUUID128Size + dataLen);
+                buf[index++] = BLE_HS_ADV_TYPE_SVC_DATA_UUID128;
+                memcpy(&buf[index], UUID_CHIPoBLEChar_C3.value, kUUID128Size);
+                index += kUUID128Size;
+                memcpy(&buf[index], additionalData->Start(), dataLen);
+                index += dataLen;
+            }
+            else
+            {
+                ChipLogError(DeviceLayer, "Additional data does not fit extended advertising payload");
+            }
+        }
+    }
+#endif
+
+    // The extended set is not scannable, so fold the application scan response into it.
+    if (mScanResponse.HasValue())
+    {
+        VerifyOrReturnError(index + mScanResponse.Value().size() <= bufSize, CHIP_ERROR_BUFFER_TOO_SMALL);
+        memcpy(&buf[index], mScanResponse.Value().data(), mScanResponse.Value().size());
+        index += mScanResponse.Value().size();
+    }
+
+    len = index;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BLEManagerImpl::SetExtAdvertisingData(void)
+{
+    uint8_t extAdvData[MYNEWT_VAL_BLE_EXT_ADV_MAX_SIZE];
+    size_t extAdvDataLen = 0;
+    struct os_mbuf * om;
+
+    ReturnErrorOnFailure(BuildExtAdvertisingData(extAdvData, sizeof(extAdvData), extAdvDataLen));
+
+    om = ble_hs_mbuf_from_flat(extAdvData, static_cast<uint16_t>(extAdvDataLen));
+    VerifyOrReturnError(om != NULL, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(MapBLEError(ble_gap_ext_adv_set_data(kExtAdvInstance, om)));
+
+    om = ble_hs_mbuf_from_flat(mAdvData, sizeof(mAdvData));
+    VerifyOrReturnError(om != NULL, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(MapBLEError(ble_gap_ext_adv_set_data(kLegacyAdvInstance, om)));
+
+    if (mScanResponse.HasValue())
+    {
+        om = ble_hs_mbuf_from_flat(mScanResponse.Value().data(), static_cast<uint16_t>(mScanResponse.Value().size()));
+        VerifyOrReturnError(om != NULL, CHIP_ERROR_NO_MEMORY);
+        ReturnErrorOnFailure(MapBLEError(ble_gap_ext_adv_rsp_set_data(kLegacyAdvInstance, om)));
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BLEManagerImpl::StartExtAdvertising(const ble_gap_adv_params & advParams)
+{
+    bool connectable = (advParams.conn_mode != BLE_GAP_CONN_MODE_NON);
+    struct ble_gap_ext_adv_params params;
+
+    // A set cannot be reconfigured while enabled (BLE_HS_EBUSY), and an ADV_COMPLETE may still
+    // be on its way; stopping an already stopped set is harmless.
+    ReturnErrorOnFailure(StopAdvertiser());
+
+    // Extended set: connectable, non-scannable, payload on the secondary PHY.
+    memset(&params, 0, sizeof(params));
+    params.connectable   = connectable;
+    params.scannable     = 0;
+    params.legacy_pdu    = 0;
+    params.itvl_min      = advParams.itvl_min;
+    params.itvl_max      = advParams.itvl_max;
+    params.channel_map   = 0x07;
+    params.own_addr_type = own_addr_type;
+    params.primary_phy   = CHIP_DEVICE_CONFIG_BLE_EXT_ADV_PRIMARY_PHY;
+    params.secondary_phy = CHIP_DEVICE_CONFIG_BLE_EXT_ADV_SECONDARY_PHY;
+    params.tx_power      = 127; // no preference
+    params.sid           = kExtAdvInstance;
+    ReturnErrorOnFailure(MapBLEError(
+        ble_gap_ext_adv_configure(kExtAdvInstance, &params, NULL, (ble_gap_event_fn *) ble_svr_gap_event, NULL)));
+
+    // Legacy fallback set for scanners that do not understand extended advertising.  Legacy
+    // connectable PDUs (ADV_IND) are always scannable.
+    memset(&params, 0, sizeof(params));
+    params.connectable   = connectable;
+    params.scannable     = connectable || mScanResponse.HasValue();
+    params.legacy_pdu    = 1;
+    params.itvl_min      = advParams.itvl_min;
+    params.itvl_max      = advParams.itvl_max;
+    params.channel_map   = 0x07;
+    params.own_addr_type = own_addr_type;
+    params.primary_phy   = BLE_HCI_LE_PHY_1M;
+    params.secondary_phy = BLE_HCI_LE_PHY_1M;
+    params.tx_power      = 127;
+    params.sid           = kLegacyAdvInstance;
+    ReturnErrorOnFailure(MapBLEError(
+        ble_gap_ext_adv_configure(kLegacyAdvInstance, &params, NULL, (ble_gap_event_fn *) ble_svr_gap_event, NULL)));
+
+    ReturnErrorOnFailure(SetExtAdvertisingData());
+
+    ReturnErrorOnFailure(MapBLEError(ble_gap_ext_adv_start(kExtAdvInstance, 0, 0)));
+    taskENTER_CRITICAL();
+    mExtAdvSets = static_cast<uint8_t>(mExtAdvSets | (1 << kExtAdvInstance));
+    taskEXIT_CRITICAL();
+    ReturnErrorOnFailure(MapBLEError(ble_gap_ext_adv_start(kLegacyAdvInstance, 0, 0)));
+    taskENTER_CRITICAL();
+    mExtAdvSets = static_cast<uint8_t>(mExtAdvSets | (1 << kLegacyAdvInstance));
+    taskEXIT_CRITICAL();
+
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_DEVICE_CONFIG_BLE_EXT_ADVERTISING
+
 void BLEManagerImpl::DriveBLEState(intptr_t arg)
 {
     sInstance.DriveBLEState();
@@ -0,0 +1,266 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "atbm_pkt_pool.h"
+
+#include "lwip/mem.h"
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+
+#include "FreeRTOS.h"
+#include "atbm_general.h"
+#include "task.h"
+
+#ifndef PBUF_MATTER_APPEND_LEN
+#define PBUF_MATTER_APPEND_LEN 0
+#endif
+
+#define POOL_ALIGN(size) (((size) + 7u) & ~(size_t) 7u)
+
+/* mem_malloc() prefixes each block with its size when lwIP keeps MEM_STATS. */
+#if LWIP_STATS && MEM_STATS
+#define POOL_STATSHELPER_SIZE LWIP_MEM_ALIGN_SIZE(sizeof(mem_size_t))
+#else
+#define POOL_STATSHELPER_SIZE 0
+#endif
+
+/* A PBUF_RAM pbuf: struct pbuf, room for every header down to the WiFi driver, and the tail the SDK appends. */
+#define POOL_PBUF_SIZE(payload)                                                                                                    \
+    POOL_ALIGN(POOL_STATSHELPER_SIZE + LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf)) + PBUF_LINK_ENCAPSULATION_HLEN + PBUF_LINK_HLEN +  \
+               PBUF_IP_HLEN + PBUF_TRANSPORT_HLEN + (payload) + PBUF_MATTER_APPEND_LEN)
+
+#define POOL_LARGE_PAYLOAD ((TCP_MSS > 1280) ? TCP_MSS : 1280)
+
+#define POOL_SMALL_SIZE POOL_ALIGN(ATBM_PKT_POOL_SMALL_SIZE)
+#define POOL_MEDIUM_SIZE POOL_PBUF_SIZE(ATBM_PKT_POOL_MEDIUM_PAYLOAD)
+#define POOL_LARGE_SIZE POOL_PBUF_SIZE(POOL_LARGE_PAYLOAD)
+
+typedef struct pool_block
+{
+    struct pool_block * next;
+} pool_block_t;
+
+typedef struct pool
+{
+    uint8_t * base;
+    size_t block_size;
+    uint16_t carved; /* Blocks below this index have been handed out at least once. */
+    pool_block_t * free_list;
+    atbm_pkt_pool_stats_t stats;
+} pool_t;
+
+static uint64_t s_small_area[POOL_SMALL_SIZE * ATBM_PKT_POOL_SMALL_COUNT / 8];
+static uint64_t s_medium_area[POOL_MEDIUM_SIZE * ATBM_PKT_POOL_MEDIUM_COUNT / 8];
+static uint64_t s_large_area[POOL_LARGE_SIZE * ATBM_PKT_POOL_LARGE_COUNT / 8];
+
+/* Smallest class first. */
+static pool_t s_pools[ATBM_PKT_POOL_CLASSES] = {
+    { (uint8_t *) s_small_area, POOL_SMALL_SIZE, 0, NULL, { POOL_SMALL_SIZE, ATBM_PKT_POOL_SMALL_COUNT, 0, 0, 0, 0 } },
+    { (uint8_t *) s_medium_area, POOL_MEDIUM_SIZE, 0, NULL, { POOL_MEDIUM_SIZE, ATBM_PKT_POOL_MEDIUM_COUNT, 0, 0, 0, 0 } },
+    { (uint8_t *) s_large_area, POOL_LARGE_SIZE, 0, NULL, { POOL_LARGE_SIZE, ATBM_PKT_POOL_LARGE_COUNT, 0, 0, 0, 0 } },
+};
+
+static uint32_t s_heap_allocs;
+static uint32_t s_heap_failures;
+
+static UBaseType_t pool_lock(void)
+{
+    if (hal_in_irq())
+    {
+        return taskENTER_CRITICAL_FROM_ISR();
+    }
+    taskENTER_CRITICAL();
+    return 0;
+}
+
+static void pool_unlock(UBaseType_t state)
+{
+    if (hal_in_irq())
+    {
+        taskEXIT_CRITICAL_FROM_ISR(state);
+        return;
+    }
+    taskEXIT_CRITICAL();
+}
+
+static pool_t * pool_of(void * ptr)
+{
+    uint8_t * p = (uint8_t *) ptr;
+    int i;
+
+    for (i = 0; i < ATBM_PKT_POOL_CLASSES; i++)
+    {
+        pool_t * pool = &s_pools[i];
+        if (p >= pool->base && p < pool->base + pool->block_size * pool->stats.blocks)
+        {
+            return pool;
+        }
+    }
+    return NULL;
+}
+
+static void * pool_take(pool_t * pool)
+{
+    pool_block_t * block = NULL;
+    UBaseType_t state    = pool_lock();
+
+    /* Untouched blocks are carved off the area in order, so the pools need no initialization. */
+    if (pool->free_list != NULL)
+    {
+        block           = pool->free_list;
+        pool->free_list = block->next;
+    }
+    else if (pool->carved < pool->stats.blocks)
+    {
+        block = (pool_block_t *) (pool->base + pool->block_size * pool->carved);
+        pool->carved++;
+    }
+
+    if (block != NULL)
+    {
+        pool->stats.allocs++;
+        pool->stats.used++;
+        if (pool->stats.used > pool->stats.peak)
+        {
+            pool->stats.peak = pool->stats.used;
+        }
+    }
+    else
+    {
+        pool->stats.misses++;
+    }
+    pool_unlock(state);
+
+    return block;
+}
+
+void * atbm_pkt_pool_malloc(size_t size)
+{
+    void * ptr = NULL;
+    UBaseType_t state;
+    int i;
+
+    for (i = 0; i < ATBM_PKT_POOL_CLASSES; i++)
+    {
+        if (size <= s_pools[i].block_size)
+        {
+            ptr = pool_take(&s_pools[i]);
+            break;
+        }
+    }
+    if (ptr != NULL)
+    {
+        return ptr;
+    }
+
+    ptr   = malloc(size);
+    state = pool_lock();
+    if (ptr != NULL)
+    {
+        s_heap_allocs++;
+    }
+    else
+    {
+        s_heap_failures++;
+    }
+    pool_unlock(state);
+    return ptr;
+}
+
+void * atbm_pkt_pool_calloc(size_t count, size_t size)
+{
+    void * ptr;
+
+    if (size != 0 && count > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+    ptr = atbm_pkt_pool_malloc(count * size);
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void atbm_pkt_pool_free(void * ptr)
+{
+    pool_t * pool;
+    pool_block_t * block;
+    UBaseType_t state;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    pool = pool_of(ptr);
+    if (pool == NULL)
+    {
+        free(ptr);
+        return;
+    }
+
+    block = (pool_block_t *) ptr;
+    state = pool_lock();
+    block->next     = pool->free_list;
+    pool->free_list = block;
+    pool->stats.used--;
+    pool_unlock(state);
+}
+
+void atbm_pkt_pool_get_stats(unsigned int pool, atbm_pkt_pool_stats_t * stats)
+{
+    UBaseType_t state;
+
+    memset(stats, 0, sizeof(*stats));
+    if (pool >= ATBM_PKT_POOL_CLASSES)
+    {
+        return;
+    }
+
+    state  = pool_lock();
+    *stats = s_pools[pool].stats;
+    pool_unlock(state);
+}
+
+void atbm_pkt_pool_get_heap_stats(uint32_t * allocs, uint32_t * failures)
+{
+    UBaseType_t state = pool_lock();
+    *allocs           = s_heap_allocs;
+    *failures         = s_heap_failures;
+    pool_unlock(state);
+}
+
+void atbm_pkt_pool_reset_stats(void)
+{
+    UBaseType_t state = pool_lock();
+    int i;
+
+    for (i = 0; i < ATBM_PKT_POOL_CLASSES; i++)
+    {
+        s_pools[i].stats.peak   = s_pools[i].stats.used;
+        s_pools[i].stats.allocs = 0;
+        s_pools[i].stats.misses = 0;
+    }
+    s_heap_allocs   = 0;
+    s_heap_failures = 0;
+    pool_unlock(state);
+}
@@ -0,0 +1,90 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Fixed-size block pools behind lwIP's mem_malloc() (ATBM_LWIP_MEM_POOL in
+ *          lwipopts.h).  With MEM_LIBC_MALLOC and MEMP_MEM_MALLOC every pbuf, and so every
+ *          CHIP PacketBuffer, and every memp object (PCBs, TCP segments, netconns, timeouts)
+ *          comes from mem_malloc(); the pools keep this traffic off the general heap.
+ *
+ *          Three size classes: small for memp objects, medium for a pbuf with all headers
+ *          and a short payload (ACKs, status reports, mDNS queries), large for a full
+ *          frame.  Allocation takes the first class that fits; an empty class, or a larger
+ *          request, falls back to malloc().  Alloc and free are O(1); pool blocks may be
+ *          freed from an ISR.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ATBM_PKT_POOL_SMALL_SIZE
+#define ATBM_PKT_POOL_SMALL_SIZE 96
+#endif
+
+#ifndef ATBM_PKT_POOL_SMALL_COUNT
+#define ATBM_PKT_POOL_SMALL_COUNT 32
+#endif
+
+/* Payload bytes of a medium block, on top of the pbuf and protocol headers. */
+#ifndef ATBM_PKT_POOL_MEDIUM_PAYLOAD
+#define ATBM_PKT_POOL_MEDIUM_PAYLOAD 160
+#endif
+
+#ifndef ATBM_PKT_POOL_MEDIUM_COUNT
+#define ATBM_PKT_POOL_MEDIUM_COUNT 16
+#endif
+
+/* Large blocks hold a TCP_MSS or IPv6 minimum MTU payload, whichever is larger. */
+#ifndef ATBM_PKT_POOL_LARGE_COUNT
+#define ATBM_PKT_POOL_LARGE_COUNT 6
+#endif
+
+#define ATBM_PKT_POOL_CLASSES 3
+
+typedef struct atbm_pkt_pool_stats
+{
+    uint32_t block_size;
+    uint16_t blocks;
+    uint16_t used;
+    uint16_t peak;
+    uint32_t allocs;
+    uint32_t misses; /* Requests of this class served by malloc() because the pool was empty. */
+} atbm_pkt_pool_stats_t;
+
+void * atbm_pkt_pool_malloc(size_t size);
+void * atbm_pkt_pool_calloc(size_t count, size_t size);
+void atbm_pkt_pool_free(void * ptr);
+
+/* Copies the statistics of class pool (0 .. ATBM_PKT_POOL_CLASSES - 1). */
+void atbm_pkt_pool_get_stats(unsigned int pool, atbm_pkt_pool_stats_t * stats);
+
+/* Requests served by malloc(), and those that malloc() failed as well. */
+void atbm_pkt_pool_get_heap_stats(uint32_t * allocs, uint32_t * failures);
+
+/* Restarts the peaks from the current usage and clears the counters. */
+void atbm_pkt_pool_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
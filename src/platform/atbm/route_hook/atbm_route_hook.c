@@ -33,6 +33,7 @@ PACK_STRUCT_END
 typedef struct rio_header_t rio_header_t;
 
 static atbm_route_hook_t * s_hooks;
+static atbm_route_hook_ra_cb_t s_ra_cb;
 
 static bool is_self_address(struct netif * netif, const ip6_addr_t * addr)
 {
@@ -140,11 +141,22 @@ static uint8_t icmp6_raw_recv_handler(void * arg, struct raw_pcb * pcb, struct p
     icmp6_header = (struct icmp6_hdr *) icmp_payload;
     if (icmp6_header->type == ICMP6_TYPE_RA)
     {
+        if (s_ra_cb != NULL && icmp_payload_len >= sizeof(struct ra_header))
+        {
+            struct ra_header ra;
+            memcpy(&ra, icmp_payload, sizeof(ra));
+            s_ra_cb(hook->netif, lwip_ntohs(ra.router_lifetime));
+        }
         ra_recv_handler(hook->netif, icmp_payload, icmp_payload_len, &src);
     }
     return 0;
 }
 
+void atbm_route_hook_set_ra_callback(atbm_route_hook_ra_cb_t cb)
+{
+    s_ra_cb = cb;
+}
+
 int8_t atbm_route_hook_init(void)
 {
     struct netif * lwip_netif = atbm_wifi_get_sta_netif();
@@ -4,8 +4,15 @@
 extern "C" {
 #endif
 
+struct netif;
+
+typedef void (*atbm_route_hook_ra_cb_t)(struct netif * netif, uint16_t router_lifetime);
+
 int8_t atbm_route_hook_init(void);
 
+/* Called from the TCP/IP thread for every router advertisement received on a hooked netif. */
+void atbm_route_hook_set_ra_callback(atbm_route_hook_ra_cb_t cb);
+
 #ifdef __cplusplus
 }
 #endif
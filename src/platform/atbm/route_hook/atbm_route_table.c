@@ -9,6 +9,8 @@
 #define MAX_RIO_TIMEOUT UINT32_MAX / (1000 * 4) // lwIP defined reasonable timeout value
 
 static atbm_route_entry_t s_route_entries[MAX_RIO_ROUTE];
+/* sys_now() at which s_route_entries[i] expires; kept apart so atbm_route_entry_t stays as is. */
+static uint32_t s_route_expiry_ms[MAX_RIO_ROUTE];
 
 static atbm_route_entry_t * find_route_entry(const atbm_route_entry_t * route_entry)
 {
@@ -77,6 +79,7 @@ atbm_route_entry_t * atbm_route_table_add_route_entry(const atbm_route_entry_t *
     entry->lifetime_seconds = route_entry->lifetime_seconds;
     if (entry->lifetime_seconds != UINT32_MAX)
     {
+        s_route_expiry_ms[entry - s_route_entries] = sys_now() + entry->lifetime_seconds * 1000;
         sys_timeout(entry->lifetime_seconds * 1000, route_timeout_handler, entry);
     }
     return entry;
@@ -91,7 +94,8 @@ int8_t atbm_route_table_remove_route_entry(atbm_route_entry_t * route_entry)
     route_entry->netif = NULL;
     for (atbm_route_entry_t * moved = route_entry; moved < &s_route_entries[LWIP_ARRAYSIZE(s_route_entries) - 1]; moved++)
     {
-        *moved = *(moved + 1);
+        *moved                                     = *(moved + 1);
+        s_route_expiry_ms[moved - s_route_entries] = s_route_expiry_ms[moved - s_route_entries + 1];
         if (moved->netif == NULL)
         {
             break;
@@ -100,6 +104,27 @@ int8_t atbm_route_table_remove_route_entry(atbm_route_entry_t * route_entry)
     return 0;
 }
 
+uint32_t atbm_route_table_next_expiry_ms(void)
+{
+    uint32_t now  = sys_now();
+    uint32_t next = UINT32_MAX;
+
+    for (size_t i = 0; i < LWIP_ARRAYSIZE(s_route_entries); i++)
+    {
+        if (s_route_entries[i].netif == NULL)
+        {
+            break;
+        }
+        if (s_route_entries[i].lifetime_seconds != UINT32_MAX)
+        {
+            int32_t remaining = (int32_t) (s_route_expiry_ms[i] - now);
+            uint32_t expiry   = (remaining > 0) ? (uint32_t) remaining : 0;
+            next              = (expiry < next) ? expiry : next;
+        }
+    }
+    return next;
+}
+
 static inline bool is_better_route(const atbm_route_entry_t * lhs, const atbm_route_entry_t * rhs)
 {
     if (rhs == NULL)
@@ -45,6 +45,16 @@ atbm_route_entry_t * atbm_route_table_add_route_entry(const atbm_route_entry_t *
  */
 int8_t atbm_route_table_remove_route_entry(atbm_route_entry_t * route_entry);
 
+/**
+ * @brief Returns the time until the earliest route entry expires. Call with the lwIP core lock held.
+ *
+ * @return
+ *   - The time in milliseconds, 0 if an entry is past its expiry
+ *   - UINT32_MAX when no entry expires
+ *
+ */
+uint32_t atbm_route_table_next_expiry_ms(void);
+
 /**
  * @brief The lwIP ip6 route hook, called by the lwIP function ip6_route when sending packets.
  *